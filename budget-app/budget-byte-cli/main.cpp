@@ -1,16 +1,13 @@
-#include <core/Hash.h>
+#include <core/FlatMap.h>
 #include <core/Log.h>
 #include <core/Mallocator.h>
+#include <core/Number.h>
 #include <core/StringView.h>
 
 #include <budget-byte/Ledger.h>
 
 #include <fmt/chrono.h>
 
-#include <sstream>
-
-#include <date/date.h>
-
 auto HELP = R"""(budget-byte-cli the cli interface for budget byte financial tracker
 budget-byte-cli path/to/ledger/file command [options]
 COMMANDS:
@@ -36,7 +33,7 @@ class Args
 	core::Allocator* m_allocator = nullptr;
 	core::StringView m_file;
 	core::StringView m_command;
-	core::Map<core::StringView, core::StringView> m_options;
+	core::FlatMap<core::StringView, core::StringView> m_options;
 
 	Args(core::Allocator* allocator)
 		: m_allocator(allocator),
@@ -213,43 +210,41 @@ int main(int argc, char** argv)
 			return EXIT_FAILURE;
 		}
 
-		uint64_t parsedAmount = 0;
-		errno = 0;
-		char* endPtr = nullptr;
-		parsedAmount = std::strtoull(amount.begin(), &endPtr, 10);
-		if ((errno == ERANGE && (parsedAmount == ULLONG_MAX || parsedAmount == 0)) || (errno != 0 && parsedAmount == 0))
+		auto parsedAmount = core::parseUint(amount);
+		if (parsedAmount.isError())
 		{
-			log.critical("failed to read number {}"_sv, amount);
-			return EXIT_FAILURE;
-		}
-		else if (endPtr == amount.begin())
-		{
-			log.critical("no digits found in number {}"_sv, amount);
-			return EXIT_FAILURE;
-		}
-		else if (endPtr != amount.end())
-		{
-			log.critical("failed to parse the entire number {}"_sv, amount);
+			log.critical("failed to parse number {}"_sv, amount);
 			return EXIT_FAILURE;
 		}
 
-		date::year_month_day parsedDate = date::floor<date::days>(std::chrono::system_clock::now());
+		std::chrono::year_month_day stdDate{std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now())};
 		if (date.count() > 0)
 		{
-			std::istringstream str{date.data()};
-			str >> date::parse("%F", parsedDate);
-			if (str.fail())
+			bool valid = date.count() == 10 && date[4] == '-' && date[7] == '-';
+			if (valid)
+			{
+				auto year = core::parseUint(date.slice(0, 4));
+				auto month = core::parseUint(date.slice(5, 7));
+				auto day = core::parseUint(date.slice(8, 10));
+				valid = year.isValue() && month.isValue() && day.isValue();
+				if (valid)
+				{
+					stdDate = std::chrono::year_month_day{
+						std::chrono::year{int(year.value())},
+						std::chrono::month{unsigned(month.value())},
+						std::chrono::day{unsigned(day.value())}};
+					valid = stdDate.ok();
+				}
+			}
+
+			if (valid == false)
 			{
 				log.critical("failed to parse date {}, it should be in YYYY-MM-DD format"_sv, date);
 				return EXIT_FAILURE;
 			}
 		}
 
-		std::chrono::year_month_day stdDate{
-			std::chrono::year{(int)parsedDate.year()},
-			std::chrono::month{(unsigned)parsedDate.month()},
-			std::chrono::day{(unsigned)parsedDate.day()}};
-		err = ledger.addTransaction(parsedAmount, src, dst, stdDate, notes);
+		err = ledger.addTransaction(parsedAmount.value(), src, dst, stdDate, notes);
 		if (err)
 		{
 			log.critical("{}"_sv, err);
@@ -259,7 +254,7 @@ int main(int argc, char** argv)
 		auto tm = std::chrono::sys_days{stdDate};
 		log.info(
 			"Success, amount = {}, src = {}, dst = {}, date = {:%Y-%m-%d}, notes = {}"_sv,
-			parsedAmount,
+			parsedAmount.value(),
 			src,
 			dst,
 			tm,
@@ -1,6 +1,7 @@
 #include "fin/Server.h"
 
 #include <core/File.h>
+#include <core/Hex.h>
 #include <core/MemoryStream.h>
 #include <core/Path.h>
 #include <core/SHA1.h>
@@ -79,13 +80,9 @@ namespace fin
 			return tmpResult.releaseError();
 		}
 
-		core::MemoryStream stream{allocator};
-		for (auto b: hash.asBytes())
-		{
-			core::strf(&stream, "{:02x}"_sv, b);
-		}
-		auto lockName = stream.releaseString();
+		auto lockName = core::Hex::encode(hash.asBytes(), allocator);
 
+		core::MemoryStream stream{allocator};
 		core::strf(&stream, "budget_byte_{}"_sv, lockName);
 		auto filePath = core::Path::join(allocator, tmpResult.releaseValue(), stream.releaseString());
 
@@ -116,12 +113,12 @@ namespace fin
 			return core::errf(allocator, "failed to acquire lock on file '{}'"_sv, lockInfo.absPath());
 		}
 
-		auto parsedUrlResult = core::Url::parse(url, allocator);
+		auto parsedUrlResult = core::UrlView::parse(url);
 		if (parsedUrlResult.isError())
 		{
-			return parsedUrlResult.releaseError();
+			return core::errf(allocator, "{}"_sv, core::UrlView::errorMessage(parsedUrlResult.error()));
 		}
-		auto parsedUrl = parsedUrlResult.releaseValue();
+		auto parsedUrl = parsedUrlResult.value();
 
 		auto server = core::websocket::Server::create(log, allocator);
 
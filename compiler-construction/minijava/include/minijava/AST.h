@@ -2,6 +2,7 @@
 
 #include "minijava/Token.h"
 
+#include <core/SmallArray.h>
 #include <core/Unique.h>
 
 namespace minijava
@@ -405,12 +406,17 @@ namespace minijava
 
 	class CallExpr: public Expr
 	{
+	public:
+		// most calls have a few arguments, so they're stored inline in the call node
+		using Arguments = core::SmallArray<core::Unique<Expr>, 4>;
+
+	private:
 		core::Unique<Expr> m_base;
 		Identifier m_name;
-		core::Array<core::Unique<Expr>> m_arguments;
+		Arguments m_arguments;
 
 	public:
-		CallExpr(core::Unique<Expr> base, Identifier name, core::Array<core::Unique<Expr>> arguments)
+		CallExpr(core::Unique<Expr> base, Identifier name, Arguments arguments)
 			: m_base(std::move(base)),
 			  m_name(name),
 			  m_arguments(std::move(arguments))
@@ -424,7 +430,7 @@ namespace minijava
 		{
 			return &m_name;
 		}
-		const core::Array<core::Unique<Expr>>& arguments() const
+		const Arguments& arguments() const
 		{
 			return m_arguments;
 		}
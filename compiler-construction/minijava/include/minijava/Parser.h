@@ -17,7 +17,7 @@ namespace minijava
 		Token eat();
 		Token eatKind(Token::KIND kind);
 		Token eatMust(Token::KIND kind);
-		core::Array<core::Unique<Expr>> parseArgs();
+		CallExpr::Arguments parseArgs();
 		core::Unique<Expr> parseAtomExpr();
 		core::Unique<Expr> parseBaseExpr();
 		core::Unique<Expr> parseUnaryExpr();
@@ -2,6 +2,7 @@
 
 #include "minijava/Token.h"
 
+#include <core/Interner.h>
 #include <core/Rune.h>
 
 namespace minijava
@@ -16,6 +17,7 @@ namespace minijava
 		core::Rune m_rune = core::Rune{0};
 		Position m_position{1, 0};
 		size_t m_lineBegin = 0;
+		core::Symbol m_firstKeyword;
 
 		bool isSpace(core::Rune r) const;
 		bool eof() const;
@@ -25,7 +27,7 @@ namespace minijava
 		core::StringView scanNumber();
 		core::StringView scanSingleLineComment();
 		core::StringView scanMultiLineComment();
-		Token::KIND inferKeywordType(core::StringView id);
+		Token::KIND inferKeywordType(core::Symbol id);
 
 	public:
 		explicit Scanner(Unit* unit, core::Allocator* allocator);
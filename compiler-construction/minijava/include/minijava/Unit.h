@@ -4,6 +4,7 @@
 #include "minijava/Token.h"
 
 #include <core/Array.h>
+#include <core/Interner.h>
 #include <core/Result.h>
 #include <core/Stream.h>
 #include <core/String.h>
@@ -49,6 +50,11 @@ namespace minijava
 		{
 			return m_token;
 		}
+		// the identifiers and keywords of the unit, their tokens carry the symbols
+		core::Interner& interner()
+		{
+			return m_interner;
+		}
 
 	private:
 		template <typename T, typename... TArgs>
@@ -62,6 +68,7 @@ namespace minijava
 		core::Array<Token> m_token;
 		core::Array<Error> m_errors;
 		core::Array<core::StringView> m_lines;
+		core::Interner m_interner;
 
 		Unit(core::String filePath, core::String absolutePath, core::String content, core::Allocator* allocator)
 			: m_allocator(allocator),
@@ -70,7 +77,8 @@ namespace minijava
 			  m_content(std::move(content)),
 			  m_token(allocator),
 			  m_errors(allocator),
-			  m_lines(allocator)
+			  m_lines(allocator),
+			  m_interner(allocator)
 		{}
 	};
 }
\ No newline at end of file
@@ -55,9 +55,9 @@ namespace minijava
 		return Token{Token::KIND_NONE, ""_sv, Location{}};
 	}
 
-	core::Array<core::Unique<Expr>> Parser::parseArgs()
+	CallExpr::Arguments Parser::parseArgs()
 	{
-		core::Array<core::Unique<Expr>> arguments{m_allocator};
+		CallExpr::Arguments arguments{m_allocator};
 		if (eatKind(Token::KIND_OPEN_PAREN).kind() == Token::KIND_OPEN_PAREN)
 		{
 			if (eatKind(Token::KIND_CLOSE_PAREN).kind() != Token::KIND_CLOSE_PAREN)
@@ -1,6 +1,8 @@
 #include "minijava/Scanner.h"
 #include "minijava/Unit.h"
 
+#include <iterator>
+
 namespace minijava
 {
 	bool Scanner::isSpace(core::Rune r) const
@@ -122,80 +124,35 @@ namespace minijava
 		return m_unit->content().slice(beginIt, m_it);
 	}
 
-	Token::KIND Scanner::inferKeywordType(core::StringView id)
+	// in the same order as the keywords in Token::KIND
+	static const core::StringView KEYWORDS[] = {
+		"boolean"_sv,
+		"class"_sv,
+		"else"_sv,
+		"false"_sv,
+		"if"_sv,
+		"int"_sv,
+		"String"_sv,
+		"length"_sv,
+		"main"_sv,
+		"new"_sv,
+		"public"_sv,
+		"return"_sv,
+		"static"_sv,
+		"this"_sv,
+		"true"_sv,
+		"void"_sv,
+		"while"_sv,
+	};
+
+	Token::KIND Scanner::inferKeywordType(core::Symbol id)
 	{
-		if (id == "boolean"_sv)
-		{
-			return Token::KIND_KEYWORD_BOOLEAN;
-		}
-		else if (id == "class"_sv)
-		{
-			return Token::KIND_KEYWORD_CLASS;
-		}
-		else if (id == "else"_sv)
-		{
-			return Token::KIND_KEYWORD_ELSE;
-		}
-		else if (id == "false"_sv)
-		{
-			return Token::KIND_KEYWORD_FALSE;
-		}
-		else if (id == "if"_sv)
-		{
-			return Token::KIND_KEYWORD_IF;
-		}
-		else if (id == "int"_sv)
-		{
-			return Token::KIND_KEYWORD_INT;
-		}
-		else if (id == "String"_sv)
-		{
-			return Token::KIND_KEYWORD_STRING;
-		}
-		else if (id == "length"_sv)
-		{
-			return Token::KIND_KEYWORD_LENGTH;
-		}
-		else if (id == "main"_sv)
-		{
-			return Token::KIND_KEYWORD_MAIN;
-		}
-		else if (id == "new"_sv)
-		{
-			return Token::KIND_KEYWORD_NEW;
-		}
-		else if (id == "public"_sv)
-		{
-			return Token::KIND_KEYWORD_PUBLIC;
-		}
-		else if (id == "return"_sv)
-		{
-			return Token::KIND_KEYWORD_RETURN;
-		}
-		else if (id == "static"_sv)
-		{
-			return Token::KIND_KEYWORD_STATIC;
-		}
-		else if (id == "this"_sv)
-		{
-			return Token::KIND_KEYWORD_THIS;
-		}
-		else if (id == "true"_sv)
-		{
-			return Token::KIND_KEYWORD_TRUE;
-		}
-		else if (id == "void"_sv)
-		{
-			return Token::KIND_KEYWORD_VOID;
-		}
-		else if (id == "while"_sv)
-		{
-			return Token::KIND_KEYWORD_WHILE;
-		}
-		else
+		auto index = id.id() - m_firstKeyword.id();
+		if (id.id() < m_firstKeyword.id() || index >= std::size(KEYWORDS))
 		{
 			return Token::KIND_NONE;
 		}
+		return Token::KIND(Token::KIND_KEYWORD_BOOLEAN + index);
 	}
 
 	Scanner::Scanner(Unit* unit, core::Allocator* allocator)
@@ -206,6 +163,16 @@ namespace minijava
 		{
 			m_rune = core::Rune::decode(m_unit->content().data() + m_it);
 		}
+
+		// the keywords are interned together so their symbols are consecutive and an identifier is checked against
+		// all of them with a single range check
+		auto& interner = m_unit->interner();
+		m_firstKeyword = interner.intern(KEYWORDS[0]);
+		for (size_t i = 1; i < std::size(KEYWORDS); ++i)
+		{
+			auto keyword = interner.intern(KEYWORDS[i]);
+			core::assertMsg(keyword.id() == m_firstKeyword.id() + i, "keywords must be interned first");
+		}
 	}
 
 	Token Scanner::scan()
@@ -223,7 +190,9 @@ namespace minijava
 		if (m_rune.isLetter() || m_rune == '_')
 		{
 			auto id = scanID();
-			auto kind = inferKeywordType(id);
+			// the keywords are already interned so a lookup is enough, interning would copy every identifier into the
+			// interner for good, an identifier which was never interned gets the invalid symbol which isn't a keyword
+			auto kind = inferKeywordType(m_unit->interner().lookup(id));
 			if (kind == Token::KIND_NONE)
 			{
 				kind = Token::KIND_ID;
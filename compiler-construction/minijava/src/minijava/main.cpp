@@ -1,7 +1,7 @@
 #include <core/Array.h>
 #include <core/FastLeak.h>
 #include <core/File.h>
-#include <core/Hash.h>
+#include <core/FlatMap.h>
 #include <core/Log.h>
 #include <core/MemoryStream.h>
 #include <core/Result.h>
@@ -30,12 +30,12 @@ class Args
 {
 	core::StringView m_command;
 	core::Array<core::StringView> m_files;
-	core::Map<core::StringView, core::StringView> m_options;
+	core::FlatMap<core::StringView, core::StringView> m_options;
 
 	Args(
 		core::StringView command,
 		core::Array<core::StringView> files,
-		core::Map<core::StringView, core::StringView> options)
+		core::FlatMap<core::StringView, core::StringView> options)
 		: m_command(command),
 		  m_files(std::move(files)),
 		  m_options(std::move(options))
@@ -51,7 +51,7 @@ public:
 
 		auto command = core::StringView{argv[1]};
 		core::Array<core::StringView> files{allocator};
-		core::Map<core::StringView, core::StringView> options{allocator};
+		core::FlatMap<core::StringView, core::StringView> options{allocator};
 
 		if (command == "scan"_sv)
 		{
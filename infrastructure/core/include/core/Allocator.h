@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/Exports.h"
 #include "core/Span.h"
 
 #include <cstddef>
@@ -65,4 +66,20 @@ namespace core
 			freeT(Span<T>{s, 1});
 		}
 	};
+
+	// returns the allocator of the innermost AllocatorScope on the calling thread, or the process wide default allocator
+	// if there's none, it lets code allocate without threading an Allocator* through every call
+	CORE_EXPORT Allocator* currentAllocator();
+
+	// sets the calling thread's current allocator until the scope ends, scopes nest
+	class AllocatorScope
+	{
+		Allocator* m_previous = nullptr;
+
+	public:
+		CORE_EXPORT explicit AllocatorScope(Allocator* allocator);
+		AllocatorScope(const AllocatorScope&) = delete;
+		AllocatorScope& operator=(const AllocatorScope&) = delete;
+		CORE_EXPORT ~AllocatorScope();
+	};
 }
@@ -142,6 +142,16 @@ namespace core
 			return m_memory[i];
 		}
 
+		operator Span<T>()
+		{
+			return m_memory.sliceLeft(m_count);
+		}
+
+		operator Span<const T>() const
+		{
+			return Span<const T>{m_memory.data(), m_count};
+		}
+
 		Allocator* allocator() const
 		{
 			return m_allocator;
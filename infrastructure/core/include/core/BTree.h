@@ -0,0 +1,941 @@
+#pragma once
+
+#include "core/Allocator.h"
+#include "core/Array.h"
+#include "core/Assert.h"
+#include "core/Hash.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core
+{
+	// an ordered container stored in a B+ tree, the entries live in the leaves which are linked in order so iteration
+	// and range scans walk arrays of consecutive entries, the inner nodes only hold the separator keys, the entries are
+	// ordered by their key using operator<, use BTreeMap and BTreeSet instead of using it directly
+	template <typename TKey, typename TEntry>
+	class BTree
+	{
+		// the size of a node in bytes, a few cache lines so that a binary search in a node touches a handful of lines
+		// and the tree stays shallow
+		static constexpr size_t NODE_SIZE = 512;
+		static constexpr size_t LEAF_CAPACITY = NODE_SIZE / sizeof(TEntry) < 4 ? 4 : NODE_SIZE / sizeof(TEntry);
+		static constexpr size_t INNER_CAPACITY =
+			NODE_SIZE / (sizeof(TKey) + sizeof(void*)) < 4 ? 4 : NODE_SIZE / (sizeof(TKey) + sizeof(void*));
+		// nodes which fall below half of their capacity borrow from or merge with a sibling
+		static constexpr size_t LEAF_MIN = LEAF_CAPACITY / 2;
+		static constexpr size_t INNER_MIN = INNER_CAPACITY / 2;
+		// a tree of this depth holds more entries than fit in memory since every inner node has at least 3 children
+		static constexpr size_t MAX_DEPTH = 48;
+
+		struct Node
+		{
+			// entries count for leaves, keys count for inner nodes
+			size_t count = 0;
+			bool isLeaf = false;
+		};
+
+		// both nodes have room for one more element than their capacity, inserting into a full node overflows it for a
+		// moment before it's split in two
+		struct Leaf: Node
+		{
+			Leaf* prev = nullptr;
+			Leaf* next = nullptr;
+			alignas(TEntry) std::byte storage[(LEAF_CAPACITY + 1) * sizeof(TEntry)];
+
+			TEntry* entries()
+			{
+				return std::launder(reinterpret_cast<TEntry*>(storage));
+			}
+		};
+
+		struct Inner: Node
+		{
+			// the keys of children[i] are less than keys[i] and the keys of children[i + 1] are greater or equal to it
+			Node* children[INNER_CAPACITY + 2];
+			alignas(TKey) std::byte storage[(INNER_CAPACITY + 1) * sizeof(TKey)];
+
+			TKey* keys()
+			{
+				return std::launder(reinterpret_cast<TKey*>(storage));
+			}
+		};
+
+		struct PathEntry
+		{
+			Inner* node;
+			// the index of the child we went down into
+			size_t index;
+		};
+
+		Allocator* m_allocator = nullptr;
+		Node* m_root = nullptr;
+		Leaf* m_first = nullptr;
+		Leaf* m_last = nullptr;
+		size_t m_count = 0;
+
+		static const TKey& keyOf(const TEntry& entry)
+		{
+			if constexpr (std::is_same_v<TKey, TEntry>)
+			{
+				return entry;
+			}
+			else
+			{
+				return entry.key;
+			}
+		}
+
+		template <typename T>
+		static void moveTo(T* dst, T* src)
+		{
+			::new (dst) T(std::move(*src));
+			src->~T();
+		}
+
+		// moves the elements in [index, count) one step to the right
+		template <typename T>
+		static void shiftRight(T* values, size_t index, size_t count)
+		{
+			for (size_t i = count; i > index; --i)
+			{
+				moveTo(&values[i], &values[i - 1]);
+			}
+		}
+
+		// moves the elements in (index, count) one step to the left, the element at index must be already destroyed
+		template <typename T>
+		static void shiftLeft(T* values, size_t index, size_t count)
+		{
+			for (size_t i = index + 1; i < count; ++i)
+			{
+				moveTo(&values[i - 1], &values[i]);
+			}
+		}
+
+		// the index of the first value which the predicate returns false for, the values must be partitioned by the
+		// predicate, the search has no branches on the comparison result so random keys don't mispredict at every step
+		template <typename T, typename F>
+		static size_t partitionPoint(const T* values, size_t count, F&& predicate)
+		{
+			if (count == 0)
+			{
+				return 0;
+			}
+
+			auto base = values;
+			while (count > 1)
+			{
+				auto half = count / 2;
+				base = predicate(base[half]) ? base + half : base;
+				count -= half;
+			}
+			return size_t(base - values) + (predicate(*base) ? 1 : 0);
+		}
+
+		// the index of the first entry which isn't less than the key
+		template <typename R>
+		static size_t lowerBoundIndex(Leaf* leaf, const R& key)
+		{
+			return partitionPoint(
+				leaf->entries(), leaf->count, [&](const TEntry& entry) { return keyOf(entry) < key; });
+		}
+
+		// the index of the first entry which is greater than the key
+		template <typename R>
+		static size_t upperBoundIndex(Leaf* leaf, const R& key)
+		{
+			return partitionPoint(
+				leaf->entries(), leaf->count, [&](const TEntry& entry) { return (key < keyOf(entry)) == false; });
+		}
+
+		// the child of the inner node which may contain the key
+		template <typename R>
+		static size_t childIndex(Inner* inner, const R& key)
+		{
+			return partitionPoint(
+				inner->keys(), inner->count, [&](const TKey& separator) { return (key < separator) == false; });
+		}
+
+		// goes down to the leaf which may contain the key, it fills the path if it's not null
+		template <typename R>
+		Leaf* findLeaf(const R& key, PathEntry* path, size_t& depth) const
+		{
+			depth = 0;
+			auto node = m_root;
+			while (node->isLeaf == false)
+			{
+				auto inner = static_cast<Inner*>(node);
+				auto index = childIndex(inner, key);
+				if (path)
+				{
+					assertTrue(depth < MAX_DEPTH);
+					path[depth] = PathEntry{inner, index};
+				}
+				++depth;
+				node = inner->children[index];
+			}
+			return static_cast<Leaf*>(node);
+		}
+
+		Leaf* newLeaf()
+		{
+			auto leaf = m_allocator->allocSingleT<Leaf>();
+			m_allocator->commitSingleT(leaf);
+			::new (leaf) Leaf();
+			leaf->isLeaf = true;
+			return leaf;
+		}
+
+		Inner* newInner()
+		{
+			auto inner = m_allocator->allocSingleT<Inner>();
+			m_allocator->commitSingleT(inner);
+			::new (inner) Inner();
+			return inner;
+		}
+
+		void freeLeaf(Leaf* leaf)
+		{
+			leaf->~Leaf();
+			m_allocator->releaseSingleT(leaf);
+			m_allocator->freeSingleT(leaf);
+		}
+
+		void freeInner(Inner* inner)
+		{
+			inner->~Inner();
+			m_allocator->releaseSingleT(inner);
+			m_allocator->freeSingleT(inner);
+		}
+
+		void freeNode(Node* node)
+		{
+			if (node->isLeaf)
+			{
+				auto leaf = static_cast<Leaf*>(node);
+				for (size_t i = 0; i < leaf->count; ++i)
+				{
+					leaf->entries()[i].~TEntry();
+				}
+				freeLeaf(leaf);
+			}
+			else
+			{
+				auto inner = static_cast<Inner*>(node);
+				for (size_t i = 0; i < inner->count; ++i)
+				{
+					inner->keys()[i].~TKey();
+				}
+				for (size_t i = 0; i <= inner->count; ++i)
+				{
+					freeNode(inner->children[i]);
+				}
+				freeInner(inner);
+			}
+		}
+
+		static const TKey& minKey(Node* node)
+		{
+			while (node->isLeaf == false)
+			{
+				node = static_cast<Inner*>(node)->children[0];
+			}
+			return keyOf(static_cast<Leaf*>(node)->entries()[0]);
+		}
+
+		// adds the separator and the right node next to the left node which was just split, splitting the parents
+		// which overflow up to the root
+		void insertIntoParent(PathEntry* path, size_t depth, Node* left, TKey separator, Node* right)
+		{
+			while (true)
+			{
+				if (depth == 0)
+				{
+					auto root = newInner();
+					root->children[0] = left;
+					root->children[1] = right;
+					::new (&root->keys()[0]) TKey(std::move(separator));
+					root->count = 1;
+					m_root = root;
+					return;
+				}
+
+				auto [parent, index] = path[--depth];
+				auto keys = parent->keys();
+				shiftRight(keys, index, parent->count);
+				::new (&keys[index]) TKey(std::move(separator));
+				for (size_t i = parent->count + 1; i > index + 1; --i)
+				{
+					parent->children[i] = parent->children[i - 1];
+				}
+				parent->children[index + 1] = right;
+				++parent->count;
+				if (parent->count <= INNER_CAPACITY)
+				{
+					return;
+				}
+
+				// the middle key moves up to the grandparent and the keys after it move to the new node
+				auto sibling = newInner();
+				auto mid = parent->count / 2;
+				separator = std::move(keys[mid]);
+				keys[mid].~TKey();
+				for (size_t i = mid + 1; i < parent->count; ++i)
+				{
+					moveTo(&sibling->keys()[i - mid - 1], &keys[i]);
+				}
+				for (size_t i = mid + 1; i <= parent->count; ++i)
+				{
+					sibling->children[i - mid - 1] = parent->children[i];
+				}
+				sibling->count = parent->count - mid - 1;
+				parent->count = mid;
+
+				left = parent;
+				right = sibling;
+			}
+		}
+
+		// removes the key at index and the child after it from the inner node
+		void removeFromInner(Inner* inner, size_t index)
+		{
+			inner->keys()[index].~TKey();
+			shiftLeft(inner->keys(), index, inner->count);
+			for (size_t i = index + 1; i < inner->count; ++i)
+			{
+				inner->children[i] = inner->children[i + 1];
+			}
+			--inner->count;
+		}
+
+		void rebalanceLeaf(PathEntry* path, size_t depth, Leaf* leaf)
+		{
+			auto [parent, index] = path[depth - 1];
+			auto entries = leaf->entries();
+
+			if (index > 0)
+			{
+				auto left = static_cast<Leaf*>(parent->children[index - 1]);
+				if (left->count > LEAF_MIN)
+				{
+					shiftRight(entries, 0, leaf->count);
+					moveTo(&entries[0], &left->entries()[left->count - 1]);
+					--left->count;
+					++leaf->count;
+					parent->keys()[index - 1] = keyOf(entries[0]);
+					return;
+				}
+			}
+
+			if (index < parent->count)
+			{
+				auto right = static_cast<Leaf*>(parent->children[index + 1]);
+				if (right->count > LEAF_MIN)
+				{
+					moveTo(&entries[leaf->count], &right->entries()[0]);
+					shiftLeft(right->entries(), 0, right->count);
+					--right->count;
+					++leaf->count;
+					parent->keys()[index] = keyOf(right->entries()[0]);
+					return;
+				}
+			}
+
+			// merge the right one of the two leaves into the left one
+			if (index == 0)
+			{
+				++index;
+			}
+			auto left = static_cast<Leaf*>(parent->children[index - 1]);
+			auto right = static_cast<Leaf*>(parent->children[index]);
+			for (size_t i = 0; i < right->count; ++i)
+			{
+				moveTo(&left->entries()[left->count + i], &right->entries()[i]);
+			}
+			left->count += right->count;
+			left->next = right->next;
+			if (right->next)
+			{
+				right->next->prev = left;
+			}
+			else
+			{
+				m_last = left;
+			}
+			freeLeaf(right);
+			removeFromInner(parent, index - 1);
+			rebalanceInner(path, depth - 1);
+		}
+
+		void rebalanceInner(PathEntry* path, size_t depth)
+		{
+			auto node = path[depth].node;
+			if (depth == 0)
+			{
+				// the root only shrinks when it has a single child left
+				if (node->count == 0)
+				{
+					m_root = node->children[0];
+					freeInner(node);
+				}
+				return;
+			}
+
+			if (node->count >= INNER_MIN)
+			{
+				return;
+			}
+
+			auto [parent, index] = path[depth - 1];
+			auto keys = node->keys();
+
+			if (index > 0)
+			{
+				auto left = static_cast<Inner*>(parent->children[index - 1]);
+				if (left->count > INNER_MIN)
+				{
+					// rotate the last child of the left sibling through the parent
+					shiftRight(keys, 0, node->count);
+					moveTo(&keys[0], &parent->keys()[index - 1]);
+					for (size_t i = node->count + 1; i > 0; --i)
+					{
+						node->children[i] = node->children[i - 1];
+					}
+					node->children[0] = left->children[left->count];
+					moveTo(&parent->keys()[index - 1], &left->keys()[left->count - 1]);
+					--left->count;
+					++node->count;
+					return;
+				}
+			}
+
+			if (index < parent->count)
+			{
+				auto right = static_cast<Inner*>(parent->children[index + 1]);
+				if (right->count > INNER_MIN)
+				{
+					// rotate the first child of the right sibling through the parent
+					moveTo(&keys[node->count], &parent->keys()[index]);
+					node->children[node->count + 1] = right->children[0];
+					moveTo(&parent->keys()[index], &right->keys()[0]);
+					shiftLeft(right->keys(), 0, right->count);
+					for (size_t i = 0; i < right->count; ++i)
+					{
+						right->children[i] = right->children[i + 1];
+					}
+					--right->count;
+					++node->count;
+					return;
+				}
+			}
+
+			// merge the right one of the two nodes into the left one with the parent key between them
+			if (index == 0)
+			{
+				++index;
+			}
+			auto left = static_cast<Inner*>(parent->children[index - 1]);
+			auto right = static_cast<Inner*>(parent->children[index]);
+			::new (&left->keys()[left->count]) TKey(parent->keys()[index - 1]);
+			for (size_t i = 0; i < right->count; ++i)
+			{
+				moveTo(&left->keys()[left->count + 1 + i], &right->keys()[i]);
+			}
+			for (size_t i = 0; i <= right->count; ++i)
+			{
+				left->children[left->count + 1 + i] = right->children[i];
+			}
+			left->count += right->count + 1;
+			freeInner(right);
+			removeFromInner(parent, index - 1);
+			rebalanceInner(path, depth - 1);
+		}
+
+		// builds the tree from count entries in strictly increasing order, next() returns the next entry, the entries
+		// are spread evenly over the nodes of each level so every node is at least half full
+		template <typename F>
+		void buildSorted(size_t count, F&& next)
+		{
+			if (count == 0)
+			{
+				return;
+			}
+
+			Array<Node*> level{m_allocator};
+			auto leavesCount = (count + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+			level.reserve(leavesCount);
+			for (size_t i = 0; i < leavesCount; ++i)
+			{
+				auto leaf = newLeaf();
+				auto leafCount = count / leavesCount + (i < count % leavesCount ? 1 : 0);
+				for (size_t j = 0; j < leafCount; ++j)
+				{
+					::new (&leaf->entries()[j]) TEntry(next());
+					++leaf->count;
+					assertTrue(j == 0 || keyOf(leaf->entries()[j - 1]) < keyOf(leaf->entries()[j]));
+				}
+
+				if (m_last)
+				{
+					assertTrue(keyOf(m_last->entries()[m_last->count - 1]) < keyOf(leaf->entries()[0]));
+					m_last->next = leaf;
+					leaf->prev = m_last;
+				}
+				else
+				{
+					m_first = leaf;
+				}
+				m_last = leaf;
+				level.push(leaf);
+			}
+			m_count = count;
+
+			while (level.count() > 1)
+			{
+				Array<Node*> parents{m_allocator};
+				auto childrenCount = level.count();
+				auto parentsCount = (childrenCount + INNER_CAPACITY) / (INNER_CAPACITY + 1);
+				parents.reserve(parentsCount);
+				size_t child = 0;
+				for (size_t i = 0; i < parentsCount; ++i)
+				{
+					auto inner = newInner();
+					auto innerCount = childrenCount / parentsCount + (i < childrenCount % parentsCount ? 1 : 0);
+					for (size_t j = 0; j < innerCount; ++j, ++child)
+					{
+						inner->children[j] = level[child];
+						if (j > 0)
+						{
+							::new (&inner->keys()[j - 1]) TKey(minKey(level[child]));
+						}
+					}
+					inner->count = innerCount - 1;
+					parents.push(inner);
+				}
+				level = std::move(parents);
+			}
+			m_root = level[0];
+		}
+
+		void destroy()
+		{
+			if (m_root)
+			{
+				freeNode(m_root);
+			}
+			m_root = nullptr;
+			m_first = nullptr;
+			m_last = nullptr;
+			m_count = 0;
+		}
+
+		void copyFrom(const BTree& other)
+		{
+			m_allocator = other.m_allocator;
+			auto leaf = other.m_first;
+			size_t index = 0;
+			buildSorted(other.m_count, [&]() -> const TEntry& {
+				if (index == leaf->count)
+				{
+					leaf = leaf->next;
+					index = 0;
+				}
+				return leaf->entries()[index++];
+			});
+		}
+
+		void moveFrom(BTree& other)
+		{
+			m_allocator = other.m_allocator;
+			m_root = other.m_root;
+			m_first = other.m_first;
+			m_last = other.m_last;
+			m_count = other.m_count;
+
+			other.m_root = nullptr;
+			other.m_first = nullptr;
+			other.m_last = nullptr;
+			other.m_count = 0;
+		}
+
+		template <typename T>
+		class IteratorBase
+		{
+			friend class BTree;
+
+			Leaf* m_leaf = nullptr;
+			size_t m_index = 0;
+
+			// moves past the end of the current leaf into the next one
+			IteratorBase(Leaf* leaf, size_t index)
+				: m_leaf(leaf),
+				  m_index(index)
+			{
+				if (m_leaf && m_index == m_leaf->count)
+				{
+					m_leaf = m_leaf->next;
+					m_index = 0;
+				}
+			}
+
+		public:
+			IteratorBase() = default;
+
+			operator IteratorBase<const T>() const
+			{
+				return IteratorBase<const T>{m_leaf, m_index};
+			}
+
+			T& operator*() const
+			{
+				return m_leaf->entries()[m_index];
+			}
+
+			T* operator->() const
+			{
+				return &m_leaf->entries()[m_index];
+			}
+
+			IteratorBase& operator++()
+			{
+				++m_index;
+				if (m_index == m_leaf->count)
+				{
+					m_leaf = m_leaf->next;
+					m_index = 0;
+				}
+				return *this;
+			}
+
+			bool operator==(const IteratorBase& other) const
+			{
+				return m_leaf == other.m_leaf && m_index == other.m_index;
+			}
+
+			bool operator!=(const IteratorBase& other) const
+			{
+				return !operator==(other);
+			}
+		};
+
+	protected:
+		// constructs the entry from the arguments if the key doesn't exist, returns true if it was inserted
+		template <typename R, typename... TArgs>
+		bool emplace(const R& key, TArgs&&... args)
+		{
+			if (m_root == nullptr)
+			{
+				auto leaf = newLeaf();
+				m_root = leaf;
+				m_first = leaf;
+				m_last = leaf;
+			}
+
+			PathEntry path[MAX_DEPTH];
+			size_t depth = 0;
+			auto leaf = findLeaf(key, path, depth);
+			auto entries = leaf->entries();
+			auto index = lowerBoundIndex(leaf, key);
+			if (index < leaf->count && (key < keyOf(entries[index])) == false)
+			{
+				return false;
+			}
+
+			shiftRight(entries, index, leaf->count);
+			::new (&entries[index]) TEntry{std::forward<TArgs>(args)...};
+			++leaf->count;
+			++m_count;
+			if (leaf->count <= LEAF_CAPACITY)
+			{
+				return true;
+			}
+
+			// split the overflowing leaf in half
+			auto sibling = newLeaf();
+			auto mid = leaf->count / 2;
+			for (size_t i = mid; i < leaf->count; ++i)
+			{
+				moveTo(&sibling->entries()[i - mid], &entries[i]);
+			}
+			sibling->count = leaf->count - mid;
+			leaf->count = mid;
+
+			sibling->prev = leaf;
+			sibling->next = leaf->next;
+			if (leaf->next)
+			{
+				leaf->next->prev = sibling;
+			}
+			else
+			{
+				m_last = sibling;
+			}
+			leaf->next = sibling;
+
+			insertIntoParent(path, depth, leaf, keyOf(sibling->entries()[0]), sibling);
+			return true;
+		}
+
+	public:
+		using Iterator = IteratorBase<TEntry>;
+		using ConstIterator = IteratorBase<const TEntry>;
+
+		explicit BTree(Allocator* allocator)
+			: m_allocator(allocator)
+		{}
+
+		BTree(const BTree& other)
+		{
+			copyFrom(other);
+		}
+
+		BTree(BTree&& other) noexcept
+		{
+			moveFrom(other);
+		}
+
+		BTree& operator=(const BTree& other)
+		{
+			if (this == &other)
+			{
+				return *this;
+			}
+
+			destroy();
+			copyFrom(other);
+			return *this;
+		}
+
+		BTree& operator=(BTree&& other) noexcept
+		{
+			if (this == &other)
+			{
+				return *this;
+			}
+
+			destroy();
+			moveFrom(other);
+			return *this;
+		}
+
+		~BTree()
+		{
+			destroy();
+		}
+
+		Allocator* allocator() const
+		{
+			return m_allocator;
+		}
+
+		size_t count() const
+		{
+			return m_count;
+		}
+
+		bool empty() const
+		{
+			return m_count == 0;
+		}
+
+		void clear()
+		{
+			destroy();
+		}
+
+		// replaces the content of the tree with the given entries which must be sorted by key with no duplicates, it's
+		// faster than inserting them one by one and it packs the nodes
+		void assignSorted(Span<const TEntry> entries)
+		{
+			destroy();
+			size_t index = 0;
+			buildSorted(entries.count(), [&]() -> const TEntry& { return entries[index++]; });
+		}
+
+		template <typename R>
+		bool remove(const R& key)
+		{
+			if (m_root == nullptr)
+			{
+				return false;
+			}
+
+			PathEntry path[MAX_DEPTH];
+			size_t depth = 0;
+			auto leaf = findLeaf(key, path, depth);
+			auto entries = leaf->entries();
+			auto index = lowerBoundIndex(leaf, key);
+			if (index == leaf->count || key < keyOf(entries[index]))
+			{
+				return false;
+			}
+
+			entries[index].~TEntry();
+			shiftLeft(entries, index, leaf->count);
+			--leaf->count;
+			--m_count;
+
+			if (depth == 0)
+			{
+				if (leaf->count == 0)
+				{
+					freeLeaf(leaf);
+					m_root = nullptr;
+					m_first = nullptr;
+					m_last = nullptr;
+				}
+			}
+			else if (leaf->count < LEAF_MIN)
+			{
+				rebalanceLeaf(path, depth, leaf);
+			}
+			return true;
+		}
+
+		template <typename R>
+		ConstIterator lookup(const R& key) const
+		{
+			auto it = lowerBound(key);
+			if (it == end() || key < keyOf(*it))
+			{
+				return end();
+			}
+			return it;
+		}
+
+		template <typename R>
+		Iterator lookup(const R& key)
+		{
+			auto it = lowerBound(key);
+			if (it == end() || key < keyOf(*it))
+			{
+				return end();
+			}
+			return it;
+		}
+
+		// the first entry whose key isn't less than the given key
+		template <typename R>
+		Iterator lowerBound(const R& key)
+		{
+			if (m_root == nullptr)
+			{
+				return end();
+			}
+			size_t depth = 0;
+			auto leaf = findLeaf(key, nullptr, depth);
+			return Iterator{leaf, lowerBoundIndex(leaf, key)};
+		}
+
+		template <typename R>
+		ConstIterator lowerBound(const R& key) const
+		{
+			return const_cast<BTree*>(this)->lowerBound(key);
+		}
+
+		// the first entry whose key is greater than the given key
+		template <typename R>
+		Iterator upperBound(const R& key)
+		{
+			if (m_root == nullptr)
+			{
+				return end();
+			}
+			size_t depth = 0;
+			auto leaf = findLeaf(key, nullptr, depth);
+			return Iterator{leaf, upperBoundIndex(leaf, key)};
+		}
+
+		template <typename R>
+		ConstIterator upperBound(const R& key) const
+		{
+			return const_cast<BTree*>(this)->upperBound(key);
+		}
+
+		Iterator begin()
+		{
+			return Iterator{m_first, 0};
+		}
+
+		ConstIterator begin() const
+		{
+			return ConstIterator{m_first, 0};
+		}
+
+		Iterator end()
+		{
+			return Iterator{};
+		}
+
+		ConstIterator end() const
+		{
+			return ConstIterator{};
+		}
+	};
+
+	// an ordered map, see BTree, the iterators give access to the KeyValue entries where the key must not be changed
+	template <typename TKey, typename TValue>
+	class BTreeMap: public BTree<TKey, KeyValue<TKey, TValue>>
+	{
+	public:
+		using BTree<TKey, KeyValue<TKey, TValue>>::BTree;
+
+		// inserts the key if it doesn't exist, returns true if it was inserted
+		template <typename R, typename U>
+		bool insert(R&& key, U&& value)
+		{
+			return this->emplace(key, std::forward<R>(key), std::forward<U>(value));
+		}
+	};
+
+	// an ordered set, see BTree
+	template <typename TKey>
+	class BTreeSet: public BTree<TKey, TKey>
+	{
+	public:
+		using Iterator = typename BTree<TKey, TKey>::ConstIterator;
+		using ConstIterator = typename BTree<TKey, TKey>::ConstIterator;
+
+		using BTree<TKey, TKey>::BTree;
+
+		// inserts the key if it doesn't exist, returns true if it was inserted
+		template <typename R>
+		bool insert(R&& key)
+		{
+			return this->emplace(key, std::forward<R>(key));
+		}
+
+		// the keys are the entries so all the lookups hand out const iterators, changing a key in place would break the
+		// order of the tree
+		template <typename R>
+		ConstIterator lookup(const R& key) const
+		{
+			return BTree<TKey, TKey>::lookup(key);
+		}
+
+		template <typename R>
+		ConstIterator lowerBound(const R& key) const
+		{
+			return BTree<TKey, TKey>::lowerBound(key);
+		}
+
+		template <typename R>
+		ConstIterator upperBound(const R& key) const
+		{
+			return BTree<TKey, TKey>::upperBound(key);
+		}
+
+		ConstIterator begin() const
+		{
+			return BTree<TKey, TKey>::begin();
+		}
+
+		ConstIterator end() const
+		{
+			return BTree<TKey, TKey>::end();
+		}
+	};
+}
\ No newline at end of file
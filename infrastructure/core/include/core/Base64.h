@@ -7,10 +7,42 @@
 
 namespace core
 {
+	// base64 as in rfc 4648, encoding and decoding use avx2 when the running cpu has it (see cpuFeatures), the standard
+	// alphabet is padded with '=' and the url safe one isn't, decoding accepts both padded and unpadded input
 	class Base64
 	{
 	public:
-		CORE_EXPORT static String encode(Span<std::byte> bytes, Allocator* allocator);
-		CORE_EXPORT static Buffer decode(StringView str, Allocator* allocator);
+		enum ALPHABET
+		{
+			// A-Z a-z 0-9 + / with padding
+			ALPHABET_STANDARD,
+			// A-Z a-z 0-9 - _ without padding
+			ALPHABET_URL,
+		};
+
+		// the exact count of characters in the encoding of count bytes
+		static constexpr size_t encodedCount(size_t count, ALPHABET alphabet = ALPHABET_STANDARD)
+		{
+			if (alphabet == ALPHABET_STANDARD)
+			{
+				return (count + 2) / 3 * 4;
+			}
+			return count / 3 * 4 + (count % 3 == 0 ? 0 : count % 3 + 1);
+		}
+
+		// the exact count of bytes the given string decodes to if it's valid
+		CORE_EXPORT static size_t decodedCount(StringView str);
+
+		// writes the encoding of bytes to out which must have room for encodedCount(bytes.count()) characters and
+		// returns the count of written characters
+		CORE_EXPORT static size_t encode(Span<const std::byte> bytes, Span<char> out, ALPHABET alphabet);
+		CORE_EXPORT static String
+		encode(Span<const std::byte> bytes, Allocator* allocator, ALPHABET alphabet = ALPHABET_STANDARD);
+
+		// writes the decoded bytes to out which must have room for decodedCount(str) bytes and returns the count of
+		// written bytes or SIZE_MAX if str isn't valid base64 in the given alphabet
+		CORE_EXPORT static size_t decode(StringView str, Span<std::byte> out, ALPHABET alphabet);
+		// returns an empty buffer if str isn't valid base64 in the given alphabet
+		CORE_EXPORT static Buffer decode(StringView str, Allocator* allocator, ALPHABET alphabet = ALPHABET_STANDARD);
 	};
 }
\ No newline at end of file
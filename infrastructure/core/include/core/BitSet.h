@@ -0,0 +1,798 @@
+#pragma once
+
+#include "core/Allocator.h"
+#include "core/Assert.h"
+#include "core/Intrinsics.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+namespace core
+{
+	// the word level operations which BitSet and FixedBitSet share, they work on arrays of 64 bit words and keep the
+	// bits past the end of the set zero so that counting and comparing don't need to mask the last word
+	namespace bits
+	{
+		constexpr size_t WORD_BITS = 64;
+		constexpr size_t NOT_FOUND = SIZE_MAX;
+
+		constexpr size_t wordsCount(size_t bitsCount)
+		{
+			return (bitsCount + WORD_BITS - 1) / WORD_BITS;
+		}
+
+		// the mask of the used bits in the last word
+		constexpr uint64_t lastWordMask(size_t bitsCount)
+		{
+			auto rem = bitsCount % WORD_BITS;
+			return rem == 0 ? ~uint64_t(0) : (uint64_t(1) << rem) - 1;
+		}
+
+		enum OP
+		{
+			OP_AND,
+			OP_OR,
+			OP_XOR,
+			// dst & ~src
+			OP_AND_NOT,
+		};
+
+		template <OP Op>
+		inline static uint64_t apply(uint64_t a, uint64_t b)
+		{
+			if constexpr (Op == OP_AND)
+			{
+				return a & b;
+			}
+			else if constexpr (Op == OP_OR)
+			{
+				return a | b;
+			}
+			else if constexpr (Op == OP_XOR)
+			{
+				return a ^ b;
+			}
+			else
+			{
+				return a & ~b;
+			}
+		}
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+		template <OP Op>
+		inline static __m128i apply(__m128i a, __m128i b)
+		{
+			if constexpr (Op == OP_AND)
+			{
+				return _mm_and_si128(a, b);
+			}
+			else if constexpr (Op == OP_OR)
+			{
+				return _mm_or_si128(a, b);
+			}
+			else if constexpr (Op == OP_XOR)
+			{
+				return _mm_xor_si128(a, b);
+			}
+			else
+			{
+				return _mm_andnot_si128(b, a);
+			}
+		}
+
+		template <OP Op>
+		TAHA_TARGET_AVX2 inline static __m256i applyAvx2(__m256i a, __m256i b)
+		{
+			if constexpr (Op == OP_AND)
+			{
+				return _mm256_and_si256(a, b);
+			}
+			else if constexpr (Op == OP_OR)
+			{
+				return _mm256_or_si256(a, b);
+			}
+			else if constexpr (Op == OP_XOR)
+			{
+				return _mm256_xor_si256(a, b);
+			}
+			else
+			{
+				return _mm256_andnot_si256(b, a);
+			}
+		}
+
+		template <OP Op>
+		TAHA_TARGET_AVX2 inline static void combineAvx2(uint64_t* dst, const uint64_t* src, size_t count)
+		{
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+				auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), applyAvx2<Op>(a, b));
+			}
+			for (; i < count; ++i)
+			{
+				dst[i] = apply<Op>(dst[i], src[i]);
+			}
+		}
+
+		// counts the bits of each nibble using a shuffle as a 16 entry lookup table then sums the bytes of each 64 bit
+		// lane, see Mula, Kurz and Lemire "Faster Population Counts Using AVX2 Instructions"
+		TAHA_TARGET_AVX2 inline static size_t popcountAvx2(const uint64_t* words, size_t count)
+		{
+			const auto lookup = _mm256_setr_epi8(
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+			const auto lowMask = _mm256_set1_epi8(0x0f);
+			auto acc = _mm256_setzero_si256();
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+				auto lo = _mm256_and_si256(v, lowMask);
+				auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+				auto bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+				acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+			}
+			uint64_t lanes[4];
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+			size_t res = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+			for (; i < count; ++i)
+			{
+				res += std::popcount(words[i]);
+			}
+			return res;
+		}
+#endif
+
+		// dst[i] = dst[i] op src[i] for each word, the avx2 path is picked at runtime and sets shorter than a vector
+		// don't pay for the feature check
+		template <OP Op>
+		inline static void combine(uint64_t* dst, const uint64_t* src, size_t count)
+		{
+			size_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+			if (count >= 4 && cpuFeatures().avx2)
+			{
+				combineAvx2<Op>(dst, src, count);
+				return;
+			}
+
+			for (; i + 2 <= count; i += 2)
+			{
+				auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+				auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), apply<Op>(a, b));
+			}
+#endif
+			for (; i < count; ++i)
+			{
+				dst[i] = apply<Op>(dst[i], src[i]);
+			}
+		}
+
+		inline static size_t popcount(const uint64_t* words, size_t count)
+		{
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+			if (count >= 4 && cpuFeatures().avx2)
+			{
+				return popcountAvx2(words, count);
+			}
+#endif
+			size_t res = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				res += std::popcount(words[i]);
+			}
+			return res;
+		}
+
+		inline static bool any(const uint64_t* words, size_t count)
+		{
+			uint64_t acc = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				acc |= words[i];
+			}
+			return acc != 0;
+		}
+
+		// whether a is a subset of b
+		inline static bool subset(const uint64_t* a, const uint64_t* b, size_t count)
+		{
+			uint64_t acc = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				acc |= a[i] & ~b[i];
+			}
+			return acc == 0;
+		}
+
+		// returns the index of the first set bit at or after start or NOT_FOUND
+		inline static size_t findNext(const uint64_t* words, size_t count, size_t start)
+		{
+			auto wordIndex = start / WORD_BITS;
+			if (wordIndex >= count)
+			{
+				return NOT_FOUND;
+			}
+
+			auto word = words[wordIndex] & (~uint64_t(0) << (start % WORD_BITS));
+			while (word == 0)
+			{
+				if (++wordIndex == count)
+				{
+					return NOT_FOUND;
+				}
+				word = words[wordIndex];
+			}
+			return wordIndex * WORD_BITS + std::countr_zero(word);
+		}
+
+		// calls f(index) for each set bit in increasing order
+		template <typename F>
+		inline static void forEach(const uint64_t* words, size_t count, F&& f)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto word = words[i];
+				while (word != 0)
+				{
+					f(i * WORD_BITS + std::countr_zero(word));
+					word &= word - 1;
+				}
+			}
+		}
+
+		// iterates over the indices of the set bits, it keeps the remaining bits of the current word so advancing only
+		// touches the next words when the current one runs out
+		class Iterator
+		{
+			const uint64_t* m_words = nullptr;
+			size_t m_count = 0;
+			size_t m_wordIndex = 0;
+			uint64_t m_word = 0;
+
+			void skipEmptyWords()
+			{
+				while (m_word == 0 && ++m_wordIndex < m_count)
+				{
+					m_word = m_words[m_wordIndex];
+				}
+			}
+
+		public:
+			// the begin iterator, the end iterator is the one with wordIndex equal to count
+			Iterator(const uint64_t* words, size_t count)
+				: m_words(words),
+				  m_count(count)
+			{
+				if (m_count > 0)
+				{
+					m_word = m_words[0];
+					skipEmptyWords();
+				}
+			}
+
+			Iterator(const uint64_t* words, size_t count, size_t wordIndex)
+				: m_words(words),
+				  m_count(count),
+				  m_wordIndex(wordIndex)
+			{}
+
+			size_t operator*() const
+			{
+				return m_wordIndex * WORD_BITS + std::countr_zero(m_word);
+			}
+
+			Iterator& operator++()
+			{
+				m_word &= m_word - 1;
+				skipEmptyWords();
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const
+			{
+				return m_wordIndex == other.m_wordIndex && m_word == other.m_word;
+			}
+
+			bool operator!=(const Iterator& other) const
+			{
+				return !operator==(other);
+			}
+		};
+	}
+
+	// a dynamically sized set of bits stored in 64 bit words, the set operations work a word at a time (or a vector
+	// of words at a time) so they are a lot faster than Set<size_t> for dense sets of small integers like the
+	// liveness sets of a compiler, iterating over it goes over the indices of the set bits
+	class BitSet
+	{
+		Allocator* m_allocator = nullptr;
+		Span<uint64_t> m_words;
+		size_t m_count = 0;
+
+		void destroy()
+		{
+			if (m_words.empty())
+			{
+				return;
+			}
+
+			m_allocator->releaseT(m_words);
+			m_allocator->freeT(m_words);
+		}
+
+		void copyFrom(const BitSet& other)
+		{
+			m_allocator = other.m_allocator;
+			m_count = other.m_count;
+			m_words = Span<uint64_t>{};
+			auto wordsCount = other.wordsCount();
+			if (wordsCount > 0)
+			{
+				m_words = m_allocator->allocT<uint64_t>(wordsCount);
+				m_allocator->commitT(m_words);
+				::memcpy(m_words.data(), other.m_words.data(), wordsCount * sizeof(uint64_t));
+			}
+		}
+
+		void moveFrom(BitSet& other)
+		{
+			m_allocator = other.m_allocator;
+			m_words = other.m_words;
+			m_count = other.m_count;
+
+			other.m_allocator = nullptr;
+			other.m_words = Span<uint64_t>{};
+			other.m_count = 0;
+		}
+
+		size_t wordsCount() const
+		{
+			return bits::wordsCount(m_count);
+		}
+
+		void clearTail()
+		{
+			if (m_count > 0)
+			{
+				m_words[wordsCount() - 1] &= bits::lastWordMask(m_count);
+			}
+		}
+
+	public:
+		static constexpr size_t NOT_FOUND = bits::NOT_FOUND;
+		using iterator = bits::Iterator;
+
+		explicit BitSet(Allocator* allocator)
+			: m_allocator(allocator)
+		{}
+
+		// a set of count bits which are all zero
+		BitSet(Allocator* allocator, size_t count)
+			: m_allocator(allocator)
+		{
+			resize(count);
+		}
+
+		BitSet(const BitSet& other)
+		{
+			copyFrom(other);
+		}
+
+		BitSet(BitSet&& other) noexcept
+		{
+			moveFrom(other);
+		}
+
+		BitSet& operator=(const BitSet& other)
+		{
+			destroy();
+			copyFrom(other);
+			return *this;
+		}
+
+		BitSet& operator=(BitSet&& other) noexcept
+		{
+			destroy();
+			moveFrom(other);
+			return *this;
+		}
+
+		~BitSet()
+		{
+			destroy();
+		}
+
+		// the count of bits in the set, set or not
+		size_t count() const
+		{
+			return m_count;
+		}
+
+		bool empty() const
+		{
+			return m_count == 0;
+		}
+
+		Allocator* allocator() const
+		{
+			return m_allocator;
+		}
+
+		// the new bits are zero
+		void resize(size_t newCount)
+		{
+			auto oldWordsCount = wordsCount();
+			auto newWordsCount = bits::wordsCount(newCount);
+			if (newWordsCount > m_words.count())
+			{
+				auto newCapacity = m_words.count() * 2;
+				if (newCapacity < newWordsCount)
+				{
+					newCapacity = newWordsCount;
+				}
+				auto newWords = m_allocator->allocT<uint64_t>(newCapacity);
+				m_allocator->commitT(newWords);
+				if (oldWordsCount > 0)
+				{
+					::memcpy(newWords.data(), m_words.data(), oldWordsCount * sizeof(uint64_t));
+				}
+				destroy();
+				m_words = newWords;
+			}
+			if (newWordsCount > oldWordsCount)
+			{
+				::memset(m_words.data() + oldWordsCount, 0, (newWordsCount - oldWordsCount) * sizeof(uint64_t));
+			}
+			m_count = newCount;
+			clearTail();
+		}
+
+		bool test(size_t i) const
+		{
+			assertTrue(i < m_count);
+			return (m_words[i / bits::WORD_BITS] >> (i % bits::WORD_BITS)) & 1;
+		}
+
+		bool operator[](size_t i) const
+		{
+			return test(i);
+		}
+
+		void set(size_t i)
+		{
+			assertTrue(i < m_count);
+			m_words[i / bits::WORD_BITS] |= uint64_t(1) << (i % bits::WORD_BITS);
+		}
+
+		void set(size_t i, bool value)
+		{
+			if (value)
+			{
+				set(i);
+			}
+			else
+			{
+				reset(i);
+			}
+		}
+
+		void reset(size_t i)
+		{
+			assertTrue(i < m_count);
+			m_words[i / bits::WORD_BITS] &= ~(uint64_t(1) << (i % bits::WORD_BITS));
+		}
+
+		void flip(size_t i)
+		{
+			assertTrue(i < m_count);
+			m_words[i / bits::WORD_BITS] ^= uint64_t(1) << (i % bits::WORD_BITS);
+		}
+
+		void setAll()
+		{
+			if (m_count > 0)
+			{
+				::memset(m_words.data(), 0xff, wordsCount() * sizeof(uint64_t));
+				clearTail();
+			}
+		}
+
+		void resetAll()
+		{
+			if (m_count > 0)
+			{
+				::memset(m_words.data(), 0, wordsCount() * sizeof(uint64_t));
+			}
+		}
+
+		// the count of the set bits
+		size_t popcount() const
+		{
+			return bits::popcount(m_words.data(), wordsCount());
+		}
+
+		bool any() const
+		{
+			return bits::any(m_words.data(), wordsCount());
+		}
+
+		bool none() const
+		{
+			return any() == false;
+		}
+
+		bool isSubsetOf(const BitSet& other) const
+		{
+			assertTrue(m_count == other.m_count);
+			return bits::subset(m_words.data(), other.m_words.data(), wordsCount());
+		}
+
+		// returns the index of the first set bit or NOT_FOUND
+		size_t findFirst() const
+		{
+			return bits::findNext(m_words.data(), wordsCount(), 0);
+		}
+
+		// returns the index of the first set bit after i or NOT_FOUND
+		size_t findNext(size_t i) const
+		{
+			return bits::findNext(m_words.data(), wordsCount(), i + 1);
+		}
+
+		// calls f(index) for each set bit in increasing order, it's faster than the iterators
+		template <typename F>
+		void forEach(F&& f) const
+		{
+			bits::forEach(m_words.data(), wordsCount(), std::forward<F>(f));
+		}
+
+		// the set operations require both sets to have the same count
+		BitSet& operator&=(const BitSet& other)
+		{
+			assertTrue(m_count == other.m_count);
+			bits::combine<bits::OP_AND>(m_words.data(), other.m_words.data(), wordsCount());
+			return *this;
+		}
+
+		BitSet& operator|=(const BitSet& other)
+		{
+			assertTrue(m_count == other.m_count);
+			bits::combine<bits::OP_OR>(m_words.data(), other.m_words.data(), wordsCount());
+			return *this;
+		}
+
+		BitSet& operator^=(const BitSet& other)
+		{
+			assertTrue(m_count == other.m_count);
+			bits::combine<bits::OP_XOR>(m_words.data(), other.m_words.data(), wordsCount());
+			return *this;
+		}
+
+		// removes the bits which are set in other
+		BitSet& andNot(const BitSet& other)
+		{
+			assertTrue(m_count == other.m_count);
+			bits::combine<bits::OP_AND_NOT>(m_words.data(), other.m_words.data(), wordsCount());
+			return *this;
+		}
+
+		bool operator==(const BitSet& other) const
+		{
+			if (m_count != other.m_count)
+			{
+				return false;
+			}
+			return m_count == 0 || ::memcmp(m_words.data(), other.m_words.data(), wordsCount() * sizeof(uint64_t)) == 0;
+		}
+
+		bool operator!=(const BitSet& other) const
+		{
+			return !operator==(other);
+		}
+
+		Span<uint64_t> words()
+		{
+			return m_words.sliceLeft(wordsCount());
+		}
+
+		Span<const uint64_t> words() const
+		{
+			return Span<const uint64_t>{m_words.data(), wordsCount()};
+		}
+
+		iterator begin() const
+		{
+			return iterator{m_words.data(), wordsCount()};
+		}
+
+		iterator end() const
+		{
+			return iterator{m_words.data(), wordsCount(), wordsCount()};
+		}
+	};
+
+	// a bit set with a compile time count of bits which lives inline with no allocations, it has the same interface as
+	// BitSet
+	template <size_t N>
+	class FixedBitSet
+	{
+		static constexpr size_t WORDS_COUNT = bits::wordsCount(N);
+
+		uint64_t m_words[WORDS_COUNT == 0 ? 1 : WORDS_COUNT] = {};
+
+		void clearTail()
+		{
+			if constexpr (N % bits::WORD_BITS != 0)
+			{
+				m_words[WORDS_COUNT - 1] &= bits::lastWordMask(N);
+			}
+		}
+
+	public:
+		static constexpr size_t NOT_FOUND = bits::NOT_FOUND;
+		using iterator = bits::Iterator;
+
+		constexpr size_t count() const
+		{
+			return N;
+		}
+
+		bool test(size_t i) const
+		{
+			assertTrue(i < N);
+			return (m_words[i / bits::WORD_BITS] >> (i % bits::WORD_BITS)) & 1;
+		}
+
+		bool operator[](size_t i) const
+		{
+			return test(i);
+		}
+
+		void set(size_t i)
+		{
+			assertTrue(i < N);
+			m_words[i / bits::WORD_BITS] |= uint64_t(1) << (i % bits::WORD_BITS);
+		}
+
+		void set(size_t i, bool value)
+		{
+			if (value)
+			{
+				set(i);
+			}
+			else
+			{
+				reset(i);
+			}
+		}
+
+		void reset(size_t i)
+		{
+			assertTrue(i < N);
+			m_words[i / bits::WORD_BITS] &= ~(uint64_t(1) << (i % bits::WORD_BITS));
+		}
+
+		void flip(size_t i)
+		{
+			assertTrue(i < N);
+			m_words[i / bits::WORD_BITS] ^= uint64_t(1) << (i % bits::WORD_BITS);
+		}
+
+		void setAll()
+		{
+			for (auto& word: m_words)
+			{
+				word = ~uint64_t(0);
+			}
+			clearTail();
+		}
+
+		void resetAll()
+		{
+			for (auto& word: m_words)
+			{
+				word = 0;
+			}
+		}
+
+		size_t popcount() const
+		{
+			return bits::popcount(m_words, WORDS_COUNT);
+		}
+
+		bool any() const
+		{
+			return bits::any(m_words, WORDS_COUNT);
+		}
+
+		bool none() const
+		{
+			return any() == false;
+		}
+
+		bool isSubsetOf(const FixedBitSet& other) const
+		{
+			return bits::subset(m_words, other.m_words, WORDS_COUNT);
+		}
+
+		size_t findFirst() const
+		{
+			return bits::findNext(m_words, WORDS_COUNT, 0);
+		}
+
+		size_t findNext(size_t i) const
+		{
+			return bits::findNext(m_words, WORDS_COUNT, i + 1);
+		}
+
+		template <typename F>
+		void forEach(F&& f) const
+		{
+			bits::forEach(m_words, WORDS_COUNT, std::forward<F>(f));
+		}
+
+		FixedBitSet& operator&=(const FixedBitSet& other)
+		{
+			bits::combine<bits::OP_AND>(m_words, other.m_words, WORDS_COUNT);
+			return *this;
+		}
+
+		FixedBitSet& operator|=(const FixedBitSet& other)
+		{
+			bits::combine<bits::OP_OR>(m_words, other.m_words, WORDS_COUNT);
+			return *this;
+		}
+
+		FixedBitSet& operator^=(const FixedBitSet& other)
+		{
+			bits::combine<bits::OP_XOR>(m_words, other.m_words, WORDS_COUNT);
+			return *this;
+		}
+
+		FixedBitSet& andNot(const FixedBitSet& other)
+		{
+			bits::combine<bits::OP_AND_NOT>(m_words, other.m_words, WORDS_COUNT);
+			return *this;
+		}
+
+		bool operator==(const FixedBitSet& other) const
+		{
+			return ::memcmp(m_words, other.m_words, sizeof(m_words)) == 0;
+		}
+
+		bool operator!=(const FixedBitSet& other) const
+		{
+			return !operator==(other);
+		}
+
+		Span<uint64_t> words()
+		{
+			return Span<uint64_t>{m_words, WORDS_COUNT};
+		}
+
+		Span<const uint64_t> words() const
+		{
+			return Span<const uint64_t>{m_words, WORDS_COUNT};
+		}
+
+		iterator begin() const
+		{
+			return iterator{m_words, WORDS_COUNT};
+		}
+
+		iterator end() const
+		{
+			return iterator{m_words, WORDS_COUNT, WORDS_COUNT};
+		}
+	};
+}
\ No newline at end of file
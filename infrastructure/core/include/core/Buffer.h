@@ -6,7 +6,9 @@
 #include "core/Span.h"
 #include "core/StringView.h"
 
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
 
 namespace core
@@ -17,9 +19,59 @@ namespace core
 	{
 		friend class String;
 
+		// small buffers are stored inline in the buffer object itself, same layout as String, the last byte of the
+		// object is the inline count which overlaps the most significant byte of the heap capacity
+		static_assert(std::endian::native == std::endian::little, "buffer layout assumes a little endian target");
+		static constexpr size_t HEAP_FLAG = size_t(1) << (sizeof(size_t) * 8 - 1);
+		static constexpr size_t INLINE_CAPACITY = 3 * sizeof(size_t) - 1;
+
+		struct HeapMemory
+		{
+			std::byte* ptr;
+			size_t count;
+			size_t capacity;
+		};
+
+		struct InlineMemory
+		{
+			std::byte data[INLINE_CAPACITY];
+			uint8_t count;
+		};
+		static_assert(sizeof(InlineMemory) == sizeof(HeapMemory));
+
 		Allocator* m_allocator = nullptr;
-		Span<std::byte> m_memory;
-		size_t m_count = 0;
+		union
+		{
+			HeapMemory m_heap;
+			InlineMemory m_inline = {};
+		};
+
+		bool isHeap() const
+		{
+			return (m_inline.count & 0x80) != 0;
+		}
+
+		std::byte* ptr()
+		{
+			return isHeap() ? m_heap.ptr : m_inline.data;
+		}
+
+		const std::byte* ptr() const
+		{
+			return isHeap() ? m_heap.ptr : m_inline.data;
+		}
+
+		void setCount(size_t count)
+		{
+			if (isHeap())
+			{
+				m_heap.count = count;
+			}
+			else
+			{
+				m_inline.count = uint8_t(count);
+			}
+		}
 
 		CORE_EXPORT void destroy();
 
@@ -69,34 +121,35 @@ namespace core
 
 		std::byte& operator[](size_t i)
 		{
-			assertTrue(i < m_count);
-			return m_memory[i];
+			assertTrue(i < count());
+			return ptr()[i];
 		}
 
 		const std::byte& operator[](size_t i) const
 		{
-			assertTrue(i < m_count);
-			return m_memory[i];
+			assertTrue(i < count());
+			return ptr()[i];
 		}
 
 		explicit operator StringView() const
 		{
-			return StringView{m_memory.sliceLeft(m_count)};
+			return StringView{(const char*)ptr(), count()};
 		}
 		explicit operator Span<const std::byte>() const
 		{
-			return m_memory.sliceLeft(m_count);
+			return Span<const std::byte>{ptr(), count()};
 		}
 		explicit operator Span<std::byte>()
 		{
-			return m_memory.sliceLeft(m_count);
+			return Span<std::byte>{ptr(), count()};
 		}
 
 		void push(std::byte b)
 		{
 			ensureSpaceExists(1);
-			m_memory[m_count] = b;
-			++m_count;
+			auto count = this->count();
+			ptr()[count] = b;
+			setCount(count + 1);
 		}
 
 		void push(StringView v)
@@ -125,19 +178,24 @@ namespace core
 
 		size_t count() const
 		{
-			return m_count;
+			return isHeap() ? m_heap.count : m_inline.count;
 		}
 		size_t capacity() const
 		{
-			return m_memory.count();
+			return isHeap() ? (m_heap.capacity & ~HEAP_FLAG) : INLINE_CAPACITY;
+		}
+		// returns true if the buffer is stored inline without a heap allocation
+		bool isInline() const
+		{
+			return isHeap() == false;
 		}
 		std::byte* data()
 		{
-			return m_memory.data();
+			return ptr();
 		}
 		const std::byte* data() const
 		{
-			return m_memory.data();
+			return ptr();
 		}
 		Allocator* allocator() const
 		{
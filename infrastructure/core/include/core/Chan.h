@@ -2,16 +2,16 @@
 
 #include "core/Allocator.h"
 #include "core/ConditionVariable.h"
+#include "core/Deque.h"
 #include "core/Func.h"
 #include "core/Hash.h"
 #include "core/Lock.h"
 #include "core/Mallocator.h"
 #include "core/Mutex.h"
-#include "core/Queue.h"
+#include "core/Rand.h"
 #include "core/Shared.h"
 
 #include <atomic>
-#include <random>
 
 namespace core
 {
@@ -152,7 +152,7 @@ namespace core
 		std::atomic<int> m_writeWaiting = 0;
 		Map<SelectCond*, size_t> m_writeSelects;
 		Map<SelectCond*, size_t> m_readSelects;
-		Queue<T> m_buffer;
+		Deque<T> m_buffer;
 		size_t m_bufferSize = 0;
 		T* m_unbufferedSlot = nullptr;
 		Mutex m_readMutex;
@@ -177,9 +177,7 @@ namespace core
 				return;
 			}
 
-			std::random_device device;
-			std::uniform_int_distribution<size_t> dist(0, selects.count() - 1);
-			auto offsetIndex = dist(device);
+			auto offsetIndex = size_t(FastRand::threadLocal().uniform(selects.count()));
 			auto it = selects.begin();
 			for (size_t i = 0; i < selects.count(); ++i)
 			{
@@ -528,6 +526,7 @@ namespace core
 		{
 			auto res = shared_from<Chan<T, dir>>(allocator, allocator);
 			res->m_bufferSize = bufferCap;
+			res->m_buffer.reserve(bufferCap);
 			return res;
 		}
 
@@ -864,9 +863,7 @@ namespace core
 				Mallocator mallocator;
 				SelectCond cond{&mallocator};
 
-				std::random_device device;
-				std::uniform_int_distribution<size_t> dist(0, descsCount);
-				auto offsetIndex = dist(device);
+				auto offsetIndex = size_t(FastRand::threadLocal().uniform(descsCount));
 				auto aliveDescsCount = descsCount;
 				for (size_t i = 0; i < descsCount; ++i)
 				{
@@ -918,9 +915,7 @@ namespace core
 			}
 			else
 			{
-				std::random_device device;
-				std::uniform_int_distribution<size_t> dist(0, descsCount);
-				auto offsetIndex = dist(device);
+				auto offsetIndex = size_t(FastRand::threadLocal().uniform(descsCount));
 				for (size_t i = 0; i < descsCount; ++i)
 				{
 					auto index = (i + offsetIndex) % descsCount;
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "core/Array.h"
+#include "core/Hash.h"
+#include "core/Lock.h"
+#include "core/RWMutex.h"
+#include "core/Thread.h"
+
+#include <bit>
+
+namespace core
+{
+	// a thread safe hash map which splits its keys over independently locked Map shards, readers share the lock of
+	// their shard so lookups scale with the number of cores, and a writer only blocks the users of its own shard
+	//
+	// the callbacks of visit, upsert and eraseIf run while the shard lock is held so they must not call back into the
+	// map, iteration works on a snapshot since the shards can change while they are being visited
+	template <typename TKey, typename TValue, typename THash = Hash<TKey>>
+	class ConcurrentMap
+	{
+		// the shards sit next to each other in m_shards, the padding keeps the map of one shard, which its writers
+		// change, off the cache lines which the readers of the next shard load, it's padding and not alignas because
+		// the allocators don't align beyond max_align_t
+		struct Shard
+		{
+			mutable RWMutex mutex;
+			Map<TKey, TValue, THash> map;
+			std::byte padding[64];
+
+			Shard(Allocator* allocator, HashSeed seed)
+				: mutex(allocator),
+				  map(allocator, seed)
+			{}
+		};
+
+		Allocator* m_allocator = nullptr;
+		// all the shards share the seed so a key is hashed once to pick its shard and to find it inside the shard
+		size_t m_seed = 0;
+		Array<Shard> m_shards;
+		// the shard index comes from the hash bits right below the 7 bits Map keeps in the control bytes, the low bits
+		// pick the group inside the shard so using them would leave most of the groups of each shard empty
+		size_t m_shardShift = 0;
+
+		Shard& shardOf(size_t hash)
+		{
+			return m_shards[(hash >> m_shardShift) & (m_shards.count() - 1)];
+		}
+
+		const Shard& shardOf(size_t hash) const
+		{
+			return m_shards[(hash >> m_shardShift) & (m_shards.count() - 1)];
+		}
+
+	public:
+		// uses 4 shards per hardware thread which keeps the chance of two threads hitting the same shard low
+		explicit ConcurrentMap(Allocator* allocator)
+			: ConcurrentMap(allocator, size_t(Thread::hardware_concurrency()) * 4)
+		{}
+
+		// the shards count is rounded up to a power of 2
+		ConcurrentMap(Allocator* allocator, size_t shardsCount)
+			: m_allocator(allocator),
+			  m_seed(HashSeed::random().value()),
+			  m_shards(allocator)
+		{
+			shardsCount = std::bit_ceil(shardsCount < 1 ? 1 : shardsCount);
+			m_shardShift = sizeof(size_t) * 8 - 7 - std::countr_zero(shardsCount);
+			m_shards.reserve(shardsCount);
+			for (size_t i = 0; i < shardsCount; ++i)
+			{
+				m_shards.push(Shard{allocator, HashSeed{m_seed}});
+			}
+		}
+
+		Allocator* allocator() const
+		{
+			return m_allocator;
+		}
+
+		size_t shardsCount() const
+		{
+			return m_shards.count();
+		}
+
+		// the count of all the shards, it's only exact if there are no concurrent writers
+		size_t count() const
+		{
+			size_t res = 0;
+			for (auto& shard: m_shards)
+			{
+				auto lock = sharedLockGuard(shard.mutex);
+				res += shard.map.count();
+			}
+			return res;
+		}
+
+		// inserts the key if it doesn't exist, returns true if it was inserted
+		template <typename R, typename U>
+		bool insert(R&& key, U&& value)
+		{
+			auto hash = THash{}(key, m_seed);
+			auto& shard = shardOf(hash);
+			auto lock = lockGuard(shard.mutex);
+			auto count = shard.map.count();
+			shard.map.insertWithHash(std::forward<R>(key), hash, std::forward<U>(value));
+			return shard.map.count() != count;
+		}
+
+		// inserts the key with the given value if it doesn't exist, otherwise calls update(TValue&) with the existing
+		// value, returns true if it was inserted
+		template <typename R, typename U, typename F>
+		bool upsert(R&& key, U&& value, F&& update)
+		{
+			auto hash = THash{}(key, m_seed);
+			auto& shard = shardOf(hash);
+			auto lock = lockGuard(shard.mutex);
+			if (auto it = shard.map.lookupWithHash(key, hash); it != shard.map.end())
+			{
+				update(it->value);
+				return false;
+			}
+			shard.map.insertWithHash(std::forward<R>(key), hash, std::forward<U>(value));
+			return true;
+		}
+
+		// calls visitor(const KeyValue<const TKey, TValue>&) with the key and its value under the shared lock of its
+		// shard, returns false if the key doesn't exist
+		template <typename R, typename F>
+		bool visit(const R& key, F&& visitor) const
+		{
+			auto hash = THash{}(key, m_seed);
+			auto& shard = shardOf(hash);
+			auto lock = sharedLockGuard(shard.mutex);
+			auto it = shard.map.lookupWithHash(key, hash);
+			if (it == shard.map.end())
+			{
+				return false;
+			}
+			visitor(*it);
+			return true;
+		}
+
+		template <typename R>
+		bool contains(const R& key) const
+		{
+			return visit(key, [](const auto&) {});
+		}
+
+		template <typename R>
+		bool remove(const R& key)
+		{
+			auto hash = THash{}(key, m_seed);
+			auto& shard = shardOf(hash);
+			auto lock = lockGuard(shard.mutex);
+			return shard.map.removeWithHash(key, hash);
+		}
+
+		// removes the key if predicate(const KeyValue<const TKey, TValue>&) returns true, returns true if it was
+		// removed
+		template <typename R, typename F>
+		bool eraseIf(const R& key, F&& predicate)
+		{
+			auto hash = THash{}(key, m_seed);
+			auto& shard = shardOf(hash);
+			auto lock = lockGuard(shard.mutex);
+			auto it = shard.map.lookupWithHash(key, hash);
+			if (it == shard.map.end() || predicate(*it) == false)
+			{
+				return false;
+			}
+			return shard.map.removeWithHash(key, hash);
+		}
+
+		// removes all the entries which the predicate returns true for, one shard at a time, returns the removed count
+		template <typename F>
+		size_t eraseIf(F&& predicate)
+		{
+			size_t res = 0;
+			for (auto& shard: m_shards)
+			{
+				auto lock = lockGuard(shard.mutex);
+				// removing an entry moves the last entry into its place so we check the same position again
+				for (auto it = shard.map.begin(); it != shard.map.end();)
+				{
+					if (predicate(*it))
+					{
+						auto hash = THash{}(it->key, m_seed);
+						shard.map.removeWithHash(it->key, hash);
+						++res;
+					}
+					else
+					{
+						++it;
+					}
+				}
+			}
+			return res;
+		}
+
+		// calls visitor(const KeyValue<const TKey, TValue>&) for each entry, one shard at a time under its shared lock,
+		// entries which are inserted or removed concurrently may or may not be visited
+		template <typename F>
+		void visitAll(F&& visitor) const
+		{
+			for (auto& shard: m_shards)
+			{
+				auto lock = sharedLockGuard(shard.mutex);
+				for (const auto& entry: shard.map)
+				{
+					visitor(entry);
+				}
+			}
+		}
+
+		// copies all the entries into a Map which can be iterated without holding any lock, like visitAll it's only
+		// consistent within each shard
+		Map<TKey, TValue, THash> snapshot(Allocator* allocator) const
+		{
+			Map<TKey, TValue, THash> res{allocator, HashSeed{m_seed}};
+			res.reserve(count());
+			visitAll([&](const auto& entry) { res.insert(entry.key, entry.value); });
+			return res;
+		}
+
+		void clear()
+		{
+			for (auto& shard: m_shards)
+			{
+				auto lock = lockGuard(shard.mutex);
+				shard.map.clear();
+			}
+		}
+	};
+}
\ No newline at end of file
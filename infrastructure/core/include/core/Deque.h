@@ -0,0 +1,303 @@
+#pragma once
+
+#include "core/Allocator.h"
+#include "core/Assert.h"
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core
+{
+	// a double ended queue stored in a single circular buffer, its capacity is a power of 2 so wrapping an index around
+	// is a mask, pushing and popping at both ends only allocates when the buffer grows
+	template <typename T>
+	class Deque
+	{
+		Allocator* m_allocator = nullptr;
+		Span<T> m_memory;
+		// the index of the front element in m_memory
+		size_t m_head = 0;
+		size_t m_count = 0;
+
+		size_t wrap(size_t i) const
+		{
+			return i & (m_memory.count() - 1);
+		}
+
+		void destroy()
+		{
+			if (m_memory.empty())
+			{
+				return;
+			}
+
+			for (size_t i = 0; i < m_count; ++i)
+			{
+				m_memory[wrap(m_head + i)].~T();
+			}
+			m_allocator->releaseT(m_memory);
+			m_allocator->freeT(m_memory);
+			m_memory = Span<T>{};
+			m_head = 0;
+			m_count = 0;
+		}
+
+		void copyFrom(const Deque& other)
+		{
+			m_allocator = other.m_allocator;
+			m_memory = Span<T>{};
+			m_head = 0;
+			m_count = other.m_count;
+			if (other.m_memory.empty())
+			{
+				return;
+			}
+
+			m_memory = m_allocator->allocT<T>(other.m_memory.count());
+			m_allocator->commitT(m_memory);
+			for (size_t i = 0; i < m_count; ++i)
+			{
+				::new (&m_memory[i]) T(other[i]);
+			}
+		}
+
+		void moveFrom(Deque& other)
+		{
+			m_allocator = other.m_allocator;
+			m_memory = other.m_memory;
+			m_head = other.m_head;
+			m_count = other.m_count;
+
+			other.m_allocator = nullptr;
+			other.m_memory = Span<T>{};
+			other.m_head = 0;
+			other.m_count = 0;
+		}
+
+		// moves the elements to the start of a new buffer so they're in order again
+		void grow(size_t new_capacity)
+		{
+			auto new_memory = m_allocator->allocT<T>(new_capacity);
+			m_allocator->commitT(new_memory);
+			for (size_t i = 0; i < m_count; ++i)
+			{
+				auto& value = m_memory[wrap(m_head + i)];
+				if constexpr (std::is_move_constructible_v<T>)
+				{
+					::new (&new_memory[i]) T(std::move(value));
+				}
+				else
+				{
+					::new (&new_memory[i]) T(value);
+				}
+				value.~T();
+			}
+
+			m_allocator->releaseT(m_memory);
+			m_allocator->freeT(m_memory);
+
+			m_memory = new_memory;
+			m_head = 0;
+		}
+
+		void ensureSpaceExists(size_t i = 1)
+		{
+			if (m_count + i > m_memory.count())
+			{
+				size_t new_capacity = m_memory.count() * 2;
+				if (new_capacity == 0)
+				{
+					new_capacity = 8;
+				}
+
+				while (new_capacity < m_count + i)
+				{
+					new_capacity *= 2;
+				}
+
+				grow(new_capacity);
+			}
+		}
+
+	public:
+		explicit Deque(Allocator* allocator)
+			: m_allocator(allocator)
+		{}
+
+		Deque(const Deque& other)
+		{
+			copyFrom(other);
+		}
+
+		Deque(Deque&& other) noexcept
+		{
+			moveFrom(other);
+		}
+
+		Deque& operator=(const Deque& other)
+		{
+			if (this == &other)
+			{
+				return *this;
+			}
+
+			destroy();
+			copyFrom(other);
+			return *this;
+		}
+
+		Deque& operator=(Deque&& other) noexcept
+		{
+			if (this == &other)
+			{
+				return *this;
+			}
+
+			destroy();
+			moveFrom(other);
+			return *this;
+		}
+
+		~Deque()
+		{
+			destroy();
+		}
+
+		// the i-th element counting from the front
+		T& operator[](size_t i)
+		{
+			assertTrue(i < m_count);
+			return m_memory[wrap(m_head + i)];
+		}
+
+		const T& operator[](size_t i) const
+		{
+			assertTrue(i < m_count);
+			return m_memory[wrap(m_head + i)];
+		}
+
+		template <typename R>
+		void push_back(R&& value)
+		{
+			ensureSpaceExists();
+			::new (&m_memory[wrap(m_head + m_count)]) T(std::forward<R>(value));
+			++m_count;
+		}
+
+		template <typename R>
+		void push_front(R&& value)
+		{
+			ensureSpaceExists();
+			auto head = wrap(m_head + m_memory.count() - 1);
+			::new (&m_memory[head]) T(std::forward<R>(value));
+			m_head = head;
+			++m_count;
+		}
+
+		T& back()
+		{
+			assertTrue(m_count > 0);
+			return m_memory[wrap(m_head + m_count - 1)];
+		}
+
+		const T& back() const
+		{
+			assertTrue(m_count > 0);
+			return m_memory[wrap(m_head + m_count - 1)];
+		}
+
+		T& front()
+		{
+			assertTrue(m_count > 0);
+			return m_memory[m_head];
+		}
+
+		const T& front() const
+		{
+			assertTrue(m_count > 0);
+			return m_memory[m_head];
+		}
+
+		void pop_back()
+		{
+			assertTrue(m_count > 0);
+			m_memory[wrap(m_head + m_count - 1)].~T();
+			--m_count;
+		}
+
+		void pop_front()
+		{
+			assertTrue(m_count > 0);
+			m_memory[m_head].~T();
+			m_head = wrap(m_head + 1);
+			--m_count;
+		}
+
+		// the elements from the front up to the end of the buffer
+		Span<T> firstSpan()
+		{
+			auto end = m_head + m_count;
+			if (end > m_memory.count())
+			{
+				end = m_memory.count();
+			}
+			return m_memory.slice(m_head, end);
+		}
+
+		Span<const T> firstSpan() const
+		{
+			return const_cast<Deque*>(this)->firstSpan();
+		}
+
+		// the elements which wrapped around to the start of the buffer, it's empty if the elements are contiguous
+		Span<T> secondSpan()
+		{
+			if (m_head + m_count <= m_memory.count())
+			{
+				return Span<T>{};
+			}
+			return m_memory.sliceLeft(m_head + m_count - m_memory.count());
+		}
+
+		Span<const T> secondSpan() const
+		{
+			return const_cast<Deque*>(this)->secondSpan();
+		}
+
+		void clear()
+		{
+			for (size_t i = 0; i < m_count; ++i)
+			{
+				m_memory[wrap(m_head + i)].~T();
+			}
+			m_head = 0;
+			m_count = 0;
+		}
+
+		void reserve(size_t extra_count)
+		{
+			ensureSpaceExists(extra_count);
+		}
+
+		size_t count() const
+		{
+			return m_count;
+		}
+
+		size_t capacity() const
+		{
+			return m_memory.count();
+		}
+
+		bool empty() const
+		{
+			return m_count == 0;
+		}
+
+		Allocator* allocator() const
+		{
+			return m_allocator;
+		}
+	};
+}
\ No newline at end of file
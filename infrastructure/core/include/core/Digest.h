@@ -0,0 +1,168 @@
+#pragma once
+
+#include "core/Allocator.h"
+#include "core/Exports.h"
+#include "core/HashFunction.h"
+#include "core/Hex.h"
+#include "core/Result.h"
+#include "core/Span.h"
+#include "core/StringView.h"
+
+#include <fmt/core.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace core
+{
+	class ThreadPool;
+
+	// a 256 bit cryptographic digest, use it to content address data, sha256 is there for interop with the outside
+	// world and blake3 is the fast one which can also hash a single big input on multiple threads
+	class Digest
+	{
+		std::byte m_digest[32];
+
+	public:
+		static constexpr size_t DIGEST_SIZE = sizeof(m_digest);
+
+		enum ALGORITHM
+		{
+			ALGORITHM_SHA256,
+			ALGORITHM_BLAKE3,
+		};
+
+		CORE_EXPORT static Digest sha256(Span<const std::byte> bytes);
+
+		static Digest sha256(StringView str)
+		{
+			return sha256(Span<const std::byte>{str});
+		}
+
+		CORE_EXPORT static Digest blake3(Span<const std::byte> bytes);
+		// splits big inputs into subtrees which are hashed on the thread pool while the calling thread helps, the
+		// allocator is used for the bookkeeping which the pool tasks share
+		CORE_EXPORT static Digest blake3(Span<const std::byte> bytes, ThreadPool* pool, Allocator* allocator);
+
+		static Digest blake3(StringView str)
+		{
+			return blake3(Span<const std::byte>{str});
+		}
+
+		// streams the file through the given algorithm in big aligned reads, the pool is only used by blake3
+		CORE_EXPORT static Result<Digest>
+		hashFile(Allocator* allocator, StringView path, ALGORITHM algorithm, ThreadPool* pool = nullptr);
+
+		Span<std::byte> asBytes()
+		{
+			return {m_digest, DIGEST_SIZE};
+		}
+
+		Span<const std::byte> asBytes() const
+		{
+			return {m_digest, DIGEST_SIZE};
+		}
+
+		bool operator==(const Digest& other) const
+		{
+			return ::memcmp(m_digest, other.m_digest, sizeof(m_digest)) == 0;
+		}
+
+		bool operator!=(const Digest& other) const
+		{
+			return !operator==(other);
+		}
+	};
+
+	template <>
+	struct Hash<Digest>
+	{
+		inline size_t operator()(const Digest& value, size_t seed) const
+		{
+			// the digest bits are uniformly distributed already, so mixing the first 16 bytes is enough
+			auto bytes = reinterpret_cast<const unsigned char*>(value.asBytes().data());
+			return size_t(_wymix(_hashRead8(bytes) ^ seed ^ _wyp[0], _hashRead8(bytes + 8) ^ _wyp[1]));
+		}
+	};
+
+	// the streaming interface of the digest algorithms, feed it the input in as many pieces as you like then call
+	// final once
+	class DigestHasher
+	{
+	public:
+		virtual ~DigestHasher() = default;
+		virtual void hash(Span<const std::byte> bytes) = 0;
+		virtual Digest final() = 0;
+
+		void hash(StringView str)
+		{
+			hash(Span<const std::byte>{str});
+		}
+	};
+
+	// uses the sha extensions when the running cpu has them (see cpuFeatures)
+	class SHA256Hasher: public DigestHasher
+	{
+		uint32_t m_state[8];
+		std::byte m_block[64];
+		size_t m_blockCount = 0;
+		uint64_t m_totalCount = 0;
+
+	public:
+		CORE_EXPORT SHA256Hasher();
+
+		using DigestHasher::hash;
+		CORE_EXPORT void hash(Span<const std::byte> bytes) override;
+		CORE_EXPORT Digest final() override;
+	};
+
+	// hashes 8 chunks at a time with avx2 when the running cpu has it and spreads big inputs over the pool if given
+	class Blake3Hasher: public DigestHasher
+	{
+		// the chunk which is still being filled, it's only compressed when more input comes because the last chunk
+		// might be the root of the tree
+		uint32_t m_chunkCV[8];
+		std::byte m_block[64];
+		size_t m_blockCount = 0;
+		size_t m_chunkBlocks = 0;
+		uint64_t m_chunkCounter = 0;
+		// the chaining values of the completed subtrees, one for each set bit in m_chunkCounter
+		uint32_t m_stack[54][8];
+		size_t m_stackCount = 0;
+		ThreadPool* m_pool = nullptr;
+		Allocator* m_allocator = nullptr;
+
+		void hashChunks(const std::byte* ptr, uint64_t count);
+		// hashes whole subtrees so their parents can be hashed 8 at a time too, on the pool if there's one
+		void hashSubtrees(const std::byte* ptr, uint64_t count);
+
+	public:
+		CORE_EXPORT Blake3Hasher();
+		CORE_EXPORT Blake3Hasher(ThreadPool* pool, Allocator* allocator);
+
+		using DigestHasher::hash;
+		CORE_EXPORT void hash(Span<const std::byte> bytes) override;
+		CORE_EXPORT Digest final() override;
+	};
+}
+
+namespace fmt
+{
+	template <>
+	struct formatter<core::Digest>
+	{
+		template <typename ParseContext>
+		constexpr auto parse(ParseContext& ctx)
+		{
+			return ctx.begin();
+		}
+
+		template <typename FormatContext>
+		auto format(const core::Digest& digest, FormatContext& ctx)
+		{
+			char buffer[core::Hex::encodedCount(core::Digest::DIGEST_SIZE)];
+			auto count = core::Hex::encode(digest.asBytes(), core::Span<char>{buffer, sizeof(buffer)});
+			return fmt::format_to(ctx.out(), "{}", fmt::string_view{buffer, count});
+		}
+	};
+}
\ No newline at end of file
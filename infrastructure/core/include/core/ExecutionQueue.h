@@ -1,10 +1,10 @@
 #pragma once
 
 #include "core/Assert.h"
+#include "core/Deque.h"
 #include "core/Func.h"
 #include "core/Lock.h"
 #include "core/Mutex.h"
-#include "core/Queue.h"
 #include "core/ThreadPool.h"
 
 namespace core
@@ -14,7 +14,7 @@ namespace core
 		template <typename TPtr, typename... TArgs>
 		friend inline Shared<TPtr> shared_from(Allocator* allocator, TArgs&&... args);
 
-		Queue<Func<void()>> m_queue;
+		Deque<Func<void()>> m_queue;
 		Mutex m_mutex;
 		bool m_scheduled = false;
 
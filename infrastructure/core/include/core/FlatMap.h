@@ -0,0 +1,358 @@
+#pragma once
+
+#include "core/Allocator.h"
+#include "core/Array.h"
+#include "core/Assert.h"
+#include "core/Hash.h"
+#include "core/StringView.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace core
+{
+	// an ordered container which keeps its entries sorted by key using operator< in one contiguous array, it's meant
+	// for small tables which are built once and read a lot (options, headers, keyword tables) where a hash table pays
+	// for its slots and indirection, lookups are a binary search (or a linear scan for a few entries) and iteration is
+	// a walk over an array, inserting and removing move the following entries so they are O(n), use build() to fill it
+	// from unsorted entries in O(n log n), use FlatMap and FlatSet instead of using it directly
+	template <typename TKey, typename TEntry>
+	class FlatTable
+	{
+		// tables with fewer entries than this are searched linearly which is cheaper than a binary search there
+		static constexpr size_t LINEAR_SEARCH_THRESHOLD = 8;
+
+		Array<TEntry> m_entries;
+
+		static const TKey& keyOf(const TEntry& entry)
+		{
+			if constexpr (std::is_same_v<TKey, TEntry>)
+			{
+				return entry;
+			}
+			else
+			{
+				return entry.key;
+			}
+		}
+
+		// the index of the first entry which the predicate returns false for, see BTree::partitionPoint
+		template <typename F>
+		size_t partitionPoint(F&& predicate) const
+		{
+			auto values = m_entries.data();
+			auto count = m_entries.count();
+			if (count < LINEAR_SEARCH_THRESHOLD)
+			{
+				size_t i = 0;
+				while (i < count && predicate(values[i]))
+				{
+					++i;
+				}
+				return i;
+			}
+
+			auto base = values;
+			while (count > 1)
+			{
+				auto half = count / 2;
+				base = predicate(base[half]) ? base + half : base;
+				count -= half;
+			}
+			return size_t(base - values) + (predicate(*base) ? 1 : 0);
+		}
+
+		template <typename R>
+		size_t lowerBoundIndex(const R& key) const
+		{
+			return partitionPoint([&](const TEntry& entry) { return keyOf(entry) < key; });
+		}
+
+		template <typename R>
+		size_t upperBoundIndex(const R& key) const
+		{
+			return partitionPoint([&](const TEntry& entry) { return (key < keyOf(entry)) == false; });
+		}
+
+		// a three way compare so the binary search compares strings once per step instead of twice with operator<
+		template <typename A, typename B>
+		static int compareKeys(const A& a, const B& b)
+		{
+			if constexpr (std::is_convertible_v<const A&, StringView> && std::is_convertible_v<const B&, StringView>)
+			{
+				return StringView::cmp(a, b);
+			}
+			else
+			{
+				return a < b ? -1 : (b < a ? 1 : 0);
+			}
+		}
+
+		// the index of the entry with the given key or the count of entries if it doesn't exist
+		template <typename R>
+		size_t findIndex(const R& key) const
+		{
+			auto values = m_entries.data();
+			auto count = m_entries.count();
+			if (count < LINEAR_SEARCH_THRESHOLD)
+			{
+				// equality is cheaper than ordering, strings of a different length aren't even compared
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (keyOf(values[i]) == key)
+					{
+						return i;
+					}
+				}
+				return count;
+			}
+
+			size_t begin = 0;
+			size_t end = count;
+			while (begin < end)
+			{
+				auto middle = begin + (end - begin) / 2;
+				auto res = compareKeys(keyOf(values[middle]), key);
+				if (res == 0)
+				{
+					return middle;
+				}
+				else if (res < 0)
+				{
+					begin = middle + 1;
+				}
+				else
+				{
+					end = middle;
+				}
+			}
+			return count;
+		}
+
+	protected:
+		// inserts the entry of the key if the key doesn't exist, returns true if it was inserted, the key is converted
+		// to the key type only when it's inserted, keys which need an allocator (like String from a StringView) are
+		// constructed with the table's allocator
+		template <typename R, typename... TArgs>
+		bool emplace(R&& key, TArgs&&... args)
+		{
+			auto index = lowerBoundIndex(key);
+			if (index < m_entries.count() && (key < keyOf(m_entries[index])) == false)
+			{
+				return false;
+			}
+
+			if constexpr (std::is_same_v<TKey, TEntry>)
+			{
+				m_entries.push(hashMakeKey<TKey>(std::forward<R>(key), m_entries.allocator()));
+			}
+			else
+			{
+				m_entries.push(TEntry{
+					hashMakeKey<TKey>(std::forward<R>(key), m_entries.allocator()),
+					std::forward<TArgs>(args)...});
+			}
+			std::rotate(m_entries.begin() + index, m_entries.end() - 1, m_entries.end());
+			return true;
+		}
+
+	public:
+		using Iterator = TEntry*;
+		using ConstIterator = const TEntry*;
+
+		explicit FlatTable(Allocator* allocator)
+			: m_entries(allocator)
+		{}
+
+		Allocator* allocator() const
+		{
+			return m_entries.allocator();
+		}
+
+		size_t count() const
+		{
+			return m_entries.count();
+		}
+
+		bool empty() const
+		{
+			return m_entries.count() == 0;
+		}
+
+		size_t capacity() const
+		{
+			return m_entries.capacity();
+		}
+
+		void reserve(size_t added_count)
+		{
+			m_entries.reserve(added_count);
+		}
+
+		void clear()
+		{
+			m_entries.clear();
+		}
+
+		// replaces the content of the table with the given entries which can be in any order, when a key is repeated
+		// the first of its entries is kept like inserting them one by one would do
+		void build(Array<TEntry> entries)
+		{
+			std::stable_sort(entries.begin(), entries.end(), [](const TEntry& a, const TEntry& b) {
+				return keyOf(a) < keyOf(b);
+			});
+			auto last = std::unique(entries.begin(), entries.end(), [](const TEntry& a, const TEntry& b) {
+				return (keyOf(a) < keyOf(b)) == false;
+			});
+			while (entries.end() != last)
+			{
+				entries.pop();
+			}
+			m_entries = std::move(entries);
+		}
+
+		template <typename R>
+		bool remove(const R& key)
+		{
+			auto index = findIndex(key);
+			if (index == m_entries.count())
+			{
+				return false;
+			}
+
+			std::move(m_entries.begin() + index + 1, m_entries.end(), m_entries.begin() + index);
+			m_entries.pop();
+			return true;
+		}
+
+		template <typename R>
+		ConstIterator lookup(const R& key) const
+		{
+			return m_entries.begin() + findIndex(key);
+		}
+
+		template <typename R>
+		Iterator lookup(const R& key)
+		{
+			return m_entries.begin() + findIndex(key);
+		}
+
+		// the first entry whose key isn't less than the given key
+		template <typename R>
+		ConstIterator lowerBound(const R& key) const
+		{
+			return m_entries.begin() + lowerBoundIndex(key);
+		}
+
+		template <typename R>
+		Iterator lowerBound(const R& key)
+		{
+			return m_entries.begin() + lowerBoundIndex(key);
+		}
+
+		// the first entry whose key is greater than the given key
+		template <typename R>
+		ConstIterator upperBound(const R& key) const
+		{
+			return m_entries.begin() + upperBoundIndex(key);
+		}
+
+		template <typename R>
+		Iterator upperBound(const R& key)
+		{
+			return m_entries.begin() + upperBoundIndex(key);
+		}
+
+		// the sorted entries
+		Span<const TEntry> entries() const
+		{
+			return m_entries;
+		}
+
+		Iterator begin()
+		{
+			return m_entries.begin();
+		}
+
+		ConstIterator begin() const
+		{
+			return m_entries.begin();
+		}
+
+		Iterator end()
+		{
+			return m_entries.end();
+		}
+
+		ConstIterator end() const
+		{
+			return m_entries.end();
+		}
+	};
+
+	// an ordered map in a sorted array, see FlatTable, the iterators give access to the KeyValue entries where the key
+	// must not be changed
+	template <typename TKey, typename TValue>
+	class FlatMap: public FlatTable<TKey, KeyValue<TKey, TValue>>
+	{
+	public:
+		using FlatTable<TKey, KeyValue<TKey, TValue>>::FlatTable;
+
+		// inserts the key if it doesn't exist, returns true if it was inserted
+		template <typename R, typename U>
+		bool insert(R&& key, U&& value)
+		{
+			return this->emplace(std::forward<R>(key), std::forward<U>(value));
+		}
+	};
+
+	// an ordered set in a sorted array, see FlatTable
+	template <typename TKey>
+	class FlatSet: public FlatTable<TKey, TKey>
+	{
+	public:
+		using Iterator = typename FlatTable<TKey, TKey>::ConstIterator;
+		using ConstIterator = typename FlatTable<TKey, TKey>::ConstIterator;
+
+		using FlatTable<TKey, TKey>::FlatTable;
+
+		// inserts the key if it doesn't exist, returns true if it was inserted
+		template <typename R>
+		bool insert(R&& key)
+		{
+			return this->emplace(std::forward<R>(key));
+		}
+
+		// the keys are the entries so all the lookups hand out const iterators, changing a key in place would break the
+		// order of the table
+		template <typename R>
+		ConstIterator lookup(const R& key) const
+		{
+			return FlatTable<TKey, TKey>::lookup(key);
+		}
+
+		template <typename R>
+		ConstIterator lowerBound(const R& key) const
+		{
+			return FlatTable<TKey, TKey>::lowerBound(key);
+		}
+
+		template <typename R>
+		ConstIterator upperBound(const R& key) const
+		{
+			return FlatTable<TKey, TKey>::upperBound(key);
+		}
+
+		ConstIterator begin() const
+		{
+			return FlatTable<TKey, TKey>::begin();
+		}
+
+		ConstIterator end() const
+		{
+			return FlatTable<TKey, TKey>::end();
+		}
+	};
+}
\ No newline at end of file
@@ -4,151 +4,402 @@
 #include "core/Assert.h"
 #include "core/HashFunction.h"
 
+#include <bit>
 #include <cstdint>
 #include <cstring>
 #include <new>
+#include <type_traits>
 #include <utility>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#endif
+
 namespace core
 {
-	enum HASH_FLAGS : uint8_t
+	// the control byte of a hash table slot, used slots store the 7 most significant bits of their value hash so the
+	// most significant bit is only set for the empty and deleted slots
+	enum HASH_CONTROL : uint8_t
 	{
-		HASH_EMPTY,
-		HASH_USED,
-		HASH_DELETED
+		HASH_CONTROL_EMPTY = 0x80,
+		HASH_CONTROL_DELETED = 0xFE,
 	};
 
-	// hash table slot with the index and hash
-	class HashSlot
+	// returns the control byte of a used slot with the given hash
+	inline static uint8_t hashControl(size_t hash)
+	{
+		return uint8_t(hash >> (sizeof(size_t) * 8 - 7));
+	}
+
+	// a group of consecutive control bytes which are matched at once, each match returns a bit mask where bit i is set
+	// if the i-th control byte in the group matches
+	class HashGroup
 	{
-		// most signficant 2 bits = HASH_FLAGS enum
-		// remaining bits = index
-		size_t index = 0;
-		size_t hash = 0;
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+		__m128i m_controls;
 
 	public:
-		HashSlot() = default;
+		static constexpr size_t WIDTH = 16;
 
-		HashSlot(size_t value_index, size_t value_hash)
-			: index(value_index),
-			  hash(value_hash)
+		explicit HashGroup(const uint8_t* controls)
+			: m_controls(_mm_loadu_si128(reinterpret_cast<const __m128i*>(controls)))
 		{}
 
-		// returns the flags of the given hash slot
-		HASH_FLAGS flags() const
+		uint32_t match(uint8_t control) const
 		{
-			if constexpr (sizeof(size_t) == 8)
-			{
-				return HASH_FLAGS((index & 0xC000000000000000) >> 62);
-			}
-			else if constexpr (sizeof(size_t) == 4)
-			{
-				return HASH_FLAGS((index & 0xC0000000) >> 30);
-			}
-			else
-			{
-				static_assert("unexpected sizeof(size_t)");
-			}
+			auto cmp = _mm_cmpeq_epi8(m_controls, _mm_set1_epi8(char(control)));
+			return uint32_t(_mm_movemask_epi8(cmp));
 		}
 
-		// returns the index into values array of the given hash slot
-		size_t valueIndex() const
+		uint32_t matchEmpty() const
 		{
-			if constexpr (sizeof(size_t) == 8)
-			{
-				return size_t(index & 0x3FFFFFFFFFFFFFFF);
-			}
-			else if constexpr (sizeof(size_t) == 4)
-			{
-				return size_t(index & 0x3FFFFFFF);
-			}
-			else
-			{
-				static_assert("unexpected sizeof(size_t)");
-			}
+			return match(HASH_CONTROL_EMPTY);
 		}
 
-		size_t valueHash() const
+		uint32_t matchEmptyOrDeleted() const
 		{
-			return hash;
+			return uint32_t(_mm_movemask_epi8(m_controls));
 		}
+#else
+		uint8_t m_controls[16];
 
-		// sets the flags of the given hash slot
-		void setFlags(HASH_FLAGS f)
+	public:
+		static constexpr size_t WIDTH = 16;
+
+		explicit HashGroup(const uint8_t* controls)
 		{
-			if constexpr (sizeof(size_t) == 8)
-			{
-				index &= ~0xC000000000000000;
-				index |= (size_t(f) << 62);
-			}
-			else if constexpr (sizeof(size_t) == 4)
-			{
-				index &= ~0xC0000000;
-				index |= (size_t(f) << 30);
-			}
-			else
+			::memcpy(m_controls, controls, WIDTH);
+		}
+
+		uint32_t match(uint8_t control) const
+		{
+			uint32_t res = 0;
+			for (size_t i = 0; i < WIDTH; ++i)
 			{
-				static_assert("unexpected sizeof(size_t)");
+				res |= uint32_t(m_controls[i] == control) << i;
 			}
+			return res;
 		}
 
-		// sets the index in values array of the given hash slot
-		void setValueIndex(size_t value_index)
+		uint32_t matchEmpty() const
 		{
-			if constexpr (sizeof(size_t) == 8)
+			return match(HASH_CONTROL_EMPTY);
+		}
+
+		uint32_t matchEmptyOrDeleted() const
+		{
+			uint32_t res = 0;
+			for (size_t i = 0; i < WIDTH; ++i)
 			{
-				index &= ~0x3FFFFFFFFFFFFFFF;
-				index |= (size_t(value_index) & 0x3FFFFFFFFFFFFFFF);
+				res |= uint32_t(m_controls[i] >> 7) << i;
 			}
-			else if constexpr (sizeof(size_t) == 4)
+			return res;
+		}
+#endif
+	};
+
+	// triangular probing over the groups of a table, it visits every group exactly once when the groups count is a
+	// power of 2
+	class HashProbe
+	{
+		size_t m_mask = 0;
+		size_t m_group = 0;
+		size_t m_step = 0;
+
+	public:
+		HashProbe(size_t hash, size_t slotsCount)
+			: m_mask(slotsCount / HashGroup::WIDTH - 1),
+			  m_group(hash & m_mask)
+		{}
+
+		// returns the index of the first slot in the current group
+		size_t offset() const
+		{
+			return m_group * HashGroup::WIDTH;
+		}
+
+		// moves to the next group, returns false if all the groups have been visited
+		bool next()
+		{
+			++m_step;
+			if (m_step > m_mask)
 			{
-				index &= ~0x3FFFFFFF;
-				index |= (size_t(value_index) & 0x3FFFFFFF);
+				return false;
 			}
-			else
+			m_group = (m_group + m_step) & m_mask;
+			return true;
+		}
+	};
+
+	// the work of an incremental rehash is done in steps of a bounded size by the inserts and removes which follow it,
+	// a step is a short pause compared to rehashing millions of slots at once but big enough that only a tiny fraction
+	// of the inserts do a step at all, so the rehash stays out of the 99th and 99.9th latency percentiles, see
+	// bench-hash-rehash
+	//
+	// the number of old table slots a step moves, a table has to move at most 8 old slots per insert or remove to
+	// finish before it's due for another rehash so a step is always more than enough
+	constexpr size_t HASH_REHASH_STEP_SLOTS_COUNT = 16 * 1024;
+
+	// the number of values a step moves while the values array grows, the new array has room for as many values as the
+	// old one so they're all moved long before it's full
+	constexpr size_t HASH_REHASH_STEP_VALUES_COUNT = 64 * 1024;
+
+	// the number of bytes of a newly allocated array a step touches (or sets to empty for the control bytes of a slots
+	// table) before anything is moved into it, fresh memory is usually backed by the os on its first access so touching
+	// it up front keeps the page faults out of the inserts which follow
+	constexpr size_t HASH_REHASH_STEP_TOUCH_BYTES = 2 * 1024 * 1024;
+
+	// touches the next chunk of the given array, returns false if all of it was already touched
+	template <typename T>
+	inline static bool hashTouchStep(Span<T> items, size_t& touched_count)
+	{
+		if (touched_count >= items.count())
+		{
+			return false;
+		}
+
+		auto end = touched_count + HASH_REHASH_STEP_TOUCH_BYTES / sizeof(T) + 1;
+		if (end > items.count())
+		{
+			end = items.count();
+		}
+
+		// one byte in every 4KB, the smallest page size we run on
+		auto it = (volatile char*)(items.data() + touched_count);
+		auto it_end = (volatile char*)(items.data() + end);
+		for (; it < it_end; it += 4096)
+		{
+			*it = *it;
+		}
+		touched_count = end;
+		return true;
+	}
+
+	// converts a key passed to a heterogeneous insert into the table's key type, keys which need an allocator (like
+	// String from a StringView) are constructed with the table's allocator
+	template <typename T, typename R>
+	inline static T hashMakeKey(R&& key, Allocator* allocator)
+	{
+		if constexpr (std::is_constructible_v<T, R&&>)
+		{
+			return T(std::forward<R>(key));
+		}
+		else
+		{
+			return T(std::forward<R>(key), allocator);
+		}
+	}
+
+	// returns the first empty or deleted slot in the probe sequence of the given hash
+	inline static size_t hashFindFreeSlot(Span<const uint8_t> controls, size_t hash)
+	{
+		HashProbe probe{hash, controls.count()};
+		do
+		{
+			auto offset = probe.offset();
+			if (auto mask = HashGroup{controls.data() + offset}.matchEmptyOrDeleted(); mask != 0)
 			{
-				static_assert("unexpected sizeof(size_t)");
+				return offset + std::countr_zero(mask);
 			}
 		}
-
-		// sets the hash of the value
-		void setValueHash(size_t value_hash)
+		while (probe.next());
+		unreachable();
+		return controls.count();
+	}
+
+	// marks the slot as free, returns true if it had to leave a tombstone behind
+	//
+	// an empty slot stops lookups, so a lookup never continues past a group which has an empty slot and no key can be
+	// placed after it in its probe sequence, so if the slot's group has an empty slot we can mark the slot as empty
+	// instead of deleted
+	inline static bool hashFreeSlot(Span<uint8_t> controls, size_t slot)
+	{
+		auto offset = slot - slot % HashGroup::WIDTH;
+		if (HashGroup{controls.data() + offset}.matchEmpty() != 0)
 		{
-			hash = value_hash;
+			controls[slot] = HASH_CONTROL_EMPTY;
+			return false;
 		}
-	};
+		else
+		{
+			controls[slot] = HASH_CONTROL_DELETED;
+			return true;
+		}
+	}
 
 	template <typename T, typename THash = Hash<T>>
 	class Set
 	{
 		Allocator* m_allocator = nullptr;
-		Span<HashSlot> m_slots;
+		// see HashSeed, it stays the same when the table is resized
+		size_t m_seed = 0;
+		// one control byte per slot, the table is probed a HashGroup at a time
+		Span<uint8_t> m_controls;
+		// the index into values array of each used slot
+		Span<size_t> m_indices;
 		size_t m_deletedCount = 0;
 		size_t m_usedCountThreshold = 0;
 		size_t m_usedCountShrinkThreshold = 0;
 		size_t m_deletedCountThreshold = 0;
+		// while an incremental rehash is in progress the slots which weren't moved to the new table yet live in the old
+		// table, see setIncrementalRehash
+		Span<uint8_t> m_oldControls;
+		Span<size_t> m_oldIndices;
+		// the next old table slot to be moved
+		size_t m_rehashIndex = 0;
+		// before an incremental rehash starts the next slots table is prepared a step at a time while the current table
+		// keeps taking the inserts, m_nextControlsInitCount control bytes of it were set to empty and
+		// m_touchedIndicesCount of its indices were touched, see HASH_REHASH_STEP_TOUCH_BYTES
+		Span<uint8_t> m_nextControls;
+		Span<size_t> m_nextIndices;
+		size_t m_nextControlsInitCount = 0;
+		size_t m_touchedIndicesCount = 0;
+		bool m_incrementalRehash = false;
 		Span<T> m_values;
 		size_t m_valuesCount = 0;
+		// while the values array grows in incremental mode the values in [m_valuesMoveIndex, m_oldValues.count()) still
+		// live in the old array, the following inserts and removes move them to the new array a step at a time
+		Span<T> m_oldValues;
+		size_t m_valuesMoveIndex = 0;
+		// the prefix of the new values array which was touched, see HASH_REHASH_STEP_TOUCH_BYTES
+		size_t m_touchedValuesCount = 0;
 
 		struct Search_Result
 		{
 			size_t hash;
 			size_t index;
+			bool found;
+			// true if the found slot is in the old table
+			bool inOldTable;
 		};
 
+		// the value at the given index, it's in the old values array if it wasn't moved yet
+		T& valueAt(size_t index)
+		{
+			if (index >= m_valuesMoveIndex && index < m_oldValues.count())
+			{
+				return m_oldValues[index];
+			}
+			return m_values[index];
+		}
+
+		const T& valueAt(size_t index) const
+		{
+			if (index >= m_valuesMoveIndex && index < m_oldValues.count())
+			{
+				return m_oldValues[index];
+			}
+			return m_values[index];
+		}
+
+		// returns the slot of the key in the given table, or the table's count if it's not there
+		template <typename R>
+		size_t findSlotInTable(
+			Span<const uint8_t> controls,
+			Span<const size_t> indices,
+			size_t hash,
+			const R& key) const
+		{
+			if (controls.count() == 0)
+			{
+				return 0;
+			}
+
+			auto control = hashControl(hash);
+			HashProbe probe{hash, controls.count()};
+			do
+			{
+				auto offset = probe.offset();
+				HashGroup group{controls.data() + offset};
+				for (auto mask = group.match(control); mask != 0; mask &= mask - 1)
+				{
+					auto ix = offset + std::countr_zero(mask);
+					if (valueAt(indices[ix]) == key)
+					{
+						return ix;
+					}
+				}
+
+				if (group.matchEmpty() != 0)
+				{
+					break;
+				}
+			}
+			while (probe.next());
+
+			return controls.count();
+		}
+
+		// allocates an empty slots table of the given count, it doesn't free the current one
+		void allocateSlots(size_t new_count)
+		{
+			m_controls = m_allocator->allocT<uint8_t>(new_count);
+			m_allocator->commitT(m_controls);
+			::memset(m_controls.data(), HASH_CONTROL_EMPTY, m_controls.sizeInBytes());
+
+			m_indices = m_allocator->allocT<size_t>(new_count);
+			m_allocator->commitT(m_indices);
+
+			resetThresholds(new_count);
+		}
+
+		void resetThresholds(size_t new_count)
+		{
+			m_deletedCount = 0;
+			// if 14/16th of table is used or deleted, grow or rebuild
+			m_usedCountThreshold = new_count - (new_count >> 3);
+			// if deleted count is 2/16th of table, rebuild instead of growing
+			m_deletedCountThreshold = new_count >> 3;
+			// if table is only 4/16th full, shrink
+			m_usedCountShrinkThreshold = new_count >> 2;
+		}
+
+		void freeSlots(Span<uint8_t>& controls, Span<size_t>& indices)
+		{
+			m_allocator->releaseT(controls);
+			m_allocator->freeT(controls);
+			m_allocator->releaseT(indices);
+			m_allocator->freeT(indices);
+			controls = Span<uint8_t>{};
+			indices = Span<size_t>{};
+		}
+
+		// copies the given slots table into a newly allocated one
+		void copySlots(
+			Span<uint8_t>& controls,
+			Span<size_t>& indices,
+			Span<const uint8_t> other_controls,
+			Span<const size_t> other_indices)
+		{
+			if (other_controls.count() == 0)
+			{
+				return;
+			}
+
+			controls = m_allocator->allocT<uint8_t>(other_controls.count());
+			m_allocator->commitT(controls);
+			::memcpy(controls.data(), other_controls.data(), controls.sizeInBytes());
+
+			indices = m_allocator->allocT<size_t>(other_indices.count());
+			m_allocator->commitT(indices);
+			::memcpy(indices.data(), other_indices.data(), indices.sizeInBytes());
+		}
+
 		void destroy()
 		{
 			for (size_t i = 0; i < m_valuesCount; ++i)
 			{
-				m_values[i].~T();
+				valueAt(i).~T();
 			}
 			m_allocator->releaseT(m_values);
 			m_allocator->freeT(m_values);
+			freeOldValues();
 
-			m_allocator->releaseT(m_slots);
-			m_allocator->freeT(m_slots);
+			freeSlots(m_controls, m_indices);
+			freeSlots(m_oldControls, m_oldIndices);
+			cancelPrepareRehash();
 
-			m_slots = Span<HashSlot>{};
+			m_rehashIndex = 0;
 			m_deletedCount = 0;
 			m_usedCountThreshold = 0;
 			m_usedCountShrinkThreshold = 0;
@@ -160,264 +411,453 @@ namespace core
 		void copyFrom(const Set& other)
 		{
 			m_allocator = other.m_allocator;
+			m_seed = other.m_seed;
 			m_deletedCount = other.m_deletedCount;
 			m_usedCountThreshold = other.m_usedCountThreshold;
 			m_usedCountShrinkThreshold = other.m_usedCountShrinkThreshold;
 			m_deletedCountThreshold = other.m_deletedCountThreshold;
+			m_rehashIndex = other.m_rehashIndex;
+			m_incrementalRehash = other.m_incrementalRehash;
 			m_valuesCount = other.m_valuesCount;
 
 			m_values = m_allocator->allocT<T>(m_valuesCount);
 			m_allocator->commitT(m_values);
 			for (size_t i = 0; i < m_valuesCount; ++i)
 			{
-				::new (&m_values[i]) T(other.m_values[i]);
-			}
-
-			m_slots = m_allocator->allocT<HashSlot>(other.m_slots.count());
-			m_allocator->commitT(m_slots);
-			for (auto& slot: m_slots)
-			{
-				::new (&slot) HashSlot();
+				::new (&m_values[i]) T(other.valueAt(i));
 			}
 
-			for (size_t i = 0; i < m_valuesCount; ++i)
-			{
-				auto res = findSlotForInsert(m_slots, m_values, m_values[i]);
-				auto& slot = m_slots[res.index];
-				auto flags = slot.flags();
-				switch (flags)
-				{
-				case HASH_FLAGS::HASH_EMPTY:
-				{
-					slot.setFlags(HASH_FLAGS::HASH_USED);
-					slot.setValueIndex(i);
-					slot.setValueHash(res.hash);
-					break;
-				}
-				case HASH_FLAGS::HASH_USED:
-				case HASH_FLAGS::HASH_DELETED:
-				default:
-					unreachable();
-					break;
-				}
-			}
+			// both tables have the same seed so the slots can be copied as is, including an in progress rehash, a
+			// rehash which is being prepared isn't copied, the copy is over its threshold too so its next insert starts
+			// the preparation over
+			copySlots(m_controls, m_indices, other.m_controls, other.m_indices);
+			copySlots(m_oldControls, m_oldIndices, other.m_oldControls, other.m_oldIndices);
 		}
 
 		void moveFrom(Set& other)
 		{
 			m_allocator = other.m_allocator;
-			m_slots = other.m_slots;
+			m_seed = other.m_seed;
+			m_controls = other.m_controls;
+			m_indices = other.m_indices;
 			m_deletedCount = other.m_deletedCount;
 			m_usedCountThreshold = other.m_usedCountThreshold;
 			m_usedCountShrinkThreshold = other.m_usedCountShrinkThreshold;
 			m_deletedCountThreshold = other.m_deletedCountThreshold;
+			m_oldControls = other.m_oldControls;
+			m_oldIndices = other.m_oldIndices;
+			m_rehashIndex = other.m_rehashIndex;
+			m_nextControls = other.m_nextControls;
+			m_nextIndices = other.m_nextIndices;
+			m_nextControlsInitCount = other.m_nextControlsInitCount;
+			m_touchedIndicesCount = other.m_touchedIndicesCount;
+			m_incrementalRehash = other.m_incrementalRehash;
 			m_values = other.m_values;
 			m_valuesCount = other.m_valuesCount;
-
-			other.m_slots = Span<HashSlot>{};
+			m_oldValues = other.m_oldValues;
+			m_valuesMoveIndex = other.m_valuesMoveIndex;
+			m_touchedValuesCount = other.m_touchedValuesCount;
+
+			other.m_controls = Span<uint8_t>{};
+			other.m_indices = Span<size_t>{};
+			other.m_oldControls = Span<uint8_t>{};
+			other.m_oldIndices = Span<size_t>{};
+			other.m_rehashIndex = 0;
+			other.m_nextControls = Span<uint8_t>{};
+			other.m_nextIndices = Span<size_t>{};
+			other.m_nextControlsInitCount = 0;
+			other.m_touchedIndicesCount = 0;
 			other.m_deletedCount = 0;
 			other.m_usedCountThreshold = 0;
 			other.m_usedCountShrinkThreshold = 0;
 			other.m_deletedCountThreshold = 0;
 			other.m_values = Span<T>{};
 			other.m_valuesCount = 0;
+			other.m_oldValues = Span<T>{};
+			other.m_valuesMoveIndex = 0;
+			other.m_touchedValuesCount = 0;
 		}
 
-		Search_Result findSlotForInsert(Span<const HashSlot> _slots, Span<const T> _values, const T& key)
+		// returns the slot of the key if it exists, otherwise returns the first free slot in its probe sequence
+		template <typename R>
+		Search_Result findSlotForInsert(const R& key, size_t hash) const
 		{
 			Search_Result res{};
-			res.hash = THash{}(key, size_t(_slots.data()));
+			res.hash = hash;
 
-			auto cap = _slots.count();
+			auto cap = m_controls.count();
+			res.index = cap;
 			if (cap == 0)
 			{
 				return res;
 			}
 
-			auto index = res.hash & (cap - 1);
-			auto ix = index;
-
-			size_t first_deleted_slot_index = 0;
-			bool found_first_deleted_slot = false;
-
-			// linear probing
-			while (true)
+			auto control = hashControl(res.hash);
+			HashProbe probe{res.hash, cap};
+			do
 			{
-				const auto& slot = _slots[ix];
-				auto slot_hash = slot.valueHash();
-				auto slot_index = slot.valueIndex();
-				auto slot_flags = slot.flags();
-				switch (slot_flags)
-				{
-				// this position is not empty but if it's the same value then we return it
-				case HASH_USED:
+				auto offset = probe.offset();
+				HashGroup group{m_controls.data() + offset};
+				for (auto mask = group.match(control); mask != 0; mask &= mask - 1)
 				{
-					if (slot_hash == res.hash && _values[slot_index] == key)
+					auto ix = offset + std::countr_zero(mask);
+					if (valueAt(m_indices[ix]) == key)
 					{
 						res.index = ix;
+						res.found = true;
 						return res;
 					}
-					break;
 				}
-				// this is an empty slot then we can use it
-				case HASH_EMPTY:
+
+				// remember the first free slot, we still have to make sure the key doesn't exist later in the sequence
+				if (res.index == cap)
 				{
-					// we didn't find the key, so check the first deleted slot if we found one then
-					// reuse it
-					if (found_first_deleted_slot)
-					{
-						res.index = first_deleted_slot_index;
-					}
-					// we didn't find the key, so use the first empty slot
-					else
+					if (auto mask = group.matchEmptyOrDeleted(); mask != 0)
 					{
-						res.index = ix;
+						res.index = offset + std::countr_zero(mask);
 					}
-					return res;
 				}
-				case HASH_DELETED:
+
+				// the key is not in the table if the group has an empty slot
+				if (group.matchEmpty() != 0)
 				{
-					if (found_first_deleted_slot == false)
-					{
-						first_deleted_slot_index = ix;
-						found_first_deleted_slot = true;
-					}
 					break;
 				}
-				default:
-					unreachable();
-					return {};
+			}
+			while (probe.next());
+
+			if (auto ix = findSlotInTable(m_oldControls, m_oldIndices, res.hash, key); ix < m_oldControls.count())
+			{
+				res.index = ix;
+				res.found = true;
+				res.inOldTable = true;
+			}
+			return res;
+		}
+
+		template <typename R>
+		Search_Result findSlotForLookup(const R& key, size_t hash) const
+		{
+			Search_Result res{};
+			res.hash = hash;
+			res.index = findSlotInTable(m_controls, m_indices, res.hash, key);
+			res.found = res.index < m_controls.count();
+			if (res.found == false)
+			{
+				if (auto ix = findSlotInTable(m_oldControls, m_oldIndices, res.hash, key); ix < m_oldControls.count())
+				{
+					res.index = ix;
+					res.found = true;
+					res.inOldTable = true;
 				}
+			}
+			return res;
+		}
+
+		// returns the slot which points to the given value index, it doesn't compare the values, it returns the table's
+		// count if it's not there
+		static size_t findSlotOfValueIndex(
+			Span<const uint8_t> controls,
+			Span<const size_t> indices,
+			size_t hash,
+			size_t value_index)
+		{
+			if (controls.count() == 0)
+			{
+				return 0;
+			}
 
-				// the position is not empty and the key is not the same
-				++ix;
-				ix &= (cap - 1);
+			auto control = hashControl(hash);
+			HashProbe probe{hash, controls.count()};
+			do
+			{
+				auto offset = probe.offset();
+				HashGroup group{controls.data() + offset};
+				for (auto mask = group.match(control); mask != 0; mask &= mask - 1)
+				{
+					auto ix = offset + std::countr_zero(mask);
+					if (indices[ix] == value_index)
+					{
+						return ix;
+					}
+				}
 
-				// if we went full circle then we just return the cap to signal no index has been found
-				if (ix == index)
+				if (group.matchEmpty() != 0)
 				{
-					ix = cap;
 					break;
 				}
 			}
-
-			res.index = ix;
-			return res;
+			while (probe.next());
+			return controls.count();
 		}
 
-		Search_Result findSlotForLookup(const T& key) const
+		// rebuilds the slots table at once, it also finishes any in progress incremental rehash
+		void reserveExact(size_t new_count)
 		{
-			Search_Result res{};
-			res.hash = THash{}(key, size_t(m_slots.data()));
+			freeSlots(m_oldControls, m_oldIndices);
+			freeSlots(m_controls, m_indices);
+			cancelPrepareRehash();
+			m_rehashIndex = 0;
+			allocateSlots(new_count);
 
-			auto cap = m_slots.count();
-			if (cap == 0)
+			// do a rehash, values are unique so we only need to find a free slot for each one
+			for (size_t i = 0; i < m_valuesCount; ++i)
 			{
-				return res;
+				auto hash = THash{}(valueAt(i), m_seed);
+				auto ix = hashFindFreeSlot(m_controls, hash);
+				m_controls[ix] = hashControl(hash);
+				m_indices[ix] = i;
 			}
+		}
 
-			auto index = res.hash & (cap - 1);
-			auto ix = index;
+		bool isRehashing() const
+		{
+			return m_oldControls.count() > 0;
+		}
 
-			// linear probing
-			while (true)
+		// moves the used slots of the old table in the range [m_rehashIndex, m_rehashIndex + slots_count) to the new
+		// table, frees the old table once all of its slots are moved
+		void rehashStep(size_t slots_count)
+		{
+			auto end = m_rehashIndex + slots_count;
+			if (end > m_oldControls.count())
 			{
-				const auto& slot = m_slots[ix];
-				auto slot_hash = slot.valueHash();
-				auto slot_index = slot.valueIndex();
-				auto slot_flags = slot.flags();
+				end = m_oldControls.count();
+			}
 
-				// if the cell is empty then we didn't find the value
-				if (slot_flags == HASH_FLAGS::HASH_EMPTY)
+			for (; m_rehashIndex < end; ++m_rehashIndex)
+			{
+				// empty and deleted slots have the most significant bit set
+				auto control = m_oldControls[m_rehashIndex];
+				if (control & HASH_CONTROL_EMPTY)
 				{
-					ix = cap;
-					break;
+					continue;
 				}
 
-				// if the cell is used and it's the same value then we found it
-				if (slot_flags == HASH_FLAGS::HASH_USED && slot_hash == res.hash && m_values[slot_index] == key)
+				// the new table has no copy of the value so we only need to find a free slot for it, the control byte
+				// is the same since both tables have the same seed
+				auto value_index = m_oldIndices[m_rehashIndex];
+				auto ix = hashFindFreeSlot(m_controls, THash{}(valueAt(value_index), m_seed));
+				if (m_controls[ix] == HASH_CONTROL_DELETED)
 				{
-					break;
+					--m_deletedCount;
 				}
+				m_controls[ix] = control;
+				m_indices[ix] = value_index;
+
+				// lookups check the new table first, so the moved slot can't be found twice
+				m_oldControls[m_rehashIndex] = HASH_CONTROL_DELETED;
+			}
 
-				// the position is not used or the key is not the same
-				++ix;
-				ix &= (cap - 1);
+			if (m_rehashIndex == m_oldControls.count())
+			{
+				freeSlots(m_oldControls, m_oldIndices);
+				m_rehashIndex = 0;
+			}
+		}
+
+		void finishRehash()
+		{
+			if (isRehashing())
+			{
+				rehashStep(m_oldControls.count());
+			}
+		}
+
+		bool isPreparingRehash() const
+		{
+			return m_nextControls.count() > 0;
+		}
+
+		void cancelPrepareRehash()
+		{
+			freeSlots(m_nextControls, m_nextIndices);
+			m_nextControlsInitCount = 0;
+			m_touchedIndicesCount = 0;
+		}
 
-				// if we went full circle then we just return the cap to signal no index has been found
-				if (ix == index)
+		// the prepared table replaces the current one which becomes the old table
+		void startRehash()
+		{
+			m_oldControls = m_controls;
+			m_oldIndices = m_indices;
+			m_rehashIndex = 0;
+			m_controls = m_nextControls;
+			m_indices = m_nextIndices;
+			m_nextControls = Span<uint8_t>{};
+			m_nextIndices = Span<size_t>{};
+			m_nextControlsInitCount = 0;
+			m_touchedIndicesCount = 0;
+			resetThresholds(m_controls.count());
+		}
+
+		// sets the next chunk of the next table's control bytes to empty, then touches its indices, and starts the
+		// rehash once it's all done
+		void prepareRehashStep()
+		{
+			if (m_nextControlsInitCount < m_nextControls.count())
+			{
+				auto count = m_nextControls.count() - m_nextControlsInitCount;
+				if (count > HASH_REHASH_STEP_TOUCH_BYTES)
 				{
-					ix = cap;
-					break;
+					count = HASH_REHASH_STEP_TOUCH_BYTES;
 				}
+				::memset(m_nextControls.data() + m_nextControlsInitCount, HASH_CONTROL_EMPTY, count);
+				m_nextControlsInitCount += count;
 			}
+			else if (hashTouchStep(m_nextIndices, m_touchedIndicesCount) == false)
+			{
+				startRehash();
+			}
+		}
 
-			res.index = ix;
-			return res;
+		void finishPrepareRehash()
+		{
+			::memset(
+				m_nextControls.data() + m_nextControlsInitCount,
+				HASH_CONTROL_EMPTY,
+				m_nextControls.count() - m_nextControlsInitCount);
+			startRehash();
 		}
 
-		void reserveExact(size_t new_count)
+		// resizes the slots table, in incremental mode the next table is prepared a step at a time by the following
+		// inserts and removes, then the current table becomes the old table which is moved to the new table a step at
+		// a time too, so no single insert pays for the whole table
+		void rehash(size_t new_count)
 		{
-			auto new_slots = m_allocator->allocT<HashSlot>(new_count);
-			m_allocator->commitT(new_slots);
-			for (auto& slot: new_slots)
+			if (m_incrementalRehash == false || m_valuesCount == 0)
 			{
-				::new (&slot) HashSlot();
+				reserveExact(new_count);
+				return;
 			}
 
-			m_deletedCount = 0;
-			// if 12/16th of table is occupied, grow
-			m_usedCountThreshold = new_count - (new_count >> 2);
-			// if deleted count is 3/16th of table, rebuild
-			m_deletedCountThreshold = (new_count >> 3) + (new_count >> 4);
-			// if table is only 4/16th full, shrink
-			m_usedCountShrinkThreshold = new_count >> 2;
-
-			// do a rehash
-			if (m_valuesCount != 0)
+			if (isPreparingRehash() && m_nextControls.count() == new_count)
 			{
-				for (size_t i = 0; i < m_valuesCount; ++i)
+				// the current table has 1/8th of its slots free when the preparation starts which is a lot more than
+				// the steps it takes, it's finished at once only if the table is about to fill up anyway
+				if (m_valuesCount + m_deletedCount + 1 >= m_controls.count())
 				{
-					auto res = findSlotForInsert(new_slots, m_values, m_values[i]);
-					auto& slot = new_slots[res.index];
-					auto flags = slot.flags();
-					switch (flags)
-					{
-					case HASH_FLAGS::HASH_EMPTY:
-					{
-						slot.setFlags(HASH_FLAGS::HASH_USED);
-						slot.setValueIndex(i);
-						slot.setValueHash(res.hash);
-						break;
-					}
-					case HASH_FLAGS::HASH_USED:
-					case HASH_FLAGS::HASH_DELETED:
-					default:
-						unreachable();
-						break;
-					}
+					finishPrepareRehash();
 				}
+				return;
 			}
 
-			m_allocator->releaseT(m_slots);
-			m_allocator->freeT(m_slots);
-			m_slots = new_slots;
+			finishRehash();
+			cancelPrepareRehash();
+			m_nextControls = m_allocator->allocT<uint8_t>(new_count);
+			m_allocator->commitT(m_nextControls);
+			m_nextIndices = m_allocator->allocT<size_t>(new_count);
+			m_allocator->commitT(m_nextIndices);
+
+			// a table which fits in a single step is prepared right away
+			if (new_count * (sizeof(uint8_t) + sizeof(size_t)) <= HASH_REHASH_STEP_TOUCH_BYTES)
+			{
+				finishPrepareRehash();
+			}
+		}
+
+		void rehashStepIfRehashing()
+		{
+			if (isPreparingRehash())
+			{
+				prepareRehashStep();
+			}
+			else if (isRehashing())
+			{
+				rehashStep(HASH_REHASH_STEP_SLOTS_COUNT);
+			}
 		}
 
 		void maintainSpaceComplexity()
 		{
-			if (m_slots.count() == 0)
+			rehashStepIfRehashing();
+
+			if (m_controls.count() == 0)
+			{
+				reserveExact(HashGroup::WIDTH);
+			}
+			else if (m_valuesCount + m_deletedCount + 1 > m_usedCountThreshold)
+			{
+				// if enough of the slots are tombstones then rebuilding the table in place frees them
+				if (m_deletedCount > m_deletedCountThreshold)
+				{
+					rehash(m_controls.count());
+				}
+				else
+				{
+					rehash(m_controls.count() * 2);
+				}
+			}
+		}
+
+		bool isMovingValues() const
+		{
+			return m_oldValues.count() > 0;
+		}
+
+		void freeOldValues()
+		{
+			m_allocator->releaseT(m_oldValues);
+			m_allocator->freeT(m_oldValues);
+			m_oldValues = Span<T>{};
+			m_valuesMoveIndex = 0;
+		}
+
+		// moves the values in [m_valuesMoveIndex, m_valuesMoveIndex + values_count) from the old values array to the
+		// new one, values keep their index so the slots don't change, frees the old array once it has no values left
+		void valuesMoveStep(size_t values_count)
+		{
+			// removes fill their holes from the end so the old array has no values past the values count
+			auto used_end = m_valuesCount < m_oldValues.count() ? m_valuesCount : m_oldValues.count();
+			auto end = m_valuesMoveIndex + values_count;
+			if (end > used_end)
 			{
-				reserveExact(8);
+				end = used_end;
 			}
-			else if (m_valuesCount + 1 > m_usedCountThreshold)
+
+			for (; m_valuesMoveIndex < end; ++m_valuesMoveIndex)
+			{
+				::new (&m_values[m_valuesMoveIndex]) T(std::move_if_noexcept(m_oldValues[m_valuesMoveIndex]));
+				m_oldValues[m_valuesMoveIndex].~T();
+			}
+
+			if (m_valuesMoveIndex >= used_end)
+			{
+				freeOldValues();
+			}
+		}
+
+		void valuesMoveStepIfMoving()
+		{
+			if (isMovingValues() && hashTouchStep(m_values, m_touchedValuesCount) == false)
+			{
+				valuesMoveStep(HASH_REHASH_STEP_VALUES_COUNT);
+			}
+		}
+
+		void finishValuesMove()
+		{
+			if (isMovingValues())
 			{
-				reserveExact(m_slots.count() * 2);
+				valuesMoveStep(m_oldValues.count());
 			}
 		}
 
+		// in incremental mode the values array grows by moving the values to the new array a step at a time, see
+		// valuesMoveStep, instead of pausing to move all of them
+		void valuesStartMove(size_t new_capacity)
+		{
+			finishValuesMove();
+			m_oldValues = m_values;
+			m_valuesMoveIndex = 0;
+			m_values = m_allocator->allocT<T>(new_capacity);
+			m_allocator->commitT(m_values);
+			m_touchedValuesCount = 0;
+		}
+
 		void valuesGrow(size_t new_capacity)
 		{
+			finishValuesMove();
 			auto new_values = m_allocator->allocT<T>(new_capacity);
 			m_allocator->commitT(new_values);
 			for (size_t i = 0; i < m_valuesCount; ++i)
@@ -454,7 +894,14 @@ namespace core
 					new_capacity = m_values.count() + i;
 				}
 
-				valuesGrow(new_capacity);
+				if (m_incrementalRehash && m_valuesCount > 0)
+				{
+					valuesStartMove(new_capacity);
+				}
+				else
+				{
+					valuesGrow(new_capacity);
+				}
 			}
 		}
 
@@ -463,7 +910,7 @@ namespace core
 		{
 			valuesEnsureSpaceExists();
 			m_allocator->commitT(m_values.slice(m_valuesCount, m_valuesCount + 1));
-			::new (&m_values[m_valuesCount]) T(std::forward<R>(key));
+			::new (&valueAt(m_valuesCount)) T(hashMakeKey<T>(std::forward<R>(key), m_allocator));
 			++m_valuesCount;
 		}
 
@@ -472,12 +919,77 @@ namespace core
 			valuesGrow(m_valuesCount);
 		}
 
+		// values live in two arrays while the values array grows in incremental mode, so iterators walk the values by
+		// index instead of by pointer
+		template <typename TEntry>
+		class IteratorBase
+		{
+			friend class Set;
+			template <typename>
+			friend class IteratorBase;
+
+			using Table = std::conditional_t<std::is_const_v<TEntry>, const Set, Set>;
+
+			Table* m_table = nullptr;
+			size_t m_index = 0;
+
+			IteratorBase(Table* table, size_t index)
+				: m_table(table),
+				  m_index(index)
+			{}
+
+		public:
+			IteratorBase() = default;
+
+			operator IteratorBase<const TEntry>() const
+			{
+				return IteratorBase<const TEntry>{m_table, m_index};
+			}
+
+			TEntry& operator*() const
+			{
+				return m_table->valueAt(m_index);
+			}
+
+			TEntry* operator->() const
+			{
+				return &m_table->valueAt(m_index);
+			}
+
+			TEntry& operator[](size_t offset) const
+			{
+				return m_table->valueAt(m_index + offset);
+			}
+
+			IteratorBase& operator++()
+			{
+				++m_index;
+				return *this;
+			}
+
+			bool operator==(const IteratorBase& other) const
+			{
+				return m_table == other.m_table && m_index == other.m_index;
+			}
+
+			bool operator!=(const IteratorBase& other) const
+			{
+				return !operator==(other);
+			}
+		};
+
 	public:
-		using Iterator = T*;
-		using ConstIterator = T const*;
+		using Iterator = IteratorBase<T>;
+		using ConstIterator = IteratorBase<const T>;
 
 		explicit Set(Allocator* a)
-			: m_allocator(a)
+			: m_allocator(a),
+			  m_seed(HashSeed::random().value())
+		{}
+
+		Set(Allocator* a, HashSeed seed)
+			: m_allocator(a),
+			  m_seed(seed.value())
 		{}
 
 		Set(const Set& other)
@@ -509,55 +1021,54 @@ namespace core
 			destroy();
 		}
 
+		// the key can be of any type which THash can hash and compare equal to the table's key type, it's only
+		// converted to the key type if it doesn't exist, allocator aware keys (like String from StringView) are
+		// constructed using the table's allocator
 		template <typename R>
 		void insert(R&& key)
 		{
-			maintainSpaceComplexity();
+			auto hash = THash{}(key, m_seed);
+			insertWithHash(std::forward<R>(key), hash);
+		}
 
-			auto res = findSlotForInsert(m_slots, m_values, key);
+		// same as insert but with the key's hash precomputed, the hash must be THash{}(key, seed().value())
+		template <typename R>
+		void insertWithHash(R&& key, size_t hash)
+		{
+			maintainSpaceComplexity();
 
-			auto& slot = m_slots[res.index];
-			auto flags = slot.flags();
-			switch (flags)
+			auto res = findSlotForInsert(key, hash);
+			if (res.found)
 			{
-			case HASH_EMPTY:
-			{
-				slot.setFlags(HASH_USED);
-				slot.setValueIndex(m_valuesCount);
-				slot.setValueHash(res.hash);
-				valuesPush(std::forward<R>(key));
+				// the key already exists
 				return;
 			}
-			case HASH_DELETED:
+
+			if (m_controls[res.index] == HASH_CONTROL_DELETED)
 			{
-				slot.setFlags(HASH_USED);
-				slot.setValueIndex(m_valuesCount);
-				slot.setValueHash(res.hash);
 				--m_deletedCount;
-				valuesPush(std::forward<R>(key));
-			}
-			case HASH_USED:
-			{
-				return;
-			}
-			default:
-			{
-				unreachable();
-				return;
-			}
 			}
+			m_controls[res.index] = hashControl(res.hash);
+			m_indices[res.index] = m_valuesCount;
+			valuesPush(std::forward<R>(key));
+			// values move after the operation since the given key may refer to a value of the table
+			valuesMoveStepIfMoving();
 		}
 
 		void clear()
 		{
-			for (auto& slot: m_slots)
+			freeSlots(m_oldControls, m_oldIndices);
+			cancelPrepareRehash();
+			m_rehashIndex = 0;
+			if (m_controls.count() > 0)
 			{
-				slot = HashSlot{};
+				::memset(m_controls.data(), HASH_CONTROL_EMPTY, m_controls.sizeInBytes());
 			}
-			for (auto& value: m_values)
+			for (size_t i = 0; i < m_valuesCount; ++i)
 			{
-				value.~T();
+				valueAt(i).~T();
 			}
+			freeOldValues();
 			m_valuesCount = 0;
 			m_deletedCount = 0;
 		}
@@ -567,6 +1078,12 @@ namespace core
 			return m_allocator;
 		}
 
+		// the seed which is passed to THash, tables with the same seed agree on the hash of each key
+		HashSeed seed() const
+		{
+			return HashSeed{m_seed};
+		}
+
 		size_t count() const
 		{
 			return m_valuesCount;
@@ -574,7 +1091,7 @@ namespace core
 
 		size_t capacity() const
 		{
-			return m_slots.count();
+			return m_controls.count();
 		}
 
 		void reserve(size_t added_count)
@@ -611,6 +1128,10 @@ namespace core
 					}
 					++new_cap;
 				}
+				if (new_cap < HashGroup::WIDTH)
+				{
+					new_cap = HashGroup::WIDTH;
+				}
 				reserveExact(new_cap);
 			}
 		}
@@ -618,64 +1139,121 @@ namespace core
 		template <typename R>
 		ConstIterator lookup(const R& key) const
 		{
-			auto res = findSlotForLookup(key);
-			if (res.index == m_slots.count())
+			return lookupWithHash(key, THash{}(key, m_seed));
+		}
+
+		// same as lookup but with the key's hash precomputed, the hash must be THash{}(key, seed().value())
+		template <typename R>
+		ConstIterator lookupWithHash(const R& key, size_t hash) const
+		{
+			auto res = findSlotForLookup(key, hash);
+			if (res.found == false)
 			{
-				return nullptr;
+				return end();
 			}
-			auto& slot = m_slots[res.index];
-			auto index = slot.valueIndex();
-			return &m_values[index];
+			auto index = res.inOldTable ? m_oldIndices[res.index] : m_indices[res.index];
+			return ConstIterator{this, index};
 		}
 
 		template <typename R>
 		bool remove(const R& key)
 		{
-			auto res = findSlotForLookup(key);
-			if (res.index == m_slots.count())
+			return removeWithHash(key, THash{}(key, m_seed));
+		}
+
+		// same as remove but with the key's hash precomputed, the hash must be THash{}(key, seed().value())
+		template <typename R>
+		bool removeWithHash(const R& key, size_t hash)
+		{
+			rehashStepIfRehashing();
+
+			auto res = findSlotForLookup(key, hash);
+			if (res.found == false)
 			{
 				return false;
 			}
-			auto& slot = m_slots[res.index];
-			auto index = slot.valueIndex();
-			slot.setFlags(HASH_DELETED);
 
-			m_values[index].~T();
+			size_t index = 0;
+			if (res.inOldTable)
+			{
+				index = m_oldIndices[res.index];
+				m_oldControls[res.index] = HASH_CONTROL_DELETED;
+			}
+			else
+			{
+				index = m_indices[res.index];
+				if (hashFreeSlot(m_controls, res.index))
+				{
+					++m_deletedCount;
+				}
+			}
+
+			valueAt(index).~T();
 
 			if (index < m_valuesCount - 1)
 			{
 				// fixup the index of the last element after swap
-				auto last_res = findSlotForLookup(m_values[m_valuesCount - 1]);
-				m_slots[last_res.index].setValueIndex(index);
-				::new (&m_values[index]) T(std::move_if_noexcept(m_values[m_valuesCount - 1]));
-				m_values[m_valuesCount - 1].~T();
+				auto last_hash = THash{}(valueAt(m_valuesCount - 1), m_seed);
+				auto last_slot = findSlotOfValueIndex(m_controls, m_indices, last_hash, m_valuesCount - 1);
+				if (last_slot < m_controls.count())
+				{
+					m_indices[last_slot] = index;
+				}
+				else
+				{
+					last_slot = findSlotOfValueIndex(m_oldControls, m_oldIndices, last_hash, m_valuesCount - 1);
+					m_oldIndices[last_slot] = index;
+				}
+				::new (&valueAt(index)) T(std::move_if_noexcept(valueAt(m_valuesCount - 1)));
+				valueAt(m_valuesCount - 1).~T();
 			}
 
 			--m_valuesCount;
-			++m_deletedCount;
 
 			// rehash because of size is too low
-			if (m_valuesCount < m_usedCountShrinkThreshold && m_slots.count() > 8)
+			if (m_valuesCount < m_usedCountShrinkThreshold && m_controls.count() > HashGroup::WIDTH)
 			{
-				reserveExact(m_slots.count() >> 1);
-				valuesShrinkToFit();
+				rehash(m_controls.count() >> 1);
+				// shrinking the values array moves all of them, so incremental mode keeps the memory instead of pausing
+				if (m_incrementalRehash == false)
+				{
+					valuesShrinkToFit();
+				}
 			}
-			// rehash because of too many deleted values
-			else if (m_deletedCount > m_deletedCountThreshold)
+			valuesMoveStepIfMoving();
+			return true;
+		}
+
+		// in incremental mode growing, shrinking or rebuilding the table and growing the values array don't move all
+		// the slots and values at once, instead the following inserts and removes move them a bounded step at a time,
+		// this bounds the latency of a single insert at the cost of lookups checking two tables while a rehash is in
+		// progress, disabling it finishes any in progress rehash
+		void setIncrementalRehash(bool enabled)
+		{
+			m_incrementalRehash = enabled;
+			if (enabled == false)
 			{
-				reserveExact(m_slots.count());
+				// the current table is still complete while the next one is prepared so it's dropped, the next insert
+				// rehashes at once
+				cancelPrepareRehash();
+				finishRehash();
+				finishValuesMove();
 			}
-			return true;
+		}
+
+		bool incrementalRehash() const
+		{
+			return m_incrementalRehash;
 		}
 
 		ConstIterator begin() const
 		{
-			return m_values.sliceLeft(m_valuesCount).begin();
+			return ConstIterator{this, 0};
 		}
 
 		ConstIterator end() const
 		{
-			return m_values.sliceLeft(m_valuesCount).end();
+			return ConstIterator{this, m_valuesCount};
 		}
 	};
 
@@ -690,33 +1268,175 @@ namespace core
 	class Map
 	{
 		Allocator* m_allocator = nullptr;
-		Span<HashSlot> m_slots;
+		// see HashSeed, it stays the same when the table is resized
+		size_t m_seed = 0;
+		// one control byte per slot, the table is probed a HashGroup at a time
+		Span<uint8_t> m_controls;
+		// the index into values array of each used slot
+		Span<size_t> m_indices;
 		size_t m_deletedCount = 0;
 		size_t m_usedCountThreshold = 0;
 		size_t m_usedCountShrinkThreshold = 0;
 		size_t m_deletedCountThreshold = 0;
+		// while an incremental rehash is in progress the slots which weren't moved to the new table yet live in the old
+		// table, see setIncrementalRehash
+		Span<uint8_t> m_oldControls;
+		Span<size_t> m_oldIndices;
+		// the next old table slot to be moved
+		size_t m_rehashIndex = 0;
+		// before an incremental rehash starts the next slots table is prepared a step at a time while the current table
+		// keeps taking the inserts, m_nextControlsInitCount control bytes of it were set to empty and
+		// m_touchedIndicesCount of its indices were touched, see HASH_REHASH_STEP_TOUCH_BYTES
+		Span<uint8_t> m_nextControls;
+		Span<size_t> m_nextIndices;
+		size_t m_nextControlsInitCount = 0;
+		size_t m_touchedIndicesCount = 0;
+		bool m_incrementalRehash = false;
 		Span<KeyValue<const TKey, TValue>> m_values;
 		size_t m_valuesCount = 0;
+		// while the values array grows in incremental mode the values in [m_valuesMoveIndex, m_oldValues.count()) still
+		// live in the old array, the following inserts and removes move them to the new array a step at a time
+		Span<KeyValue<const TKey, TValue>> m_oldValues;
+		size_t m_valuesMoveIndex = 0;
+		// the prefix of the new values array which was touched, see HASH_REHASH_STEP_TOUCH_BYTES
+		size_t m_touchedValuesCount = 0;
 
 		struct Search_Result
 		{
-			size_t hash;
-			size_t index;
-		};
+			size_t hash;
+			size_t index;
+			bool found;
+			// true if the found slot is in the old table
+			bool inOldTable;
+		};
+
+		// the value at the given index, it's in the old values array if it wasn't moved yet
+		KeyValue<const TKey, TValue>& valueAt(size_t index)
+		{
+			if (index >= m_valuesMoveIndex && index < m_oldValues.count())
+			{
+				return m_oldValues[index];
+			}
+			return m_values[index];
+		}
+
+		const KeyValue<const TKey, TValue>& valueAt(size_t index) const
+		{
+			if (index >= m_valuesMoveIndex && index < m_oldValues.count())
+			{
+				return m_oldValues[index];
+			}
+			return m_values[index];
+		}
+
+		// returns the slot of the key in the given table, or the table's count if it's not there
+		template <typename R>
+		size_t findSlotInTable(
+			Span<const uint8_t> controls,
+			Span<const size_t> indices,
+			size_t hash,
+			const R& key) const
+		{
+			if (controls.count() == 0)
+			{
+				return 0;
+			}
+
+			auto control = hashControl(hash);
+			HashProbe probe{hash, controls.count()};
+			do
+			{
+				auto offset = probe.offset();
+				HashGroup group{controls.data() + offset};
+				for (auto mask = group.match(control); mask != 0; mask &= mask - 1)
+				{
+					auto ix = offset + std::countr_zero(mask);
+					if (valueAt(indices[ix]).key == key)
+					{
+						return ix;
+					}
+				}
+
+				if (group.matchEmpty() != 0)
+				{
+					break;
+				}
+			}
+			while (probe.next());
+
+			return controls.count();
+		}
+
+		// allocates an empty slots table of the given count, it doesn't free the current one
+		void allocateSlots(size_t new_count)
+		{
+			m_controls = m_allocator->allocT<uint8_t>(new_count);
+			m_allocator->commitT(m_controls);
+			::memset(m_controls.data(), HASH_CONTROL_EMPTY, m_controls.sizeInBytes());
+
+			m_indices = m_allocator->allocT<size_t>(new_count);
+			m_allocator->commitT(m_indices);
+
+			resetThresholds(new_count);
+		}
+
+		void resetThresholds(size_t new_count)
+		{
+			m_deletedCount = 0;
+			// if 14/16th of table is used or deleted, grow or rebuild
+			m_usedCountThreshold = new_count - (new_count >> 3);
+			// if deleted count is 2/16th of table, rebuild instead of growing
+			m_deletedCountThreshold = new_count >> 3;
+			// if table is only 4/16th full, shrink
+			m_usedCountShrinkThreshold = new_count >> 2;
+		}
+
+		void freeSlots(Span<uint8_t>& controls, Span<size_t>& indices)
+		{
+			m_allocator->releaseT(controls);
+			m_allocator->freeT(controls);
+			m_allocator->releaseT(indices);
+			m_allocator->freeT(indices);
+			controls = Span<uint8_t>{};
+			indices = Span<size_t>{};
+		}
+
+		// copies the given slots table into a newly allocated one
+		void copySlots(
+			Span<uint8_t>& controls,
+			Span<size_t>& indices,
+			Span<const uint8_t> other_controls,
+			Span<const size_t> other_indices)
+		{
+			if (other_controls.count() == 0)
+			{
+				return;
+			}
+
+			controls = m_allocator->allocT<uint8_t>(other_controls.count());
+			m_allocator->commitT(controls);
+			::memcpy(controls.data(), other_controls.data(), controls.sizeInBytes());
+
+			indices = m_allocator->allocT<size_t>(other_indices.count());
+			m_allocator->commitT(indices);
+			::memcpy(indices.data(), other_indices.data(), indices.sizeInBytes());
+		}
 
 		void destroy()
 		{
 			for (size_t i = 0; i < m_valuesCount; ++i)
 			{
-				m_values[i].~KeyValue();
+				valueAt(i).~KeyValue();
 			}
 			m_allocator->releaseT(m_values);
 			m_allocator->freeT(m_values);
+			freeOldValues();
 
-			m_allocator->releaseT(m_slots);
-			m_allocator->freeT(m_slots);
+			freeSlots(m_controls, m_indices);
+			freeSlots(m_oldControls, m_oldIndices);
+			cancelPrepareRehash();
 
-			m_slots = Span<HashSlot>{};
+			m_rehashIndex = 0;
 			m_deletedCount = 0;
 			m_usedCountThreshold = 0;
 			m_usedCountShrinkThreshold = 0;
@@ -728,265 +1448,454 @@ namespace core
 		void copyFrom(const Map& other)
 		{
 			m_allocator = other.m_allocator;
+			m_seed = other.m_seed;
 			m_deletedCount = other.m_deletedCount;
 			m_usedCountThreshold = other.m_usedCountThreshold;
 			m_usedCountShrinkThreshold = other.m_usedCountShrinkThreshold;
 			m_deletedCountThreshold = other.m_deletedCountThreshold;
+			m_rehashIndex = other.m_rehashIndex;
+			m_incrementalRehash = other.m_incrementalRehash;
 			m_valuesCount = other.m_valuesCount;
 
 			m_values = m_allocator->allocT<KeyValue<const TKey, TValue>>(m_valuesCount);
 			m_allocator->commitT(m_values);
 			for (size_t i = 0; i < m_valuesCount; ++i)
 			{
-				::new (&m_values[i]) KeyValue<const TKey, TValue>(other.m_values[i]);
-			}
-
-			m_slots = m_allocator->allocT<HashSlot>(other.m_slots.count());
-			m_allocator->commitT(m_slots);
-			for (auto& slot: m_slots)
-			{
-				::new (&slot) HashSlot();
+				::new (&m_values[i]) KeyValue<const TKey, TValue>(other.valueAt(i));
 			}
 
-			for (size_t i = 0; i < m_valuesCount; ++i)
-			{
-				auto res = findSlotForInsert(m_slots, m_values, m_values[i].key);
-				auto& slot = m_slots[res.index];
-				auto flags = slot.flags();
-				switch (flags)
-				{
-				case HASH_FLAGS::HASH_EMPTY:
-				{
-					slot.setFlags(HASH_FLAGS::HASH_USED);
-					slot.setValueIndex(i);
-					slot.setValueHash(res.hash);
-					break;
-				}
-				case HASH_FLAGS::HASH_USED:
-				case HASH_FLAGS::HASH_DELETED:
-				default:
-					unreachable();
-					break;
-				}
-			}
+			// both tables have the same seed so the slots can be copied as is, including an in progress rehash, a
+			// rehash which is being prepared isn't copied, the copy is over its threshold too so its next insert starts
+			// the preparation over
+			copySlots(m_controls, m_indices, other.m_controls, other.m_indices);
+			copySlots(m_oldControls, m_oldIndices, other.m_oldControls, other.m_oldIndices);
 		}
 
 		void moveFrom(Map& other)
 		{
 			m_allocator = other.m_allocator;
-			m_slots = other.m_slots;
+			m_seed = other.m_seed;
+			m_controls = other.m_controls;
+			m_indices = other.m_indices;
 			m_deletedCount = other.m_deletedCount;
 			m_usedCountThreshold = other.m_usedCountThreshold;
 			m_usedCountShrinkThreshold = other.m_usedCountShrinkThreshold;
 			m_deletedCountThreshold = other.m_deletedCountThreshold;
+			m_oldControls = other.m_oldControls;
+			m_oldIndices = other.m_oldIndices;
+			m_rehashIndex = other.m_rehashIndex;
+			m_nextControls = other.m_nextControls;
+			m_nextIndices = other.m_nextIndices;
+			m_nextControlsInitCount = other.m_nextControlsInitCount;
+			m_touchedIndicesCount = other.m_touchedIndicesCount;
+			m_incrementalRehash = other.m_incrementalRehash;
 			m_values = other.m_values;
 			m_valuesCount = other.m_valuesCount;
-
-			other.m_slots = Span<HashSlot>{};
+			m_oldValues = other.m_oldValues;
+			m_valuesMoveIndex = other.m_valuesMoveIndex;
+			m_touchedValuesCount = other.m_touchedValuesCount;
+
+			other.m_controls = Span<uint8_t>{};
+			other.m_indices = Span<size_t>{};
+			other.m_oldControls = Span<uint8_t>{};
+			other.m_oldIndices = Span<size_t>{};
+			other.m_rehashIndex = 0;
+			other.m_nextControls = Span<uint8_t>{};
+			other.m_nextIndices = Span<size_t>{};
+			other.m_nextControlsInitCount = 0;
+			other.m_touchedIndicesCount = 0;
 			other.m_deletedCount = 0;
 			other.m_usedCountThreshold = 0;
 			other.m_usedCountShrinkThreshold = 0;
 			other.m_deletedCountThreshold = 0;
 			other.m_values = Span<KeyValue<const TKey, TValue>>{};
 			other.m_valuesCount = 0;
+			other.m_oldValues = Span<KeyValue<const TKey, TValue>>{};
+			other.m_valuesMoveIndex = 0;
+			other.m_touchedValuesCount = 0;
 		}
 
-		Search_Result findSlotForInsert(
-			Span<const HashSlot> _slots, Span<const KeyValue<const TKey, TValue>> _values, const TKey& key)
+		// returns the slot of the key if it exists, otherwise returns the first free slot in its probe sequence
+		template <typename R>
+		Search_Result findSlotForInsert(const R& key, size_t hash) const
 		{
 			Search_Result res{};
-			res.hash = THash{}(key, size_t(_slots.data()));
+			res.hash = hash;
 
-			auto cap = _slots.count();
+			auto cap = m_controls.count();
+			res.index = cap;
 			if (cap == 0)
 			{
 				return res;
 			}
 
-			auto index = res.hash & (cap - 1);
-			auto ix = index;
-
-			size_t first_deleted_slot_index = 0;
-			bool found_first_deleted_slot = false;
-
-			// linear probing
-			while (true)
+			auto control = hashControl(res.hash);
+			HashProbe probe{res.hash, cap};
+			do
 			{
-				const auto& slot = _slots[ix];
-				auto slot_hash = slot.valueHash();
-				auto slot_index = slot.valueIndex();
-				auto slot_flags = slot.flags();
-				switch (slot_flags)
+				auto offset = probe.offset();
+				HashGroup group{m_controls.data() + offset};
+				for (auto mask = group.match(control); mask != 0; mask &= mask - 1)
 				{
-				// this position is not empty but if it's the same value then we return it
-				case HASH_USED:
-				{
-					if (slot_hash == res.hash && _values[slot_index].key == key)
+					auto ix = offset + std::countr_zero(mask);
+					if (valueAt(m_indices[ix]).key == key)
 					{
 						res.index = ix;
+						res.found = true;
 						return res;
 					}
-					break;
 				}
-				// this is an empty slot then we can use it
-				case HASH_EMPTY:
+
+				// remember the first free slot, we still have to make sure the key doesn't exist later in the sequence
+				if (res.index == cap)
 				{
-					// we didn't find the key, so check the first deleted slot if we found one then
-					// reuse it
-					if (found_first_deleted_slot)
-					{
-						res.index = first_deleted_slot_index;
-					}
-					// we didn't find the key, so use the first empty slot
-					else
+					if (auto mask = group.matchEmptyOrDeleted(); mask != 0)
 					{
-						res.index = ix;
+						res.index = offset + std::countr_zero(mask);
 					}
-					return res;
 				}
-				case HASH_DELETED:
+
+				// the key is not in the table if the group has an empty slot
+				if (group.matchEmpty() != 0)
 				{
-					if (found_first_deleted_slot == false)
-					{
-						first_deleted_slot_index = ix;
-						found_first_deleted_slot = true;
-					}
 					break;
 				}
-				default:
-					unreachable();
-					return {};
+			}
+			while (probe.next());
+
+			if (auto ix = findSlotInTable(m_oldControls, m_oldIndices, res.hash, key); ix < m_oldControls.count())
+			{
+				res.index = ix;
+				res.found = true;
+				res.inOldTable = true;
+			}
+			return res;
+		}
+
+		template <typename R>
+		Search_Result findSlotForLookup(const R& key, size_t hash) const
+		{
+			Search_Result res{};
+			res.hash = hash;
+			res.index = findSlotInTable(m_controls, m_indices, res.hash, key);
+			res.found = res.index < m_controls.count();
+			if (res.found == false)
+			{
+				if (auto ix = findSlotInTable(m_oldControls, m_oldIndices, res.hash, key); ix < m_oldControls.count())
+				{
+					res.index = ix;
+					res.found = true;
+					res.inOldTable = true;
 				}
+			}
+			return res;
+		}
+
+		// returns the slot which points to the given value index, it doesn't compare the values, it returns the table's
+		// count if it's not there
+		static size_t findSlotOfValueIndex(
+			Span<const uint8_t> controls,
+			Span<const size_t> indices,
+			size_t hash,
+			size_t value_index)
+		{
+			if (controls.count() == 0)
+			{
+				return 0;
+			}
 
-				// the position is not empty and the key is not the same
-				++ix;
-				ix &= (cap - 1);
+			auto control = hashControl(hash);
+			HashProbe probe{hash, controls.count()};
+			do
+			{
+				auto offset = probe.offset();
+				HashGroup group{controls.data() + offset};
+				for (auto mask = group.match(control); mask != 0; mask &= mask - 1)
+				{
+					auto ix = offset + std::countr_zero(mask);
+					if (indices[ix] == value_index)
+					{
+						return ix;
+					}
+				}
 
-				// if we went full circle then we just return the cap to signal no index has been found
-				if (ix == index)
+				if (group.matchEmpty() != 0)
 				{
-					ix = cap;
 					break;
 				}
 			}
-
-			res.index = ix;
-			return res;
+			while (probe.next());
+			return controls.count();
 		}
 
-		Search_Result findSlotForLookup(const TKey& key) const
+		// rebuilds the slots table at once, it also finishes any in progress incremental rehash
+		void reserveExact(size_t new_count)
 		{
-			Search_Result res{};
-			res.hash = THash{}(key, size_t(m_slots.data()));
+			freeSlots(m_oldControls, m_oldIndices);
+			freeSlots(m_controls, m_indices);
+			cancelPrepareRehash();
+			m_rehashIndex = 0;
+			allocateSlots(new_count);
 
-			auto cap = m_slots.count();
-			if (cap == 0)
+			// do a rehash, values are unique so we only need to find a free slot for each one
+			for (size_t i = 0; i < m_valuesCount; ++i)
 			{
-				return res;
+				auto hash = THash{}(valueAt(i).key, m_seed);
+				auto ix = hashFindFreeSlot(m_controls, hash);
+				m_controls[ix] = hashControl(hash);
+				m_indices[ix] = i;
 			}
+		}
 
-			auto index = res.hash & (cap - 1);
-			auto ix = index;
+		bool isRehashing() const
+		{
+			return m_oldControls.count() > 0;
+		}
 
-			// linear probing
-			while (true)
+		// moves the used slots of the old table in the range [m_rehashIndex, m_rehashIndex + slots_count) to the new
+		// table, frees the old table once all of its slots are moved
+		void rehashStep(size_t slots_count)
+		{
+			auto end = m_rehashIndex + slots_count;
+			if (end > m_oldControls.count())
 			{
-				const auto& slot = m_slots[ix];
-				auto slot_hash = slot.valueHash();
-				auto slot_index = slot.valueIndex();
-				auto slot_flags = slot.flags();
+				end = m_oldControls.count();
+			}
 
-				// if the cell is empty then we didn't find the value
-				if (slot_flags == HASH_FLAGS::HASH_EMPTY)
+			for (; m_rehashIndex < end; ++m_rehashIndex)
+			{
+				// empty and deleted slots have the most significant bit set
+				auto control = m_oldControls[m_rehashIndex];
+				if (control & HASH_CONTROL_EMPTY)
 				{
-					ix = cap;
-					break;
+					continue;
 				}
 
-				// if the cell is used and it's the same value then we found it
-				if (slot_flags == HASH_FLAGS::HASH_USED && slot_hash == res.hash && m_values[slot_index].key == key)
+				// the new table has no copy of the value so we only need to find a free slot for it, the control byte
+				// is the same since both tables have the same seed
+				auto value_index = m_oldIndices[m_rehashIndex];
+				auto ix = hashFindFreeSlot(m_controls, THash{}(valueAt(value_index).key, m_seed));
+				if (m_controls[ix] == HASH_CONTROL_DELETED)
 				{
-					break;
+					--m_deletedCount;
 				}
+				m_controls[ix] = control;
+				m_indices[ix] = value_index;
+
+				// lookups check the new table first, so the moved slot can't be found twice
+				m_oldControls[m_rehashIndex] = HASH_CONTROL_DELETED;
+			}
+
+			if (m_rehashIndex == m_oldControls.count())
+			{
+				freeSlots(m_oldControls, m_oldIndices);
+				m_rehashIndex = 0;
+			}
+		}
+
+		void finishRehash()
+		{
+			if (isRehashing())
+			{
+				rehashStep(m_oldControls.count());
+			}
+		}
+
+		bool isPreparingRehash() const
+		{
+			return m_nextControls.count() > 0;
+		}
+
+		void cancelPrepareRehash()
+		{
+			freeSlots(m_nextControls, m_nextIndices);
+			m_nextControlsInitCount = 0;
+			m_touchedIndicesCount = 0;
+		}
 
-				// the position is not used or the key is not the same
-				++ix;
-				ix &= (cap - 1);
+		// the prepared table replaces the current one which becomes the old table
+		void startRehash()
+		{
+			m_oldControls = m_controls;
+			m_oldIndices = m_indices;
+			m_rehashIndex = 0;
+			m_controls = m_nextControls;
+			m_indices = m_nextIndices;
+			m_nextControls = Span<uint8_t>{};
+			m_nextIndices = Span<size_t>{};
+			m_nextControlsInitCount = 0;
+			m_touchedIndicesCount = 0;
+			resetThresholds(m_controls.count());
+		}
 
-				// if we went full circle then we just return the cap to signal no index has been found
-				if (ix == index)
+		// sets the next chunk of the next table's control bytes to empty, then touches its indices, and starts the
+		// rehash once it's all done
+		void prepareRehashStep()
+		{
+			if (m_nextControlsInitCount < m_nextControls.count())
+			{
+				auto count = m_nextControls.count() - m_nextControlsInitCount;
+				if (count > HASH_REHASH_STEP_TOUCH_BYTES)
 				{
-					ix = cap;
-					break;
+					count = HASH_REHASH_STEP_TOUCH_BYTES;
 				}
+				::memset(m_nextControls.data() + m_nextControlsInitCount, HASH_CONTROL_EMPTY, count);
+				m_nextControlsInitCount += count;
+			}
+			else if (hashTouchStep(m_nextIndices, m_touchedIndicesCount) == false)
+			{
+				startRehash();
 			}
+		}
 
-			res.index = ix;
-			return res;
+		void finishPrepareRehash()
+		{
+			::memset(
+				m_nextControls.data() + m_nextControlsInitCount,
+				HASH_CONTROL_EMPTY,
+				m_nextControls.count() - m_nextControlsInitCount);
+			startRehash();
 		}
 
-		void reserveExact(size_t new_count)
+		// resizes the slots table, in incremental mode the next table is prepared a step at a time by the following
+		// inserts and removes, then the current table becomes the old table which is moved to the new table a step at
+		// a time too, so no single insert pays for the whole table
+		void rehash(size_t new_count)
 		{
-			auto new_slots = m_allocator->allocT<HashSlot>(new_count);
-			m_allocator->commitT(new_slots);
-			for (auto& slot: new_slots)
+			if (m_incrementalRehash == false || m_valuesCount == 0)
 			{
-				::new (&slot) HashSlot();
+				reserveExact(new_count);
+				return;
 			}
 
-			m_deletedCount = 0;
-			// if 12/16th of table is occupied, grow
-			m_usedCountThreshold = new_count - (new_count >> 2);
-			// if deleted count is 3/16th of table, rebuild
-			m_deletedCountThreshold = (new_count >> 3) + (new_count >> 4);
-			// if table is only 4/16th full, shrink
-			m_usedCountShrinkThreshold = new_count >> 2;
-
-			// do a rehash
-			if (m_valuesCount != 0)
+			if (isPreparingRehash() && m_nextControls.count() == new_count)
 			{
-				for (size_t i = 0; i < m_valuesCount; ++i)
+				// the current table has 1/8th of its slots free when the preparation starts which is a lot more than
+				// the steps it takes, it's finished at once only if the table is about to fill up anyway
+				if (m_valuesCount + m_deletedCount + 1 >= m_controls.count())
 				{
-					auto res = findSlotForInsert(new_slots, m_values, m_values[i].key);
-					auto& slot = new_slots[res.index];
-					auto flags = slot.flags();
-					switch (flags)
-					{
-					case HASH_FLAGS::HASH_EMPTY:
-					{
-						slot.setFlags(HASH_FLAGS::HASH_USED);
-						slot.setValueIndex(i);
-						slot.setValueHash(res.hash);
-						break;
-					}
-					case HASH_FLAGS::HASH_USED:
-					case HASH_FLAGS::HASH_DELETED:
-					default:
-						unreachable();
-						break;
-					}
+					finishPrepareRehash();
 				}
+				return;
+			}
+
+			finishRehash();
+			cancelPrepareRehash();
+			m_nextControls = m_allocator->allocT<uint8_t>(new_count);
+			m_allocator->commitT(m_nextControls);
+			m_nextIndices = m_allocator->allocT<size_t>(new_count);
+			m_allocator->commitT(m_nextIndices);
+
+			// a table which fits in a single step is prepared right away
+			if (new_count * (sizeof(uint8_t) + sizeof(size_t)) <= HASH_REHASH_STEP_TOUCH_BYTES)
+			{
+				finishPrepareRehash();
 			}
+		}
 
-			m_allocator->releaseT(m_slots);
-			m_allocator->freeT(m_slots);
-			m_slots = new_slots;
+		void rehashStepIfRehashing()
+		{
+			if (isPreparingRehash())
+			{
+				prepareRehashStep();
+			}
+			else if (isRehashing())
+			{
+				rehashStep(HASH_REHASH_STEP_SLOTS_COUNT);
+			}
 		}
 
 		void maintainSpaceComplexity()
 		{
-			if (m_slots.count() == 0)
+			rehashStepIfRehashing();
+
+			if (m_controls.count() == 0)
+			{
+				reserveExact(HashGroup::WIDTH);
+			}
+			else if (m_valuesCount + m_deletedCount + 1 > m_usedCountThreshold)
+			{
+				// if enough of the slots are tombstones then rebuilding the table in place frees them
+				if (m_deletedCount > m_deletedCountThreshold)
+				{
+					rehash(m_controls.count());
+				}
+				else
+				{
+					rehash(m_controls.count() * 2);
+				}
+			}
+		}
+
+		bool isMovingValues() const
+		{
+			return m_oldValues.count() > 0;
+		}
+
+		void freeOldValues()
+		{
+			m_allocator->releaseT(m_oldValues);
+			m_allocator->freeT(m_oldValues);
+			m_oldValues = Span<KeyValue<const TKey, TValue>>{};
+			m_valuesMoveIndex = 0;
+		}
+
+		// moves the values in [m_valuesMoveIndex, m_valuesMoveIndex + values_count) from the old values array to the
+		// new one, values keep their index so the slots don't change, frees the old array once it has no values left
+		void valuesMoveStep(size_t values_count)
+		{
+			// removes fill their holes from the end so the old array has no values past the values count
+			auto used_end = m_valuesCount < m_oldValues.count() ? m_valuesCount : m_oldValues.count();
+			auto end = m_valuesMoveIndex + values_count;
+			if (end > used_end)
+			{
+				end = used_end;
+			}
+
+			for (; m_valuesMoveIndex < end; ++m_valuesMoveIndex)
+			{
+				::new (&m_values[m_valuesMoveIndex])
+					KeyValue<const TKey, TValue>(std::move(m_oldValues[m_valuesMoveIndex]));
+				m_oldValues[m_valuesMoveIndex].~KeyValue();
+			}
+
+			if (m_valuesMoveIndex >= used_end)
+			{
+				freeOldValues();
+			}
+		}
+
+		void valuesMoveStepIfMoving()
+		{
+			if (isMovingValues() && hashTouchStep(m_values, m_touchedValuesCount) == false)
 			{
-				reserveExact(8);
+				valuesMoveStep(HASH_REHASH_STEP_VALUES_COUNT);
 			}
-			else if (m_valuesCount + 1 > m_usedCountThreshold)
+		}
+
+		void finishValuesMove()
+		{
+			if (isMovingValues())
 			{
-				reserveExact(m_slots.count() * 2);
+				valuesMoveStep(m_oldValues.count());
 			}
 		}
 
+		// in incremental mode the values array grows by moving the values to the new array a step at a time, see
+		// valuesMoveStep, instead of pausing to move all of them
+		void valuesStartMove(size_t new_capacity)
+		{
+			finishValuesMove();
+			m_oldValues = m_values;
+			m_valuesMoveIndex = 0;
+			m_values = m_allocator->allocT<KeyValue<const TKey, TValue>>(new_capacity);
+			m_allocator->commitT(m_values);
+			m_touchedValuesCount = 0;
+		}
+
 		void valuesGrow(size_t new_capacity)
 		{
+			finishValuesMove();
 			auto new_values = m_allocator->allocT<KeyValue<const TKey, TValue>>(new_capacity);
 			m_allocator->commitT(new_values);
 			for (size_t i = 0; i < m_valuesCount; ++i)
@@ -1023,7 +1932,14 @@ namespace core
 					new_capacity = m_values.count() + i;
 				}
 
-				valuesGrow(new_capacity);
+				if (m_incrementalRehash && m_valuesCount > 0)
+				{
+					valuesStartMove(new_capacity);
+				}
+				else
+				{
+					valuesGrow(new_capacity);
+				}
 			}
 		}
 
@@ -1032,7 +1948,9 @@ namespace core
 		{
 			valuesEnsureSpaceExists();
 			m_allocator->commitT(m_values.slice(m_valuesCount, m_valuesCount + 1));
-			::new (&m_values[m_valuesCount]) KeyValue<const TKey, TValue>{std::forward<R>(key), std::forward<U>(value)};
+			::new (&valueAt(m_valuesCount)) KeyValue<const TKey, TValue>{
+				hashMakeKey<TKey>(std::forward<R>(key), m_allocator),
+				std::forward<U>(value)};
 			++m_valuesCount;
 		}
 
@@ -1041,12 +1959,77 @@ namespace core
 			valuesGrow(m_valuesCount);
 		}
 
+		// values live in two arrays while the values array grows in incremental mode, so iterators walk the values by
+		// index instead of by pointer
+		template <typename TEntry>
+		class IteratorBase
+		{
+			friend class Map;
+			template <typename>
+			friend class IteratorBase;
+
+			using Table = std::conditional_t<std::is_const_v<TEntry>, const Map, Map>;
+
+			Table* m_table = nullptr;
+			size_t m_index = 0;
+
+			IteratorBase(Table* table, size_t index)
+				: m_table(table),
+				  m_index(index)
+			{}
+
+		public:
+			IteratorBase() = default;
+
+			operator IteratorBase<const TEntry>() const
+			{
+				return IteratorBase<const TEntry>{m_table, m_index};
+			}
+
+			TEntry& operator*() const
+			{
+				return m_table->valueAt(m_index);
+			}
+
+			TEntry* operator->() const
+			{
+				return &m_table->valueAt(m_index);
+			}
+
+			TEntry& operator[](size_t offset) const
+			{
+				return m_table->valueAt(m_index + offset);
+			}
+
+			IteratorBase& operator++()
+			{
+				++m_index;
+				return *this;
+			}
+
+			bool operator==(const IteratorBase& other) const
+			{
+				return m_table == other.m_table && m_index == other.m_index;
+			}
+
+			bool operator!=(const IteratorBase& other) const
+			{
+				return !operator==(other);
+			}
+		};
+
 	public:
-		using Iterator = KeyValue<const TKey, TValue>*;
-		using ConstIterator = KeyValue<const TKey, TValue> const*;
+		using Iterator = IteratorBase<KeyValue<const TKey, TValue>>;
+		using ConstIterator = IteratorBase<const KeyValue<const TKey, TValue>>;
 
 		explicit Map(Allocator* a)
-			: m_allocator(a)
+			: m_allocator(a),
+			  m_seed(HashSeed::random().value())
+		{}
+
+		Map(Allocator* a, HashSeed seed)
+			: m_allocator(a),
+			  m_seed(seed.value())
 		{}
 
 		Map(const Map& other)
@@ -1078,55 +2061,54 @@ namespace core
 			destroy();
 		}
 
+		// the key can be of any type which THash can hash and compare equal to the table's key type, it's only
+		// converted to the key type if it doesn't exist, allocator aware keys (like String from StringView) are
+		// constructed using the table's allocator
 		template <typename R, typename U>
 		void insert(R&& key, U&& value = U{})
 		{
-			maintainSpaceComplexity();
+			auto hash = THash{}(key, m_seed);
+			insertWithHash(std::forward<R>(key), hash, std::forward<U>(value));
+		}
 
-			auto res = findSlotForInsert(m_slots, m_values, key);
+		// same as insert but with the key's hash precomputed, the hash must be THash{}(key, seed().value())
+		template <typename R, typename U>
+		void insertWithHash(R&& key, size_t hash, U&& value = U{})
+		{
+			maintainSpaceComplexity();
 
-			auto& slot = m_slots[res.index];
-			auto flags = slot.flags();
-			switch (flags)
+			auto res = findSlotForInsert(key, hash);
+			if (res.found)
 			{
-			case HASH_EMPTY:
-			{
-				slot.setFlags(HASH_USED);
-				slot.setValueIndex(m_valuesCount);
-				slot.setValueHash(res.hash);
-				valuesPush(std::forward<R>(key), std::forward<U>(value));
+				// the key already exists
 				return;
 			}
-			case HASH_DELETED:
+
+			if (m_controls[res.index] == HASH_CONTROL_DELETED)
 			{
-				slot.setFlags(HASH_USED);
-				slot.setValueIndex(m_valuesCount);
-				slot.setValueHash(res.hash);
 				--m_deletedCount;
-				valuesPush(std::forward<R>(key), std::forward<U>(value));
-			}
-			case HASH_USED:
-			{
-				return;
-			}
-			default:
-			{
-				unreachable();
-				return;
-			}
 			}
+			m_controls[res.index] = hashControl(res.hash);
+			m_indices[res.index] = m_valuesCount;
+			valuesPush(std::forward<R>(key), std::forward<U>(value));
+			// values move after the operation since the given key or value may refer to a value of the table
+			valuesMoveStepIfMoving();
 		}
 
 		void clear()
 		{
-			for (auto& slot: m_slots)
+			freeSlots(m_oldControls, m_oldIndices);
+			cancelPrepareRehash();
+			m_rehashIndex = 0;
+			if (m_controls.count() > 0)
 			{
-				slot = HashSlot{};
+				::memset(m_controls.data(), HASH_CONTROL_EMPTY, m_controls.sizeInBytes());
 			}
-			for (auto& value: m_values)
+			for (size_t i = 0; i < m_valuesCount; ++i)
 			{
-				value.~KeyValue();
+				valueAt(i).~KeyValue();
 			}
+			freeOldValues();
 			m_valuesCount = 0;
 			m_deletedCount = 0;
 		}
@@ -1136,6 +2118,12 @@ namespace core
 			return m_allocator;
 		}
 
+		// the seed which is passed to THash, tables with the same seed agree on the hash of each key
+		HashSeed seed() const
+		{
+			return HashSeed{m_seed};
+		}
+
 		size_t count() const
 		{
 			return m_valuesCount;
@@ -1143,7 +2131,7 @@ namespace core
 
 		size_t capacity() const
 		{
-			return m_slots.count();
+			return m_controls.count();
 		}
 
 		void reserve(size_t added_count)
@@ -1180,6 +2168,10 @@ namespace core
 					}
 					++new_cap;
 				}
+				if (new_cap < HashGroup::WIDTH)
+				{
+					new_cap = HashGroup::WIDTH;
+				}
 				reserveExact(new_cap);
 			}
 		}
@@ -1187,74 +2179,144 @@ namespace core
 		template <typename R>
 		ConstIterator lookup(const R& key) const
 		{
-			auto res = findSlotForLookup(key);
-			if (res.index == m_slots.count())
+			return lookupWithHash(key, THash{}(key, m_seed));
+		}
+
+		// same as lookup but with the key's hash precomputed, the hash must be THash{}(key, seed().value())
+		template <typename R>
+		ConstIterator lookupWithHash(const R& key, size_t hash) const
+		{
+			auto res = findSlotForLookup(key, hash);
+			if (res.found == false)
 			{
 				return end();
 			}
-			auto& slot = m_slots[res.index];
-			auto index = slot.valueIndex();
-			return &m_values[index];
+			auto index = res.inOldTable ? m_oldIndices[res.index] : m_indices[res.index];
+			return ConstIterator{this, index};
+		}
+
+		template <typename R>
+		Iterator lookup(const R& key)
+		{
+			return lookupWithHash(key, THash{}(key, m_seed));
+		}
+
+		template <typename R>
+		Iterator lookupWithHash(const R& key, size_t hash)
+		{
+			return Iterator{this, std::as_const(*this).lookupWithHash(key, hash).m_index};
 		}
 
 		template <typename R>
 		bool remove(const R& key)
 		{
-			auto res = findSlotForLookup(key);
-			if (res.index == m_slots.count())
+			return removeWithHash(key, THash{}(key, m_seed));
+		}
+
+		// same as remove but with the key's hash precomputed, the hash must be THash{}(key, seed().value())
+		template <typename R>
+		bool removeWithHash(const R& key, size_t hash)
+		{
+			rehashStepIfRehashing();
+
+			auto res = findSlotForLookup(key, hash);
+			if (res.found == false)
 			{
 				return false;
 			}
-			auto& slot = m_slots[res.index];
-			auto index = slot.valueIndex();
-			slot.setFlags(HASH_DELETED);
 
-			m_values[index].~KeyValue();
+			size_t index = 0;
+			if (res.inOldTable)
+			{
+				index = m_oldIndices[res.index];
+				m_oldControls[res.index] = HASH_CONTROL_DELETED;
+			}
+			else
+			{
+				index = m_indices[res.index];
+				if (hashFreeSlot(m_controls, res.index))
+				{
+					++m_deletedCount;
+				}
+			}
+
+			valueAt(index).~KeyValue();
 
 			if (index < m_valuesCount - 1)
 			{
 				// fixup the index of the last element after swap
-				auto last_res = findSlotForLookup(m_values[m_valuesCount - 1].key);
-				m_slots[last_res.index].setValueIndex(index);
-				::new (&m_values[index]) KeyValue<const TKey, TValue>(std::move(m_values[m_valuesCount - 1]));
-				m_values[m_valuesCount - 1].~KeyValue();
+				auto last_hash = THash{}(valueAt(m_valuesCount - 1).key, m_seed);
+				auto last_slot = findSlotOfValueIndex(m_controls, m_indices, last_hash, m_valuesCount - 1);
+				if (last_slot < m_controls.count())
+				{
+					m_indices[last_slot] = index;
+				}
+				else
+				{
+					last_slot = findSlotOfValueIndex(m_oldControls, m_oldIndices, last_hash, m_valuesCount - 1);
+					m_oldIndices[last_slot] = index;
+				}
+				::new (&valueAt(index)) KeyValue<const TKey, TValue>(std::move(valueAt(m_valuesCount - 1)));
+				valueAt(m_valuesCount - 1).~KeyValue();
 			}
 
 			--m_valuesCount;
-			++m_deletedCount;
 
 			// rehash because of size is too low
-			if (m_valuesCount < m_usedCountShrinkThreshold && m_slots.count() > 8)
+			if (m_valuesCount < m_usedCountShrinkThreshold && m_controls.count() > HashGroup::WIDTH)
 			{
-				reserveExact(m_slots.count() >> 1);
-				valuesShrinkToFit();
+				rehash(m_controls.count() >> 1);
+				// shrinking the values array moves all of them, so incremental mode keeps the memory instead of pausing
+				if (m_incrementalRehash == false)
+				{
+					valuesShrinkToFit();
+				}
 			}
-			// rehash because of too many deleted values
-			else if (m_deletedCount > m_deletedCountThreshold)
+			valuesMoveStepIfMoving();
+			return true;
+		}
+
+		// in incremental mode growing, shrinking or rebuilding the table and growing the values array don't move all
+		// the slots and values at once, instead the following inserts and removes move them a bounded step at a time,
+		// this bounds the latency of a single insert at the cost of lookups checking two tables while a rehash is in
+		// progress, disabling it finishes any in progress rehash
+		void setIncrementalRehash(bool enabled)
+		{
+			m_incrementalRehash = enabled;
+			if (enabled == false)
 			{
-				reserveExact(m_slots.count());
+				// the current table is still complete while the next one is prepared so it's dropped, the next insert
+				// rehashes at once
+				cancelPrepareRehash();
+				finishRehash();
+				finishValuesMove();
 			}
-			return true;
+		}
+
+		bool incrementalRehash() const
+		{
+			return m_incrementalRehash;
 		}
 
 		Iterator begin()
 		{
-			return m_values.begin();
+			return Iterator{this, 0};
 		}
 
 		ConstIterator begin() const
 		{
-			return m_values.begin();
+			return ConstIterator{this, 0};
 		}
 
 		Iterator end()
 		{
-			return m_values.sliceLeft(m_valuesCount).end();
+			return Iterator{this, m_valuesCount};
 		}
 
 		ConstIterator end() const
 		{
-			return m_values.sliceLeft(m_valuesCount).end();
+			return ConstIterator{this, m_valuesCount};
 		}
 	};
+
 }
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "core/Buffer.h"
+#include "core/Exports.h"
+#include "core/Span.h"
+#include "core/String.h"
+
+namespace core
+{
+	// base16 as in rfc 4648, encoding writes lower case digits and decoding accepts both cases, both work on 16 bytes
+	// at a time with sse2
+	class Hex
+	{
+	public:
+		// the exact count of characters in the encoding of count bytes
+		static constexpr size_t encodedCount(size_t count)
+		{
+			return count * 2;
+		}
+
+		// the exact count of bytes the given string decodes to if it's valid
+		static size_t decodedCount(StringView str)
+		{
+			return str.count() / 2;
+		}
+
+		// writes the encoding of bytes to out which must have room for encodedCount(bytes.count()) characters and
+		// returns the count of written characters
+		CORE_EXPORT static size_t encode(Span<const std::byte> bytes, Span<char> out);
+		CORE_EXPORT static String encode(Span<const std::byte> bytes, Allocator* allocator);
+
+		// writes the decoded bytes to out which must have room for decodedCount(str) bytes and returns the count of
+		// written bytes or SIZE_MAX if str has an odd count of characters or a character which isn't a hex digit
+		CORE_EXPORT static size_t decode(StringView str, Span<std::byte> out);
+		// returns an empty buffer if str isn't valid hex
+		CORE_EXPORT static Buffer decode(StringView str, Allocator* allocator);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "core/Array.h"
+#include "core/Exports.h"
+#include "core/Hash.h"
+#include "core/RWMutex.h"
+#include "core/StringView.h"
+
+#include <cstdint>
+
+namespace core
+{
+	// a compact id of a string in an Interner, two symbols of the same interner are equal only if their strings are
+	// equal so comparing and hashing them costs as much as an integer, the default symbol is the invalid one
+	class Symbol
+	{
+		uint32_t m_id = 0;
+
+	public:
+		Symbol() = default;
+
+		explicit Symbol(uint32_t id)
+			: m_id(id)
+		{}
+
+		uint32_t id() const
+		{
+			return m_id;
+		}
+
+		bool valid() const
+		{
+			return m_id != 0;
+		}
+
+		bool operator==(const Symbol& other) const
+		{
+			return m_id == other.m_id;
+		}
+
+		bool operator!=(const Symbol& other) const
+		{
+			return m_id != other.m_id;
+		}
+
+		// an arbitrary but stable order which isn't the order of their strings, it lets symbols be keys of ordered
+		// containers
+		bool operator<(const Symbol& other) const
+		{
+			return m_id < other.m_id;
+		}
+	};
+
+	template <>
+	struct Hash<Symbol>
+	{
+		inline size_t operator()(Symbol value, size_t seed) const
+		{
+			return hashInteger(uint64_t(value.id()), seed);
+		}
+	};
+
+	// maps strings to symbols, each distinct string is copied once into append only blocks which are never moved or
+	// freed before the interner so the views it returns stay valid for its whole life
+	class Interner
+	{
+		// strings which are longer than the block get a block of their own
+		static constexpr size_t BLOCK_SIZE = 64ULL * 1024ULL;
+
+		Allocator* m_allocator = nullptr;
+		Array<Span<std::byte>> m_blocks;
+		// the used bytes in the last block
+		size_t m_blockUsed = 0;
+		// the string of each symbol indexed by its id, the first one is the empty string of the invalid symbol
+		Array<StringView> m_strings;
+		Map<StringView, uint32_t> m_symbols;
+
+		StringView store(StringView str);
+		void destroy();
+
+	public:
+		CORE_EXPORT explicit Interner(Allocator* allocator);
+		CORE_EXPORT Interner(Allocator* allocator, HashSeed seed);
+		Interner(const Interner&) = delete;
+		CORE_EXPORT Interner(Interner&& other) noexcept;
+		Interner& operator=(const Interner&) = delete;
+		CORE_EXPORT Interner& operator=(Interner&& other) noexcept;
+		CORE_EXPORT ~Interner();
+
+		// returns the symbol of the string, the string is copied the first time it's interned
+		CORE_EXPORT Symbol intern(StringView str);
+		// same as intern with the hash computed using Hash<StringView> and seed()
+		CORE_EXPORT Symbol internWithHash(StringView str, size_t hash);
+		// returns the invalid symbol if the string was never interned
+		CORE_EXPORT Symbol lookup(StringView str) const;
+		CORE_EXPORT Symbol lookupWithHash(StringView str, size_t hash) const;
+
+		StringView str(Symbol symbol) const
+		{
+			assertTrue(symbol.id() < m_strings.count());
+			return m_strings[symbol.id()];
+		}
+
+		// the count of the interned strings
+		size_t count() const
+		{
+			return m_strings.count() - 1;
+		}
+
+		HashSeed seed() const
+		{
+			return m_symbols.seed();
+		}
+
+		Allocator* allocator() const
+		{
+			return m_allocator;
+		}
+	};
+
+	// a thread safe interner which splits its strings over independently locked Interner shards like ConcurrentMap, a
+	// string which was interned already only takes the shared lock of its shard, the symbol id carries the shard index
+	// in its low bits so str() goes straight to the right shard
+	class ConcurrentInterner
+	{
+		struct Shard
+		{
+			mutable RWMutex mutex;
+			Interner interner;
+
+			Shard(Allocator* allocator, HashSeed seed)
+				: mutex(allocator),
+				  interner(allocator, seed)
+			{}
+		};
+
+		Allocator* m_allocator = nullptr;
+		size_t m_seed = 0;
+		Array<Shard> m_shards;
+		size_t m_shardBits = 0;
+		// see ConcurrentMap, the shard index comes from the hash bits right below the ones Map keeps
+		size_t m_shardShift = 0;
+
+		size_t shardIndexOf(size_t hash) const
+		{
+			return (hash >> m_shardShift) & (m_shards.count() - 1);
+		}
+
+	public:
+		// uses 4 shards per hardware thread
+		CORE_EXPORT explicit ConcurrentInterner(Allocator* allocator);
+		// the shards count is rounded up to a power of 2
+		CORE_EXPORT ConcurrentInterner(Allocator* allocator, size_t shardsCount);
+
+		CORE_EXPORT Symbol intern(StringView str);
+		CORE_EXPORT Symbol lookup(StringView str) const;
+		CORE_EXPORT StringView str(Symbol symbol) const;
+		// the count of all the shards, it's only exact if there are no concurrent writers
+		CORE_EXPORT size_t count() const;
+
+		size_t shardsCount() const
+		{
+			return m_shards.count();
+		}
+
+		Allocator* allocator() const
+		{
+			return m_allocator;
+		}
+	};
+}
\ No newline at end of file
@@ -3,6 +3,33 @@
 #include "core/Exports.h"
 #include <cstdint>
 
+// enables avx2 code generation for a single function so that simd code paths can be compiled into a build which
+// targets an older instruction set and picked at runtime after checking cpuFeatures().avx2, msvc doesn't need it to use
+// the intrinsics
+#if TAHA_COMPILER_GNU || TAHA_COMPILER_CLANG
+	#define TAHA_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt")))
+#else
+	#define TAHA_TARGET_AVX2
+#endif
+
+// same as TAHA_TARGET_AVX2 but for the sha extensions, it's picked after checking cpuFeatures().sha
+#if TAHA_COMPILER_GNU || TAHA_COMPILER_CLANG
+	#define TAHA_TARGET_SHA __attribute__((target("sha,sse4.1")))
+#else
+	#define TAHA_TARGET_SHA
+#endif
+
+// forces a function to be inlined into its callers, the simd loops which are templates over the vector width use it so
+// that they end up compiled with the target of the TAHA_TARGET_AVX2 function which instantiates them instead of being a
+// separate function which calls into the avx2 helpers
+#if TAHA_COMPILER_GNU || TAHA_COMPILER_CLANG
+	#define TAHA_FORCE_INLINE __attribute__((always_inline)) inline
+#elif TAHA_COMPILER_MSVC
+	#define TAHA_FORCE_INLINE __forceinline
+#else
+	#define TAHA_FORCE_INLINE inline
+#endif
+
 namespace core
 {
 	enum class Endianness
@@ -16,4 +43,18 @@ namespace core
 	CORE_EXPORT uint32_t byteswap_uint32(uint32_t value);
 	CORE_EXPORT uint64_t byteswap_uint64(uint64_t value);
 	CORE_EXPORT int leading_zeros(uint64_t value);
+
+	// the instruction set extensions which the running cpu and os support, they're all false on non x86 cpus
+	struct CPUFeatures
+	{
+		bool ssse3 = false;
+		bool sse42 = false;
+		bool avx2 = false;
+		bool bmi2 = false;
+		// the sha1 and sha256 instructions, cpus which have them have sse4.1 too
+		bool sha = false;
+	};
+
+	// detects the features once and caches them
+	CORE_EXPORT const CPUFeatures& cpuFeatures();
 }
\ No newline at end of file
@@ -11,6 +11,12 @@ namespace core
 	template <typename T>
 	inline Lock<T> tryLockGuard(T& lockable);
 
+	template <typename T>
+	class SharedLock;
+
+	template <typename T>
+	inline SharedLock<T> sharedLockGuard(T& lockable);
+
 	template <typename T>
 	class Lock
 	{
@@ -88,4 +94,61 @@ namespace core
 		}
 		return Lock<T>{lockable, false};
 	}
+
+	// same as Lock but it holds the shared side of a reader writer lock like RWMutex
+	template <typename T>
+	class SharedLock
+	{
+		template <typename U>
+		friend inline SharedLock<U> sharedLockGuard(U& lockable);
+
+		T* m_lockable = nullptr;
+
+		explicit SharedLock(T& lockable)
+			: m_lockable(&lockable)
+		{}
+
+		void destroy()
+		{
+			if (m_lockable)
+			{
+				m_lockable->unlockShared();
+			}
+		}
+
+		void moveFrom(SharedLock& other)
+		{
+			m_lockable = other.m_lockable;
+			other.m_lockable = nullptr;
+		}
+
+	public:
+		SharedLock(const SharedLock&) = delete;
+
+		SharedLock(SharedLock&& other) noexcept
+		{
+			moveFrom(other);
+		}
+
+		SharedLock& operator=(const SharedLock&) = delete;
+
+		SharedLock& operator=(SharedLock&& other) noexcept
+		{
+			destroy();
+			moveFrom(other);
+			return *this;
+		}
+
+		~SharedLock()
+		{
+			destroy();
+		}
+	};
+
+	template <typename T>
+	inline SharedLock<T> sharedLockGuard(T& lockable)
+	{
+		lockable.lockShared();
+		return SharedLock<T>{lockable};
+	}
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "core/Buffer.h"
 #include "core/Exports.h"
 #include "core/Hash.h"
+#include "core/Interner.h"
 #include "core/Result.h"
 #include "core/Stream.h"
 #include "core/String.h"
@@ -16,6 +17,7 @@ namespace core::msgpack
 	{
 		Stream* m_stream = nullptr;
 		Allocator* m_allocator = nullptr;
+		Interner* m_interner = nullptr;
 
 	public:
 		Writer(Stream* stream, Allocator* allocator)
@@ -23,11 +25,23 @@ namespace core::msgpack
 			  m_allocator(allocator)
 		{}
 
+		// symbols are written as the strings they have in the interner
+		Writer(Stream* stream, Allocator* allocator, Interner* interner)
+			: m_stream(stream),
+			  m_allocator(allocator),
+			  m_interner(interner)
+		{}
+
 		Allocator* allocator() const
 		{
 			return m_allocator;
 		}
 
+		Interner* interner() const
+		{
+			return m_interner;
+		}
+
 		CORE_EXPORT HumanError write_blob(const void* data, size_t size);
 		CORE_EXPORT HumanError write_uint8(uint8_t value);
 		CORE_EXPORT HumanError write_uint16(uint16_t value);
@@ -48,6 +62,7 @@ namespace core::msgpack
 	CORE_EXPORT HumanError msgpack(Writer& writer, float value);
 	CORE_EXPORT HumanError msgpack(Writer& writer, double value);
 	CORE_EXPORT HumanError msgpack(Writer& writer, StringView value);
+	CORE_EXPORT HumanError msgpack(Writer& writer, Symbol value);
 	CORE_EXPORT HumanError msgpack(Writer& writer, const void* data, size_t size);
 
 	template <typename T>
@@ -241,6 +256,7 @@ namespace core::msgpack
 	{
 		Stream* m_stream = nullptr;
 		Allocator* m_allocator = nullptr;
+		Interner* m_interner = nullptr;
 
 	public:
 		Reader(Stream* stream, Allocator* allocator)
@@ -248,11 +264,24 @@ namespace core::msgpack
 			  m_allocator(allocator)
 		{}
 
+		// strings which are read into symbols are interned, so decoding a Map<Symbol, T> copies each distinct key once
+		// instead of allocating a String for every key
+		Reader(Stream* stream, Allocator* allocator, Interner* interner)
+			: m_stream(stream),
+			  m_allocator(allocator),
+			  m_interner(interner)
+		{}
+
 		Allocator* allocator() const
 		{
 			return m_allocator;
 		}
 
+		Interner* interner() const
+		{
+			return m_interner;
+		}
+
 		CORE_EXPORT HumanError read_blob(void* data, size_t size);
 		CORE_EXPORT HumanError read_uint8(uint8_t& value);
 		CORE_EXPORT HumanError read_uint16(uint16_t& value);
@@ -288,6 +317,7 @@ namespace core::msgpack
 	CORE_EXPORT HumanError msgpack(Reader& reader, float& value);
 	CORE_EXPORT HumanError msgpack(Reader& reader, double& value);
 	CORE_EXPORT HumanError msgpack(Reader& reader, String& value);
+	CORE_EXPORT HumanError msgpack(Reader& reader, Symbol& value);
 	CORE_EXPORT HumanError msgpack(Reader& reader, Buffer& value);
 
 	template <typename T>
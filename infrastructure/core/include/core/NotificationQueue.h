@@ -1,10 +1,10 @@
 #pragma once
 
 #include "core/ConditionVariable.h"
+#include "core/Deque.h"
 #include "core/Func.h"
 #include "core/Lock.h"
 #include "core/Mutex.h"
-#include "core/Queue.h"
 #include "core/Shared.h"
 
 namespace core
@@ -19,7 +19,7 @@ namespace core
 
 	class NotificationQueue
 	{
-		Queue<NotificationQueueEntry> m_queue;
+		Deque<NotificationQueueEntry> m_queue;
 		Mutex m_mutex;
 		ConditionVariable m_condition;
 		bool m_done = false;
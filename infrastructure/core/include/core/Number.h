@@ -0,0 +1,43 @@
+#pragma once
+
+#include "core/Exports.h"
+#include "core/Result.h"
+#include "core/StringView.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace core
+{
+	enum class ParseNumberErr
+	{
+		Ok = 0,
+		// the string isn't a number in the expected syntax
+		Syntax,
+		// the string is a number which doesn't fit in the requested type
+		Range,
+	};
+
+	// the most bytes written by formatInt and formatUint
+	constexpr size_t FORMAT_INT_MAX = 20;
+	// the most bytes written by formatFloat
+	constexpr size_t FORMAT_FLOAT_MAX = 32;
+
+	// parses a decimal integer with an optional + or - sign, the whole string must be the number so there's no white
+	// space or trailing characters allowed
+	CORE_EXPORT Result<int64_t, ParseNumberErr> parseInt(StringView str);
+	// parses a decimal integer without a sign, the whole string must be the number
+	CORE_EXPORT Result<uint64_t, ParseNumberErr> parseUint(StringView str);
+	// parses a decimal floating point number like strtod does minus the locale, hex floats and leading white space,
+	// which is [+-](digits[.digits]|.digits)[(e|E)[+-]digits] or inf, infinity and nan in any case, the result is
+	// correctly rounded, a number which rounds to infinity is a range error
+	CORE_EXPORT Result<double, ParseNumberErr> parseFloat(StringView str);
+
+	// writes the decimal representation of the value into out which must have room for FORMAT_INT_MAX bytes and
+	// returns the count of written bytes, out isn't null terminated
+	CORE_EXPORT size_t formatInt(int64_t value, char* out);
+	CORE_EXPORT size_t formatUint(uint64_t value, char* out);
+	// writes the shortest representation which parses back to the same value into out which must have room for
+	// FORMAT_FLOAT_MAX bytes and returns the count of written bytes, out isn't null terminated
+	CORE_EXPORT size_t formatFloat(double value, char* out);
+}
\ No newline at end of file
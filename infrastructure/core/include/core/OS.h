@@ -10,5 +10,11 @@ namespace core
 	{
 	public:
 		CORE_EXPORT static uint64_t pageSize();
+		// returns the default huge page size of the system, or 0 if huge pages are not supported
+		CORE_EXPORT static uint64_t hugePageSize();
+		// returns the number of numa nodes available, always >= 1
+		CORE_EXPORT static int numaNodesCount();
+		// returns the numa node of the cpu the calling thread is currently running on
+		CORE_EXPORT static int currentNumaNode();
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "core/Allocator.h"
+#include "core/Exports.h"
+#include "core/Stream.h"
+#include "core/Unique.h"
+
+#include <cstddef>
+
+namespace core
+{
+	// wraps another allocator and samples its allocations heapprof style, on average one allocation is sampled every
+	// sampleRate bytes, sampled allocations capture the raw return addresses of their call-site, and they are
+	// aggregated per call-site, symbolization only happens when a report or a profile is written
+	class ProfilingAllocator: public Allocator
+	{
+		struct IProfile;
+
+		Allocator* m_allocator = nullptr;
+		size_t m_sampleRate = 0;
+		Unique<IProfile> m_profile;
+
+	public:
+		// the same default as tcmalloc and heapprof
+		static constexpr size_t DEFAULT_SAMPLE_RATE = 512 * 1024;
+
+		// estimated totals, each sample is scaled by the inverse of its sampling probability
+		struct Stats
+		{
+			size_t liveBytes = 0;
+			size_t liveCount = 0;
+			size_t allocatedBytes = 0;
+			size_t allocatedCount = 0;
+			size_t callSitesCount = 0;
+		};
+
+		// sampleRate = 0 samples every allocation
+		CORE_EXPORT explicit ProfilingAllocator(Allocator* allocator, size_t sampleRate = DEFAULT_SAMPLE_RATE);
+		ProfilingAllocator(const ProfilingAllocator&) = delete;
+		ProfilingAllocator& operator=(const ProfilingAllocator&) = delete;
+		CORE_EXPORT ~ProfilingAllocator() override;
+
+		CORE_EXPORT Span<std::byte> alloc(size_t size, size_t alignment) override;
+		CORE_EXPORT void commit(Span<std::byte> bytes) override;
+		CORE_EXPORT void release(Span<std::byte> bytes) override;
+		CORE_EXPORT void free(Span<std::byte> bytes) override;
+
+		CORE_EXPORT Stats stats() const;
+		// writes a human readable report of the call-sites sorted by their live bytes, maxCallSites = 0 writes all of
+		// them
+		CORE_EXPORT void writeReport(Stream* stream, size_t maxCallSites = 0) const;
+		// writes a pprof compatible heap profile (uncompressed protobuf), use `pprof -http=: heap.pb` to inspect it
+		CORE_EXPORT void writePprof(Stream* stream) const;
+	};
+}
\ No newline at end of file
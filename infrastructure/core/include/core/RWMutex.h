@@ -0,0 +1,32 @@
+#pragma once
+
+#include "core/Exports.h"
+#include "core/Unique.h"
+
+namespace core
+{
+	// a reader writer mutex, any number of readers can hold the shared lock at the same time while the exclusive lock
+	// is held by a single writer, use sharedLockGuard and lockGuard from Lock.h to hold it
+	class RWMutex
+	{
+		// readers write to the lock too, so each platform's IRWMutex pads the lock to give it cache lines of its own
+		// instead of sharing them with the neighbouring allocations like the locks of the other ConcurrentMap shards,
+		// the allocators don't align beyond max_align_t so it's padded on both sides
+		struct IRWMutex;
+		Unique<IRWMutex> m_mutex;
+
+	public:
+		CORE_EXPORT explicit RWMutex(Allocator* allocator);
+		CORE_EXPORT RWMutex(RWMutex&& other) noexcept;
+		CORE_EXPORT RWMutex& operator=(RWMutex&& other) noexcept;
+		CORE_EXPORT ~RWMutex();
+
+		CORE_EXPORT void lock();
+		CORE_EXPORT bool tryLock();
+		CORE_EXPORT void unlock();
+
+		CORE_EXPORT void lockShared();
+		CORE_EXPORT bool tryLockShared();
+		CORE_EXPORT void unlockShared();
+	};
+}
\ No newline at end of file
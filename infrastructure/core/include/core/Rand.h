@@ -1,13 +1,91 @@
 #pragma once
 
 #include "core/Exports.h"
+#include "core/HashFunction.h"
 #include "core/Span.h"
 
+#include <cstdint>
+
 namespace core
 {
 	class Rand
 	{
 	public:
+		// each thread keeps a pool of os random bytes which is refilled RAND_POOL_SIZE bytes at a time, so small
+		// requests like uuids and websocket masks don't cost a syscall each, the handed out bytes are wiped from the
+		// pool and a forked child process throws away the pool it inherited
 		CORE_EXPORT static bool cryptoRand(Span<std::byte> buffer);
+		// asks the os for every call, big requests skip the pool and go here directly
+		CORE_EXPORT static bool osCryptoRand(Span<std::byte> buffer);
+	};
+
+	// xoshiro256++, a fast generator which isn't cryptographically secure, it's for picking among equal choices,
+	// sampling, load generation and tests, use Rand::cryptoRand for anything that shouldn't be guessed like keys and
+	// tokens
+	class FastRand
+	{
+		uint64_t m_state[4];
+
+		static uint64_t rotl(uint64_t x, int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+
+	public:
+		// seeded from Rand::cryptoRand
+		CORE_EXPORT FastRand();
+		// the same seed gives the same sequence, the seed is expanded into the state with splitmix64
+		CORE_EXPORT explicit FastRand(uint64_t seed);
+
+		// the generator of the calling thread, it's seeded from Rand::cryptoRand the first time the thread uses it so
+		// it needs no locking
+		CORE_EXPORT static FastRand& threadLocal();
+
+		uint64_t next()
+		{
+			auto res = rotl(m_state[0] + m_state[3], 23) + m_state[0];
+			auto t = m_state[1] << 17;
+			m_state[2] ^= m_state[0];
+			m_state[3] ^= m_state[1];
+			m_state[1] ^= m_state[2];
+			m_state[0] ^= m_state[3];
+			m_state[2] ^= t;
+			m_state[3] = rotl(m_state[3], 45);
+			return res;
+		}
+
+		// uniform in [0, range) without the bias of taking the modulo, it's lemire's multiply and shift which only
+		// divides in the rare case of a rejection, a range of 0 gives 0
+		uint64_t uniform(uint64_t range)
+		{
+			auto lo = next();
+			auto hi = range;
+			_wymum(&lo, &hi);
+			if (lo < range)
+			{
+				auto threshold = (0 - range) % range;
+				while (lo < threshold)
+				{
+					lo = next();
+					hi = range;
+					_wymum(&lo, &hi);
+				}
+			}
+			return hi;
+		}
+
+		// uniform in [0, 1)
+		double uniformDouble()
+		{
+			return double(next() >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+		// advances the state as if next was called 2^128 times, it's used to split the sequence into
+		// non-overlapping streams
+		CORE_EXPORT void jump();
+
+		// fills the bytes with random bytes, big buffers are filled 4 streams at a time with avx2 when the running
+		// cpu has it (see cpuFeatures), so the bytes differ from what calling next would produce
+		CORE_EXPORT void fill(Span<std::byte> bytes);
 	};
 }
\ No newline at end of file
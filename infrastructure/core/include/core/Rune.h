@@ -10,6 +10,8 @@ namespace core
 	{
 		int m_value = 0;
 
+		CORE_EXPORT static Rune decodeMultiByte(const char* ptr);
+
 	public:
 		static const Rune SELF;
 
@@ -56,9 +58,25 @@ namespace core
 
 		CORE_EXPORT static size_t count(const char* ptr);
 		CORE_EXPORT static size_t count(const char* begin, const char* end);
-		CORE_EXPORT static const char* next(const char* ptr);
+		static const char* next(const char* ptr)
+		{
+			++ptr;
+			while (*ptr && ((*ptr & 0xC0) == 0x80))
+			{
+				++ptr;
+			}
+			return ptr;
+		}
 		CORE_EXPORT static const char* prev(const char* ptr);
-		CORE_EXPORT static Rune decode(const char* ptr);
+		// ascii runes are decoded inline, the rest go through Utf8::decode
+		static Rune decode(const char* ptr)
+		{
+			if (ptr != nullptr && (*ptr & 0x80) == 0)
+			{
+				return Rune{*ptr};
+			}
+			return decodeMultiByte(ptr);
+		}
 		CORE_EXPORT static size_t encode(Rune c, char* ptr);
 	};
 }
\ No newline at end of file
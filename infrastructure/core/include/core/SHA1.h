@@ -1,11 +1,14 @@
 #pragma once
 
 #include "core/Exports.h"
+#include "core/HashFunction.h"
 #include "core/Span.h"
 #include "core/String.h"
 
 #include <fmt/core.h>
 
+#include <cstring>
+
 #include <openssl/sha.h>
 
 namespace core
@@ -18,6 +21,8 @@ namespace core
 		std::byte m_digest[20];
 
 	public:
+		static constexpr size_t DIGEST_SIZE = sizeof(m_digest);
+
 		static SHA1 hash(Span<std::byte> bytes)
 		{
 			SHA_CTX ctx;
@@ -50,6 +55,27 @@ namespace core
 		{
 			return {m_digest, 20};
 		}
+
+		bool operator==(const SHA1& other) const
+		{
+			return ::memcmp(m_digest, other.m_digest, sizeof(m_digest)) == 0;
+		}
+
+		bool operator!=(const SHA1& other) const
+		{
+			return !operator==(other);
+		}
+	};
+
+	template <>
+	struct Hash<SHA1>
+	{
+		inline size_t operator()(const SHA1& value, size_t seed) const
+		{
+			// the digest bits are uniformly distributed already, so mixing the first 16 bytes is enough
+			auto bytes = reinterpret_cast<const unsigned char*>(value.asBytes().data());
+			return size_t(_wymix(_hashRead8(bytes) ^ seed ^ _wyp[0], _hashRead8(bytes + 8) ^ _wyp[1]));
+		}
 	};
 
 	class SHA1Hasher
@@ -0,0 +1,336 @@
+#pragma once
+
+#include "core/Allocator.h"
+#include "core/Assert.h"
+#include "core/Span.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core
+{
+	// an array which stores the first N elements inline in the array object itself, it only allocates from the
+	// allocator when the elements overflow the inline storage
+	template <typename T, size_t N>
+	class SmallArray
+	{
+		static_assert(N > 0, "SmallArray needs at least one inline element, use Array instead");
+
+		Allocator* m_allocator = nullptr;
+		// points to the inline storage or to the heap memory if the array overflowed
+		T* m_ptr = nullptr;
+		size_t m_count = 0;
+		size_t m_capacity = N;
+		alignas(T) std::byte m_inline[N * sizeof(T)];
+
+		T* inlinePtr()
+		{
+			return reinterpret_cast<T*>(m_inline);
+		}
+
+		void destroy()
+		{
+			for (size_t i = 0; i < m_count; ++i)
+			{
+				m_ptr[i].~T();
+			}
+
+			if (isInline() == false)
+			{
+				auto memory = Span<T>{m_ptr, m_capacity};
+				m_allocator->releaseT(memory);
+				m_allocator->freeT(memory);
+			}
+
+			m_ptr = inlinePtr();
+			m_count = 0;
+			m_capacity = N;
+		}
+
+		void copyFrom(const SmallArray& other)
+		{
+			m_allocator = other.m_allocator;
+			m_ptr = inlinePtr();
+			m_count = 0;
+			m_capacity = N;
+
+			if (other.m_count > N)
+			{
+				auto memory = m_allocator->allocT<T>(other.m_count);
+				m_allocator->commitT(memory);
+				m_ptr = memory.data();
+				m_capacity = memory.count();
+			}
+
+			for (size_t i = 0; i < other.m_count; ++i)
+			{
+				::new (&m_ptr[i]) T(other.m_ptr[i]);
+			}
+			m_count = other.m_count;
+		}
+
+		void moveFrom(SmallArray& other)
+		{
+			m_allocator = other.m_allocator;
+
+			if (other.isInline())
+			{
+				// inline elements can't be stolen, so we move them one by one
+				m_ptr = inlinePtr();
+				m_capacity = N;
+				for (size_t i = 0; i < other.m_count; ++i)
+				{
+					::new (&m_ptr[i]) T(std::move(other.m_ptr[i]));
+					other.m_ptr[i].~T();
+				}
+				m_count = other.m_count;
+			}
+			else
+			{
+				m_ptr = other.m_ptr;
+				m_count = other.m_count;
+				m_capacity = other.m_capacity;
+			}
+
+			other.m_allocator = nullptr;
+			other.m_ptr = other.inlinePtr();
+			other.m_count = 0;
+			other.m_capacity = N;
+		}
+
+		void grow(size_t new_capacity)
+		{
+			auto new_memory = m_allocator->allocT<T>(new_capacity);
+			m_allocator->commitT(new_memory.sliceLeft(m_count));
+			for (size_t i = 0; i < m_count; ++i)
+			{
+				if constexpr (std::is_move_constructible_v<T>)
+				{
+					::new (&new_memory[i]) T(std::move(m_ptr[i]));
+				}
+				else
+				{
+					::new (&new_memory[i]) T(m_ptr[i]);
+				}
+				m_ptr[i].~T();
+			}
+
+			if (isInline() == false)
+			{
+				auto memory = Span<T>{m_ptr, m_capacity};
+				m_allocator->releaseT(memory);
+				m_allocator->freeT(memory);
+			}
+
+			m_ptr = new_memory.data();
+			m_capacity = new_memory.count();
+		}
+
+		void ensureSpaceExists(size_t i = 1)
+		{
+			if (m_count + i > m_capacity)
+			{
+				size_t new_capacity = m_capacity * 2;
+				if (new_capacity < m_count + i)
+				{
+					new_capacity = m_count + i;
+				}
+
+				grow(new_capacity);
+			}
+		}
+
+		// commit is a no-op for the inline storage, it's only forwarded to the allocator for heap memory
+		void commitElements(size_t begin, size_t end)
+		{
+			if (isInline() == false)
+			{
+				m_allocator->commitT(Span<T>{m_ptr + begin, end - begin});
+			}
+		}
+
+		void releaseElements(size_t begin, size_t end)
+		{
+			if (isInline() == false)
+			{
+				m_allocator->releaseT(Span<T>{m_ptr + begin, end - begin});
+			}
+		}
+
+	public:
+		explicit SmallArray(Allocator* a)
+			: m_allocator(a),
+			  m_ptr(inlinePtr())
+		{}
+
+		SmallArray(const SmallArray& other)
+		{
+			copyFrom(other);
+		}
+
+		SmallArray(SmallArray&& other) noexcept
+		{
+			moveFrom(other);
+		}
+
+		SmallArray& operator=(const SmallArray& other)
+		{
+			destroy();
+			copyFrom(other);
+			return *this;
+		}
+
+		SmallArray& operator=(SmallArray&& other) noexcept
+		{
+			destroy();
+			moveFrom(other);
+			return *this;
+		}
+
+		~SmallArray()
+		{
+			destroy();
+		}
+
+		T& operator[](size_t i)
+		{
+			assertTrue(i < m_count);
+			return m_ptr[i];
+		}
+
+		const T& operator[](size_t i) const
+		{
+			assertTrue(i < m_count);
+			return m_ptr[i];
+		}
+
+		operator Span<T>()
+		{
+			return Span<T>{m_ptr, m_count};
+		}
+
+		operator Span<const T>() const
+		{
+			return Span<const T>{m_ptr, m_count};
+		}
+
+		Allocator* allocator() const
+		{
+			return m_allocator;
+		}
+		size_t count() const
+		{
+			return m_count;
+		}
+		size_t capacity() const
+		{
+			return m_capacity;
+		}
+		// returns true if the elements are stored inline without a heap allocation
+		bool isInline() const
+		{
+			return m_ptr == reinterpret_cast<const T*>(m_inline);
+		}
+
+		void push(const T& v)
+		{
+			ensureSpaceExists();
+			commitElements(m_count, m_count + 1);
+			::new (&m_ptr[m_count]) T(v);
+			++m_count;
+		}
+
+		void push(T&& v)
+		{
+			ensureSpaceExists();
+			commitElements(m_count, m_count + 1);
+			::new (&m_ptr[m_count]) T(std::move(v));
+			++m_count;
+		}
+
+		template <typename... TArgs>
+		void emplace(TArgs&&... args)
+		{
+			ensureSpaceExists();
+			commitElements(m_count, m_count + 1);
+			::new (&m_ptr[m_count]) T(std::forward<TArgs>(args)...);
+			++m_count;
+		}
+
+		void pop()
+		{
+			assertTrue(m_count > 0);
+			m_ptr[m_count - 1].~T();
+			releaseElements(m_count - 1, m_count);
+			--m_count;
+		}
+
+		void clear()
+		{
+			for (size_t i = 0; i < m_count; ++i)
+			{
+				m_ptr[i].~T();
+			}
+			releaseElements(0, m_count);
+			m_count = 0;
+		}
+
+		void reserve(size_t added_count)
+		{
+			ensureSpaceExists(added_count);
+		}
+
+		void resize(size_t new_count)
+		{
+			if (new_count > m_count)
+			{
+				ensureSpaceExists(new_count - m_count);
+				commitElements(m_count, new_count);
+				for (; m_count < new_count; ++m_count)
+				{
+					::new (&m_ptr[m_count]) T();
+				}
+			}
+			else if (new_count < m_count)
+			{
+				for (size_t i = new_count; i < m_count; ++i)
+				{
+					m_ptr[i].~T();
+				}
+				releaseElements(new_count, m_count);
+				m_count = new_count;
+			}
+		}
+
+		T* data()
+		{
+			return m_ptr;
+		}
+		const T* data() const
+		{
+			return m_ptr;
+		}
+
+		T* begin()
+		{
+			return m_ptr;
+		}
+
+		const T* begin() const
+		{
+			return m_ptr;
+		}
+
+		T* end()
+		{
+			return m_ptr + m_count;
+		}
+
+		const T* end() const
+		{
+			return m_ptr + m_count;
+		}
+	};
+}
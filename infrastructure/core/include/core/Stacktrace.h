@@ -5,6 +5,7 @@
 
 #include <cpptrace/cpptrace.hpp>
 
+#include <cstdint>
 #include <ostream>
 #include <streambuf>
 
@@ -78,6 +79,11 @@ namespace core
 			print(&stream, color);
 			return stream.releaseString();
 		}
+
+		const std::vector<cpptrace::stacktrace_frame>& frames() const
+		{
+			return m_trace.frames;
+		}
 	};
 
 	class Rawtrace
@@ -89,11 +95,23 @@ namespace core
 			: m_trace(std::move(trace))
 		{}
 
+		explicit Rawtrace(Span<const uintptr_t> frames)
+		{
+			m_trace.frames.assign(frames.begin(), frames.end());
+		}
+
 		static Rawtrace current(size_t skip, size_t maxDepth)
 		{
 			return Rawtrace{cpptrace::generate_raw_trace(skip + 1, maxDepth)};
 		}
 
+		// captures the return addresses of the current stack into frames without allocating, returns the number of
+		// captured frames
+		static size_t currentFrames(Span<uintptr_t> frames, size_t skip)
+		{
+			return cpptrace::safe_generate_raw_trace(frames.data(), frames.count(), skip + 1);
+		}
+
 		Stacktrace resolve()
 		{
 			return Stacktrace{m_trace.resolve()};
@@ -9,6 +9,8 @@
 #include <fmt/core.h>
 #include <fmt/format.h>
 
+#include <bit>
+#include <cstdint>
 #include <cstring>
 #include <utility>
 
@@ -22,9 +24,60 @@ namespace core
 		friend class OSString;
 		friend class Buffer;
 
+		// small strings are stored inline in the string object itself, the last byte of the object is the inline count
+		// which overlaps the most significant byte of the heap capacity, the HEAP_FLAG bit distinguishes between them
+		static_assert(std::endian::native == std::endian::little, "string layout assumes a little endian target");
+		static constexpr size_t HEAP_FLAG = size_t(1) << (sizeof(size_t) * 8 - 1);
+		// inline capacity in bytes including the null terminator, 23 bytes on 64-bit targets
+		static constexpr size_t INLINE_CAPACITY = 3 * sizeof(size_t) - 1;
+
+		struct HeapMemory
+		{
+			char* ptr;
+			size_t count;
+			size_t capacity;
+		};
+
+		struct InlineMemory
+		{
+			char data[INLINE_CAPACITY];
+			uint8_t count;
+		};
+		static_assert(sizeof(InlineMemory) == sizeof(HeapMemory));
+
 		Allocator* m_allocator = nullptr;
-		Span<char> m_memory;
-		size_t m_count = 0;
+		union
+		{
+			HeapMemory m_heap;
+			InlineMemory m_inline = {};
+		};
+
+		bool isHeap() const
+		{
+			return (m_inline.count & 0x80) != 0;
+		}
+
+		char* ptr()
+		{
+			return isHeap() ? m_heap.ptr : m_inline.data;
+		}
+
+		const char* ptr() const
+		{
+			return isHeap() ? m_heap.ptr : m_inline.data;
+		}
+
+		void setCount(size_t count)
+		{
+			if (isHeap())
+			{
+				m_heap.count = count;
+			}
+			else
+			{
+				m_inline.count = uint8_t(count);
+			}
+		}
 
 		CORE_EXPORT void destroy();
 
@@ -82,44 +135,49 @@ namespace core
 
 		char& operator[](size_t i)
 		{
-			assertTrue(i < m_count);
-			return m_memory[i];
+			assertTrue(i < count());
+			return ptr()[i];
 		}
 
 		const char& operator[](size_t i) const
 		{
-			assertTrue(i < m_count);
-			return m_memory[i];
+			assertTrue(i < count());
+			return ptr()[i];
 		}
 
 		operator StringView() const
 		{
-			return StringView{m_memory.sliceLeft(m_count)};
+			return StringView{ptr(), count()};
 		}
 		explicit operator Span<const std::byte>() const
 		{
-			return Span<const std::byte>{(const std::byte*)m_memory.data(), m_count};
+			return Span<const std::byte>{(const std::byte*)ptr(), count()};
 		}
 
 		size_t count() const
 		{
-			return m_count;
+			return isHeap() ? m_heap.count : m_inline.count;
 		}
 		size_t capacity() const
 		{
-			return m_memory.count();
+			return isHeap() ? (m_heap.capacity & ~HEAP_FLAG) : INLINE_CAPACITY;
+		}
+		// returns true if the string is stored inline without a heap allocation
+		bool isInline() const
+		{
+			return isHeap() == false;
 		}
 		size_t runeCount() const
 		{
-			return Rune::count(m_memory.data(), m_memory.data() + m_count);
+			return Rune::count(ptr(), ptr() + count());
 		}
 		char* data()
 		{
-			return m_memory.data();
+			return ptr();
 		}
 		const char* data() const
 		{
-			return m_memory.data();
+			return ptr();
 		}
 		Allocator* allocator() const
 		{
@@ -142,16 +200,16 @@ namespace core
 		CORE_EXPORT size_t findLast(StringView str, size_t start) const;
 		size_t findLast(StringView str) const
 		{
-			return findLast(str, m_count);
+			return findLast(str, count());
 		}
 
 		bool operator==(const String& other) const
 		{
-			return StringView::cmp(*this, other) == 0;
+			return StringView{*this} == StringView{other};
 		}
 		bool operator!=(const String& other) const
 		{
-			return StringView::cmp(*this, other) != 0;
+			return StringView{*this} != StringView{other};
 		}
 		bool operator<(const String& other) const
 		{
@@ -171,11 +229,11 @@ namespace core
 		}
 		bool operator==(StringView other) const
 		{
-			return StringView::cmp(*this, other) == 0;
+			return StringView{*this} == StringView{other};
 		}
 		bool operator!=(StringView other) const
 		{
-			return StringView::cmp(*this, other) != 0;
+			return StringView{*this} != StringView{other};
 		}
 		bool operator<(StringView other) const
 		{
@@ -206,25 +264,42 @@ namespace core
 
 		const char* begin() const
 		{
-			return m_memory.begin();
+			return ptr();
 		}
 		char* begin()
 		{
-			return m_memory.begin();
+			return ptr();
 		}
 		const char* end() const
 		{
-			return m_memory.sliceLeft(m_count).end();
+			return ptr() + count();
 		}
 		char* end()
 		{
-			return m_memory.sliceLeft(m_count).end();
+			return ptr() + count();
 		}
 
+		StringSplit split(StringView delim, bool skipEmpty) const
+		{
+			return StringView{*this}.split(delim, skipEmpty);
+		}
 		Array<StringView> split(StringView delim, bool skipEmpty, Allocator* allocator) const
 		{
 			return StringView{*this}.split(delim, skipEmpty, allocator);
 		}
+		template <size_t N>
+		void split(StringView delim, bool skipEmpty, SmallArray<StringView, N>& res) const
+		{
+			StringView{*this}.split(delim, skipEmpty, res);
+		}
+		StringLines lines() const
+		{
+			return StringView{*this}.lines();
+		}
+		StringFields fields() const
+		{
+			return StringView{*this}.fields();
+		}
 
 		bool startsWith(StringView other) const
 		{
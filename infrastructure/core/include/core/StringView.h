@@ -5,6 +5,7 @@
 #include "core/CUtils.h"
 #include "core/Exports.h"
 #include "core/Rune.h"
+#include "core/SmallArray.h"
 #include "core/Span.h"
 
 #include <fmt/core.h>
@@ -16,6 +17,9 @@
 namespace core
 {
 	class String;
+	class StringSplit;
+	class StringLines;
+	class StringFields;
 
 	class RuneIterator
 	{
@@ -88,19 +92,19 @@ namespace core
 		const char* m_begin = nullptr;
 		size_t m_count = 0;
 
-		struct RabinKarpState
+	public:
+		// a three way compare, negative if a is before b, zero if they're equal and positive if a is after b
+		static int cmp(StringView a, StringView b)
 		{
-			uint32_t hash, pow;
-		};
-
-		constexpr static uint32_t PRIME_RABIN_KARP = 16777619;
-
-		static RabinKarpState hashRabinKarp(StringView v);
-		static RabinKarpState hashRabinKarpReverse(StringView v);
-		static RabinKarpState hashRabinKarpIgnoreCase(StringView v);
-		CORE_EXPORT static int cmp(StringView a, StringView b);
+			auto minCount = a.m_count < b.m_count ? a.m_count : b.m_count;
+			// NOTE: Possible that a[:minCount] == b[:minCount] but a>b, or vice versa, like "ABC" and "AB"
+			if (auto res = ::memcmp(a.m_begin, b.m_begin, minCount); res != 0)
+			{
+				return res;
+			}
+			return a.m_count == b.m_count ? 0 : (a.m_count > b.m_count ? 1 : -1);
+		}
 
-	public:
 		StringView() = default;
 
 		explicit constexpr StringView(const char* ptr)
@@ -191,12 +195,12 @@ namespace core
 
 		bool operator==(StringView other) const
 		{
-			if (m_begin == other.m_begin && m_count == other.m_count)
+			// different lengths can't be equal so they skip the memcmp
+			if (m_count != other.m_count)
 			{
-				return true;
+				return false;
 			}
-
-			return cmp(*this, other) == 0;
+			return m_begin == other.m_begin || ::memcmp(m_begin, other.m_begin, m_count) == 0;
 		}
 		bool operator!=(StringView other) const
 		{
@@ -239,7 +243,19 @@ namespace core
 			return slice(0, start);
 		}
 
+		// returns the parts separated by delim lazily, each part is found when the iteration reaches it so nothing is
+		// allocated and the rest of the string isn't scanned if the iteration stops early
+		StringSplit split(StringView delim, bool skipEmpty) const;
 		CORE_EXPORT Array<StringView> split(StringView delim, bool skipEmpty, Allocator* allocator) const;
+		// clears the given array and fills it with the parts, it doesn't allocate if the parts fit in the array's
+		// inline storage
+		template <size_t N>
+		void split(StringView delim, bool skipEmpty, SmallArray<StringView, N>& res) const;
+		// returns the lines lazily, a line ends with "\n" or "\r\n" which isn't part of it and the last line doesn't
+		// need to end with a line break
+		StringLines lines() const;
+		// returns the parts separated by runs of ascii white space lazily, the parts are never empty
+		StringFields fields() const;
 
 		bool startsWith(StringView str) const
 		{
@@ -380,6 +396,334 @@ namespace core
 
 		CORE_EXPORT bool isValidUtf8() const;
 	};
+
+	// iterates over the parts of a string separated by a delimiter, see StringView::split
+	class SplitIterator
+	{
+		// the next part starts at m_next until the last part is reached
+		static constexpr size_t LAST = SIZE_MAX - 1;
+		static constexpr size_t END = SIZE_MAX;
+
+		StringView m_str;
+		StringView m_delim;
+		StringView m_part;
+		size_t m_next = END;
+		bool m_skipEmpty = false;
+
+		void advance()
+		{
+			while (m_next <= m_str.count())
+			{
+				auto start = m_next;
+				auto delimIndex = start + m_delim.count() <= m_str.count() ? m_str.find(m_delim, start) : SIZE_MAX;
+				if (delimIndex == SIZE_MAX)
+				{
+					// the rest of the string is the last part which is empty if the string ends with a delimiter
+					m_part = start == m_str.count() ? StringView{} : m_str.sliceRight(start);
+					m_next = m_part.count() == 0 && m_skipEmpty ? END : LAST;
+					return;
+				}
+
+				m_part = m_str.slice(start, delimIndex);
+				m_next = delimIndex + m_delim.count();
+				if (m_part.count() > 0 || m_skipEmpty == false)
+				{
+					return;
+				}
+			}
+			m_next = END;
+		}
+
+	public:
+		// the end iterator
+		SplitIterator() = default;
+
+		SplitIterator(StringView str, StringView delim, bool skipEmpty)
+			: m_str(str),
+			  m_delim(delim),
+			  m_next(0),
+			  m_skipEmpty(skipEmpty)
+		{
+			assertMsg(delim.count() > 0, "split delimiter can't be empty");
+			advance();
+		}
+
+		SplitIterator& operator++()
+		{
+			advance();
+			return *this;
+		}
+
+		SplitIterator operator++(int)
+		{
+			auto res = *this;
+			advance();
+			return res;
+		}
+
+		bool operator==(const SplitIterator& other) const
+		{
+			return m_next == other.m_next;
+		}
+
+		bool operator!=(const SplitIterator& other) const
+		{
+			return m_next != other.m_next;
+		}
+
+		const StringView& operator*() const
+		{
+			return m_part;
+		}
+
+		const StringView* operator->() const
+		{
+			return &m_part;
+		}
+	};
+
+	class StringSplit
+	{
+		StringView m_str;
+		StringView m_delim;
+		bool m_skipEmpty = false;
+
+	public:
+		StringSplit(StringView str, StringView delim, bool skipEmpty)
+			: m_str(str),
+			  m_delim(delim),
+			  m_skipEmpty(skipEmpty)
+		{}
+
+		SplitIterator begin() const
+		{
+			return SplitIterator{m_str, m_delim, m_skipEmpty};
+		}
+
+		SplitIterator end() const
+		{
+			return SplitIterator{};
+		}
+	};
+
+	// iterates over the lines of a string, see StringView::lines
+	class LinesIterator
+	{
+		StringView m_str;
+		StringView m_line;
+		// where the next line starts, SIZE_MAX at the end
+		size_t m_next = SIZE_MAX;
+
+		void advance()
+		{
+			if (m_next >= m_str.count())
+			{
+				m_next = SIZE_MAX;
+				return;
+			}
+
+			auto lineEnd = m_str.find(Rune{'\n'}, m_next);
+			auto end = lineEnd == SIZE_MAX ? m_str.count() : lineEnd;
+			m_line = m_str.slice(m_next, end);
+			if (m_line.count() > 0 && m_line[m_line.count() - 1] == '\r')
+			{
+				m_line = m_line.slice(0, m_line.count() - 1);
+			}
+			m_next = lineEnd == SIZE_MAX ? m_str.count() : lineEnd + 1;
+		}
+
+	public:
+		// the end iterator
+		LinesIterator() = default;
+
+		explicit LinesIterator(StringView str)
+			: m_str(str),
+			  m_next(0)
+		{
+			advance();
+		}
+
+		LinesIterator& operator++()
+		{
+			advance();
+			return *this;
+		}
+
+		LinesIterator operator++(int)
+		{
+			auto res = *this;
+			advance();
+			return res;
+		}
+
+		bool operator==(const LinesIterator& other) const
+		{
+			return m_next == other.m_next;
+		}
+
+		bool operator!=(const LinesIterator& other) const
+		{
+			return m_next != other.m_next;
+		}
+
+		const StringView& operator*() const
+		{
+			return m_line;
+		}
+
+		const StringView* operator->() const
+		{
+			return &m_line;
+		}
+	};
+
+	class StringLines
+	{
+		StringView m_str;
+
+	public:
+		explicit StringLines(StringView str)
+			: m_str(str)
+		{}
+
+		LinesIterator begin() const
+		{
+			return LinesIterator{m_str};
+		}
+
+		LinesIterator end() const
+		{
+			return LinesIterator{};
+		}
+	};
+
+	// iterates over the parts of a string which are separated by ascii white space, see StringView::fields
+	class FieldsIterator
+	{
+		StringView m_str;
+		StringView m_field;
+		// where the search for the next field starts, SIZE_MAX at the end
+		size_t m_next = SIZE_MAX;
+
+		static bool isSpace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+		}
+
+		void advance()
+		{
+			auto ptr = m_str.data();
+			auto count = m_str.count();
+			auto i = m_next;
+			while (i < count && isSpace(ptr[i]))
+			{
+				++i;
+			}
+
+			if (i >= count)
+			{
+				m_next = SIZE_MAX;
+				return;
+			}
+
+			auto start = i;
+			while (i < count && isSpace(ptr[i]) == false)
+			{
+				++i;
+			}
+			m_field = m_str.slice(start, i);
+			m_next = i;
+		}
+
+	public:
+		// the end iterator
+		FieldsIterator() = default;
+
+		explicit FieldsIterator(StringView str)
+			: m_str(str),
+			  m_next(0)
+		{
+			advance();
+		}
+
+		FieldsIterator& operator++()
+		{
+			advance();
+			return *this;
+		}
+
+		FieldsIterator operator++(int)
+		{
+			auto res = *this;
+			advance();
+			return res;
+		}
+
+		bool operator==(const FieldsIterator& other) const
+		{
+			return m_next == other.m_next;
+		}
+
+		bool operator!=(const FieldsIterator& other) const
+		{
+			return m_next != other.m_next;
+		}
+
+		const StringView& operator*() const
+		{
+			return m_field;
+		}
+
+		const StringView* operator->() const
+		{
+			return &m_field;
+		}
+	};
+
+	class StringFields
+	{
+		StringView m_str;
+
+	public:
+		explicit StringFields(StringView str)
+			: m_str(str)
+		{}
+
+		FieldsIterator begin() const
+		{
+			return FieldsIterator{m_str};
+		}
+
+		FieldsIterator end() const
+		{
+			return FieldsIterator{};
+		}
+	};
+
+	inline StringSplit StringView::split(StringView delim, bool skipEmpty) const
+	{
+		return StringSplit{*this, delim, skipEmpty};
+	}
+
+	template <size_t N>
+	inline void StringView::split(StringView delim, bool skipEmpty, SmallArray<StringView, N>& res) const
+	{
+		res.clear();
+		for (auto part: split(delim, skipEmpty))
+		{
+			res.push(part);
+		}
+	}
+
+	inline StringLines StringView::lines() const
+	{
+		return StringLines{*this};
+	}
+
+	inline StringFields StringView::fields() const
+	{
+		return StringFields{*this};
+	}
 }
 
 inline static core::StringView operator"" _sv(const char* ptr, size_t len)
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "core/Allocator.h"
+#include "core/Array.h"
+#include "core/Exports.h"
+#include "core/Mutex.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace core
+{
+	// a thread caching front-end over any allocator, small allocations are served from per-thread free lists of power
+	// of two size classes, the free lists are refilled from and flushed to the backing allocator in batches, so the
+	// backing allocator is only touched once per batch under a lock, which makes it safe to wrap allocators which
+	// aren't thread safe
+	//
+	// NOTE: the backing allocator's commit and release are called without the lock, they're stateless for all the core
+	// allocators, and the cached sizes don't support alignments bigger than alignof(std::max_align_t)
+	class ThreadCachedAllocator: public Allocator
+	{
+		friend struct ThreadCacheTable;
+		struct ThreadCache;
+
+	public:
+		static constexpr size_t MIN_BLOCK_SIZE = 16;
+		static constexpr size_t MAX_BLOCK_SIZE = 32 * 1024;
+		static constexpr size_t SIZE_CLASSES_COUNT = 12;
+		// the number of bytes moved between the thread cache and the backing allocator at once
+		static constexpr size_t BATCH_SIZE_IN_BYTES = 64 * 1024;
+
+	private:
+		Allocator* m_allocator = nullptr;
+		// unique for the lifetime of the process, unlike the address of the allocator
+		uint64_t m_id = 0;
+		Mutex m_mutex;
+		Array<ThreadCache*> m_caches;
+
+		ThreadCache* threadCache();
+		void refill(ThreadCache* cache, size_t sizeClass);
+		void flush(ThreadCache* cache, size_t sizeClass, size_t count);
+		Span<std::byte> allocUncached(size_t size, size_t alignment);
+		void freeUncached(Span<std::byte> bytes);
+		void releaseThreadCache(ThreadCache* cache);
+
+	public:
+		CORE_EXPORT explicit ThreadCachedAllocator(Allocator* allocator);
+		ThreadCachedAllocator(const ThreadCachedAllocator&) = delete;
+		ThreadCachedAllocator& operator=(const ThreadCachedAllocator&) = delete;
+		CORE_EXPORT ~ThreadCachedAllocator() override;
+
+		CORE_EXPORT Span<std::byte> alloc(size_t size, size_t alignment) override;
+		CORE_EXPORT void commit(Span<std::byte> bytes) override;
+		CORE_EXPORT void release(Span<std::byte> bytes) override;
+		CORE_EXPORT void free(Span<std::byte> bytes) override;
+
+		// returns the calling thread's cached blocks to the backing allocator, thread caches are flushed automatically
+		// when their thread exits
+		CORE_EXPORT void flushThreadCache();
+	};
+}
@@ -39,6 +39,8 @@ namespace core
 		}
 
 	public:
+		// the tasks run with the given allocator as the currentAllocator() of their worker, pass a ThreadCachedAllocator
+		// so each worker allocates from its own cache without an Allocator* being passed to every call
 		CORE_EXPORT ThreadPool(Allocator* allocator, size_t threads_count = Thread::hardware_concurrency());
 		CORE_EXPORT ThreadPool(ThreadPool&& other) = default;
 		CORE_EXPORT ThreadPool& operator=(ThreadPool&& other) = default;
@@ -2,6 +2,7 @@
 
 #include "core/Exports.h"
 #include "core/Result.h"
+#include "core/Span.h"
 
 #include <fmt/core.h>
 
@@ -68,9 +69,20 @@ namespace core
 			UUID_VERSION_RANDOM_NUMBER_BASED,
 			// The name-based version specified in RFS 4122 with SHA1 hashing
 			UUID_VERSION_NAME_BASED_SHA1,
+			// The unix epoch time-based version specified in RFC 9562, the first 48 bits are the milliseconds since
+			// the epoch so the uuids sort by creation time
+			UUID_VERSION_UNIX_TIME_BASED,
 		};
 
+		// the count of characters in the xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx form
+		static constexpr size_t STRING_SIZE = 36;
+
+		// a version 4 uuid, it's random so it's the one to use when the uuid shouldn't tell anything
 		CORE_EXPORT static UUID generate();
+		// a version 7 uuid, the ones generated by this process are strictly increasing even within the same
+		// millisecond because the 12 bits after the timestamp are a counter, use it for database keys since the new
+		// keys are appended to the end of the index instead of being scattered all over it
+		CORE_EXPORT static UUID generateV7();
 		CORE_EXPORT static Result<UUID> parse(StringView str, Allocator* allocator);
 
 		UUID()
@@ -123,6 +135,10 @@ namespace core
 			return data.bytes[i];
 		}
 
+		// writes the lower case xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx form to out which must have room for STRING_SIZE
+		// characters
+		CORE_EXPORT void format(Span<char> out) const;
+
 		bool is_null() const
 		{
 			for (size_t i = 0; i < 16; ++i)
@@ -177,6 +193,10 @@ namespace core
 			{
 				return UUID_VERSION_NAME_BASED_SHA1;
 			}
+			else if ((data.bytes[6] & 0xf0) == 0x70)
+			{
+				return UUID_VERSION_UNIX_TIME_BASED;
+			}
 			else
 			{
 				return UUID_VERSION_NONE;
@@ -199,25 +219,9 @@ namespace fmt
 		template <typename FormatContext>
 		auto format(core::UUID value, FormatContext& ctx)
 		{
-			return format_to(
-				ctx.out(),
-				"{:02x}{:02x}{:02x}{:02x}-{:02x}{:02x}-{:02x}{:02x}-{:02x}{:02x}-{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}",
-				value[0],
-				value[1],
-				value[2],
-				value[3],
-				value[4],
-				value[5],
-				value[6],
-				value[7],
-				value[8],
-				value[9],
-				value[10],
-				value[11],
-				value[12],
-				value[13],
-				value[14],
-				value[15]);
+			char buffer[core::UUID::STRING_SIZE];
+			value.format(core::Span<char>{buffer, sizeof(buffer)});
+			return fmt::format_to(ctx.out(), "{}", fmt::string_view{buffer, sizeof(buffer)});
 		}
 	};
 }
\ No newline at end of file
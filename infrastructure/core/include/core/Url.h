@@ -4,10 +4,218 @@
 #include "core/Exports.h"
 #include "core/Hash.h"
 #include "core/Result.h"
+#include "core/SmallArray.h"
+#include "core/Span.h"
 #include "core/String.h"
+#include "core/StringView.h"
 
 namespace core
 {
+	enum class UrlParseErr
+	{
+		Ok = 0,
+		TooLong,
+		Scheme,
+		User,
+		Host,
+		Port,
+		Path,
+		Query,
+		Fragment,
+	};
+
+	// a key and a value of a query as they're written in the url, they're still percent encoded so use
+	// UrlView::decodeQueryElement to get the actual key and value
+	struct UrlQueryKeyValue
+	{
+		StringView key, value;
+	};
+
+	// iterates over the key value pairs of a query separated by '&' or ';', a key without '=' has an empty value, see
+	// UrlQueryView
+	class UrlQueryIterator
+	{
+		static constexpr size_t END = SIZE_MAX;
+
+		StringView m_query;
+		UrlQueryKeyValue m_keyValue;
+		// the next key starts at m_next
+		size_t m_next = END;
+
+		void advance()
+		{
+			if (m_next >= m_query.count())
+			{
+				m_next = END;
+				return;
+			}
+
+			auto keyEnd = m_query.findFirstByte("=;&"_sv, m_next);
+			if (keyEnd == SIZE_MAX)
+			{
+				m_keyValue = UrlQueryKeyValue{m_query.sliceRight(m_next), StringView{}};
+				m_next = m_query.count();
+				return;
+			}
+
+			m_keyValue.key = m_query.slice(m_next, keyEnd);
+			m_keyValue.value = StringView{};
+			m_next = keyEnd + 1;
+			if (m_query[keyEnd] == '=')
+			{
+				auto valueEnd = m_query.findFirstByte(";&"_sv, m_next);
+				if (valueEnd == SIZE_MAX)
+				{
+					valueEnd = m_query.count();
+				}
+				m_keyValue.value = m_query.slice(m_next, valueEnd);
+				m_next = valueEnd + 1;
+			}
+		}
+
+	public:
+		// the end iterator
+		UrlQueryIterator() = default;
+
+		explicit UrlQueryIterator(StringView query)
+			: m_query(query),
+			  m_next(0)
+		{
+			advance();
+		}
+
+		UrlQueryIterator& operator++()
+		{
+			advance();
+			return *this;
+		}
+
+		UrlQueryIterator operator++(int)
+		{
+			auto res = *this;
+			advance();
+			return res;
+		}
+
+		bool operator==(const UrlQueryIterator& other) const
+		{
+			return m_next == other.m_next;
+		}
+
+		bool operator!=(const UrlQueryIterator& other) const
+		{
+			return m_next != other.m_next;
+		}
+
+		const UrlQueryKeyValue& operator*() const
+		{
+			return m_keyValue;
+		}
+
+		const UrlQueryKeyValue* operator->() const
+		{
+			return &m_keyValue;
+		}
+	};
+
+	// the query of a url as it's written in the url, the key value pairs are parsed while iterating
+	class UrlQueryView
+	{
+		StringView m_query;
+
+	public:
+		UrlQueryView() = default;
+
+		explicit UrlQueryView(StringView query)
+			: m_query(query)
+		{}
+
+		StringView str() const
+		{
+			return m_query;
+		}
+
+		UrlQueryIterator begin() const
+		{
+			return UrlQueryIterator{m_query};
+		}
+
+		UrlQueryIterator end() const
+		{
+			return UrlQueryIterator{};
+		}
+
+		// the first pair whose key decodes to the given key or end(), the keys are compared while decoding so it
+		// doesn't allocate
+		CORE_EXPORT UrlQueryIterator find(StringView key) const;
+	};
+
+	// a parsed url which points into the parsed string, nothing is decoded or normalized (see Url for that) so
+	// parsing doesn't allocate, use decode and decodeQueryElement on the parts which can be percent encoded
+	class UrlView
+	{
+		StringView m_scheme;
+		StringView m_user;
+		StringView m_host;
+		StringView m_port;
+		StringView m_path;
+		StringView m_query;
+		StringView m_fragment;
+		// the path, query and fragment as they're written in the url, it's what http calls the request target
+		StringView m_pathWithQueryAndFragment;
+		int m_ipVersion = 0;
+
+	public:
+		// the longest url we parse
+		static constexpr size_t MAX_COUNT = 8000;
+
+		CORE_EXPORT static Result<UrlView, UrlParseErr> parse(StringView url);
+		CORE_EXPORT static StringView errorMessage(UrlParseErr err);
+
+		// writes the percent decoding of str to out which must have room for str.count() characters and returns the
+		// count of written characters or SIZE_MAX if str has an invalid percent encoding
+		CORE_EXPORT static size_t decode(StringView str, Span<char> out);
+		// same as decode but it also decodes '+' to ' ' like the query keys and values are encoded
+		CORE_EXPORT static size_t decodeQueryElement(StringView str, Span<char> out);
+
+		StringView scheme() const
+		{
+			return m_scheme;
+		}
+		StringView user() const
+		{
+			return m_user;
+		}
+		StringView host() const
+		{
+			return m_host;
+		}
+		StringView port() const
+		{
+			return m_port;
+		}
+		StringView path() const
+		{
+			return m_path;
+		}
+		UrlQueryView query() const
+		{
+			return UrlQueryView{m_query};
+		}
+		StringView fragment() const
+		{
+			return m_fragment;
+		}
+		StringView pathWithQueryAndFragment() const
+		{
+			return m_pathWithQueryAndFragment;
+		}
+		int ipVersion() const
+		{
+			return m_ipVersion;
+		}
+	};
+
 	class UrlQuery
 	{
 	public:
@@ -22,15 +230,28 @@ namespace core
 		};
 
 	private:
+		// most queries have a handful of parameters, so we keep the first few inline
+		static constexpr size_t INLINE_KEY_VALUES_COUNT = 4;
+
 		Allocator* m_allocator = nullptr;
-		Array<KeyValue> m_keyValues;
-		Map<StringView, size_t> m_keyToIndex;
+		SmallArray<KeyValue, INLINE_KEY_VALUES_COUNT> m_keyValues;
+		// maps the hash of a key to the index of the first pair with that hash, it doesn't keep views into
+		// m_keyValues because short strings are stored inline and move when the array grows
+		Map<size_t, size_t> m_hashToIndex;
+
+		size_t keyHash(StringView key) const
+		{
+			return Hash<StringView>{}(key, m_hashToIndex.seed().value());
+		}
 
 	public:
-		using KeyIterator = Map<StringView, size_t>::Iterator;
-		using KeyConstIterator = Map<StringView, size_t>::ConstIterator;
+		using KeyIterator = KeyValue*;
+		// points to the first pair with the given key or is nullptr if there's none
+		using KeyConstIterator = const KeyValue*;
 
 		CORE_EXPORT static Result<UrlQuery> parse(StringView query, Allocator* allocator);
+		// decodes the keys and values of an already validated query, see UrlView::parse
+		CORE_EXPORT static UrlQuery fromView(UrlQueryView query, Allocator* allocator);
 
 		CORE_EXPORT explicit UrlQuery(Allocator* allocator);
 
@@ -62,6 +283,8 @@ namespace core
 	public:
 		CORE_EXPORT static String encodeQueryElement(StringView str, Allocator* allocator);
 		CORE_EXPORT static Result<Url> parse(StringView url, Allocator* allocator);
+		// decodes and normalizes the parts of the view into an owned url
+		CORE_EXPORT static Url fromView(const UrlView& url, Allocator* allocator);
 
 		explicit Url(Allocator* allocator)
 			: m_scheme(allocator),
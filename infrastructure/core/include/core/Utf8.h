@@ -0,0 +1,35 @@
+#pragma once
+
+#include "core/Exports.h"
+#include "core/Rune.h"
+
+#include <cstddef>
+
+namespace core
+{
+	// utf8 routines which work on whole strings at once, they back StringView::isValidUtf8, Rune::count, Rune::decode
+	// and OSString, validation and counting use avx2 when the running cpu has it (see cpuFeatures) and the conversions
+	// move ascii runs a vector at a time and only decode the other runes one by one
+	class Utf8
+	{
+	public:
+		// returns true if the bytes are well formed utf8, which rejects overlong encodings, surrogates, runes above
+		// 0x10FFFF and truncated sequences
+		CORE_EXPORT static bool validate(const char* ptr, size_t count);
+		// returns the count of runes in the bytes which is the count of bytes that aren't continuation bytes
+		CORE_EXPORT static size_t countRunes(const char* ptr, size_t count);
+		// decodes the rune at the start of the bytes and returns its size in bytes, an invalid or truncated sequence
+		// decodes to Rune{-1} with a size of 1 and empty bytes decode to Rune{} with a size of 0, it doesn't read past
+		// the first byte which doesn't belong to the sequence so it's safe on null terminated strings
+		CORE_EXPORT static size_t decode(const char* ptr, size_t count, Rune& rune);
+		// converts utf8 to utf16, out must have room for count code units since no rune is longer in utf16 than in
+		// utf8, invalid sequences are replaced by U+FFFD, returns the count of written code units
+		CORE_EXPORT static size_t toUtf16(const char* ptr, size_t count, char16_t* out);
+		// converts utf8 to utf32, out must have room for count code units, invalid sequences are replaced by U+FFFD,
+		// returns the count of written code units
+		CORE_EXPORT static size_t toUtf32(const char* ptr, size_t count, char32_t* out);
+		// converts utf16 to utf8, out must have room for 3 * count bytes, unpaired surrogates are replaced by U+FFFD,
+		// returns the count of written bytes
+		CORE_EXPORT static size_t fromUtf16(const char16_t* ptr, size_t count, char* out);
+	};
+}
\ No newline at end of file
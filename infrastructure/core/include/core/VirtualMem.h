@@ -7,7 +7,43 @@ namespace core
 {
 	class VirtualMem: public Allocator
 	{
+		int m_flags = 0;
+		int m_numaNode = -1;
+
 	public:
+		enum FLAGS
+		{
+			FLAGS_NONE = 0,
+			// advises the kernel to back the memory with transparent huge pages, large reservations are aligned to the
+			// huge page size so that they can be fully covered
+			FLAGS_TRANSPARENT_HUGE_PAGES = 1 << 0,
+			// maps the memory with explicit huge pages, falls back to normal pages if the system has no huge pages
+			// available, the memory will be committed at allocation time
+			FLAGS_HUGE_PAGES = 1 << 1,
+			// prefaults the pages when they are committed so that the first touch doesn't page fault
+			FLAGS_PREFAULT = 1 << 2,
+		};
+
+		// don't bind the memory to any numa node
+		static constexpr int NUMA_NODE_ANY = -1;
+		// bind the memory to the numa node of the thread which calls alloc
+		static constexpr int NUMA_NODE_LOCAL = -2;
+
+		VirtualMem() = default;
+		explicit VirtualMem(int flags, int numaNode = NUMA_NODE_ANY)
+			: m_flags(flags),
+			  m_numaNode(numaNode)
+		{}
+
+		int flags() const
+		{
+			return m_flags;
+		}
+		int numaNode() const
+		{
+			return m_numaNode;
+		}
+
 		CORE_EXPORT Span<std::byte> alloc(size_t size, size_t alignment) override;
 		CORE_EXPORT void commit(Span<std::byte> bytes) override;
 		CORE_EXPORT void release(Span<std::byte> bytes) override;
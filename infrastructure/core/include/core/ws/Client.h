@@ -24,9 +24,9 @@ namespace core::ws
 
 		HumanError write(Span<const std::byte> bytes);
 		HumanError read(Span<std::byte> bytes);
-		HumanError sendHandshake(const Url& url, const String& base64Key);
+		HumanError sendHandshake(const UrlView& url, StringView base64Key);
 		Result<String> readHTTP(size_t maxSize);
-		HumanError handshake(const Url& url);
+		HumanError handshake(const UrlView& url);
 		HumanError serverHandshake();
 		HumanError writeFrame(Frame::OPCODE opcode, Span<const std::byte> payload);
 		HumanError writeCloseWithCode(uint16_t code, StringView reason);
@@ -0,0 +1,33 @@
+#include "core/Allocator.h"
+#include "core/Mallocator.h"
+
+namespace core
+{
+	inline static Allocator* defaultAllocator()
+	{
+		static Mallocator mallocator;
+		return &mallocator;
+	}
+
+	thread_local Allocator* t_currentAllocator = nullptr;
+
+	Allocator* currentAllocator()
+	{
+		if (t_currentAllocator)
+		{
+			return t_currentAllocator;
+		}
+		return defaultAllocator();
+	}
+
+	AllocatorScope::AllocatorScope(Allocator* allocator)
+		: m_previous(t_currentAllocator)
+	{
+		t_currentAllocator = allocator;
+	}
+
+	AllocatorScope::~AllocatorScope()
+	{
+		t_currentAllocator = m_previous;
+	}
+}
\ No newline at end of file
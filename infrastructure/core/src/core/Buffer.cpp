@@ -7,63 +7,81 @@ namespace core
 {
 	void Buffer::destroy()
 	{
-		if (m_allocator == nullptr || m_memory.empty())
+		if (isHeap() == false)
 		{
 			return;
 		}
 
-		m_allocator->release(m_memory);
-		m_allocator->free(m_memory);
+		auto memory = Span<std::byte>{m_heap.ptr, capacity()};
+		m_allocator->release(memory);
+		m_allocator->free(memory);
+		m_inline = InlineMemory{};
 	}
 
 	void Buffer::copyFrom(const core::Buffer& other)
 	{
 		m_allocator = other.m_allocator;
-		m_count = other.m_count;
+		auto count = other.count();
 
-		m_memory = m_allocator->alloc(other.m_memory.count(), alignof(std::byte));
-		m_allocator->commit(m_memory);
+		if (count <= INLINE_CAPACITY)
+		{
+			m_inline = InlineMemory{};
+			::memcpy(m_inline.data, other.ptr(), count);
+			m_inline.count = uint8_t(count);
+		}
+		else
+		{
+			auto memory = m_allocator->alloc(count, alignof(std::byte));
+			m_allocator->commit(memory);
 
-		::memcpy(m_memory.data(), other.m_memory.data(), m_memory.count());
+			::memcpy(memory.data(), other.ptr(), count);
+
+			m_heap.ptr = memory.data();
+			m_heap.count = count;
+			m_heap.capacity = memory.count() | HEAP_FLAG;
+		}
 	}
 
 	void Buffer::moveFrom(core::Buffer& other)
 	{
 		m_allocator = other.m_allocator;
-		m_memory = other.m_memory;
-		m_count = other.m_count;
+		if (other.isHeap())
+		{
+			m_heap = other.m_heap;
+		}
+		else
+		{
+			m_inline = other.m_inline;
+		}
 
 		other.m_allocator = nullptr;
-		other.m_memory = Span<std::byte>{};
-		other.m_count = 0;
+		other.m_inline = InlineMemory{};
 	}
 
 	void Buffer::grow(size_t new_capacity)
 	{
+		auto count = this->count();
 		auto new_memory = m_allocator->alloc(new_capacity, alignof(std::byte));
-		m_allocator->commit(new_memory.sliceLeft(m_count));
+		m_allocator->commit(new_memory.sliceLeft(count));
 
-		::memcpy(new_memory.data(), m_memory.data(), m_count);
+		::memcpy(new_memory.data(), ptr(), count);
 
-		m_allocator->release(m_memory);
-		m_allocator->free(m_memory);
+		destroy();
 
-		m_memory = new_memory;
+		m_heap.ptr = new_memory.data();
+		m_heap.count = count;
+		m_heap.capacity = new_memory.count() | HEAP_FLAG;
 	}
 
 	void Buffer::ensureSpaceExists(size_t count)
 	{
-		if (m_count + count > m_memory.count())
+		auto old_capacity = capacity();
+		if (this->count() + count > old_capacity)
 		{
-			auto new_capacity = m_memory.count() * 2;
-			if (new_capacity == 0)
+			auto new_capacity = old_capacity * 2;
+			if (new_capacity < this->count() + count)
 			{
-				new_capacity = 8;
-			}
-
-			if (new_capacity < m_count + count)
-			{
-				new_capacity = m_count + count;
+				new_capacity = this->count() + count;
 			}
 
 			grow(new_capacity);
@@ -73,42 +91,60 @@ namespace core
 	Buffer::Buffer(String&& str)
 	{
 		m_allocator = str.m_allocator;
-		m_memory = Span<std::byte>{(std::byte*)str.m_memory.data(), str.m_memory.count()};
-		m_count = str.m_count;
 
-		str.m_memory = Span<char>{};
-		str.m_count = 0;
+		// inline strings always fit in the inline buffer, otherwise we steal the string's heap memory
+		if (str.isHeap())
+		{
+			m_heap.ptr = (std::byte*)str.m_heap.ptr;
+			m_heap.count = str.m_heap.count;
+			m_heap.capacity = str.m_heap.capacity;
+		}
+		else
+		{
+			static_assert(String::INLINE_CAPACITY <= INLINE_CAPACITY);
+			::memcpy(m_inline.data, str.m_inline.data, str.m_inline.count);
+			m_inline.count = str.m_inline.count;
+		}
+
+		str.m_inline = String::InlineMemory{};
 	}
 
 	void Buffer::push(const std::byte* ptr, size_t size)
 	{
 		ensureSpaceExists(size);
-		::memcpy(m_memory.sliceRight(m_count).data(), ptr, size);
-		m_count += size;
+		auto count = this->count();
+		::memcpy(this->ptr() + count, ptr, size);
+		setCount(count + size);
 	}
 
 	void Buffer::resize(size_t new_count)
 	{
-		if (new_count > m_memory.count())
-		{
-			grow(new_count);
-			m_allocator->commit(m_memory.slice(m_count, new_count));
-		}
-		else if (new_count < m_memory.count())
+		auto count = this->count();
+		if (new_count > count)
 		{
-			m_allocator->release(m_memory.slice(new_count, m_count));
+			ensureSpaceExists(new_count - count);
+			if (isHeap())
+			{
+				m_allocator->commit(Span<std::byte>{m_heap.ptr + count, new_count - count});
+			}
 		}
-		else
+		else if (new_count < count)
 		{
-			m_allocator->commit(m_memory.slice(m_count, new_count));
+			if (isHeap())
+			{
+				m_allocator->release(Span<std::byte>{m_heap.ptr + new_count, count - new_count});
+			}
 		}
 
-		m_count = new_count;
+		setCount(new_count);
 	}
 
 	void Buffer::clear()
 	{
-		m_allocator->release(m_memory.sliceLeft(m_count));
-		m_count = 0;
+		if (isHeap())
+		{
+			m_allocator->release(Span<std::byte>{m_heap.ptr, m_heap.count});
+		}
+		setCount(0);
 	}
 }
\ No newline at end of file
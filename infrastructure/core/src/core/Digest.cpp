@@ -0,0 +1,886 @@
+#include "core/Digest.h"
+#include "core/CUtils.h"
+#include "core/File.h"
+#include "core/Intrinsics.h"
+#include "core/Shared.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+namespace core
+{
+	// the size of each read when hashing a file, it's big enough to keep all the pool threads busy with blake3
+	constexpr size_t DIGEST_FILE_READ_SIZE = 16ULL * 1024 * 1024;
+	constexpr size_t DIGEST_FILE_READ_ALIGNMENT = 4096;
+
+	inline static uint32_t digestRead32be(const std::byte* ptr)
+	{
+		auto p = reinterpret_cast<const uint8_t*>(ptr);
+		return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+	}
+
+	inline static uint32_t digestRead32le(const std::byte* ptr)
+	{
+		auto p = reinterpret_cast<const uint8_t*>(ptr);
+		return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+	}
+
+	inline static void digestWrite32be(std::byte* ptr, uint32_t value)
+	{
+		ptr[0] = std::byte(value >> 24);
+		ptr[1] = std::byte(value >> 16);
+		ptr[2] = std::byte(value >> 8);
+		ptr[3] = std::byte(value);
+	}
+
+	inline static void digestWrite32le(std::byte* ptr, uint32_t value)
+	{
+		ptr[0] = std::byte(value);
+		ptr[1] = std::byte(value >> 8);
+		ptr[2] = std::byte(value >> 16);
+		ptr[3] = std::byte(value >> 24);
+	}
+
+	inline static uint32_t digestRotr(uint32_t value, int count)
+	{
+		return (value >> count) | (value << (32 - count));
+	}
+
+	// the first 32 bits of the fractional parts of the cube roots of the first 64 primes
+	alignas(16) static constexpr uint32_t SHA256_K[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+	};
+
+	// the first 32 bits of the fractional parts of the square roots of the first 8 primes, blake3 uses it too
+	static constexpr uint32_t SHA256_IV[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+	static void sha256CompressScalar(uint32_t state[8], const std::byte* ptr, size_t blocks)
+	{
+		for (; blocks > 0; --blocks, ptr += 64)
+		{
+			uint32_t w[64];
+			for (size_t i = 0; i < 16; ++i)
+			{
+				w[i] = digestRead32be(ptr + i * 4);
+			}
+			for (size_t i = 16; i < 64; ++i)
+			{
+				auto s0 = digestRotr(w[i - 15], 7) ^ digestRotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+				auto s1 = digestRotr(w[i - 2], 17) ^ digestRotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+				w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+			}
+
+			auto a = state[0], b = state[1], c = state[2], d = state[3];
+			auto e = state[4], f = state[5], g = state[6], h = state[7];
+			for (size_t i = 0; i < 64; ++i)
+			{
+				auto s1 = digestRotr(e, 6) ^ digestRotr(e, 11) ^ digestRotr(e, 25);
+				auto ch = (e & f) ^ (~e & g);
+				auto t1 = h + s1 + ch + SHA256_K[i] + w[i];
+				auto s0 = digestRotr(a, 2) ^ digestRotr(a, 13) ^ digestRotr(a, 22);
+				auto maj = (a & b) ^ (a & c) ^ (b & c);
+				auto t2 = s0 + maj;
+				h = g;
+				g = f;
+				f = e;
+				e = d + t1;
+				d = c;
+				c = b;
+				b = a;
+				a = t1 + t2;
+			}
+
+			state[0] += a;
+			state[1] += b;
+			state[2] += c;
+			state[3] += d;
+			state[4] += e;
+			state[5] += f;
+			state[6] += g;
+			state[7] += h;
+		}
+	}
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+	// the sha extensions keep the state as ABEF and CDGH and each sha256rnds2 does 2 rounds
+	TAHA_TARGET_SHA inline static void sha256RoundsSha(__m128i& abef, __m128i& cdgh, __m128i words, size_t index)
+	{
+		auto msg = _mm_add_epi32(words, _mm_load_si128((const __m128i*)&SHA256_K[index]));
+		cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+		abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(msg, 0x0E));
+	}
+
+	// the 4 message words which come 16 words after the ones in w0
+	TAHA_TARGET_SHA inline static __m128i sha256ScheduleSha(__m128i w0, __m128i w4, __m128i w8, __m128i w12)
+	{
+		auto res = _mm_add_epi32(_mm_sha256msg1_epu32(w0, w4), _mm_alignr_epi8(w12, w8, 4));
+		return _mm_sha256msg2_epu32(res, w12);
+	}
+
+	TAHA_TARGET_SHA static void sha256CompressSha(uint32_t state[8], const std::byte* ptr, size_t blocks)
+	{
+		const auto byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+		auto dcba = _mm_loadu_si128((const __m128i*)&state[0]);
+		auto hgfe = _mm_loadu_si128((const __m128i*)&state[4]);
+		auto cdab = _mm_shuffle_epi32(dcba, 0xB1);
+		auto efgh = _mm_shuffle_epi32(hgfe, 0x1B);
+		auto abef = _mm_alignr_epi8(cdab, efgh, 8);
+		auto cdgh = _mm_blend_epi16(efgh, cdab, 0xF0);
+
+		for (; blocks > 0; --blocks, ptr += 64)
+		{
+			auto abefSaved = abef;
+			auto cdghSaved = cdgh;
+
+			auto w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(ptr + 0)), byteSwap);
+			auto w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(ptr + 16)), byteSwap);
+			auto w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(ptr + 32)), byteSwap);
+			auto w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(ptr + 48)), byteSwap);
+			sha256RoundsSha(abef, cdgh, w0, 0);
+			sha256RoundsSha(abef, cdgh, w1, 4);
+			sha256RoundsSha(abef, cdgh, w2, 8);
+			sha256RoundsSha(abef, cdgh, w3, 12);
+			for (size_t i = 16; i < 64; i += 16)
+			{
+				w0 = sha256ScheduleSha(w0, w1, w2, w3);
+				sha256RoundsSha(abef, cdgh, w0, i);
+				w1 = sha256ScheduleSha(w1, w2, w3, w0);
+				sha256RoundsSha(abef, cdgh, w1, i + 4);
+				w2 = sha256ScheduleSha(w2, w3, w0, w1);
+				sha256RoundsSha(abef, cdgh, w2, i + 8);
+				w3 = sha256ScheduleSha(w3, w0, w1, w2);
+				sha256RoundsSha(abef, cdgh, w3, i + 12);
+			}
+
+			abef = _mm_add_epi32(abef, abefSaved);
+			cdgh = _mm_add_epi32(cdgh, cdghSaved);
+		}
+
+		auto feba = _mm_shuffle_epi32(abef, 0x1B);
+		auto dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+		_mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(feba, dchg, 0xF0));
+		_mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(dchg, feba, 8));
+	}
+#endif
+
+	inline static void sha256Compress(uint32_t state[8], const std::byte* ptr, size_t blocks)
+	{
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+		if (cpuFeatures().sha)
+		{
+			sha256CompressSha(state, ptr, blocks);
+			return;
+		}
+#endif
+		sha256CompressScalar(state, ptr, blocks);
+	}
+
+	// blake3 splits the input into 1KB chunks which are hashed 64 bytes at a time, the chaining values of the chunks
+	// are the leaves of a binary tree whose left subtrees are always complete
+	constexpr size_t BLAKE3_BLOCK_SIZE = 64;
+	constexpr size_t BLAKE3_CHUNK_SIZE = 1024;
+	constexpr size_t BLAKE3_CHUNK_BLOCKS = BLAKE3_CHUNK_SIZE / BLAKE3_BLOCK_SIZE;
+	constexpr uint32_t BLAKE3_CHUNK_START = 1 << 0;
+	constexpr uint32_t BLAKE3_CHUNK_END = 1 << 1;
+	constexpr uint32_t BLAKE3_PARENT = 1 << 2;
+	constexpr uint32_t BLAKE3_ROOT = 1 << 3;
+	// the chunks of the subtree which a pool task hashes, 1MB is big enough to hide the cost of scheduling it
+	constexpr uint64_t BLAKE3_TASK_CHUNKS = 1024;
+	// the tasks which run together before their chaining values are merged into the tree
+	constexpr size_t BLAKE3_BATCH_TASKS = 64;
+
+	// the order in which each of the 7 rounds reads the message words, it's the permutation applied again every round
+	static constexpr auto BLAKE3_SCHEDULE = [] {
+		constexpr uint8_t permutation[16] = {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8};
+		std::array<std::array<uint8_t, 16>, 7> res{};
+		for (uint8_t i = 0; i < 16; ++i)
+		{
+			res[0][i] = i;
+		}
+		for (size_t round = 1; round < 7; ++round)
+		{
+			for (size_t i = 0; i < 16; ++i)
+			{
+				res[round][i] = res[round - 1][permutation[i]];
+			}
+		}
+		return res;
+	}();
+
+	inline static void blake3G(uint32_t v[16], int a, int b, int c, int d, uint32_t x, uint32_t y)
+	{
+		v[a] = v[a] + v[b] + x;
+		v[d] = digestRotr(v[d] ^ v[a], 16);
+		v[c] = v[c] + v[d];
+		v[b] = digestRotr(v[b] ^ v[c], 12);
+		v[a] = v[a] + v[b] + y;
+		v[d] = digestRotr(v[d] ^ v[a], 8);
+		v[c] = v[c] + v[d];
+		v[b] = digestRotr(v[b] ^ v[c], 7);
+	}
+
+	static void blake3Compress(
+		const uint32_t cv[8], const uint32_t block[16], uint64_t counter, uint32_t blockCount, uint32_t flags,
+		uint32_t out[16])
+	{
+		uint32_t v[16] = {
+			cv[0],
+			cv[1],
+			cv[2],
+			cv[3],
+			cv[4],
+			cv[5],
+			cv[6],
+			cv[7],
+			SHA256_IV[0],
+			SHA256_IV[1],
+			SHA256_IV[2],
+			SHA256_IV[3],
+			uint32_t(counter),
+			uint32_t(counter >> 32),
+			blockCount,
+			flags,
+		};
+
+		for (const auto& s: BLAKE3_SCHEDULE)
+		{
+			blake3G(v, 0, 4, 8, 12, block[s[0]], block[s[1]]);
+			blake3G(v, 1, 5, 9, 13, block[s[2]], block[s[3]]);
+			blake3G(v, 2, 6, 10, 14, block[s[4]], block[s[5]]);
+			blake3G(v, 3, 7, 11, 15, block[s[6]], block[s[7]]);
+			blake3G(v, 0, 5, 10, 15, block[s[8]], block[s[9]]);
+			blake3G(v, 1, 6, 11, 12, block[s[10]], block[s[11]]);
+			blake3G(v, 2, 7, 8, 13, block[s[12]], block[s[13]]);
+			blake3G(v, 3, 4, 9, 14, block[s[14]], block[s[15]]);
+		}
+
+		for (size_t i = 0; i < 8; ++i)
+		{
+			out[i] = v[i] ^ v[i + 8];
+			out[i + 8] = v[i + 8] ^ cv[i];
+		}
+	}
+
+	inline static void blake3ReadBlock(const std::byte* ptr, size_t count, uint32_t block[16])
+	{
+		std::byte padded[BLAKE3_BLOCK_SIZE] = {};
+		::memcpy(padded, ptr, count);
+		for (size_t i = 0; i < 16; ++i)
+		{
+			block[i] = digestRead32le(padded + i * 4);
+		}
+	}
+
+	static void blake3ChunkCV(const std::byte* ptr, uint64_t counter, uint32_t cv[8])
+	{
+		::memcpy(cv, SHA256_IV, sizeof(SHA256_IV));
+		for (size_t i = 0; i < BLAKE3_CHUNK_BLOCKS; ++i)
+		{
+			uint32_t block[16];
+			blake3ReadBlock(ptr + i * BLAKE3_BLOCK_SIZE, BLAKE3_BLOCK_SIZE, block);
+
+			uint32_t flags = 0;
+			if (i == 0)
+			{
+				flags |= BLAKE3_CHUNK_START;
+			}
+			if (i + 1 == BLAKE3_CHUNK_BLOCKS)
+			{
+				flags |= BLAKE3_CHUNK_END;
+			}
+
+			uint32_t out[16];
+			blake3Compress(cv, block, counter, BLAKE3_BLOCK_SIZE, flags, out);
+			::memcpy(cv, out, 8 * sizeof(uint32_t));
+		}
+	}
+
+	// cv may be the same as left or right
+	inline static void blake3ParentCV(const uint32_t left[8], const uint32_t right[8], uint32_t cv[8])
+	{
+		uint32_t block[16];
+		::memcpy(block, left, 8 * sizeof(uint32_t));
+		::memcpy(block + 8, right, 8 * sizeof(uint32_t));
+
+		uint32_t out[16];
+		blake3Compress(SHA256_IV, block, 0, BLAKE3_BLOCK_SIZE, BLAKE3_PARENT, out);
+		::memcpy(cv, out, 8 * sizeof(uint32_t));
+	}
+
+	// pushes the chaining value of the subtree which makes the tree totalCount subtrees of its size, then merges every
+	// pair of subtrees which became complete, which are as many as the trailing zeros of totalCount
+	inline static void blake3PushCV(uint32_t stack[][8], size_t& stackCount, const uint32_t cv[8], uint64_t totalCount)
+	{
+		uint32_t merged[8];
+		::memcpy(merged, cv, sizeof(merged));
+		while ((totalCount & 1) == 0)
+		{
+			blake3ParentCV(stack[--stackCount], merged, merged);
+			totalCount >>= 1;
+		}
+		::memcpy(stack[stackCount++], merged, sizeof(merged));
+	}
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+	TAHA_TARGET_AVX2 inline static __m256i blake3RotrAvx2(__m256i value, int count)
+	{
+		return _mm256_or_si256(_mm256_srli_epi32(value, count), _mm256_slli_epi32(value, 32 - count));
+	}
+
+	TAHA_TARGET_AVX2 inline static void
+	blake3GAvx2(__m256i v[16], int a, int b, int c, int d, __m256i x, __m256i y, __m256i rotr16, __m256i rotr8)
+	{
+		v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), x);
+		v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rotr16);
+		v[c] = _mm256_add_epi32(v[c], v[d]);
+		v[b] = blake3RotrAvx2(_mm256_xor_si256(v[b], v[c]), 12);
+		v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), y);
+		v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rotr8);
+		v[c] = _mm256_add_epi32(v[c], v[d]);
+		v[b] = blake3RotrAvx2(_mm256_xor_si256(v[b], v[c]), 7);
+	}
+
+	// turns 8 vectors of 8 words into 8 vectors of the 1st words, the 2nd words and so on
+	TAHA_TARGET_AVX2 inline static void blake3TransposeAvx2(__m256i v[8])
+	{
+		auto ab0145 = _mm256_unpacklo_epi32(v[0], v[1]);
+		auto ab2367 = _mm256_unpackhi_epi32(v[0], v[1]);
+		auto cd0145 = _mm256_unpacklo_epi32(v[2], v[3]);
+		auto cd2367 = _mm256_unpackhi_epi32(v[2], v[3]);
+		auto ef0145 = _mm256_unpacklo_epi32(v[4], v[5]);
+		auto ef2367 = _mm256_unpackhi_epi32(v[4], v[5]);
+		auto gh0145 = _mm256_unpacklo_epi32(v[6], v[7]);
+		auto gh2367 = _mm256_unpackhi_epi32(v[6], v[7]);
+
+		auto abcd04 = _mm256_unpacklo_epi64(ab0145, cd0145);
+		auto abcd15 = _mm256_unpackhi_epi64(ab0145, cd0145);
+		auto abcd26 = _mm256_unpacklo_epi64(ab2367, cd2367);
+		auto abcd37 = _mm256_unpackhi_epi64(ab2367, cd2367);
+		auto efgh04 = _mm256_unpacklo_epi64(ef0145, gh0145);
+		auto efgh15 = _mm256_unpackhi_epi64(ef0145, gh0145);
+		auto efgh26 = _mm256_unpacklo_epi64(ef2367, gh2367);
+		auto efgh37 = _mm256_unpackhi_epi64(ef2367, gh2367);
+
+		v[0] = _mm256_permute2x128_si256(abcd04, efgh04, 0x20);
+		v[1] = _mm256_permute2x128_si256(abcd15, efgh15, 0x20);
+		v[2] = _mm256_permute2x128_si256(abcd26, efgh26, 0x20);
+		v[3] = _mm256_permute2x128_si256(abcd37, efgh37, 0x20);
+		v[4] = _mm256_permute2x128_si256(abcd04, efgh04, 0x31);
+		v[5] = _mm256_permute2x128_si256(abcd15, efgh15, 0x31);
+		v[6] = _mm256_permute2x128_si256(abcd26, efgh26, 0x31);
+		v[7] = _mm256_permute2x128_si256(abcd37, efgh37, 0x31);
+	}
+
+	// hashes 8 inputs of the given count of blocks at once with a lane for each input, the inputs are stride bytes
+	// apart and the counter of each is counterStep more than the one before, it's used for chunks and for parents
+	TAHA_TARGET_AVX2 static void blake3Hash8Avx2(
+		const std::byte* ptr,
+		size_t stride,
+		size_t blocks,
+		uint64_t counter,
+		uint64_t counterStep,
+		uint32_t flags,
+		uint32_t flagsStart,
+		uint32_t flagsEnd,
+		uint32_t cvs[8][8])
+	{
+		// rotating by whole bytes is a shuffle
+		const auto rotr16 =
+			_mm256_broadcastsi128_si256(_mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+		const auto rotr8 =
+			_mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12));
+
+		alignas(32) uint32_t counterLow[8];
+		alignas(32) uint32_t counterHigh[8];
+		for (size_t i = 0; i < 8; ++i)
+		{
+			counterLow[i] = uint32_t(counter + i * counterStep);
+			counterHigh[i] = uint32_t((counter + i * counterStep) >> 32);
+		}
+
+		__m256i h[8];
+		for (size_t i = 0; i < 8; ++i)
+		{
+			h[i] = _mm256_set1_epi32(int(SHA256_IV[i]));
+		}
+
+		for (size_t blockIndex = 0; blockIndex < blocks; ++blockIndex)
+		{
+			__m256i m[16];
+			for (size_t i = 0; i < 8; ++i)
+			{
+				auto block = ptr + i * stride + blockIndex * BLAKE3_BLOCK_SIZE;
+				m[i] = _mm256_loadu_si256((const __m256i*)block);
+				m[i + 8] = _mm256_loadu_si256((const __m256i*)(block + 32));
+			}
+			blake3TransposeAvx2(m);
+			blake3TransposeAvx2(m + 8);
+
+			auto blockFlags = flags;
+			if (blockIndex == 0)
+			{
+				blockFlags |= flagsStart;
+			}
+			if (blockIndex + 1 == blocks)
+			{
+				blockFlags |= flagsEnd;
+			}
+
+			__m256i v[16] = {
+				h[0],
+				h[1],
+				h[2],
+				h[3],
+				h[4],
+				h[5],
+				h[6],
+				h[7],
+				_mm256_set1_epi32(int(SHA256_IV[0])),
+				_mm256_set1_epi32(int(SHA256_IV[1])),
+				_mm256_set1_epi32(int(SHA256_IV[2])),
+				_mm256_set1_epi32(int(SHA256_IV[3])),
+				_mm256_load_si256((const __m256i*)counterLow),
+				_mm256_load_si256((const __m256i*)counterHigh),
+				_mm256_set1_epi32(int(BLAKE3_BLOCK_SIZE)),
+				_mm256_set1_epi32(int(blockFlags)),
+			};
+
+			for (const auto& s: BLAKE3_SCHEDULE)
+			{
+				blake3GAvx2(v, 0, 4, 8, 12, m[s[0]], m[s[1]], rotr16, rotr8);
+				blake3GAvx2(v, 1, 5, 9, 13, m[s[2]], m[s[3]], rotr16, rotr8);
+				blake3GAvx2(v, 2, 6, 10, 14, m[s[4]], m[s[5]], rotr16, rotr8);
+				blake3GAvx2(v, 3, 7, 11, 15, m[s[6]], m[s[7]], rotr16, rotr8);
+				blake3GAvx2(v, 0, 5, 10, 15, m[s[8]], m[s[9]], rotr16, rotr8);
+				blake3GAvx2(v, 1, 6, 11, 12, m[s[10]], m[s[11]], rotr16, rotr8);
+				blake3GAvx2(v, 2, 7, 8, 13, m[s[12]], m[s[13]], rotr16, rotr8);
+				blake3GAvx2(v, 3, 4, 9, 14, m[s[14]], m[s[15]], rotr16, rotr8);
+			}
+
+			for (size_t i = 0; i < 8; ++i)
+			{
+				h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+			}
+		}
+
+		blake3TransposeAvx2(h);
+		for (size_t i = 0; i < 8; ++i)
+		{
+			_mm256_storeu_si256((__m256i*)cvs[i], h[i]);
+		}
+	}
+#endif
+
+	// the chaining values of up to 8 consecutive whole chunks
+	inline static void blake3ChunkCVs(const std::byte* ptr, uint64_t count, uint64_t counter, uint32_t cvs[8][8])
+	{
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+		if (count == 8 && cpuFeatures().avx2)
+		{
+			blake3Hash8Avx2(
+				ptr, BLAKE3_CHUNK_SIZE, BLAKE3_CHUNK_BLOCKS, counter, 1, 0, BLAKE3_CHUNK_START, BLAKE3_CHUNK_END, cvs);
+			return;
+		}
+#endif
+		for (size_t i = 0; i < count; ++i)
+		{
+			blake3ChunkCV(ptr + i * BLAKE3_CHUNK_SIZE, counter + i, cvs[i]);
+		}
+	}
+
+	// the chaining values of the parents of count pairs of consecutive children, cvs may be the same as children
+	// because each group of 8 parents is written after its 16 children are read
+	inline static void blake3ParentCVs(const uint32_t children[][8], size_t count, uint32_t cvs[][8])
+	{
+		size_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+		if (cpuFeatures().avx2)
+		{
+			for (; i + 8 <= count; i += 8)
+			{
+				blake3Hash8Avx2(
+					(const std::byte*)children[2 * i], BLAKE3_BLOCK_SIZE, 1, 0, 0, BLAKE3_PARENT, 0, 0, cvs + i);
+			}
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			blake3ParentCV(children[2 * i], children[2 * i + 1], cvs[i]);
+		}
+	}
+
+	// the chaining value of the BLAKE3_TASK_CHUNKS chunks subtree which starts at the given chunk counter, the tree is
+	// reduced a level at a time so the parents are hashed 8 at a time too
+	static void blake3SubtreeCV(const std::byte* ptr, uint64_t counter, uint32_t cv[8])
+	{
+		uint32_t cvs[BLAKE3_TASK_CHUNKS][8];
+		for (uint64_t i = 0; i < BLAKE3_TASK_CHUNKS; i += 8)
+		{
+			blake3ChunkCVs(ptr + i * BLAKE3_CHUNK_SIZE, 8, counter + i, cvs + i);
+		}
+		for (size_t count = BLAKE3_TASK_CHUNKS; count > 1; count /= 2)
+		{
+			blake3ParentCVs(cvs, count / 2, cvs);
+		}
+		::memcpy(cv, cvs[0], sizeof(cvs[0]));
+	}
+
+	// the subtrees which the pool threads and the calling thread take one at a time, it's shared with the pool tasks
+	// because the ones which start after all the work is done still need to look at it
+	struct Blake3Batch
+	{
+		const std::byte* ptr = nullptr;
+		uint64_t counter = 0;
+		size_t count = 0;
+		std::atomic<size_t> next = 0;
+		std::atomic<size_t> finished = 0;
+		uint32_t cvs[BLAKE3_BATCH_TASKS][8];
+	};
+
+	static void blake3RunBatch(Blake3Batch& batch)
+	{
+		for (auto i = batch.next.fetch_add(1); i < batch.count; i = batch.next.fetch_add(1))
+		{
+			auto ptr = batch.ptr + i * BLAKE3_TASK_CHUNKS * BLAKE3_CHUNK_SIZE;
+			blake3SubtreeCV(ptr, batch.counter + i * BLAKE3_TASK_CHUNKS, batch.cvs[i]);
+			if (batch.finished.fetch_add(1) + 1 == batch.count)
+			{
+				batch.finished.notify_all();
+			}
+		}
+	}
+
+	Digest Digest::sha256(Span<const std::byte> bytes)
+	{
+		SHA256Hasher hasher;
+		hasher.hash(bytes);
+		return hasher.final();
+	}
+
+	Digest Digest::blake3(Span<const std::byte> bytes)
+	{
+		Blake3Hasher hasher;
+		hasher.hash(bytes);
+		return hasher.final();
+	}
+
+	Digest Digest::blake3(Span<const std::byte> bytes, ThreadPool* pool, Allocator* allocator)
+	{
+		Blake3Hasher hasher{pool, allocator};
+		hasher.hash(bytes);
+		return hasher.final();
+	}
+
+	Result<Digest> Digest::hashFile(Allocator* allocator, StringView path, ALGORITHM algorithm, ThreadPool* pool)
+	{
+		auto file = File::open(allocator, path, File::IO_MODE_READ, File::OPEN_MODE_OPEN_ONLY);
+		if (!file)
+		{
+			return errf(allocator, "failed to open file '{}'"_sv, path);
+		}
+
+		SHA256Hasher sha256Hasher;
+		Blake3Hasher blake3Hasher{pool, allocator};
+		DigestHasher* hasher = &sha256Hasher;
+		if (algorithm == ALGORITHM_BLAKE3)
+		{
+			hasher = &blake3Hasher;
+		}
+
+		auto buffer = allocator->alloc(DIGEST_FILE_READ_SIZE, DIGEST_FILE_READ_ALIGNMENT);
+		allocator->commit(buffer);
+		coreDefer
+		{
+			allocator->release(buffer);
+			allocator->free(buffer);
+		};
+
+		while (true)
+		{
+			// fill the whole buffer so that blake3 gets whole chunks and big enough inputs to split over the pool
+			size_t count = 0;
+			while (count < buffer.count())
+			{
+				auto readCount = file->read(buffer.data() + count, buffer.count() - count);
+				if (readCount == SIZE_MAX)
+				{
+					return errf(allocator, "failed to read file '{}'"_sv, path);
+				}
+				if (readCount == 0)
+				{
+					break;
+				}
+				count += readCount;
+			}
+
+			hasher->hash(Span<const std::byte>{buffer.data(), count});
+			if (count < buffer.count())
+			{
+				break;
+			}
+		}
+
+		return hasher->final();
+	}
+
+	SHA256Hasher::SHA256Hasher()
+	{
+		::memcpy(m_state, SHA256_IV, sizeof(m_state));
+	}
+
+	void SHA256Hasher::hash(Span<const std::byte> bytes)
+	{
+		auto ptr = bytes.data();
+		auto count = bytes.count();
+		if (count == 0)
+		{
+			return;
+		}
+		m_totalCount += count;
+
+		if (m_blockCount > 0)
+		{
+			auto copyCount = std::min(sizeof(m_block) - m_blockCount, count);
+			::memcpy(m_block + m_blockCount, ptr, copyCount);
+			m_blockCount += copyCount;
+			ptr += copyCount;
+			count -= copyCount;
+
+			if (m_blockCount < sizeof(m_block))
+			{
+				return;
+			}
+			sha256Compress(m_state, m_block, 1);
+			m_blockCount = 0;
+		}
+
+		auto blocks = count / sizeof(m_block);
+		if (blocks > 0)
+		{
+			sha256Compress(m_state, ptr, blocks);
+			ptr += blocks * sizeof(m_block);
+			count -= blocks * sizeof(m_block);
+		}
+
+		::memcpy(m_block, ptr, count);
+		m_blockCount = count;
+	}
+
+	Digest SHA256Hasher::final()
+	{
+		// the message is followed by a 1 bit, zeros and its length in bits as a big endian 64 bit integer
+		std::byte tail[128] = {};
+		::memcpy(tail, m_block, m_blockCount);
+		tail[m_blockCount] = std::byte(0x80);
+		size_t tailCount = m_blockCount + 9 <= 64 ? 64 : 128;
+		auto bitCount = m_totalCount * 8;
+		digestWrite32be(tail + tailCount - 8, uint32_t(bitCount >> 32));
+		digestWrite32be(tail + tailCount - 4, uint32_t(bitCount));
+
+		uint32_t state[8];
+		::memcpy(state, m_state, sizeof(state));
+		sha256Compress(state, tail, tailCount / 64);
+
+		Digest res{};
+		auto out = res.asBytes().data();
+		for (size_t i = 0; i < 8; ++i)
+		{
+			digestWrite32be(out + i * 4, state[i]);
+		}
+		return res;
+	}
+
+	void Blake3Hasher::hashChunks(const std::byte* ptr, uint64_t count)
+	{
+		while (count > 0)
+		{
+			auto batchCount = std::min<uint64_t>(count, 8);
+
+			uint32_t cvs[8][8];
+			blake3ChunkCVs(ptr, batchCount, m_chunkCounter, cvs);
+			for (size_t i = 0; i < batchCount; ++i)
+			{
+				++m_chunkCounter;
+				blake3PushCV(m_stack, m_stackCount, cvs[i], m_chunkCounter);
+			}
+
+			ptr += batchCount * BLAKE3_CHUNK_SIZE;
+			count -= batchCount;
+		}
+	}
+
+	void Blake3Hasher::hashSubtrees(const std::byte* ptr, uint64_t count)
+	{
+		// a subtree has to start at a multiple of its size so we hash chunks one by one until we reach one
+		auto unalignedCount = (BLAKE3_TASK_CHUNKS - m_chunkCounter % BLAKE3_TASK_CHUNKS) % BLAKE3_TASK_CHUNKS;
+		unalignedCount = std::min(count, unalignedCount);
+		hashChunks(ptr, unalignedCount);
+		ptr += unalignedCount * BLAKE3_CHUNK_SIZE;
+		count -= unalignedCount;
+
+		while (m_pool == nullptr && count >= BLAKE3_TASK_CHUNKS)
+		{
+			uint32_t cv[8];
+			blake3SubtreeCV(ptr, m_chunkCounter, cv);
+			m_chunkCounter += BLAKE3_TASK_CHUNKS;
+			blake3PushCV(m_stack, m_stackCount, cv, m_chunkCounter / BLAKE3_TASK_CHUNKS);
+
+			ptr += BLAKE3_TASK_CHUNKS * BLAKE3_CHUNK_SIZE;
+			count -= BLAKE3_TASK_CHUNKS;
+		}
+
+		while (count >= BLAKE3_TASK_CHUNKS)
+		{
+			auto batch = shared_from<Blake3Batch>(m_allocator);
+			batch->ptr = ptr;
+			batch->counter = m_chunkCounter;
+			batch->count = std::min<size_t>(count / BLAKE3_TASK_CHUNKS, BLAKE3_BATCH_TASKS);
+
+			auto helpersCount = std::min(batch->count - 1, m_pool->threadsCount());
+			for (size_t i = 0; i < helpersCount; ++i)
+			{
+				m_pool->run([batch] { blake3RunBatch(*batch); });
+			}
+			blake3RunBatch(*batch);
+			for (auto finished = batch->finished.load(); finished < batch->count; finished = batch->finished.load())
+			{
+				batch->finished.wait(finished);
+			}
+
+			for (size_t i = 0; i < batch->count; ++i)
+			{
+				m_chunkCounter += BLAKE3_TASK_CHUNKS;
+				blake3PushCV(m_stack, m_stackCount, batch->cvs[i], m_chunkCounter / BLAKE3_TASK_CHUNKS);
+			}
+
+			ptr += batch->count * BLAKE3_TASK_CHUNKS * BLAKE3_CHUNK_SIZE;
+			count -= batch->count * BLAKE3_TASK_CHUNKS;
+		}
+
+		hashChunks(ptr, count);
+	}
+
+	Blake3Hasher::Blake3Hasher()
+	{
+		::memcpy(m_chunkCV, SHA256_IV, sizeof(m_chunkCV));
+	}
+
+	Blake3Hasher::Blake3Hasher(ThreadPool* pool, Allocator* allocator)
+		: m_pool(pool),
+		  m_allocator(allocator)
+	{
+		::memcpy(m_chunkCV, SHA256_IV, sizeof(m_chunkCV));
+	}
+
+	void Blake3Hasher::hash(Span<const std::byte> bytes)
+	{
+		auto ptr = bytes.data();
+		auto count = bytes.count();
+		while (count > 0)
+		{
+			// the chunk is full and there's more input so it isn't the root and can be merged into the tree
+			if (m_chunkBlocks * BLAKE3_BLOCK_SIZE + m_blockCount == BLAKE3_CHUNK_SIZE)
+			{
+				uint32_t block[16];
+				blake3ReadBlock(m_block, m_blockCount, block);
+				uint32_t out[16];
+				blake3Compress(m_chunkCV, block, m_chunkCounter, uint32_t(m_blockCount), BLAKE3_CHUNK_END, out);
+
+				++m_chunkCounter;
+				blake3PushCV(m_stack, m_stackCount, out, m_chunkCounter);
+
+				::memcpy(m_chunkCV, SHA256_IV, sizeof(m_chunkCV));
+				m_chunkBlocks = 0;
+				m_blockCount = 0;
+			}
+
+			// whole chunks are hashed right from the input except for the last one which might be the root
+			if (m_chunkBlocks == 0 && m_blockCount == 0 && count > BLAKE3_CHUNK_SIZE)
+			{
+				auto chunksCount = (count - 1) / BLAKE3_CHUNK_SIZE;
+				if (chunksCount >= 2 * BLAKE3_TASK_CHUNKS)
+				{
+					hashSubtrees(ptr, chunksCount);
+				}
+				else
+				{
+					hashChunks(ptr, chunksCount);
+				}
+				ptr += chunksCount * BLAKE3_CHUNK_SIZE;
+				count -= chunksCount * BLAKE3_CHUNK_SIZE;
+				continue;
+			}
+
+			// same for a full block, it's only compressed when we know it's not the end of the chunk
+			if (m_blockCount == BLAKE3_BLOCK_SIZE)
+			{
+				uint32_t block[16];
+				blake3ReadBlock(m_block, m_blockCount, block);
+				uint32_t flags = m_chunkBlocks == 0 ? BLAKE3_CHUNK_START : 0;
+				uint32_t out[16];
+				blake3Compress(m_chunkCV, block, m_chunkCounter, BLAKE3_BLOCK_SIZE, flags, out);
+				::memcpy(m_chunkCV, out, sizeof(m_chunkCV));
+				++m_chunkBlocks;
+				m_blockCount = 0;
+			}
+
+			auto copyCount = std::min(BLAKE3_BLOCK_SIZE - m_blockCount, count);
+			::memcpy(m_block + m_blockCount, ptr, copyCount);
+			m_blockCount += copyCount;
+			ptr += copyCount;
+			count -= copyCount;
+		}
+	}
+
+	Digest Blake3Hasher::final()
+	{
+		// starts with the last chunk then makes it the right child of each stacked subtree from the smallest up
+		uint32_t cv[8];
+		::memcpy(cv, m_chunkCV, sizeof(cv));
+		uint32_t block[16];
+		blake3ReadBlock(m_block, m_blockCount, block);
+		uint64_t counter = m_chunkCounter;
+		auto blockCount = uint32_t(m_blockCount);
+		uint32_t flags = BLAKE3_CHUNK_END;
+		if (m_chunkBlocks == 0)
+		{
+			flags |= BLAKE3_CHUNK_START;
+		}
+
+		uint32_t out[16];
+		for (size_t i = m_stackCount; i > 0; --i)
+		{
+			blake3Compress(cv, block, counter, blockCount, flags, out);
+			::memcpy(block, m_stack[i - 1], sizeof(m_stack[i - 1]));
+			::memcpy(block + 8, out, 8 * sizeof(uint32_t));
+			::memcpy(cv, SHA256_IV, sizeof(cv));
+			counter = 0;
+			blockCount = BLAKE3_BLOCK_SIZE;
+			flags = BLAKE3_PARENT;
+		}
+		blake3Compress(cv, block, counter, blockCount, flags | BLAKE3_ROOT, out);
+
+		Digest res{};
+		auto bytes = res.asBytes().data();
+		for (size_t i = 0; i < 8; ++i)
+		{
+			digestWrite32le(bytes + i * 4, out[i]);
+		}
+		return res;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#include "core/HashFunction.h"
+#include "core/Rand.h"
+
+namespace core
+{
+	HashSeed HashSeed::random()
+	{
+		// the generator is per thread and seeded from the os, so tables which are built on different threads don't
+		// contend on a shared counter and their seeds can't be predicted from outside the process
+		return HashSeed{size_t(FastRand::threadLocal().next())};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "core/Hex.h"
+
+#include <array>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#endif
+
+namespace core
+{
+	static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+	// the value of each hex digit in either case and 0xFF for the rest
+	static constexpr auto HEX_VALUES = [] {
+		std::array<uint8_t, 256> res{};
+		for (size_t i = 0; i < res.size(); ++i)
+		{
+			if (i >= '0' && i <= '9')
+			{
+				res[i] = uint8_t(i - '0');
+			}
+			else if (i >= 'a' && i <= 'f')
+			{
+				res[i] = uint8_t(i - 'a' + 10);
+			}
+			else if (i >= 'A' && i <= 'F')
+			{
+				res[i] = uint8_t(i - 'A' + 10);
+			}
+			else
+			{
+				res[i] = 0xFF;
+			}
+		}
+		return res;
+	}();
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+	// turns nibbles into their lower case hex digits
+	inline static __m128i hexDigitsSse2(__m128i nibbles)
+	{
+		auto letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+		auto offset = _mm_add_epi8(_mm_set1_epi8('0'), _mm_and_si128(letters, _mm_set1_epi8('a' - '0' - 10)));
+		return _mm_add_epi8(nibbles, offset);
+	}
+
+	inline static __m128i hexInRangeSse2(__m128i chars, char lo, char hi)
+	{
+		return _mm_and_si128(
+			_mm_cmpgt_epi8(chars, _mm_set1_epi8(char(lo - 1))), _mm_cmpgt_epi8(_mm_set1_epi8(char(hi + 1)), chars));
+	}
+
+	// turns hex digits into their values and clears the lanes of valid which aren't hex digits
+	inline static __m128i hexValuesSse2(__m128i chars, __m128i& valid)
+	{
+		auto digit = hexInRangeSse2(chars, '0', '9');
+		// setting the 0x20 bit turns upper case letters into lower case ones and leaves the digits as they are
+		auto lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+		auto letter = hexInRangeSse2(lower, 'a', 'f');
+		valid = _mm_and_si128(valid, _mm_or_si128(digit, letter));
+		return _mm_or_si128(
+			_mm_and_si128(digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+			_mm_and_si128(letter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+	}
+#endif
+
+	size_t Hex::encode(Span<const std::byte> bytes, Span<char> out)
+	{
+		auto ptr = reinterpret_cast<const uint8_t*>(bytes.data());
+		auto count = bytes.count();
+		assertTrue(out.count() >= encodedCount(count));
+		auto it = out.data();
+
+		size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+		for (; i + 16 <= count; i += 16)
+		{
+			auto input = _mm_loadu_si128((const __m128i*)(ptr + i));
+			auto hi = hexDigitsSse2(_mm_and_si128(_mm_srli_epi16(input, 4), _mm_set1_epi8(0x0F)));
+			auto lo = hexDigitsSse2(_mm_and_si128(input, _mm_set1_epi8(0x0F)));
+			_mm_storeu_si128((__m128i*)it, _mm_unpacklo_epi8(hi, lo));
+			_mm_storeu_si128((__m128i*)(it + 16), _mm_unpackhi_epi8(hi, lo));
+			it += 32;
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			it[0] = HEX_DIGITS[ptr[i] >> 4];
+			it[1] = HEX_DIGITS[ptr[i] & 0x0F];
+			it += 2;
+		}
+		return encodedCount(count);
+	}
+
+	String Hex::encode(Span<const std::byte> bytes, Allocator* allocator)
+	{
+		String res{allocator};
+		res.resize(encodedCount(bytes.count()));
+		encode(bytes, Span<char>{res.data(), res.count()});
+		return res;
+	}
+
+	size_t Hex::decode(StringView str, Span<std::byte> out)
+	{
+		auto ptr = reinterpret_cast<const uint8_t*>(str.data());
+		auto count = str.count();
+		if (count % 2 != 0)
+		{
+			return SIZE_MAX;
+		}
+
+		assertTrue(out.count() >= decodedCount(str));
+		auto it = reinterpret_cast<uint8_t*>(out.data());
+
+		size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+		for (; i + 32 <= count; i += 32)
+		{
+			auto valid = _mm_set1_epi8(-1);
+			auto a = hexValuesSse2(_mm_loadu_si128((const __m128i*)(ptr + i)), valid);
+			auto b = hexValuesSse2(_mm_loadu_si128((const __m128i*)(ptr + i + 16)), valid);
+			if (_mm_movemask_epi8(valid) != 0xFFFF)
+			{
+				return SIZE_MAX;
+			}
+
+			// each 16-bit lane has the high nibble in its low byte and the low nibble in its high byte
+			auto lowBytes = _mm_set1_epi16(0x00FF);
+			a = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(a, lowBytes), 4), _mm_srli_epi16(a, 8));
+			b = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b, lowBytes), 4), _mm_srli_epi16(b, 8));
+			_mm_storeu_si128((__m128i*)it, _mm_packus_epi16(a, b));
+			it += 16;
+		}
+#endif
+
+		for (; i < count; i += 2)
+		{
+			auto hi = HEX_VALUES[ptr[i]];
+			auto lo = HEX_VALUES[ptr[i + 1]];
+			if ((hi | lo) & 0x80)
+			{
+				return SIZE_MAX;
+			}
+			*it++ = uint8_t((hi << 4) | lo);
+		}
+		return decodedCount(str);
+	}
+
+	Buffer Hex::decode(StringView str, Allocator* allocator)
+	{
+		Buffer res{allocator};
+		res.resize(decodedCount(str));
+		auto count = decode(str, Span<std::byte>{res.data(), res.count()});
+		if (count == SIZE_MAX)
+		{
+			res.clear();
+		}
+		return res;
+	}
+}
\ No newline at end of file
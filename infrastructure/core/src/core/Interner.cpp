@@ -0,0 +1,188 @@
+#include "core/Interner.h"
+#include "core/Lock.h"
+#include "core/Thread.h"
+
+#include <bit>
+#include <cstring>
+
+namespace core
+{
+	StringView Interner::store(StringView str)
+	{
+		if (str.count() == 0)
+		{
+			return StringView{};
+		}
+
+		if (m_blocks.count() == 0 || m_blockUsed + str.count() > m_blocks[m_blocks.count() - 1].count())
+		{
+			auto blockSize = str.count() > BLOCK_SIZE ? str.count() : BLOCK_SIZE;
+			auto block = m_allocator->alloc(blockSize, alignof(char));
+			m_allocator->commit(block);
+			m_blocks.push(block);
+			m_blockUsed = 0;
+		}
+
+		auto ptr = m_blocks[m_blocks.count() - 1].data() + m_blockUsed;
+		::memcpy(ptr, str.data(), str.count());
+		m_blockUsed += str.count();
+		return StringView{reinterpret_cast<const char*>(ptr), str.count()};
+	}
+
+	void Interner::destroy()
+	{
+		for (auto block: m_blocks)
+		{
+			m_allocator->release(block);
+			m_allocator->free(block);
+		}
+	}
+
+	Interner::Interner(Allocator* allocator)
+		: Interner(allocator, HashSeed::random())
+	{}
+
+	Interner::Interner(Allocator* allocator, HashSeed seed)
+		: m_allocator(allocator),
+		  m_blocks(allocator),
+		  m_strings(allocator),
+		  m_symbols(allocator, seed)
+	{
+		m_strings.push(StringView{});
+	}
+
+	Interner::Interner(Interner&& other) noexcept
+		: m_allocator(other.m_allocator),
+		  m_blocks(std::move(other.m_blocks)),
+		  m_blockUsed(other.m_blockUsed),
+		  m_strings(std::move(other.m_strings)),
+		  m_symbols(std::move(other.m_symbols))
+	{
+		other.m_blockUsed = 0;
+	}
+
+	Interner& Interner::operator=(Interner&& other) noexcept
+	{
+		destroy();
+		m_allocator = other.m_allocator;
+		m_blocks = std::move(other.m_blocks);
+		m_blockUsed = other.m_blockUsed;
+		m_strings = std::move(other.m_strings);
+		m_symbols = std::move(other.m_symbols);
+		other.m_blockUsed = 0;
+		return *this;
+	}
+
+	Interner::~Interner()
+	{
+		destroy();
+	}
+
+	Symbol Interner::intern(StringView str)
+	{
+		return internWithHash(str, Hash<StringView>{}(str, m_symbols.seed().value()));
+	}
+
+	Symbol Interner::internWithHash(StringView str, size_t hash)
+	{
+		if (auto it = m_symbols.lookupWithHash(str, hash); it != m_symbols.end())
+		{
+			return Symbol{it->value};
+		}
+
+		auto id = uint32_t(m_strings.count());
+		assertMsg(id != 0, "symbols ids overflowed");
+		auto stored = store(str);
+		m_strings.push(stored);
+		m_symbols.insertWithHash(stored, hash, id);
+		return Symbol{id};
+	}
+
+	Symbol Interner::lookup(StringView str) const
+	{
+		return lookupWithHash(str, Hash<StringView>{}(str, m_symbols.seed().value()));
+	}
+
+	Symbol Interner::lookupWithHash(StringView str, size_t hash) const
+	{
+		if (auto it = m_symbols.lookupWithHash(str, hash); it != m_symbols.end())
+		{
+			return Symbol{it->value};
+		}
+		return Symbol{};
+	}
+
+	ConcurrentInterner::ConcurrentInterner(Allocator* allocator)
+		: ConcurrentInterner(allocator, size_t(Thread::hardware_concurrency()) * 4)
+	{}
+
+	ConcurrentInterner::ConcurrentInterner(Allocator* allocator, size_t shardsCount)
+		: m_allocator(allocator),
+		  m_seed(HashSeed::random().value()),
+		  m_shards(allocator)
+	{
+		shardsCount = std::bit_ceil(shardsCount < 1 ? 1 : shardsCount);
+		m_shardBits = std::countr_zero(shardsCount);
+		m_shardShift = sizeof(size_t) * 8 - 7 - m_shardBits;
+		m_shards.reserve(shardsCount);
+		for (size_t i = 0; i < shardsCount; ++i)
+		{
+			m_shards.push(Shard{allocator, HashSeed{m_seed}});
+		}
+	}
+
+	Symbol ConcurrentInterner::intern(StringView str)
+	{
+		auto hash = Hash<StringView>{}(str, m_seed);
+		auto shardIndex = shardIndexOf(hash);
+		auto& shard = m_shards[shardIndex];
+
+		Symbol local;
+		{
+			auto lock = sharedLockGuard(shard.mutex);
+			local = shard.interner.lookupWithHash(str, hash);
+		}
+		if (local.valid() == false)
+		{
+			auto lock = lockGuard(shard.mutex);
+			local = shard.interner.internWithHash(str, hash);
+		}
+
+		assertMsg((uint64_t(local.id()) << m_shardBits) <= UINT32_MAX, "symbols ids overflowed");
+		return Symbol{uint32_t((local.id() << m_shardBits) | shardIndex)};
+	}
+
+	Symbol ConcurrentInterner::lookup(StringView str) const
+	{
+		auto hash = Hash<StringView>{}(str, m_seed);
+		auto shardIndex = shardIndexOf(hash);
+		auto& shard = m_shards[shardIndex];
+
+		auto lock = sharedLockGuard(shard.mutex);
+		auto local = shard.interner.lookupWithHash(str, hash);
+		if (local.valid() == false)
+		{
+			return Symbol{};
+		}
+		return Symbol{uint32_t((local.id() << m_shardBits) | shardIndex)};
+	}
+
+	StringView ConcurrentInterner::str(Symbol symbol) const
+	{
+		auto& shard = m_shards[symbol.id() & (m_shards.count() - 1)];
+		// the view points into the shard blocks which never move, the lock only guards the strings array
+		auto lock = sharedLockGuard(shard.mutex);
+		return shard.interner.str(Symbol{symbol.id() >> m_shardBits});
+	}
+
+	size_t ConcurrentInterner::count() const
+	{
+		size_t res = 0;
+		for (auto& shard: m_shards)
+		{
+			auto lock = sharedLockGuard(shard.mutex);
+			res += shard.interner.count();
+		}
+		return res;
+	}
+}
\ No newline at end of file
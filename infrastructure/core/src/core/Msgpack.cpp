@@ -320,6 +320,12 @@ namespace core::msgpack
 		}
 	}
 
+	HumanError msgpack(Writer& writer, Symbol value)
+	{
+		assertMsg(writer.interner() != nullptr, "writing symbols requires a writer with an interner");
+		return msgpack(writer, writer.interner()->str(value));
+	}
+
 	HumanError msgpack(Writer& writer, const void* data, size_t size)
 	{
 		if (size <= UINT8_MAX)
@@ -1167,6 +1173,44 @@ namespace core::msgpack
 		return {};
 	}
 
+	HumanError msgpack(Reader& reader, Symbol& value)
+	{
+		assertMsg(reader.interner() != nullptr, "reading symbols requires a reader with an interner");
+
+		uint8_t prefix{};
+		if (auto err = reader.read_uint8(prefix))
+		{
+			return err;
+		}
+
+		auto count = reader.read_string_count(prefix);
+		if (count.isError())
+		{
+			return count.releaseError();
+		}
+
+		// most keys are short enough to be read on the stack
+		char small[256];
+		if (count.value() <= sizeof(small))
+		{
+			if (auto err = reader.read_blob(small, count.value()))
+			{
+				return err;
+			}
+			value = reader.interner()->intern(StringView{small, count.value()});
+			return {};
+		}
+
+		String str{reader.allocator()};
+		str.resize(count.value());
+		if (auto err = reader.read_blob(str.data(), str.count()))
+		{
+			return err;
+		}
+		value = reader.interner()->intern(str);
+		return {};
+	}
+
 	HumanError msgpack(Reader& reader, Buffer& value)
 	{
 		uint8_t prefix{};
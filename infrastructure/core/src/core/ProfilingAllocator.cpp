@@ -0,0 +1,606 @@
+#include "core/ProfilingAllocator.h"
+#include "core/Array.h"
+#include "core/Buffer.h"
+#include "core/Hash.h"
+#include "core/Lock.h"
+#include "core/Mallocator.h"
+#include "core/Mutex.h"
+#include "core/Rand.h"
+#include "core/Stacktrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace core
+{
+	constexpr size_t PROFILE_MAX_FRAMES = 32;
+	constexpr size_t PROFILE_SAMPLED_FILTER_SIZE = 16 * 1024;
+
+	struct ProfileCallSite
+	{
+		uintptr_t frames[PROFILE_MAX_FRAMES];
+		size_t framesCount;
+
+		bool operator==(const ProfileCallSite& other) const
+		{
+			return framesCount == other.framesCount &&
+				   ::memcmp(frames, other.frames, framesCount * sizeof(uintptr_t)) == 0;
+		}
+	};
+
+	template <>
+	struct Hash<ProfileCallSite>
+	{
+		inline size_t operator()(const ProfileCallSite& value, size_t seed) const
+		{
+			return hashBytes(
+				Span<const std::byte>{(const std::byte*)value.frames, value.framesCount * sizeof(uintptr_t)}, seed);
+		}
+	};
+
+	// all the values are estimates, each sample is scaled by the inverse of its sampling probability
+	struct ProfileCallSiteStats
+	{
+		double liveBytes = 0;
+		double liveCount = 0;
+		double allocatedBytes = 0;
+		double allocatedCount = 0;
+	};
+
+	struct ProfileLiveSample
+	{
+		size_t callSiteIndex = 0;
+		double bytes = 0;
+		double count = 0;
+	};
+
+	struct ProfilingAllocator::IProfile
+	{
+		// the profile bookkeeping never goes through the profiled allocator
+		Mallocator allocator;
+		Mutex mutex;
+		Array<ProfileCallSite> callSites;
+		Array<ProfileCallSiteStats> callSitesStats;
+		Map<ProfileCallSite, size_t> callSiteToIndex;
+		Map<const std::byte*, ProfileLiveSample> liveSamples;
+		std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+		// each sampled pointer increments one of these counters, so that free can skip the lock for the (vast
+		// majority of) pointers which were never sampled
+		std::atomic<uint32_t> sampledFilter[PROFILE_SAMPLED_FILTER_SIZE] = {};
+		// identifies the profile in the per thread samplers, unlike its address it's never reused
+		uint64_t samplerId = 0;
+
+		IProfile()
+			: mutex(&allocator),
+			  callSites(&allocator),
+			  callSitesStats(&allocator),
+			  callSiteToIndex(&allocator),
+			  liveSamples(&allocator)
+		{}
+
+		std::atomic<uint32_t>& filterEntry(const std::byte* ptr)
+		{
+			auto h = uint64_t(uintptr_t(ptr)) * 0x9E3779B97F4A7C15ULL;
+			return sampledFilter[(h >> 32) % PROFILE_SAMPLED_FILTER_SIZE];
+		}
+
+		void recordAlloc(const std::byte* ptr, const ProfileCallSite& callSite, double bytes, double count)
+		{
+			auto lock = lockGuard(mutex);
+
+			size_t callSiteIndex = 0;
+			if (auto it = callSiteToIndex.lookup(callSite); it != callSiteToIndex.end())
+			{
+				callSiteIndex = it->value;
+			}
+			else
+			{
+				callSiteIndex = callSites.count();
+				callSites.push(callSite);
+				callSitesStats.push(ProfileCallSiteStats{});
+				callSiteToIndex.insert(callSite, callSiteIndex);
+			}
+
+			auto& stats = callSitesStats[callSiteIndex];
+			stats.liveBytes += bytes;
+			stats.liveCount += count;
+			stats.allocatedBytes += bytes;
+			stats.allocatedCount += count;
+
+			liveSamples.insert(ptr, ProfileLiveSample{callSiteIndex, bytes, count});
+			filterEntry(ptr).fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void recordFree(const std::byte* ptr)
+		{
+			if (filterEntry(ptr).load(std::memory_order_relaxed) == 0)
+			{
+				return;
+			}
+
+			auto lock = lockGuard(mutex);
+			auto it = liveSamples.lookup(ptr);
+			if (it == liveSamples.end())
+			{
+				return;
+			}
+
+			auto& stats = callSitesStats[it->value.callSiteIndex];
+			stats.liveBytes -= it->value.bytes;
+			stats.liveCount -= it->value.count;
+
+			liveSamples.remove(ptr);
+			filterEntry(ptr).fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		double elapsedSeconds() const
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		}
+	};
+
+	// the countdown of a single profile on a thread
+	struct ProfileSamplerSlot
+	{
+		uint64_t samplerId = 0;
+		int64_t bytesUntilSample = 0;
+	};
+
+	// each profile counts down on its own so that allocators with different sample rates don't reset each other, the
+	// slots are a small cache and a profile which gets evicted starts over with a fresh interval, which doesn't skew
+	// the sampling since the intervals are exponential and so memoryless
+	struct ProfileThreadSampler
+	{
+		static constexpr size_t SLOTS_COUNT = 8;
+
+		ProfileSamplerSlot slots[SLOTS_COUNT];
+		size_t nextEvictedSlot = 0;
+	};
+
+	// the sampler is per thread so that the non sampled allocations don't touch any shared state
+	thread_local ProfileThreadSampler t_profileSampler;
+	static std::atomic<uint64_t> PROFILE_NEXT_SAMPLER_ID{1};
+
+	// the distance between samples is exponentially distributed, this makes the sampling a poisson process over the
+	// allocated bytes, so every byte has the same probability of being sampled
+	inline static int64_t profileNextSampleInterval(size_t sampleRate)
+	{
+		// 1 - uniformDouble is in (0, 1] so the log is finite
+		auto interval = -std::log(1.0 - FastRand::threadLocal().uniformDouble()) * double(sampleRate);
+		return interval < 1 ? 1 : int64_t(interval);
+	}
+
+	inline static ProfileSamplerSlot& profileSamplerSlot(uint64_t samplerId, size_t sampleRate)
+	{
+		auto& sampler = t_profileSampler;
+		for (auto& slot: sampler.slots)
+		{
+			if (slot.samplerId == samplerId)
+			{
+				return slot;
+			}
+		}
+
+		auto& slot = sampler.slots[sampler.nextEvictedSlot];
+		sampler.nextEvictedSlot = (sampler.nextEvictedSlot + 1) % ProfileThreadSampler::SLOTS_COUNT;
+		slot.samplerId = samplerId;
+		slot.bytesUntilSample = profileNextSampleInterval(sampleRate);
+		return slot;
+	}
+
+	inline static bool profileShouldSample(size_t size, uint64_t samplerId, size_t sampleRate)
+	{
+		if (sampleRate == 0)
+		{
+			return true;
+		}
+
+		auto& slot = profileSamplerSlot(samplerId, sampleRate);
+		slot.bytesUntilSample -= int64_t(size);
+		if (slot.bytesUntilSample > 0)
+		{
+			return false;
+		}
+
+		slot.bytesUntilSample = profileNextSampleInterval(sampleRate);
+		return true;
+	}
+
+	// minimal protobuf encoder for the pprof profile format
+	// https://github.com/google/pprof/blob/main/proto/profile.proto
+	class ProtobufWriter
+	{
+		Buffer m_buffer;
+
+	public:
+		explicit ProtobufWriter(Allocator* allocator)
+			: m_buffer(allocator)
+		{}
+
+		const Buffer& buffer() const
+		{
+			return m_buffer;
+		}
+
+		void varint(uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				m_buffer.push(std::byte(value | 0x80));
+				value >>= 7;
+			}
+			m_buffer.push(std::byte(value));
+		}
+
+		void uint64Field(uint64_t field, uint64_t value)
+		{
+			varint(field << 3);
+			varint(value);
+		}
+
+		void int64Field(uint64_t field, int64_t value)
+		{
+			uint64Field(field, uint64_t(value));
+		}
+
+		void bytesField(uint64_t field, Span<const std::byte> bytes)
+		{
+			varint((field << 3) | 2);
+			varint(bytes.count());
+			m_buffer.push(bytes);
+		}
+
+		void messageField(uint64_t field, const ProtobufWriter& message)
+		{
+			bytesField(field, Span<const std::byte>{message.m_buffer});
+		}
+
+		void packedField(uint64_t field, Span<const uint64_t> values)
+		{
+			ProtobufWriter packed{m_buffer.allocator()};
+			for (auto value: values)
+			{
+				packed.varint(value);
+			}
+			messageField(field, packed);
+		}
+	};
+
+	class ProfileStringTable
+	{
+		Allocator* m_allocator = nullptr;
+		Array<String> m_strings;
+		Map<String, uint64_t> m_stringToIndex;
+
+	public:
+		explicit ProfileStringTable(Allocator* allocator)
+			: m_allocator(allocator),
+			  m_strings(allocator),
+			  m_stringToIndex(allocator)
+		{
+			// pprof requires the first string to be the empty string
+			index(""_sv);
+		}
+
+		uint64_t index(StringView str)
+		{
+			if (auto it = m_stringToIndex.lookup(str); it != m_stringToIndex.end())
+			{
+				return it->value;
+			}
+
+			String key{str, m_allocator};
+			auto res = uint64_t(m_strings.count());
+			m_strings.push(key);
+			m_stringToIndex.insert(std::move(key), res);
+			return res;
+		}
+
+		void write(ProtobufWriter& profile) const
+		{
+			for (const auto& str: m_strings)
+			{
+				profile.bytesField(6, Span<const std::byte>{str});
+			}
+		}
+	};
+
+	inline static Allocator* profileAllocator()
+	{
+		static Mallocator mallocator;
+		return &mallocator;
+	}
+
+	ProfilingAllocator::ProfilingAllocator(Allocator* allocator, size_t sampleRate)
+		: m_allocator(allocator),
+		  m_sampleRate(sampleRate)
+	{
+		m_profile = unique_from<IProfile>(profileAllocator());
+		m_profile->samplerId = PROFILE_NEXT_SAMPLER_ID.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	ProfilingAllocator::~ProfilingAllocator() = default;
+
+	Span<std::byte> ProfilingAllocator::alloc(size_t size, size_t alignment)
+	{
+		auto bytes = m_allocator->alloc(size, alignment);
+		if (bytes.empty() || profileShouldSample(size, m_profile->samplerId, m_sampleRate) == false)
+		{
+			return bytes;
+		}
+
+		ProfileCallSite callSite{};
+		callSite.framesCount = Rawtrace::currentFrames(Span<uintptr_t>{callSite.frames, PROFILE_MAX_FRAMES}, 0);
+
+		// an allocation of `size` bytes gets sampled with probability 1 - e^(-size/rate), each sample stands for
+		// 1/probability allocations
+		auto probability = m_sampleRate == 0 ? 1.0 : 1.0 - std::exp(-double(size) / double(m_sampleRate));
+		m_profile->recordAlloc(bytes.data(), callSite, double(size) / probability, 1.0 / probability);
+		return bytes;
+	}
+
+	void ProfilingAllocator::commit(Span<std::byte> bytes)
+	{
+		m_allocator->commit(bytes);
+	}
+
+	void ProfilingAllocator::release(Span<std::byte> bytes)
+	{
+		m_allocator->release(bytes);
+	}
+
+	void ProfilingAllocator::free(Span<std::byte> bytes)
+	{
+		// the sample should be removed before the memory is freed, otherwise another thread could get the same
+		// address and sample it before we remove the old sample
+		if (bytes.data() != nullptr)
+		{
+			m_profile->recordFree(bytes.data());
+		}
+		m_allocator->free(bytes);
+	}
+
+	ProfilingAllocator::Stats ProfilingAllocator::stats() const
+	{
+		auto lock = lockGuard(m_profile->mutex);
+
+		ProfileCallSiteStats total{};
+		for (const auto& stats: m_profile->callSitesStats)
+		{
+			total.liveBytes += stats.liveBytes;
+			total.liveCount += stats.liveCount;
+			total.allocatedBytes += stats.allocatedBytes;
+			total.allocatedCount += stats.allocatedCount;
+		}
+
+		Stats res{};
+		res.liveBytes = size_t(std::llround(total.liveBytes));
+		res.liveCount = size_t(std::llround(total.liveCount));
+		res.allocatedBytes = size_t(std::llround(total.allocatedBytes));
+		res.allocatedCount = size_t(std::llround(total.allocatedCount));
+		res.callSitesCount = m_profile->callSites.count();
+		return res;
+	}
+
+	void ProfilingAllocator::writeReport(Stream* stream, size_t maxCallSites) const
+	{
+		Mallocator allocator;
+
+		// take a snapshot so that we don't hold the lock while symbolizing
+		Array<ProfileCallSite> callSites{&allocator};
+		Array<ProfileCallSiteStats> callSitesStats{&allocator};
+		{
+			auto lock = lockGuard(m_profile->mutex);
+			callSites = m_profile->callSites;
+			callSitesStats = m_profile->callSitesStats;
+		}
+		auto elapsed = m_profile->elapsedSeconds();
+
+		Array<size_t> order{&allocator};
+		ProfileCallSiteStats total{};
+		for (size_t i = 0; i < callSitesStats.count(); ++i)
+		{
+			order.push(i);
+			total.liveBytes += callSitesStats[i].liveBytes;
+			total.liveCount += callSitesStats[i].liveCount;
+			total.allocatedBytes += callSitesStats[i].allocatedBytes;
+			total.allocatedCount += callSitesStats[i].allocatedCount;
+		}
+		std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+			return callSitesStats[a].liveBytes > callSitesStats[b].liveBytes;
+		});
+
+		strf(
+			stream,
+			"heap profile: live {:.0f} bytes in {:.0f} objects, allocated {:.0f} bytes in {:.0f} objects, sample rate "
+			"{} bytes, elapsed {:.3f}s\n"_sv,
+			total.liveBytes,
+			total.liveCount,
+			total.allocatedBytes,
+			total.allocatedCount,
+			m_sampleRate,
+			elapsed);
+
+		auto count = order.count();
+		if (maxCallSites != 0 && maxCallSites < count)
+		{
+			count = maxCallSites;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const auto& callSite = callSites[order[i]];
+			const auto& stats = callSitesStats[order[i]];
+			strf(
+				stream,
+				"\n#{} live: {:.0f} bytes in {:.0f} objects, allocated: {:.0f} bytes in {:.0f} objects, rate: {:.1f} "
+				"bytes/s\n"_sv,
+				i + 1,
+				stats.liveBytes,
+				stats.liveCount,
+				stats.allocatedBytes,
+				stats.allocatedCount,
+				elapsed > 0 ? stats.allocatedBytes / elapsed : 0.0);
+			Rawtrace{Span<const uintptr_t>{callSite.frames, callSite.framesCount}}.resolve().print(stream, false);
+		}
+	}
+
+	void ProfilingAllocator::writePprof(Stream* stream) const
+	{
+		Mallocator allocator;
+
+		Array<ProfileCallSite> callSites{&allocator};
+		Array<ProfileCallSiteStats> callSitesStats{&allocator};
+		{
+			auto lock = lockGuard(m_profile->mutex);
+			callSites = m_profile->callSites;
+			callSitesStats = m_profile->callSitesStats;
+		}
+		auto elapsed = m_profile->elapsedSeconds();
+
+		// every unique address becomes a location
+		Array<uintptr_t> addresses{&allocator};
+		Map<uintptr_t, uint64_t> addressToLocationId{&allocator};
+		for (const auto& callSite: callSites)
+		{
+			for (size_t i = 0; i < callSite.framesCount; ++i)
+			{
+				auto address = callSite.frames[i];
+				if (addressToLocationId.lookup(address) == addressToLocationId.end())
+				{
+					addresses.push(address);
+					addressToLocationId.insert(address, uint64_t(addresses.count()));
+				}
+			}
+		}
+
+		ProfileStringTable strings{&allocator};
+		ProtobufWriter out{&allocator};
+
+		auto writeValueType = [&](uint64_t field, StringView type, StringView unit) {
+			ProtobufWriter valueType{&allocator};
+			valueType.int64Field(1, int64_t(strings.index(type)));
+			valueType.int64Field(2, int64_t(strings.index(unit)));
+			out.messageField(field, valueType);
+		};
+
+		// sample_type
+		writeValueType(1, "alloc_objects"_sv, "count"_sv);
+		writeValueType(1, "alloc_space"_sv, "bytes"_sv);
+		writeValueType(1, "inuse_objects"_sv, "count"_sv);
+		writeValueType(1, "inuse_space"_sv, "bytes"_sv);
+
+		// sample
+		for (size_t i = 0; i < callSites.count(); ++i)
+		{
+			const auto& callSite = callSites[i];
+			const auto& stats = callSitesStats[i];
+
+			Array<uint64_t> locationIds{&allocator};
+			for (size_t j = 0; j < callSite.framesCount; ++j)
+			{
+				locationIds.push(addressToLocationId.lookup(callSite.frames[j])->value);
+			}
+
+			uint64_t values[] = {
+				uint64_t(std::llround(stats.allocatedCount)),
+				uint64_t(std::llround(stats.allocatedBytes)),
+				uint64_t(std::llround(stats.liveCount)),
+				uint64_t(std::llround(stats.liveBytes)),
+			};
+
+			ProtobufWriter sample{&allocator};
+			sample.packedField(1, Span<const uint64_t>{locationIds.data(), locationIds.count()});
+			sample.packedField(2, Span<const uint64_t>{values, sizeof(values) / sizeof(*values)});
+			out.messageField(2, sample);
+		}
+
+		// mapping, we don't track the loaded objects, so a single mapping covers the whole address space
+		{
+			ProtobufWriter mapping{&allocator};
+			mapping.uint64Field(1, 1);
+			mapping.uint64Field(2, 0);
+			mapping.uint64Field(3, UINT64_MAX);
+			mapping.uint64Field(7, 1);
+			mapping.uint64Field(8, 1);
+			mapping.uint64Field(9, 1);
+			mapping.uint64Field(10, 1);
+			out.messageField(3, mapping);
+		}
+
+		// the symbolization happens here, all the addresses are resolved in one go
+		auto trace = Rawtrace{Span<const uintptr_t>{addresses.data(), addresses.count()}}.resolve();
+
+		// location, inlined frames share the address of their caller so they become extra lines of the same location
+		Array<ProtobufWriter> locations{&allocator};
+		for (size_t i = 0; i < addresses.count(); ++i)
+		{
+			ProtobufWriter location{&allocator};
+			location.uint64Field(1, i + 1);
+			location.uint64Field(2, 1);
+			location.uint64Field(3, addresses[i]);
+			locations.push(std::move(location));
+		}
+
+		Map<String, uint64_t> functionToId{&allocator};
+		Array<ProtobufWriter> functions{&allocator};
+		for (const auto& frame: trace.frames())
+		{
+			auto it = addressToLocationId.lookup(uintptr_t(frame.raw_address));
+			if (it == addressToLocationId.end())
+			{
+				continue;
+			}
+
+			auto name = StringView{frame.symbol.data(), frame.symbol.size()};
+			auto filename = StringView{frame.filename.data(), frame.filename.size()};
+
+			auto functionKey = strf(&allocator, "{}\n{}"_sv, name, filename);
+			uint64_t functionId = 0;
+			if (auto functionIt = functionToId.lookup(functionKey); functionIt != functionToId.end())
+			{
+				functionId = functionIt->value;
+			}
+			else
+			{
+				functionId = functionToId.count() + 1;
+				functionToId.insert(std::move(functionKey), functionId);
+
+				ProtobufWriter function{&allocator};
+				function.uint64Field(1, functionId);
+				function.int64Field(2, int64_t(strings.index(name)));
+				function.int64Field(3, int64_t(strings.index(name)));
+				function.int64Field(4, int64_t(strings.index(filename)));
+				functions.push(std::move(function));
+			}
+
+			ProtobufWriter line{&allocator};
+			line.uint64Field(1, functionId);
+			line.int64Field(2, int64_t(frame.line.value_or(0)));
+			locations[it->value - 1].messageField(4, line);
+		}
+
+		for (const auto& location: locations)
+		{
+			out.messageField(4, location);
+		}
+
+		for (const auto& function: functions)
+		{
+			out.messageField(5, function);
+		}
+
+		auto now = std::chrono::system_clock::now().time_since_epoch();
+		out.int64Field(9, std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+		out.int64Field(10, int64_t(elapsed * 1e9));
+		writeValueType(11, "space"_sv, "bytes"_sv);
+		out.int64Field(12, int64_t(m_sampleRate == 0 ? 1 : m_sampleRate));
+
+		// the string table must be written last, since all the other fields add strings to it
+		strings.write(out);
+		stream->write(out.buffer().data(), out.buffer().count());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "core/Rand.h"
+#include "core/Assert.h"
+#include "core/Intrinsics.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if TAHA_OS_LINUX || TAHA_OS_DARWIN
+#include <pthread.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+namespace core
+{
+	// the count of bytes a thread asks the os for at a time
+	constexpr size_t RAND_POOL_SIZE = 4096;
+	// bigger requests would drain most of the pool so they go to the os directly
+	constexpr size_t RAND_POOL_MAX_REQUEST = 256;
+
+	// it's bumped in the child process after a fork, the pools compare it with the generation they were filled in
+	// so the child never hands out the same bytes as its parent
+	static std::atomic<uint64_t> RAND_FORK_GENERATION{0};
+
+	struct RandPool
+	{
+		std::byte bytes[RAND_POOL_SIZE];
+		// the bytes before offset are handed out already and are zeroed
+		size_t offset = RAND_POOL_SIZE;
+		uint64_t forkGeneration = 0;
+	};
+
+	thread_local RandPool t_randPool;
+
+	// below this the jumps which set up the avx2 streams cost more than they save
+	constexpr size_t FAST_RAND_AVX2_MIN_COUNT = 16 * 1024;
+
+	inline static uint64_t fastRandSplitMix64(uint64_t& state)
+	{
+		auto z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+	TAHA_TARGET_AVX2 inline static __m256i fastRandRotlAvx2(__m256i x, int k)
+	{
+		return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+	}
+
+	// runs 4 xoshiro256++ streams side by side, one in each 64-bit lane, and returns the count of filled bytes which
+	// is count rounded down to a multiple of 32
+	TAHA_TARGET_AVX2 static size_t fastRandFillAvx2(const uint64_t streams[4][4], std::byte* ptr, size_t count)
+	{
+		__m256i s[4];
+		for (size_t i = 0; i < 4; ++i)
+		{
+			s[i] = _mm256_set_epi64x(
+				int64_t(streams[3][i]), int64_t(streams[2][i]), int64_t(streams[1][i]), int64_t(streams[0][i]));
+		}
+
+		size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			auto res = _mm256_add_epi64(fastRandRotlAvx2(_mm256_add_epi64(s[0], s[3]), 23), s[0]);
+			_mm256_storeu_si256((__m256i*)(ptr + i), res);
+
+			auto t = _mm256_slli_epi64(s[1], 17);
+			s[2] = _mm256_xor_si256(s[2], s[0]);
+			s[3] = _mm256_xor_si256(s[3], s[1]);
+			s[1] = _mm256_xor_si256(s[1], s[2]);
+			s[0] = _mm256_xor_si256(s[0], s[3]);
+			s[2] = _mm256_xor_si256(s[2], t);
+			s[3] = fastRandRotlAvx2(s[3], 45);
+		}
+		return i;
+	}
+#endif
+
+	inline static void randRegisterForkHandler()
+	{
+#if TAHA_OS_LINUX || TAHA_OS_DARWIN
+		static bool registered = [] {
+			::pthread_atfork(nullptr, nullptr, [] { RAND_FORK_GENERATION.fetch_add(1, std::memory_order_relaxed); });
+			return true;
+		}();
+		(void)registered;
+#endif
+	}
+
+	bool Rand::cryptoRand(Span<std::byte> buffer)
+	{
+		if (buffer.count() > RAND_POOL_MAX_REQUEST)
+		{
+			return osCryptoRand(buffer);
+		}
+
+		auto& pool = t_randPool;
+		auto forkGeneration = RAND_FORK_GENERATION.load(std::memory_order_relaxed);
+		if (pool.forkGeneration != forkGeneration)
+		{
+			::memset(pool.bytes, 0, sizeof(pool.bytes));
+			pool.offset = RAND_POOL_SIZE;
+			pool.forkGeneration = forkGeneration;
+		}
+
+		auto out = buffer.data();
+		auto count = buffer.count();
+		while (count > 0)
+		{
+			if (pool.offset == RAND_POOL_SIZE)
+			{
+				randRegisterForkHandler();
+				if (osCryptoRand(Span<std::byte>{pool.bytes, RAND_POOL_SIZE}) == false)
+				{
+					return false;
+				}
+				pool.offset = 0;
+			}
+
+			auto available = RAND_POOL_SIZE - pool.offset;
+			auto taken = count < available ? count : available;
+			::memcpy(out, pool.bytes + pool.offset, taken);
+			::memset(pool.bytes + pool.offset, 0, taken);
+			pool.offset += taken;
+			out += taken;
+			count -= taken;
+		}
+		return true;
+	}
+
+	FastRand::FastRand()
+	{
+		auto ok = Rand::cryptoRand(Span<std::byte>{reinterpret_cast<std::byte*>(m_state), sizeof(m_state)});
+		assertTrue(ok);
+		// the all zero state never leaves zero
+		if ((m_state[0] | m_state[1] | m_state[2] | m_state[3]) == 0)
+		{
+			m_state[0] = 1;
+		}
+	}
+
+	FastRand::FastRand(uint64_t seed)
+	{
+		for (auto& s: m_state)
+		{
+			s = fastRandSplitMix64(seed);
+		}
+	}
+
+	FastRand& FastRand::threadLocal()
+	{
+		thread_local FastRand t_fastRand;
+		return t_fastRand;
+	}
+
+	void FastRand::jump()
+	{
+		constexpr uint64_t JUMP[] = {0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C, 0xA9582618E03FC9AA, 0x39ABDC4529B1661C};
+
+		uint64_t res[4] = {};
+		for (auto j: JUMP)
+		{
+			for (int b = 0; b < 64; ++b)
+			{
+				if (j & (uint64_t(1) << b))
+				{
+					for (size_t i = 0; i < 4; ++i)
+					{
+						res[i] ^= m_state[i];
+					}
+				}
+				next();
+			}
+		}
+		::memcpy(m_state, res, sizeof(m_state));
+	}
+
+	void FastRand::fill(Span<std::byte> bytes)
+	{
+		auto ptr = bytes.data();
+		auto count = bytes.count();
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+		if (count >= FAST_RAND_AVX2_MIN_COUNT && cpuFeatures().avx2)
+		{
+			// each stream starts 2^128 values after the one before it so they never overlap, and this generator
+			// continues after the last one
+			uint64_t streams[4][4];
+			for (auto& stream: streams)
+			{
+				::memcpy(stream, m_state, sizeof(m_state));
+				jump();
+			}
+
+			auto filled = fastRandFillAvx2(streams, ptr, count);
+			ptr += filled;
+			count -= filled;
+		}
+#endif
+
+		for (; count >= sizeof(uint64_t); count -= sizeof(uint64_t))
+		{
+			auto value = next();
+			::memcpy(ptr, &value, sizeof(value));
+			ptr += sizeof(value);
+		}
+
+		if (count > 0)
+		{
+			auto value = next();
+			::memcpy(ptr, &value, count);
+		}
+	}
+}
\ No newline at end of file
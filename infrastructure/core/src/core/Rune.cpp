@@ -1,7 +1,10 @@
 #include "core/Rune.h"
+#include "core/Utf8.h"
 
 #include <utf8proc.h>
 
+#include <cstring>
+
 namespace core
 {
 	const Rune Rune::SELF{0x80};
@@ -43,34 +46,26 @@ namespace core
 
 	size_t Rune::count(const char* ptr)
 	{
-		size_t result = 0;
-		while (ptr != nullptr && *ptr != '\0')
+		if (ptr == nullptr)
 		{
-			result += ((*ptr & 0xC0) != 0x80);
-			++ptr;
+			return 0;
 		}
-		return result;
+		return Utf8::countRunes(ptr, ::strlen(ptr));
 	}
 
 	size_t Rune::count(const char* begin, const char* end)
 	{
-		size_t result = 0;
-		while (begin != nullptr && *begin != '\0' && begin < end)
+		if (begin == nullptr || begin >= end)
 		{
-			result += ((*begin & 0xC0) != 0x80);
-			++begin;
+			return 0;
 		}
-		return result;
-	}
 
-	const char* Rune::next(const char* ptr)
-	{
-		++ptr;
-		while (*ptr && ((*ptr & 0xC0) == 0x80))
+		// like the null terminated version it stops at the first null byte
+		if (auto nul = static_cast<const char*>(::memchr(begin, 0, size_t(end - begin))))
 		{
-			++ptr;
+			end = nul;
 		}
-		return ptr;
+		return Utf8::countRunes(begin, size_t(end - begin));
 	}
 
 	const char* Rune::prev(const char* ptr)
@@ -83,36 +78,6 @@ namespace core
 		return ptr;
 	}
 
-	Rune Rune::decode(const char* ptr)
-	{
-		if (ptr == nullptr)
-		{
-			return Rune{};
-		}
-
-		if (*ptr == 0)
-		{
-			return Rune{};
-		}
-
-		size_t str_count = 1;
-		for (size_t i = 1; i < 4; ++i)
-		{
-			if (ptr[i] == 0)
-			{
-				break;
-			}
-			else
-			{
-				++str_count;
-			}
-		}
-
-		Rune r{};
-		utf8proc_iterate((utf8proc_uint8_t*)ptr, str_count, (utf8proc_int32_t*)&r.m_value);
-		return r;
-	}
-
 	size_t Rune::encode(Rune c, char* ptr)
 	{
 		return utf8proc_encode_char(c, (utf8proc_uint8_t*)ptr);
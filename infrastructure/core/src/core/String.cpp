@@ -7,64 +7,82 @@ namespace core
 {
 	void String::destroy()
 	{
-		if (m_allocator == nullptr || m_memory.empty())
+		if (isHeap() == false)
 		{
 			return;
 		}
 
-		m_allocator->releaseT(m_memory);
-		m_allocator->freeT(m_memory);
+		auto memory = Span<char>{m_heap.ptr, capacity()};
+		m_allocator->releaseT(memory);
+		m_allocator->freeT(memory);
+		m_inline = InlineMemory{};
 	}
 
 	void String::copyFrom(const String& other)
 	{
 		m_allocator = other.m_allocator;
-		m_count = other.m_count;
+		auto count = other.count();
 
-		m_memory = m_allocator->allocT<char>(m_count + 1);
-		m_allocator->commitT(m_memory);
+		if (count < INLINE_CAPACITY)
+		{
+			m_inline = InlineMemory{};
+			::memcpy(m_inline.data, other.ptr(), count);
+			m_inline.count = uint8_t(count);
+		}
+		else
+		{
+			auto memory = m_allocator->allocT<char>(count + 1);
+			m_allocator->commitT(memory);
 
-		::memcpy(m_memory.data(), other.m_memory.data(), m_count);
-		m_memory[m_count] = '\0';
+			::memcpy(memory.data(), other.ptr(), count);
+			memory[count] = '\0';
+
+			m_heap.ptr = memory.data();
+			m_heap.count = count;
+			m_heap.capacity = memory.count() | HEAP_FLAG;
+		}
 	}
 
 	void String::moveFrom(String& other)
 	{
 		m_allocator = other.m_allocator;
-		m_memory = other.m_memory;
-		m_count = other.m_count;
+		if (other.isHeap())
+		{
+			m_heap = other.m_heap;
+		}
+		else
+		{
+			m_inline = other.m_inline;
+		}
 
 		other.m_allocator = nullptr;
-		other.m_memory = Span<char>{};
-		other.m_count = 0;
+		other.m_inline = InlineMemory{};
 	}
 
 	void String::grow(size_t new_capacity)
 	{
+		auto count = this->count();
 		auto new_memory = m_allocator->allocT<char>(new_capacity);
-		m_allocator->commitT(new_memory.sliceLeft(m_count));
+		m_allocator->commitT(new_memory);
 
-		::memcpy(new_memory.data(), m_memory.data(), m_count);
+		::memcpy(new_memory.data(), ptr(), count);
 
-		m_allocator->releaseT(m_memory);
-		m_allocator->freeT(m_memory);
+		destroy();
 
-		m_memory = new_memory;
+		m_heap.ptr = new_memory.data();
+		m_heap.count = count;
+		m_heap.capacity = new_memory.count() | HEAP_FLAG;
 	}
 
 	void String::ensureSpaceExists(size_t count)
 	{
-		if (m_count + count > m_memory.count())
+		auto old_capacity = capacity();
+		if (this->count() + count > old_capacity)
 		{
-			auto new_capacity = m_memory.count() * 2;
-			if (new_capacity == 0)
-			{
-				new_capacity = 8;
-			}
-
-			if (new_capacity < m_count + count)
+			auto new_capacity = old_capacity * 2;
+			if (new_capacity < this->count() + count)
 			{
-				new_capacity = m_count + count;
+				new_capacity = this->count() + count;
 			}
 
 			grow(new_capacity);
@@ -74,74 +92,103 @@ namespace core
 	String::String(StringView str, Allocator* allocator)
 		: m_allocator(allocator)
 	{
-		if (str.count() != 0)
+		auto count = str.count();
+		if (count < INLINE_CAPACITY)
 		{
-			m_count = str.count();
+			::memcpy(m_inline.data, str.begin(), count);
+			m_inline.count = uint8_t(count);
+		}
+		else
+		{
+			auto memory = m_allocator->allocT<char>(count + 1);
+			m_allocator->commitT(memory);
 
-			m_memory = m_allocator->allocT<char>(m_count + 1);
-			m_allocator->commitT(m_memory);
+			::memcpy(memory.data(), str.begin(), count);
+			memory[count] = '\0';
 
-			::memcpy(m_memory.data(), str.begin(), m_count);
-			m_memory[m_count] = '\0';
+			m_heap.ptr = memory.data();
+			m_heap.count = count;
+			m_heap.capacity = memory.count() | HEAP_FLAG;
 		}
 	}
 
 	String::String(Buffer&& buffer)
 	{
-		bool null_terminated = buffer.count() > 0 && buffer[buffer.count() - 1] == std::byte('\0');
-		if (null_terminated == false)
+		m_allocator = buffer.m_allocator;
+
+		auto count = buffer.count();
+		if (count > 0 && buffer[count - 1] == std::byte('\0'))
+		{
+			--count;
+		}
+
+		// small buffers are copied into the inline storage, otherwise we steal the buffer's heap memory
+		if (count < INLINE_CAPACITY)
+		{
+			::memcpy(m_inline.data, buffer.data(), count);
+			m_inline.count = uint8_t(count);
+			buffer.clear();
+			return;
+		}
+
+		if (count == buffer.count())
 		{
 			buffer.push((std::byte)'\0');
 		}
+		assertTrue(buffer.isHeap());
 
-		m_allocator = buffer.m_allocator;
-		m_memory = Span<char>{(char*)buffer.m_memory.data(), buffer.m_memory.count()};
-		m_count = buffer.m_count - 1;
+		m_heap.ptr = (char*)buffer.m_heap.ptr;
+		m_heap.count = count;
+		m_heap.capacity = buffer.capacity() | HEAP_FLAG;
 
-		buffer.m_memory = Span<std::byte>{};
-		buffer.m_count = 0;
+		buffer.m_inline = Buffer::InlineMemory{};
 	}
 
 	void String::resize(size_t new_count)
 	{
 		// +1 for the null terminator
-		if (new_count + 1 > m_memory.count())
+		if (new_count + 1 > capacity())
 		{
 			grow(new_count + 1);
 		}
 
-		m_count = new_count;
-		m_memory[m_count] = '\0';
+		setCount(new_count);
+		ptr()[new_count] = '\0';
 	}
 
 	void String::push(StringView str)
 	{
-		auto len = m_count;
-		resize(m_count + (str.count() + 1));
-		--m_count;
-		::memcpy(m_memory.sliceRight(len).data(), str.begin(), str.count());
-		m_memory[m_count] = '\0';
+		// +1 for the null termination
+		ensureSpaceExists(str.count() + 1);
+		auto count = this->count();
+		::memcpy(ptr() + count, str.begin(), str.count());
+		count += str.count();
+		setCount(count);
+		ptr()[count] = '\0';
 	}
 
 	void String::push(Rune r)
 	{
-		auto old_count = m_count;
 		// +5 = 4 for the rune + 1 for the null termination
-		ensureSpaceExists(m_count + 5);
+		ensureSpaceExists(5);
 
-		auto width = Rune::encode(r, m_memory.data() + m_count);
+		auto count = this->count();
+		auto width = Rune::encode(r, ptr() + count);
 		assertTrue(width > 0 && width <= 4);
-		m_count += width;
-		m_memory[m_count] = '\0';
+		count += width;
+		setCount(count);
+		ptr()[count] = '\0';
 	}
 
 	void String::pushByte(char v)
 	{
 		// +2 = 1 for the byte + 1 for the null termination
-		ensureSpaceExists(m_count + 2);
-		m_memory[m_count] = v;
-		++m_count;
-		m_memory[m_count] = '\0';
+		ensureSpaceExists(2);
+		auto count = this->count();
+		ptr()[count] = v;
+		++count;
+		setCount(count);
+		ptr()[count] = '\0';
 	}
 
 	size_t String::find(StringView str, size_t start) const
@@ -171,20 +218,20 @@ namespace core
 	void String::replace(StringView search, StringView replace)
 	{
 		String out{m_allocator};
-		out.ensureSpaceExists(m_count);
+		out.ensureSpaceExists(count());
 		// find the first pattern or -1
 		size_t search_it = find(search, 0);
 		size_t it = 0;
 		// while we didn't finish the string
-		while (it < m_count)
+		while (it < count())
 		{
 			// if search_str is not found then put search_it to the end of string
 			if (search_it == SIZE_MAX)
 			{
 				// push the remaining content
-				if (it < m_count)
+				if (it < count())
 				{
-					out.push(StringView{m_memory.data() + it, m_count - it});
+					out.push(StringView{ptr() + it, count() - it});
 				}
 
 				// exit we finished the string
@@ -194,7 +241,7 @@ namespace core
 			// push the preceding content
 			if (search_it > it)
 			{
-				out.push(StringView{m_memory.data() + it, search_it - it});
+				out.push(StringView{ptr() + it, search_it - it});
 			}
 
 			// push the replacement string
@@ -1,227 +1,553 @@
 #include "core/StringView.h"
+#include "core/Intrinsics.h"
+#include "core/Utf8.h"
+
+#include <bit>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
 
 namespace core
 {
-	StringView::RabinKarpState StringView::hashRabinKarp(StringView str)
+	// the search compares the first and last bytes of the needle against a block of positions at once then verifies
+	// the candidates, which is a lot faster than Two-Way on real text but degrades to O(n * m) on repetitive input, so
+	// once the bytes compared by candidates which didn't match grow beyond this factor of the scanned bytes (plus
+	// the allowance) the rest is searched with Two-Way which is linear in the worst case
+	constexpr size_t SEARCH_WASTE_FACTOR = 8;
+	constexpr size_t SEARCH_WASTE_ALLOWANCE = 4096;
+
+	// folds the ascii upper case letters to lower case and leaves every other byte as is, including the bytes of non
+	// ascii runes
+	inline static char asciiLower(char c)
 	{
-		RabinKarpState res{0, 1};
+		return char(c | (uint8_t(c - 'A') < 26 ? 0x20 : 0));
+	}
 
-		for (size_t i = 0; i < str.count(); ++i)
-		{
-			res.hash = res.hash * PRIME_RABIN_KARP + uint32_t(str.m_begin[i]);
-		}
-		auto sq = PRIME_RABIN_KARP;
-		for (size_t i = str.m_count; i > 0; i >>= 1)
+	// returns the count of the leading bytes which are ascii in both strings and equal ignoring case starting from i
+	inline static size_t asciiEqualIgnoreCasePrefixScalar(const char* a, const char* b, size_t i, size_t count)
+	{
+		for (; i < count; ++i)
 		{
-			if ((i & 1) != 0)
+			if (((a[i] | b[i]) & 0x80) != 0 || asciiLower(a[i]) != asciiLower(b[i]))
 			{
-				res.pow *= sq;
+				break;
 			}
-			sq *= sq;
 		}
-		return res;
+		return i;
 	}
 
-	StringView::RabinKarpState StringView::hashRabinKarpIgnoreCase(StringView str)
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+	// the vector versions of asciiLower, the bytes of non ascii runes are negative as signed bytes so they are never
+	// in the A-Z range
+	inline static __m128i asciiLower(__m128i v)
 	{
-		RabinKarpState res{0, 1};
+		auto upper =
+			_mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+		return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+	}
+
+	TAHA_TARGET_AVX2 inline static __m256i asciiLowerAvx2(__m256i v)
+	{
+		auto upper = _mm256_and_si256(
+			_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+			_mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+		return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+	}
 
-		for (size_t i = 0; i < str.count(); ++i)
+	TAHA_TARGET_AVX2 static size_t asciiEqualIgnoreCasePrefixAvx2(const char* a, const char* b, size_t count)
+	{
+		size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+			auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+			auto nonAscii = uint32_t(_mm256_movemask_epi8(_mm256_or_si256(va, vb)));
+			auto equal = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(asciiLowerAvx2(va), asciiLowerAvx2(vb))));
+			if (auto stop = nonAscii | ~equal; stop != 0)
+			{
+				return i + std::countr_zero(stop);
+			}
+		}
+		return asciiEqualIgnoreCasePrefixScalar(a, b, i, count);
+	}
+#endif
+
+	// returns the count of the leading bytes which are ascii in both strings and equal ignoring case
+	inline static size_t asciiEqualIgnoreCasePrefix(const char* a, const char* b, size_t count)
+	{
+		size_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+		if (count >= 32 && cpuFeatures().avx2)
 		{
-			res.hash = res.hash * PRIME_RABIN_KARP + uint32_t(Rune{str.m_begin[i]}.lower());
+			return asciiEqualIgnoreCasePrefixAvx2(a, b, count);
 		}
-		auto sq = PRIME_RABIN_KARP;
-		for (size_t i = str.m_count; i > 0; i >>= 1)
+
+		for (; i + 16 <= count; i += 16)
 		{
-			if ((i & 1) != 0)
+			auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+			auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+			auto nonAscii = uint32_t(_mm_movemask_epi8(_mm_or_si128(va, vb)));
+			auto equal = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(asciiLower(va), asciiLower(vb))));
+			if (auto stop = nonAscii | (~equal & 0xFFFF); stop != 0)
 			{
-				res.pow *= sq;
+				return i + std::countr_zero(stop);
 			}
-			sq *= sq;
 		}
-		return res;
+#endif
+		return asciiEqualIgnoreCasePrefixScalar(a, b, i, count);
 	}
 
-	StringView::RabinKarpState StringView::hashRabinKarpReverse(StringView str)
+	// compares the first and last bytes of a needle against a block of consecutive haystack positions at once, bit i
+	// of the mask is set if position i matches both, when ignoring case the bytes are compared after asciiLower
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+	template <bool IgnoreCase>
+	struct SearchBlock
 	{
-		assertTrue(str.m_count > 0);
+		static constexpr size_t SIZE = 16;
 
-		RabinKarpState res{0, 1};
+		__m128i first, last;
 
-		for (size_t i = 0; i < str.m_count; ++i)
-		{
-			auto rev_i = str.m_count - i - 1;
-			res.hash = res.hash * PRIME_RABIN_KARP + uint32_t(str.m_begin[rev_i]);
-		}
-		auto sq = PRIME_RABIN_KARP;
-		for (size_t i = str.m_count; i > 0; i >>= 1)
+		SearchBlock(char firstByte, char lastByte)
+			: first(_mm_set1_epi8(firstByte)),
+			  last(_mm_set1_epi8(lastByte))
+		{}
+
+		uint32_t match(const char* ptr, size_t lastOffset) const
 		{
-			if ((i & 1) != 0)
+			auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+			auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + lastOffset));
+			if constexpr (IgnoreCase)
 			{
-				res.pow *= sq;
+				a = asciiLower(a);
+				b = asciiLower(b);
 			}
-			sq *= sq;
+			return uint32_t(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, a), _mm_cmpeq_epi8(last, b))));
 		}
-		return res;
-	}
+	};
 
-	int StringView::cmp(StringView a, StringView b)
+	// the search loops which use it are instantiated inside TAHA_TARGET_AVX2 functions and are only called after
+	// checking cpuFeatures().avx2
+	template <bool IgnoreCase>
+	struct SearchBlockAvx2
 	{
-		auto min_count = a.m_count < b.m_count ? a.m_count : b.m_count;
-		auto res = ::memcmp(a.m_begin, b.m_begin, min_count);
-		// NOTE: Possible that a[:min_count] == b[:min_count] but a>b, or vice versa, like "ABC" and "AB"
-		if (res == 0)
+		static constexpr size_t SIZE = 32;
+
+		__m256i first, last;
+
+		TAHA_TARGET_AVX2 SearchBlockAvx2(char firstByte, char lastByte)
+			: first(_mm256_set1_epi8(firstByte)),
+			  last(_mm256_set1_epi8(lastByte))
+		{}
+
+		TAHA_TARGET_AVX2 uint32_t match(const char* ptr, size_t lastOffset) const
 		{
-			if (a.m_count == b.m_count)
+			auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+			auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + lastOffset));
+			if constexpr (IgnoreCase)
 			{
-				return 0;
+				a = asciiLowerAvx2(a);
+				b = asciiLowerAvx2(b);
 			}
-			else if (a.m_count > b.m_count)
+			auto matches = _mm256_and_si256(_mm256_cmpeq_epi8(first, a), _mm256_cmpeq_epi8(last, b));
+			return uint32_t(_mm256_movemask_epi8(matches));
+		}
+	};
+#else
+	template <bool IgnoreCase>
+	struct SearchBlock
+	{
+		static constexpr size_t SIZE = 1;
+
+		char first, last;
+
+		SearchBlock(char firstByte, char lastByte)
+			: first(firstByte),
+			  last(lastByte)
+		{}
+
+		uint32_t match(const char* ptr, size_t lastOffset) const
+		{
+			if constexpr (IgnoreCase)
 			{
-				return 1;
+				return asciiLower(ptr[0]) == first && asciiLower(ptr[lastOffset]) == last;
 			}
 			else
 			{
-				return -1;
+				return ptr[0] == first && ptr[lastOffset] == last;
 			}
 		}
-		else
+	};
+#endif
+
+	inline static bool isAscii(const char* ptr, size_t count)
+	{
+		uint8_t acc = 0;
+		for (size_t i = 0; i < count; ++i)
 		{
-			return res;
+			acc |= uint8_t(ptr[i]);
 		}
+		return (acc & 0x80) == 0;
 	}
 
-	size_t StringView::find(StringView target, size_t start) const
+	template <bool IgnoreCase>
+	inline static bool searchMatchesAt(const char* haystack, size_t index, const char* needle, size_t needleCount)
 	{
-		if (start >= m_count || m_count - start < target.m_count)
+		if constexpr (IgnoreCase)
 		{
-			return SIZE_MAX;
+			return StringView{haystack + index, needleCount}.equalsIgnoreCase(StringView{needle, needleCount});
+		}
+		else
+		{
+			// the first and last bytes were already compared
+			return needleCount <= 2 || ::memcmp(haystack + index + 1, needle + 1, needleCount - 2) == 0;
 		}
+	}
+
+	// the bytes of a string read front to back or back to front, Two-Way searches the reversed strings to find the
+	// last occurrence and the asciiLower of the bytes to ignore case
+	template <bool Reverse, bool IgnoreCase = false>
+	struct SearchBytes
+	{
+		const unsigned char* ptr;
+		size_t count;
 
-		auto self = sliceRight(start);
+		SearchBytes(const char* p, size_t c)
+			: ptr(reinterpret_cast<const unsigned char*>(p)),
+			  count(c)
+		{}
 
-		if (target.m_count == 0)
+		unsigned char operator[](size_t i) const
 		{
-			return start;
+			auto c = Reverse ? ptr[count - 1 - i] : ptr[i];
+			if constexpr (IgnoreCase)
+			{
+				return uint8_t(asciiLower(char(c)));
+			}
+			else
+			{
+				return c;
+			}
 		}
-		else if (target.m_count == 1)
-		{
-			for (size_t i = 0; i < self.count(); ++i)
+	};
+
+	// returns the start of the maximal suffix of the needle minus one (-1 for the whole needle) using the byte order
+	// or its inverse, and its period, see Crochemore and Perrin "Two-way string-matching"
+	template <typename TBytes>
+	inline static ptrdiff_t searchMaximalSuffix(const TBytes& needle, bool inverse, size_t& period)
+	{
+		ptrdiff_t ms = -1;
+		size_t j = 0, k = 1;
+		period = 1;
+		while (j + k < needle.count)
+		{
+			auto a = needle[j + k];
+			auto b = needle[size_t(ms + ptrdiff_t(k))];
+			if (inverse ? a > b : a < b)
+			{
+				j += k;
+				k = 1;
+				period = size_t(ptrdiff_t(j) - ms);
+			}
+			else if (a == b)
 			{
-				if (self.m_begin[i] == target.m_begin[0])
+				if (k != period)
+				{
+					++k;
+				}
+				else
 				{
-					return start + i;
+					j += period;
+					k = 1;
 				}
 			}
-			return SIZE_MAX;
-		}
-		else if (target.m_count == m_count)
-		{
-			if (target == self)
+			else
 			{
-				return start;
+				ms = ptrdiff_t(j);
+				j = size_t(ms) + 1;
+				k = 1;
+				period = 1;
 			}
-			return SIZE_MAX;
-		}
-		else if (target.m_count > m_count)
-		{
-			return SIZE_MAX;
 		}
+		return ms;
+	}
 
-		auto [hash, pow] = hashRabinKarp(target);
+	// returns the first occurrence of the needle in the haystack in O(n + m) time and O(1) space
+	template <typename TBytes>
+	inline static size_t searchTwoWay(const TBytes& haystack, const TBytes& needle)
+	{
+		auto n = ptrdiff_t(haystack.count);
+		auto m = ptrdiff_t(needle.count);
+
+		size_t p = 0, q = 0;
+		auto i = searchMaximalSuffix(needle, false, p);
+		auto j = searchMaximalSuffix(needle, true, q);
+		auto ell = i > j ? i : j;
+		auto period = ptrdiff_t(i > j ? p : q);
 
-		uint32_t h{};
-		for (size_t i = 0; i < target.m_count; ++i)
+		// whether the left part is a suffix of the right part shifted by the period, then the needle is periodic
+		bool periodic = true;
+		for (ptrdiff_t k = 0; k <= ell; ++k)
 		{
-			h = h * PRIME_RABIN_KARP + uint32_t(self.m_begin[i]);
+			if (needle[size_t(k)] != needle[size_t(k + period)])
+			{
+				periodic = false;
+				break;
+			}
 		}
 
-		if (h == hash && ::memcmp(self.m_begin, target.m_begin, target.m_count) == 0)
+		if (periodic)
 		{
-			return start;
+			// memory is the prefix which is known to match after a shift by the period
+			ptrdiff_t memory = -1;
+			for (ptrdiff_t pos = 0; pos <= n - m;)
+			{
+				auto k = (ell > memory ? ell : memory) + 1;
+				while (k < m && needle[size_t(k)] == haystack[size_t(k + pos)])
+				{
+					++k;
+				}
+				if (k >= m)
+				{
+					k = ell;
+					while (k > memory && needle[size_t(k)] == haystack[size_t(k + pos)])
+					{
+						--k;
+					}
+					if (k <= memory)
+					{
+						return size_t(pos);
+					}
+					pos += period;
+					memory = m - period - 1;
+				}
+				else
+				{
+					pos += k - ell;
+					memory = -1;
+				}
+			}
 		}
-
-		for (size_t i = target.m_count; i < self.m_count;)
+		else
 		{
-			h *= PRIME_RABIN_KARP;
-			h += uint32_t(self.m_begin[i]);
-			h -= pow * uint32_t(self.m_begin[i - target.m_count]);
-			i += 1;
-			if (h == hash && ::memcmp(self.m_begin + i - target.m_count, target.m_begin, target.m_count) == 0)
+			period = (ell + 1 > m - ell - 1 ? ell + 1 : m - ell - 1) + 1;
+			for (ptrdiff_t pos = 0; pos <= n - m;)
 			{
-				return i - target.m_count + start;
+				auto k = ell + 1;
+				while (k < m && needle[size_t(k)] == haystack[size_t(k + pos)])
+				{
+					++k;
+				}
+				if (k >= m)
+				{
+					k = ell;
+					while (k >= 0 && needle[size_t(k)] == haystack[size_t(k + pos)])
+					{
+						--k;
+					}
+					if (k < 0)
+					{
+						return size_t(pos);
+					}
+					pos += period;
+				}
+				else
+				{
+					pos += k - ell;
+				}
 			}
 		}
 		return SIZE_MAX;
 	}
 
-	size_t StringView::findIgnoreCase(StringView target, size_t start) const
+	// returns the index of the first occurrence of the needle, the needle must not be empty or longer than the
+	// haystack, when ignoring case the candidates are the positions where the first and last bytes are equal after
+	// asciiLower and they are verified with equalsIgnoreCase
+	template <bool IgnoreCase, typename TBlock>
+	TAHA_FORCE_INLINE static size_t
+	searchFirstBlocks(const char* haystack, size_t count, const char* needle, size_t needleCount)
 	{
-		if (start >= m_count || m_count - start < target.m_count)
+		// the positions which a match can start at are [0, end)
+		auto end = count - needleCount + 1;
+		auto lastOffset = needleCount - 1;
+		auto first = IgnoreCase ? asciiLower(needle[0]) : needle[0];
+		auto last = IgnoreCase ? asciiLower(needle[lastOffset]) : needle[lastOffset];
+		TBlock block{first, last};
+		// when ignoring case Two-Way compares the asciiLower of the bytes which only matches equalsIgnoreCase for ascii
+		// needles, a multi byte rune which folds to an ascii one is longer than it so it can't be part of a match of an
+		// ascii needle, the other needles keep verifying the candidates
+		auto canTwoWay = IgnoreCase == false || isAscii(needle, needleCount);
+		size_t wasted = 0;
+		size_t i = 0;
+		for (; i + block.SIZE <= end; i += block.SIZE)
+		{
+			if (canTwoWay && wasted > SEARCH_WASTE_FACTOR * i + SEARCH_WASTE_ALLOWANCE)
+			{
+				auto index = searchTwoWay(
+					SearchBytes<false, IgnoreCase>{haystack + i, count - i},
+					SearchBytes<false, IgnoreCase>{needle, needleCount});
+				return index == SIZE_MAX ? SIZE_MAX : i + index;
+			}
+
+			auto mask = block.match(haystack + i, lastOffset);
+			while (mask != 0)
+			{
+				auto index = i + std::countr_zero(mask);
+				if (searchMatchesAt<IgnoreCase>(haystack, index, needle, needleCount))
+				{
+					return index;
+				}
+				wasted += needleCount;
+				mask &= mask - 1;
+			}
+		}
+		for (; i < end; ++i)
 		{
-			return SIZE_MAX;
+			auto a = IgnoreCase ? asciiLower(haystack[i]) : haystack[i];
+			auto b = IgnoreCase ? asciiLower(haystack[i + lastOffset]) : haystack[i + lastOffset];
+			if (a == first && b == last && searchMatchesAt<IgnoreCase>(haystack, i, needle, needleCount))
+			{
+				return i;
+			}
 		}
+		return SIZE_MAX;
+	}
 
-		auto self = sliceRight(start);
+	// returns the index of the last occurrence of the needle, the needle must not be empty or longer than the haystack
+	template <typename TBlock>
+	TAHA_FORCE_INLINE static size_t
+	searchLastBlocks(const char* haystack, size_t count, const char* needle, size_t needleCount)
+	{
+		// same as searchFirst but the blocks go from the end, memrchr isn't available everywhere so single bytes take
+		// the same path
+		auto end = count - needleCount + 1;
+		auto lastOffset = needleCount - 1;
+		TBlock block{needle[0], needle[lastOffset]};
+		size_t wasted = 0;
+		auto i = end;
+		for (; i >= block.SIZE; i -= block.SIZE)
+		{
+			if (wasted > SEARCH_WASTE_FACTOR * (end - i) + SEARCH_WASTE_ALLOWANCE)
+			{
+				// the matches which are left start before i so they are in the first i + lastOffset bytes
+				auto prefixCount = i + lastOffset;
+				auto index = searchTwoWay(
+					SearchBytes<true>{haystack, prefixCount},
+					SearchBytes<true>{needle, needleCount});
+				return index == SIZE_MAX ? SIZE_MAX : prefixCount - index - needleCount;
+			}
 
-		if (target.m_count == 0)
-		{
-			return start;
-		}
-		else if (target.m_count == 1)
-		{
-			for (size_t i = 0; i < self.count(); ++i)
+			auto begin = i - block.SIZE;
+			auto mask = block.match(haystack + begin, lastOffset);
+			while (mask != 0)
 			{
-				if (Rune{self.m_begin[i]}.lower() == Rune{target.m_begin[0]}.lower())
+				auto bit = 31 - std::countl_zero(mask);
+				if (searchMatchesAt<false>(haystack, begin + bit, needle, needleCount))
 				{
-					return start + i;
+					return begin + bit;
 				}
+				wasted += needleCount;
+				mask &= ~(uint32_t(1) << bit);
 			}
-			return SIZE_MAX;
 		}
-		else if (target.m_count == m_count)
+		while (i > 0)
 		{
-			if (target.endsWithIgnoreCase(self))
+			--i;
+			if (haystack[i] == needle[0] && haystack[i + lastOffset] == needle[lastOffset] &&
+				searchMatchesAt<false>(haystack, i, needle, needleCount))
 			{
-				return start;
+				return i;
 			}
-			return SIZE_MAX;
 		}
-		else if (target.m_count > m_count)
+		return SIZE_MAX;
+	}
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+	template <bool IgnoreCase>
+	TAHA_TARGET_AVX2 static size_t
+	searchFirstAvx2(const char* haystack, size_t count, const char* needle, size_t needleCount)
+	{
+		return searchFirstBlocks<IgnoreCase, SearchBlockAvx2<IgnoreCase>>(haystack, count, needle, needleCount);
+	}
+
+	TAHA_TARGET_AVX2 static size_t
+	searchLastAvx2(const char* haystack, size_t count, const char* needle, size_t needleCount)
+	{
+		return searchLastBlocks<SearchBlockAvx2<false>>(haystack, count, needle, needleCount);
+	}
+#endif
+
+	template <bool IgnoreCase>
+	inline static size_t searchFirst(const char* haystack, size_t count, const char* needle, size_t needleCount)
+	{
+		if (IgnoreCase == false && needleCount == 1)
 		{
-			return SIZE_MAX;
+			auto ptr = static_cast<const char*>(::memchr(haystack, needle[0], count));
+			return ptr ? size_t(ptr - haystack) : SIZE_MAX;
 		}
 
-		auto [hash, pow] = hashRabinKarpIgnoreCase(target);
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+		if (cpuFeatures().avx2)
+		{
+			return searchFirstAvx2<IgnoreCase>(haystack, count, needle, needleCount);
+		}
+#endif
+		return searchFirstBlocks<IgnoreCase, SearchBlock<IgnoreCase>>(haystack, count, needle, needleCount);
+	}
 
-		uint32_t h{};
-		for (size_t i = 0; i < target.m_count; ++i)
+	inline static size_t searchLast(const char* haystack, size_t count, const char* needle, size_t needleCount)
+	{
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+		if (cpuFeatures().avx2)
+		{
+			return searchLastAvx2(haystack, count, needle, needleCount);
+		}
+#endif
+		return searchLastBlocks<SearchBlock<false>>(haystack, count, needle, needleCount);
+	}
+
+	size_t StringView::find(StringView target, size_t start) const
+	{
+		if (start >= m_count || m_count - start < target.m_count)
 		{
-			h = h * PRIME_RABIN_KARP + uint32_t(Rune{self.m_begin[i]}.lower());
+			return SIZE_MAX;
 		}
 
-		if (h == hash && self.equalsIgnoreCase(target))
+		if (target.m_count == 0)
 		{
 			return start;
 		}
 
-		for (size_t i = target.m_count; i < self.m_count;)
+		auto index = searchFirst<false>(m_begin + start, m_count - start, target.m_begin, target.m_count);
+		return index == SIZE_MAX ? SIZE_MAX : start + index;
+	}
+
+	size_t StringView::findIgnoreCase(StringView target, size_t start) const
+	{
+		if (start >= m_count || m_count - start < target.m_count)
+		{
+			return SIZE_MAX;
+		}
+
+		if (target.m_count == 0)
 		{
-			h *= PRIME_RABIN_KARP;
-			h += uint32_t(Rune{self.m_begin[i]}.lower());
-			h -= pow * uint32_t(Rune{self.m_begin[i - target.m_count]}.lower());
-			i += 1;
-			if (h == hash && self.sliceRight(i - target.count()).equalsIgnoreCase(target))
-			{
-				return i - target.m_count + start;
-			}
+			return start;
 		}
-		return SIZE_MAX;
+
+		auto index = searchFirst<true>(m_begin + start, m_count - start, target.m_begin, target.m_count);
+		return index == SIZE_MAX ? SIZE_MAX : start + index;
 	}
 
 	size_t StringView::find(Rune target, size_t start) const
 	{
 		assertTrue(start < m_count);
+		// an ascii byte never shows up inside the encoding of another rune so it can be searched for as a byte
+		if (int(target) >= 0 && int(target) < 0x80)
+		{
+			auto ptr = static_cast<const char*>(::memchr(m_begin + start, int(target), m_count - start));
+			return ptr ? size_t(ptr - m_begin) : SIZE_MAX;
+		}
 		for (auto it = m_begin + start; it < m_begin + m_count; it = Rune::next(it))
 		{
 			auto c = Rune::decode(it);
@@ -246,56 +572,12 @@ namespace core
 		{
 			return self.m_count;
 		}
-		else if (target.m_count == 1)
-		{
-			for (size_t i = 0; i < self.m_count; ++i)
-			{
-				auto rev_i = self.m_count - i - 1;
-				if (self.m_begin[rev_i] == target.m_begin[0])
-				{
-					return rev_i;
-				}
-			}
-			return SIZE_MAX;
-		}
-		else if (target.m_count == self.m_count)
-		{
-			if (::memcmp(self.m_begin, target.m_begin, target.m_count) == 0)
-			{
-				return 0;
-			}
-			return SIZE_MAX;
-		}
 		else if (target.m_count > self.m_count)
 		{
 			return SIZE_MAX;
 		}
 
-		auto [hash, pow] = hashRabinKarpReverse(target);
-		auto last = self.m_count - target.m_count;
-
-		uint32_t h{};
-		for (size_t i = self.m_count - 1; i >= last; --i)
-		{
-			h = h * PRIME_RABIN_KARP + uint32_t(self.m_begin[i]);
-		}
-		if (h == hash && ::memcmp(self.m_begin + last, target.m_begin, target.m_count) == 0)
-		{
-			return last;
-		}
-
-		for (size_t i = 0; i < last; ++i)
-		{
-			auto rev_i = last - i - 1;
-			h *= PRIME_RABIN_KARP;
-			h += uint32_t(self.m_begin[rev_i]);
-			h -= pow * uint32_t(self.m_begin[rev_i + target.m_count]);
-			if (h == hash && ::memcmp(self.m_begin + rev_i, target.m_begin, target.m_count) == 0)
-			{
-				return rev_i;
-			}
-		}
-		return SIZE_MAX;
+		return searchLast(self.m_begin, self.m_count, target.m_begin, target.m_count);
 	}
 
 	size_t StringView::findFirstByte(StringView str, size_t start) const
@@ -316,43 +598,10 @@ namespace core
 	Array<StringView> StringView::split(StringView delim, bool skipEmpty, Allocator* allocator) const
 	{
 		Array<StringView> res{allocator};
-
-		size_t ix = 0;
-		while (true)
+		for (auto part: split(delim, skipEmpty))
 		{
-			if (ix + delim.count() > m_count)
-			{
-				break;
-			}
-
-			size_t delim_ix = find(delim, ix);
-			if (delim_ix == SIZE_MAX)
-			{
-				break;
-			}
-
-			auto skip = skipEmpty && ix == delim_ix;
-			if (!skip)
-			{
-				res.push(slice(ix, delim_ix));
-			}
-
-			ix = delim_ix + delim.count();
-			if (ix == m_count)
-			{
-				break;
-			}
-		}
-
-		if (ix != m_count)
-		{
-			res.push(slice(ix, m_count));
+			res.push(part);
 		}
-		else if (!skipEmpty && ix == m_count)
-		{
-			res.push(StringView{});
-		}
-
 		return res;
 	}
 
@@ -363,16 +612,28 @@ namespace core
 			return false;
 		}
 
-		for (size_t i = 0; i < m_count; ++i)
+		// ascii runs are compared a block at a time, only the non ascii runes go through Rune::lower
+		auto a = m_begin;
+		auto b = other.m_begin;
+		auto aEnd = m_begin + m_count;
+		auto bEnd = other.m_begin + other.m_count;
+		while (true)
 		{
-			auto a = m_begin + i;
-			auto b = other.m_begin + i;
-			if (Rune::decode(a).lower() != Rune::decode(b).lower())
+			auto count = asciiEqualIgnoreCasePrefix(a, b, size_t(aEnd - a < bEnd - b ? aEnd - a : bEnd - b));
+			a += count;
+			b += count;
+			if (a >= aEnd || b >= bEnd)
+			{
+				return a >= aEnd && b >= bEnd;
+			}
+
+			if (((*a | *b) & 0x80) == 0 || Rune::decode(a).lower() != Rune::decode(b).lower())
 			{
 				return false;
 			}
+			a = Rune::next(a);
+			b = Rune::next(b);
 		}
-		return true;
 	}
 
 	StringView StringView::trimLeft() const
@@ -392,336 +653,6 @@ namespace core
 
 	bool StringView::isValidUtf8() const
 	{
-		struct AcceptRange
-		{
-			uint8_t lo, hi;
-		};
-
-		static constexpr AcceptRange acceptRanges[5] = {
-			AcceptRange{0x80, 0xbf},
-			AcceptRange{0xa0, 0xbf},
-			AcceptRange{0x80, 0x9f},
-			AcceptRange{0x90, 0xbf},
-			AcceptRange{0x80, 0x8f},
-		};
-
-		static constexpr uint8_t xx = 0xf1;
-		static constexpr uint8_t as = 0xf0;
-		static constexpr uint8_t s1 = 0x02;
-		static constexpr uint8_t s2 = 0x13;
-		static constexpr uint8_t s3 = 0x03;
-		static constexpr uint8_t s4 = 0x23;
-		static constexpr uint8_t s5 = 0x34;
-		static constexpr uint8_t s6 = 0x04;
-		static constexpr uint8_t s7 = 0x44;
-
-		static constexpr uint8_t acceptSizes[256] = {
-			//   1   2   3   4   5   6   7   8   9   A   B   C   D   E   F
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as, // 0x00-0x0F
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as, // 0x10-0x1F
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as, // 0x20-0x2F
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as, // 0x30-0x3F
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as, // 0x40-0x4F
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as, // 0x50-0x5F
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as, // 0x60-0x6F
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as,
-			as, // 0x70-0x7F
-			//   1   2   3   4   5   6   7   8   9   A   B   C   D   E   F
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx, // 0x80-0x8F
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx, // 0x90-0x9F
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx, // 0xA0-0xAF
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx, // 0xB0-0xBF
-			xx,
-			xx,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1, // 0xC0-0xCF
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1,
-			s1, // 0xD0-0xDF
-			s2,
-			s3,
-			s3,
-			s3,
-			s3,
-			s3,
-			s3,
-			s3,
-			s3,
-			s3,
-			s3,
-			s3,
-			s3,
-			s4,
-			s3,
-			s3, // 0xE0-0xEF
-			s5,
-			s6,
-			s6,
-			s6,
-			s7,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx,
-			xx, // 0xF0-0xFF
-		};
-
-		auto bytes = (uint8_t*)m_begin;
-
-		for (size_t i = 0; i < m_count;)
-		{
-			auto byte = bytes[i];
-			if (Rune{byte} < Rune::SELF)
-			{
-				++i;
-				continue;
-			}
-
-			auto x = acceptSizes[byte];
-			if (x == xx)
-			{
-				return false;
-			}
-
-			auto size = (int)(x & 7);
-			if (i + size > m_count)
-			{
-				return false;
-			}
-
-			auto ar = acceptRanges[x >> 4];
-			if (auto b = bytes[i + 1]; b < ar.lo || ar.hi < b)
-			{
-				return false;
-			}
-			else if (size == 2)
-			{
-				// okay
-			}
-			else if (auto c = bytes[i + 2]; c < 0x80 || 0xbf < c)
-			{
-				return false;
-			}
-			else if (size == 3)
-			{
-				// okay
-			}
-			else if (auto d = bytes[i + 3]; d < 0x80 || 0xbf < d)
-			{
-				return false;
-			}
-			i += size;
-		}
-		return true;
+		return Utf8::validate(m_begin, m_count);
 	}
 }
\ No newline at end of file
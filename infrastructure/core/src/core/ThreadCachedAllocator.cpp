@@ -0,0 +1,371 @@
+#include "core/ThreadCachedAllocator.h"
+#include "core/Hash.h"
+#include "core/Lock.h"
+#include "core/Mallocator.h"
+
+#include <bit>
+#include <new>
+
+namespace core
+{
+	struct ThreadCachedAllocator::ThreadCache
+	{
+		// freed blocks are linked through their first bytes
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		struct Bin
+		{
+			FreeBlock* head = nullptr;
+			size_t count = 0;
+		};
+
+		Bin bins[SIZE_CLASSES_COUNT];
+	};
+
+	inline static size_t sizeClassOf(size_t size)
+	{
+		if (size <= ThreadCachedAllocator::MIN_BLOCK_SIZE)
+		{
+			return 0;
+		}
+		return std::bit_width(size - 1) - std::bit_width(ThreadCachedAllocator::MIN_BLOCK_SIZE - 1);
+	}
+
+	inline static size_t blockSizeOf(size_t sizeClass)
+	{
+		return ThreadCachedAllocator::MIN_BLOCK_SIZE << sizeClass;
+	}
+
+	inline static size_t batchCountOf(size_t sizeClass)
+	{
+		auto res = ThreadCachedAllocator::BATCH_SIZE_IN_BYTES / blockSizeOf(sizeClass);
+		if (res < 2)
+		{
+			return 2;
+		}
+		else if (res > 64)
+		{
+			return 64;
+		}
+		return res;
+	}
+
+	// all the live allocators, it's used to find out whether the allocator of a thread cache is still alive when its
+	// thread exits
+	struct ThreadCachedAllocatorRegistry
+	{
+		Mallocator allocator;
+		Mutex mutex{&allocator};
+		Map<uint64_t, ThreadCachedAllocator*> aliveAllocators{&allocator};
+		uint64_t nextId = 1;
+	};
+
+	inline static ThreadCachedAllocatorRegistry& registry()
+	{
+		static ThreadCachedAllocatorRegistry registry;
+		return registry;
+	}
+
+	// a thread can use a limited number of thread cached allocators at the same time, the rest of them go directly to
+	// their backing allocators
+	constexpr size_t THREAD_CACHES_COUNT = 16;
+
+	struct ThreadCacheTable
+	{
+		struct Entry
+		{
+			uint64_t allocatorId = 0;
+			ThreadCachedAllocator::ThreadCache* cache = nullptr;
+		};
+
+		Entry entries[THREAD_CACHES_COUNT];
+		size_t count = 0;
+
+		ThreadCachedAllocator::ThreadCache* find(uint64_t allocatorId) const
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (entries[i].allocatorId == allocatorId)
+				{
+					return entries[i].cache;
+				}
+			}
+			return nullptr;
+		}
+
+		void remove(uint64_t allocatorId)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (entries[i].allocatorId == allocatorId)
+				{
+					entries[i] = entries[count - 1];
+					--count;
+					return;
+				}
+			}
+		}
+
+		// removes the entries of the destroyed allocators
+		void compact()
+		{
+			auto& registry = core::registry();
+			auto lock = lockGuard(registry.mutex);
+			for (size_t i = 0; i < count;)
+			{
+				if (registry.aliveAllocators.lookup(entries[i].allocatorId) == registry.aliveAllocators.end())
+				{
+					entries[i] = entries[count - 1];
+					--count;
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+
+		~ThreadCacheTable()
+		{
+			auto& registry = core::registry();
+			auto lock = lockGuard(registry.mutex);
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (auto it = registry.aliveAllocators.lookup(entries[i].allocatorId);
+					it != registry.aliveAllocators.end())
+				{
+					it->value->releaseThreadCache(entries[i].cache);
+				}
+			}
+			count = 0;
+		}
+	};
+
+	thread_local ThreadCacheTable t_threadCaches;
+
+	ThreadCachedAllocator::ThreadCache* ThreadCachedAllocator::threadCache()
+	{
+		auto& table = t_threadCaches;
+		if (auto cache = table.find(m_id))
+		{
+			return cache;
+		}
+
+		if (table.count == THREAD_CACHES_COUNT)
+		{
+			table.compact();
+			if (table.count == THREAD_CACHES_COUNT)
+			{
+				return nullptr;
+			}
+		}
+
+		auto lock = lockGuard(m_mutex);
+		auto cache = m_allocator->allocSingleT<ThreadCache>();
+		m_allocator->commitSingleT(cache);
+		::new (cache) ThreadCache{};
+		m_caches.push(cache);
+
+		table.entries[table.count++] = ThreadCacheTable::Entry{m_id, cache};
+		return cache;
+	}
+
+	void ThreadCachedAllocator::refill(ThreadCache* cache, size_t sizeClass)
+	{
+		auto blockSize = blockSizeOf(sizeClass);
+		auto batchCount = batchCountOf(sizeClass);
+		auto& bin = cache->bins[sizeClass];
+
+		auto lock = lockGuard(m_mutex);
+		for (size_t i = 0; i < batchCount; ++i)
+		{
+			auto bytes = m_allocator->alloc(blockSize, alignof(std::max_align_t));
+			if (bytes.empty())
+			{
+				break;
+			}
+			m_allocator->commit(bytes);
+
+			auto block = (ThreadCache::FreeBlock*)bytes.data();
+			block->next = bin.head;
+			bin.head = block;
+			++bin.count;
+		}
+	}
+
+	void ThreadCachedAllocator::flush(ThreadCache* cache, size_t sizeClass, size_t count)
+	{
+		auto blockSize = blockSizeOf(sizeClass);
+		auto& bin = cache->bins[sizeClass];
+
+		auto lock = lockGuard(m_mutex);
+		for (size_t i = 0; i < count && bin.head != nullptr; ++i)
+		{
+			auto block = bin.head;
+			bin.head = block->next;
+			--bin.count;
+
+			auto bytes = Span<std::byte>{(std::byte*)block, blockSize};
+			m_allocator->release(bytes);
+			m_allocator->free(bytes);
+		}
+	}
+
+	Span<std::byte> ThreadCachedAllocator::allocUncached(size_t size, size_t alignment)
+	{
+		auto lock = lockGuard(m_mutex);
+		return m_allocator->alloc(size, alignment);
+	}
+
+	void ThreadCachedAllocator::freeUncached(Span<std::byte> bytes)
+	{
+		auto lock = lockGuard(m_mutex);
+		m_allocator->free(bytes);
+	}
+
+	void ThreadCachedAllocator::releaseThreadCache(ThreadCache* cache)
+	{
+		for (size_t i = 0; i < SIZE_CLASSES_COUNT; ++i)
+		{
+			flush(cache, i, SIZE_MAX);
+		}
+
+		auto lock = lockGuard(m_mutex);
+		m_caches.removeIf([cache](ThreadCache* c) { return c == cache; });
+		cache->~ThreadCache();
+		m_allocator->releaseSingleT(cache);
+		m_allocator->freeSingleT(cache);
+	}
+
+	ThreadCachedAllocator::ThreadCachedAllocator(Allocator* allocator)
+		: m_allocator(allocator),
+		  m_mutex(allocator),
+		  m_caches(allocator)
+	{
+		auto& registry = core::registry();
+		auto lock = lockGuard(registry.mutex);
+		m_id = registry.nextId++;
+		registry.aliveAllocators.insert(m_id, this);
+	}
+
+	ThreadCachedAllocator::~ThreadCachedAllocator()
+	{
+		// the registry lock is held while we release the caches so that an exiting thread can't release its cache at
+		// the same time
+		auto& registry = core::registry();
+		auto lock = lockGuard(registry.mutex);
+		registry.aliveAllocators.remove(m_id);
+
+		while (m_caches.count() > 0)
+		{
+			releaseThreadCache(m_caches[m_caches.count() - 1]);
+		}
+		t_threadCaches.remove(m_id);
+	}
+
+	Span<std::byte> ThreadCachedAllocator::alloc(size_t size, size_t alignment)
+	{
+		if (size == 0)
+		{
+			return Span<std::byte>{};
+		}
+
+		if (size > MAX_BLOCK_SIZE)
+		{
+			return allocUncached(size, alignment);
+		}
+
+		assertTrue(alignment <= alignof(std::max_align_t));
+
+		auto sizeClass = sizeClassOf(size);
+		auto cache = threadCache();
+		if (cache == nullptr)
+		{
+			// the block still has the size of its class, so it can be freed through a thread cache later
+			auto bytes = allocUncached(blockSizeOf(sizeClass), alignof(std::max_align_t));
+			m_allocator->commit(bytes);
+			return Span<std::byte>{bytes.data(), size};
+		}
+
+		auto& bin = cache->bins[sizeClass];
+		if (bin.head == nullptr)
+		{
+			refill(cache, sizeClass);
+			if (bin.head == nullptr)
+			{
+				return Span<std::byte>{};
+			}
+		}
+
+		auto block = bin.head;
+		bin.head = block->next;
+		--bin.count;
+		return Span<std::byte>{(std::byte*)block, size};
+	}
+
+	void ThreadCachedAllocator::commit(Span<std::byte> bytes)
+	{
+		// cached blocks are already committed, but the bytes might be part of a big uncached allocation so we forward
+		// it anyway
+		m_allocator->commit(bytes);
+	}
+
+	void ThreadCachedAllocator::release(Span<std::byte> bytes)
+	{
+		// cached blocks are kept committed, release is only a hint so we ignore the small ranges since they might be
+		// part of a cached block, bigger ranges can only be part of an uncached allocation
+		if (bytes.sizeInBytes() > MAX_BLOCK_SIZE)
+		{
+			m_allocator->release(bytes);
+		}
+	}
+
+	void ThreadCachedAllocator::free(Span<std::byte> bytes)
+	{
+		if (bytes.data() == nullptr)
+		{
+			return;
+		}
+
+		if (bytes.sizeInBytes() > MAX_BLOCK_SIZE)
+		{
+			freeUncached(bytes);
+			return;
+		}
+
+		auto sizeClass = sizeClassOf(bytes.sizeInBytes());
+		auto cache = threadCache();
+		if (cache == nullptr)
+		{
+			freeUncached(Span<std::byte>{bytes.data(), blockSizeOf(sizeClass)});
+			return;
+		}
+
+		auto& bin = cache->bins[sizeClass];
+		auto block = (ThreadCache::FreeBlock*)bytes.data();
+		block->next = bin.head;
+		bin.head = block;
+		++bin.count;
+
+		// keep up to two batches in the cache so that alternating alloc/free doesn't keep hitting the backing allocator
+		auto batchCount = batchCountOf(sizeClass);
+		if (bin.count > 2 * batchCount)
+		{
+			flush(cache, sizeClass, batchCount);
+		}
+	}
+
+	void ThreadCachedAllocator::flushThreadCache()
+	{
+		if (auto cache = t_threadCaches.find(m_id))
+		{
+			for (size_t i = 0; i < SIZE_CLASSES_COUNT; ++i)
+			{
+				flush(cache, i, SIZE_MAX);
+			}
+		}
+	}
+}
@@ -18,7 +18,8 @@ namespace core
 		m_threads.reserve(threads_count);
 		for (size_t i = 0; i < threads_count; ++i)
 		{
-			Thread thread(allocator, [this, n = i]() {
+			Thread thread(allocator, [this, n = i, allocator]() {
+				AllocatorScope allocatorScope{allocator};
 				while (true)
 				{
 					NotificationQueueEntry entry;
@@ -1,6 +1,10 @@
 #include "core/UUID.h"
+#include "core/Hex.h"
 #include "core/Rand.h"
 
+#include <atomic>
+#include <chrono>
+
 namespace core
 {
 	inline uint8_t hex_to_uint8(char c)
@@ -42,6 +46,66 @@ namespace core
 		return uuid;
 	}
 
+	// the unix milliseconds and the 12 bit counter of the last uuid generateV7 handed out as (ms << 12) | counter, all
+	// the threads share it so the uuids are increasing in the whole process
+	static std::atomic<uint64_t> UUID_V7_LAST{0};
+
+	// where the 5 groups of hex digits are in the xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx form
+	static constexpr size_t UUID_GROUP_OFFSETS[] = {0, 9, 14, 19, 24};
+	static constexpr size_t UUID_GROUP_COUNTS[] = {8, 4, 4, 4, 12};
+
+	UUID UUID::generateV7()
+	{
+		UUID uuid;
+		auto ok = Rand::cryptoRand(Span<std::byte>{(std::byte*)&uuid.data, sizeof(uuid.data)});
+		assertTrue(ok);
+
+		auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch());
+		// the counter starts at a random value below 2048 each millisecond so there's room for at least 2048 uuids
+		// before it carries over into the timestamp, which is fine since the timestamp only has to be increasing
+		auto counter = ((uint64_t(uuid.data.bytes[6]) << 8) | uuid.data.bytes[7]) & 0x7FF;
+		auto candidate = (uint64_t(now.count()) << 12) | counter;
+		auto last = UUID_V7_LAST.load(std::memory_order_relaxed);
+		uint64_t next = 0;
+		do
+		{
+			next = candidate > last ? candidate : last + 1;
+		}
+		while (UUID_V7_LAST.compare_exchange_weak(last, next, std::memory_order_relaxed) == false);
+
+		auto timestamp = next >> 12;
+		for (size_t i = 0; i < 6; ++i)
+		{
+			uuid.data.bytes[i] = uint8_t(timestamp >> (40 - i * 8));
+		}
+		// version 7 followed by the counter
+		uuid.data.bytes[6] = uint8_t(0x70 | ((next >> 8) & 0x0f));
+		uuid.data.bytes[7] = uint8_t(next);
+		// variant is 10
+		uuid.data.bytes[8] = (uuid.data.bytes[8] & 0x3f) | 0x80;
+		return uuid;
+	}
+
+	void UUID::format(Span<char> out) const
+	{
+		assertTrue(out.count() >= STRING_SIZE);
+
+		char digits[Hex::encodedCount(sizeof(data))];
+		Hex::encode(Span<const std::byte>{(const std::byte*)&data, sizeof(data)}, Span<char>{digits, sizeof(digits)});
+
+		auto it = digits;
+		for (size_t i = 0; i < 5; ++i)
+		{
+			::memcpy(out.data() + UUID_GROUP_OFFSETS[i], it, UUID_GROUP_COUNTS[i]);
+			it += UUID_GROUP_COUNTS[i];
+			if (i + 1 < 5)
+			{
+				out[UUID_GROUP_OFFSETS[i] + UUID_GROUP_COUNTS[i]] = '-';
+			}
+		}
+	}
+
 	Result<UUID> UUID::parse(StringView str, Allocator* allocator)
 	{
 		UUID res{};
@@ -62,6 +126,28 @@ namespace core
 			return errf(allocator, "mismatched opening curly brace"_sv);
 		}
 
+		// the usual form has its dashes in place so we gather the digits and decode them all at once
+		auto canonical = str.slice(has_braces, str.count() - has_braces);
+		if (canonical.count() == STRING_SIZE && canonical[8] == '-' && canonical[13] == '-' && canonical[18] == '-' &&
+			canonical[23] == '-')
+		{
+			char digits[Hex::encodedCount(sizeof(res.data))];
+			auto it = digits;
+			for (size_t i = 0; i < 5; ++i)
+			{
+				::memcpy(it, canonical.data() + UUID_GROUP_OFFSETS[i], UUID_GROUP_COUNTS[i]);
+				it += UUID_GROUP_COUNTS[i];
+			}
+
+			auto count = Hex::decode(
+				StringView{digits, sizeof(digits)}, Span<std::byte>{(std::byte*)&res.data, sizeof(res.data)});
+			if (count == SIZE_MAX)
+			{
+				return errf(allocator, "invalid uuid"_sv);
+			}
+			return res;
+		}
+
 		size_t index = 0;
 		bool first_digit = true;
 		char digit = 0;
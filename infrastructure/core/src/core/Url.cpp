@@ -28,16 +28,16 @@ namespace core
 
 	constexpr static auto HEX_DIGITS = "0123456789ABCDEF";
 
-	static bool isAllowedChar(char c, uint8_t mask)
+	static bool is_allowed_char(char c, uint8_t mask)
 	{
 		return (ALLOWED_CHAR[uint8_t(c)] & mask) != 0;
 	}
 
-	static bool isAllowedStr(StringView str, uint8_t mask)
+	static bool is_allowed_str(const char* begin, const char* end, uint8_t mask)
 	{
-		for (auto b: str)
+		for (auto it = begin; it != end; ++it)
 		{
-			if (isAllowedChar(b, mask) == false)
+			if (is_allowed_char(*it, mask) == false)
 			{
 				return false;
 			}
@@ -45,7 +45,7 @@ namespace core
 		return true;
 	}
 
-	static int hexDigit(char c)
+	static int get_hex_digit(char c)
 	{
 		if (c >= '0' && c <= '9')
 		{
@@ -62,58 +62,88 @@ namespace core
 		return -1;
 	}
 
-	static Result<String> decodePlusStr(StringView str, Allocator* allocator)
+	// writes the decoding of str to out and returns the count of written characters or SIZE_MAX if str has an invalid
+	// percent encoding
+	static size_t decodeStr(StringView str, Span<char> out, bool plusIsSpace)
 	{
-		if (str.count() == 0)
-		{
-			return String{allocator};
-		}
-
-		String res{allocator};
-		res.reserve(str.count());
+		assertTrue(out.count() >= str.count());
 
+		size_t count = 0;
 		for (size_t i = 0; i < str.count(); ++i)
 		{
 			auto c = str[i];
-
-			if (c == '+')
+			if (c == '+' && plusIsSpace)
 			{
 				c = ' ';
 			}
 			else if (c == '%')
 			{
-				++i;
-				if (i >= str.count())
+				if (i + 2 >= str.count())
 				{
-					return errf(allocator, "Invalid percent encoding in '{}'"_sv, str);
+					return SIZE_MAX;
 				}
-				c = str[i];
 
-				auto a = hexDigit(c);
-				if (a == -1)
+				auto a = get_hex_digit(str[i + 1]);
+				auto b = get_hex_digit(str[i + 2]);
+				if (a == -1 || b == -1)
 				{
-					return errf(allocator, "Invalid percent encoding in '{}'"_sv, str);
+					return SIZE_MAX;
 				}
 
-				++i;
-				if (i >= str.count())
-				{
-					return errf(allocator, "Invalid percent encoding in '{}'"_sv, str);
-				}
-				c = str[i];
+				c = char((a << 4) | b);
+				i += 2;
+			}
+			out[count++] = c;
+		}
+		return count;
+	}
 
-				auto b = hexDigit(c);
-				if (b == -1)
+	// a string with invalid percent encoding is kept as is
+	static String decodeToString(StringView str, bool plusIsSpace, Allocator* allocator)
+	{
+		String res{allocator};
+		res.resize(str.count());
+		auto count = decodeStr(str, Span<char>{res.data(), res.count()}, plusIsSpace);
+		if (count == SIZE_MAX)
+		{
+			return String{str, allocator};
+		}
+		res.resize(count);
+		return res;
+	}
+
+	// compares the query element to the given decoded string while decoding it, so it matches what decodeToString
+	// would've returned
+	static bool queryElementEquals(StringView encoded, StringView decoded)
+	{
+		bool equal = true;
+		size_t count = 0;
+		for (size_t i = 0; i < encoded.count(); ++i, ++count)
+		{
+			auto c = encoded[i];
+			if (c == '+')
+			{
+				c = ' ';
+			}
+			else if (c == '%')
+			{
+				auto a = i + 2 < encoded.count() ? get_hex_digit(encoded[i + 1]) : -1;
+				auto b = i + 2 < encoded.count() ? get_hex_digit(encoded[i + 2]) : -1;
+				if (a == -1 || b == -1)
 				{
-					return errf(allocator, "Invalid percent encoding in '{}'"_sv, str);
+					return encoded == decoded;
 				}
 
-				c = (a << 4) | b;
+				c = char((a << 4) | b);
+				i += 2;
 			}
-			res.pushByte(c);
-		}
 
-		return res;
+			if (count >= decoded.count() || decoded[count] != c)
+			{
+				equal = false;
+			}
+		}
+		return equal && count == decoded.count();
 	}
 
 	static String encodeString(StringView str, uint8_t mask, Allocator* allocator)
@@ -123,7 +153,7 @@ namespace core
 
 		for (auto c: str)
 		{
-			if (isAllowedChar(c, mask))
+			if (is_allowed_char(c, mask))
 			{
 				res.pushByte(c);
 			}
@@ -138,23 +168,6 @@ namespace core
 		return res;
 	}
 
-	static bool is_allowed_char(char c, uint8_t mask)
-	{
-		return (ALLOWED_CHAR[uint8_t(c)] & mask) != 0;
-	}
-
-	static bool is_allowed_str(const char* begin, const char* end, uint8_t mask)
-	{
-		for (auto it = begin; it != end; ++it)
-		{
-			if (is_allowed_char(*it, mask) == false)
-			{
-				return false;
-			}
-		}
-		return true;
-	}
-
 	static const char* find_first_of(const char* begin, const char* end, const char* search)
 	{
 		for (auto it = begin; it != end; ++it)
@@ -220,23 +233,6 @@ namespace core
 		return (is_num(c) || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f'));
 	}
 
-	static int get_hex_digit(char c)
-	{
-		if (c >= '0' && c <= '9')
-		{
-			return c - '0';
-		}
-		else if (c >= 'A' && c <= 'F')
-		{
-			return c - 'A' + 10;
-		}
-		else if (c >= 'a' && c <= 'f')
-		{
-			return c - 'a' + 10;
-		}
-		return -1;
-	}
-
 	static bool is_ipv6(const char* begin, const char* end)
 	{
 		size_t len = end - begin;
@@ -308,57 +304,6 @@ namespace core
 		}
 	}
 
-	static bool decode_str(String& str)
-	{
-		if (str.count() == 0)
-		{
-			return true;
-		}
-
-		String res{str.allocator()};
-		res.reserve(str.count());
-
-		for (auto it = str.begin(); it != str.end(); ++it)
-		{
-			char c = *it;
-			char a = 0, b = 0;
-			if (c == '%')
-			{
-				++it;
-				if (it == str.end())
-				{
-					return false;
-				}
-				c = *it;
-
-				a = get_hex_digit(c);
-				if (a == -1)
-				{
-					return false;
-				}
-
-				++it;
-				if (it == str.end())
-				{
-					return false;
-				}
-				c = *it;
-
-				b = get_hex_digit(c);
-				if (b == -1)
-				{
-					return false;
-				}
-
-				c = (a << 4) | b;
-			}
-			res.pushByte(c);
-		}
-
-		str = std::move(res);
-		return true;
-	}
-
 	static void normalize_reg_domain_name(String& scheme)
 	{
 		for (auto& c: scheme)
@@ -546,11 +491,9 @@ namespace core
 			return;
 		}
 
-		auto parts = path.split("/"_sv, true, allocator);
-
 		// filter parts without . and ..
-		Array<StringView> parts_filtered{allocator};
-		for (const auto& part: parts)
+		SmallArray<StringView, 16> parts_filtered{allocator};
+		for (auto part: path.split("/"_sv, true))
 		{
 			if (part == ""_sv || part == "."_sv)
 			{
@@ -582,181 +525,18 @@ namespace core
 		path = stream.releaseString();
 	}
 
-	static bool decode_plus_str(String& str)
-	{
-		if (str.count() == 0)
-		{
-			return true;
-		}
-
-		String res{str.allocator()};
-		res.reserve(str.count());
-
-		for (auto it = str.begin(); it != str.end(); ++it)
-		{
-			char c = *it;
-			char a = 0, b = 0;
-			if (c == '+')
-			{
-				c = ' ';
-			}
-			else if (c == '%')
-			{
-				++it;
-				if (it == str.end())
-				{
-					return false;
-				}
-				c = *it;
-
-				a = get_hex_digit(c);
-				if (a == -1)
-				{
-					return false;
-				}
-
-				++it;
-				if (it == str.end())
-				{
-					return false;
-				}
-				c = *it;
-
-				b = get_hex_digit(c);
-				if (b == -1)
-				{
-					return false;
-				}
-
-				c = (a << 4) | b;
-			}
-			res.pushByte(c);
-		}
-
-		str = res;
-		return true;
-	}
-
-	Result<UrlQuery> UrlQuery::parse(core::StringView query, core::Allocator* allocator)
-	{
-		UrlQuery res{allocator};
-
-		auto begin = query.begin();
-		auto end = query.end();
-		auto it = begin;
-		while (begin < end)
-		{
-			it = find_first_of(begin, end, "=;&");
-			if (is_allowed_str(begin, it, 0x3F) == false)
-			{
-				return errf(allocator, "Invalid query string '{}'"_sv, StringView{begin, it});
-			}
-
-			String value{allocator};
-			String key{StringView{begin, it}, allocator};
-			decode_plus_str(key);
-
-			if (it == end)
-			{
-				res.add(key, ""_sv);
-				break;
-			}
-
-			if (*it == '=')
-			{
-				begin = it + 1;
-				it = find_first_of(begin, end, ";&");
-				if (is_allowed_str(begin, it, 0x3F) == false)
-				{
-					return errf(allocator, "invalid query string '{}'"_sv, StringView{begin, it});
-				}
-				value = String{StringView{begin, it}, allocator};
-				decode_plus_str(value);
-			}
-
-			res.add(key, value);
-			begin = it + 1;
-		}
-
-		return res;
-	}
-
-	UrlQuery::UrlQuery(core::Allocator* allocator)
-		: m_allocator(allocator),
-		  m_keyValues(allocator),
-		  m_keyToIndex(allocator)
-	{}
-
-	void UrlQuery::add(StringView key, StringView value)
-	{
-		size_t index = m_keyValues.count();
-		m_keyValues.emplace(String{key, m_allocator}, String{value, m_allocator});
-		m_keyToIndex.insert(m_keyValues[m_keyValues.count() - 1].key, index);
-	}
-
-	UrlQuery::KeyConstIterator UrlQuery::find(StringView key) const
-	{
-		return m_keyToIndex.lookup(key);
-	}
-
-	StringView UrlQuery::get(KeyConstIterator it) const
-	{
-		assertTrue(it != m_keyToIndex.end());
-		return m_keyValues[it->value].value;
-	}
-
-	String Url::encodeQueryElement(StringView str, Allocator* allocator)
-	{
-		String res{allocator};
-		res.reserve(str.count());
-
-		for (auto c: str)
-		{
-			if (c == ' ')
-			{
-				res.pushByte('+');
-			}
-			else if (c >= '!' && c <= ',')
-			{
-				res.pushByte('%');
-				res.pushByte(HEX_DIGITS[c >> 4]);
-				res.pushByte(HEX_DIGITS[c & 0xF]);
-			}
-			else if (c == '=')
-			{
-				res.push("%3D"_sv);
-			}
-			else if (c == ';')
-			{
-				res.push("%3B"_sv);
-			}
-			else if (isAllowedChar(c, 0x01))
-			{
-				res.pushByte(c);
-			}
-			else
-			{
-				res.pushByte('%');
-				res.pushByte("0123456789ABCDEF"[uint8_t(c) >> 4]);
-				res.pushByte("0123456789ABCDEF"[uint8_t(c) & 0xF]);
-			}
-		}
-
-		return res;
-	}
-
-	Result<Url> Url::parse(StringView str, Allocator* allocator)
+	Result<UrlView, UrlParseErr> UrlView::parse(StringView str)
 	{
-		Url res{allocator};
+		UrlView res{};
 
 		if (str.count() == 0)
 		{
 			return res;
 		}
 
-		if (str.count() > 8000)
+		if (str.count() > MAX_COUNT)
 		{
-			return errf(allocator, "URL is longer than 8000 characters"_sv);
+			return UrlParseErr::TooLong;
 		}
 
 		//          userinfo       host      port
@@ -775,9 +555,6 @@ namespace core
 		// let's start by finding [scheme ':', path '/', query '?', fragment '#']
 		const char *str_begin = str.begin(), *str_it = find_first_of(str_begin, str_end, ":/?#");
 
-		const char* query_begin = nullptr;
-		const char* query_end = nullptr;
-
 		// if we didn't find any of the above things then this is a path
 		// /forum/questions/
 		if (str_it == str_end)
@@ -785,11 +562,12 @@ namespace core
 			// check the characters in the path part if it has any unallowed character then there's an error
 			if (!is_allowed_str(str_begin, str_it, 0x2F))
 			{
-				return errf(allocator, "Path is invalid"_sv);
+				return UrlParseErr::Path;
 			}
 
 			// yay: we have path
-			res.m_path = String{StringView{str_begin, str_end}, allocator};
+			res.m_path = StringView{str_begin, str_end};
+			res.m_pathWithQueryAndFragment = res.m_path;
 		}
 		else
 		{
@@ -799,11 +577,11 @@ namespace core
 			{
 				if (is_scheme(str_begin, str_it) == false)
 				{
-					return errf(allocator, "Scheme is invalid"_sv);
+					return UrlParseErr::Scheme;
 				}
 
 				// yay: we have scheme
-				res.m_scheme = String{StringView{str_begin, str_it}, allocator};
+				res.m_scheme = StringView{str_begin, str_it};
 
 				// update the p pointer to the search for [path '/', query '?', fragment '#']
 				str_begin = str_it + 1;
@@ -833,11 +611,11 @@ namespace core
 				{
 					if (is_allowed_str(str_begin, str_it, 0x2F) == false)
 					{
-						return errf(allocator, "User info is invalid"_sv);
+						return UrlParseErr::User;
 					}
 
 					// yay: we have user info
-					res.m_user = String{StringView{str_begin, str_it}, allocator};
+					res.m_user = StringView{str_begin, str_it};
 
 					// skip to after user info
 					str_begin = str_it + 1;
@@ -845,7 +623,7 @@ namespace core
 
 				// Get IP literal if any
 				// [2001:db8::7]
-				if (*str_begin == '[')
+				if (str_begin != end_authority && *str_begin == '[')
 				{
 					str_begin += 1; // eat "[" at the start of ip literal
 
@@ -853,9 +631,9 @@ namespace core
 					str_it = find_char(str_begin, end_authority, ']');
 
 					// we didn't find the end of ip literal
-					if (*str_it != ']')
+					if (str_it == end_authority)
 					{
-						return errf(allocator, "missing ] in ipv6 literal"_sv);
+						return UrlParseErr::Host;
 					}
 
 					// decode IPvFuture protocol version
@@ -873,10 +651,10 @@ namespace core
 						}
 
 						str_begin += 1; // eat second hex digit
-						if (res.m_ipVersion == -1 || *str_begin != '.' ||
+						if (res.m_ipVersion == -1 || str_begin >= str_it || *str_begin != '.' ||
 							is_allowed_str(str_begin, str_it, 0x05) == false)
 						{
-							return errf(allocator, "Host address is invalid"_sv);
+							return UrlParseErr::Host;
 						}
 					}
 					else if (is_ipv6(str_begin, str_it))
@@ -885,11 +663,11 @@ namespace core
 					}
 					else
 					{
-						return errf(allocator, "Host address is invalid"_sv);
+						return UrlParseErr::Host;
 					}
 
 					// if we get the version then all we have left is the host
-					res.m_host = String{StringView{str_begin, str_it}, allocator};
+					res.m_host = StringView{str_begin, str_it};
 					str_begin = str_it + 1; // skip to after the ip literal
 				}
 				// no ip literal found then this must be normal name
@@ -914,11 +692,11 @@ namespace core
 					// wrong url!!
 					else
 					{
-						return errf(allocator, "Host address is invalid"_sv);
+						return UrlParseErr::Host;
 					}
 
 					// yay: we have host
-					res.m_host = String{StringView{str_begin, str_it}, allocator};
+					res.m_host = StringView{str_begin, str_it};
 					str_begin = str_it; // skip to the end of the host
 				}
 
@@ -929,26 +707,29 @@ namespace core
 					str_begin += 1; // eat the ':'
 					if (is_port(str_begin, end_authority) == false)
 					{
-						return errf(allocator, "Port is invalid"_sv);
+						return UrlParseErr::Port;
 					}
 					// yay: we have a port
-					res.m_port = String{StringView{str_begin, end_authority}, allocator};
+					res.m_port = StringView{str_begin, end_authority};
 				}
 
 				str_begin = end_authority; // skip to the end of authority
 			}
 
+			// whatever is left is what http calls the request target
+			res.m_pathWithQueryAndFragment = StringView{str_begin, str_end};
+
 			// let's find any of the following [query '?', fragment '#']
 			str_it = find_first_of(str_begin, str_end, "?#");
 
 			// let's try finding the path
 			if (is_allowed_str(str_begin, str_it, 0x2F) == false)
 			{
-				return errf(allocator, "Path is invalid"_sv);
+				return UrlParseErr::Path;
 			}
 
 			// yay: we have path
-			res.m_path = String{StringView{str_begin, str_it}, allocator};
+			res.m_path = StringView{str_begin, str_it};
 
 			// try to find a query if it exists
 			if (str_it != str_end && *str_it == '?')
@@ -957,9 +738,14 @@ namespace core
 				// find end of query [fragment '#'] or end of string
 				str_it = find_char(str_begin, str_end, '#');
 
+				// the query separators are allowed characters too so we check it as a whole
+				if (is_allowed_str(str_begin, str_it, 0x3F) == false)
+				{
+					return UrlParseErr::Query;
+				}
+
 				// yay: we have query
-				query_begin = str_begin;
-				query_end = str_it;
+				res.m_query = StringView{str_begin, str_it};
 			}
 
 			// try to find a fragment if it exists
@@ -967,20 +753,196 @@ namespace core
 			{
 				if (is_allowed_str(str_it + 1, str_end, 0x3F) == false)
 				{
-					return errf(allocator, "Fragment is invalid"_sv);
+					return UrlParseErr::Fragment;
 				}
 
 				// yay: we have a fragment
-				res.m_fragment = String{StringView{str_it + 1, str_end}, allocator};
+				res.m_fragment = StringView{str_it + 1, str_end};
+			}
+		}
+
+		return res;
+	}
+
+	StringView UrlView::errorMessage(UrlParseErr err)
+	{
+		switch (err)
+		{
+		case UrlParseErr::Ok:
+			return ""_sv;
+		case UrlParseErr::TooLong:
+			return "URL is longer than 8000 characters"_sv;
+		case UrlParseErr::Scheme:
+			return "Scheme is invalid"_sv;
+		case UrlParseErr::User:
+			return "User info is invalid"_sv;
+		case UrlParseErr::Host:
+			return "Host address is invalid"_sv;
+		case UrlParseErr::Port:
+			return "Port is invalid"_sv;
+		case UrlParseErr::Path:
+			return "Path is invalid"_sv;
+		case UrlParseErr::Query:
+			return "Query string is invalid"_sv;
+		case UrlParseErr::Fragment:
+			return "Fragment is invalid"_sv;
+		default:
+			unreachable();
+			return ""_sv;
+		}
+	}
+
+	size_t UrlView::decode(StringView str, Span<char> out)
+	{
+		return decodeStr(str, out, false);
+	}
+
+	size_t UrlView::decodeQueryElement(StringView str, Span<char> out)
+	{
+		return decodeStr(str, out, true);
+	}
+
+	UrlQueryIterator UrlQueryView::find(StringView key) const
+	{
+		auto it = begin();
+		for (; it != end(); ++it)
+		{
+			if (queryElementEquals(it->key, key))
+			{
+				break;
+			}
+		}
+		return it;
+	}
+
+	Result<UrlQuery> UrlQuery::parse(core::StringView query, core::Allocator* allocator)
+	{
+		if (is_allowed_str(query.begin(), query.end(), 0x3F) == false)
+		{
+			return errf(allocator, "Invalid query string '{}'"_sv, query);
+		}
+		return fromView(UrlQueryView{query}, allocator);
+	}
+
+	UrlQuery UrlQuery::fromView(UrlQueryView query, Allocator* allocator)
+	{
+		UrlQuery res{allocator};
+		for (auto [key, value]: query)
+		{
+			res.add(decodeToString(key, true, allocator), decodeToString(value, true, allocator));
+		}
+		return res;
+	}
+
+	UrlQuery::UrlQuery(core::Allocator* allocator)
+		: m_allocator(allocator),
+		  m_keyValues(allocator),
+		  m_hashToIndex(allocator)
+	{}
+
+	void UrlQuery::add(StringView key, StringView value)
+	{
+		size_t index = m_keyValues.count();
+		m_keyValues.emplace(String{key, m_allocator}, String{value, m_allocator});
+		// a repeated key keeps pointing to its first pair, and so does a different key with the same hash which find
+		// handles with a scan
+		if (auto hash = keyHash(key); m_hashToIndex.lookup(hash) == m_hashToIndex.end())
+		{
+			m_hashToIndex.insert(hash, index);
+		}
+	}
+
+	UrlQuery::KeyConstIterator UrlQuery::find(StringView key) const
+	{
+		auto it = m_hashToIndex.lookup(keyHash(key));
+		if (it == m_hashToIndex.end())
+		{
+			return nullptr;
+		}
+
+		if (auto& keyValue = m_keyValues[it->value]; keyValue.key == key)
+		{
+			return &keyValue;
+		}
+
+		for (const auto& keyValue: m_keyValues)
+		{
+			if (keyValue.key == key)
+			{
+				return &keyValue;
+			}
+		}
+		return nullptr;
+	}
+
+	StringView UrlQuery::get(KeyConstIterator it) const
+	{
+		assertTrue(it != nullptr);
+		return it->value;
+	}
+
+	String Url::encodeQueryElement(StringView str, Allocator* allocator)
+	{
+		String res{allocator};
+		res.reserve(str.count());
+
+		for (auto c: str)
+		{
+			if (c == ' ')
+			{
+				res.pushByte('+');
+			}
+			else if (c >= '!' && c <= ',')
+			{
+				res.pushByte('%');
+				res.pushByte(HEX_DIGITS[c >> 4]);
+				res.pushByte(HEX_DIGITS[c & 0xF]);
+			}
+			else if (c == '=')
+			{
+				res.push("%3D"_sv);
+			}
+			else if (c == ';')
+			{
+				res.push("%3B"_sv);
+			}
+			else if (is_allowed_char(c, 0x01))
+			{
+				res.pushByte(c);
+			}
+			else
+			{
+				res.pushByte('%');
+				res.pushByte("0123456789ABCDEF"[uint8_t(c) >> 4]);
+				res.pushByte("0123456789ABCDEF"[uint8_t(c) & 0xF]);
 			}
 		}
 
+		return res;
+	}
+
+	Result<Url> Url::parse(StringView str, Allocator* allocator)
+	{
+		auto view = UrlView::parse(str);
+		if (view.isError())
+		{
+			return errf(allocator, "{}"_sv, UrlView::errorMessage(view.error()));
+		}
+		return fromView(view.value(), allocator);
+	}
+
+	Url Url::fromView(const UrlView& url, Allocator* allocator)
+	{
+		Url res{allocator};
+
+		res.m_scheme = String{url.scheme(), allocator};
 		normalize_scheme(res.m_scheme);
 
-		decode_str(res.m_user);
+		res.m_user = decodeToString(url.user(), false, allocator);
 
 		// decode and normalize host
-		decode_str(res.m_host);
+		res.m_ipVersion = url.ipVersion();
+		res.m_host = decodeToString(url.host(), false, allocator);
 		if (res.m_ipVersion == 0)
 		{
 			normalize_reg_domain_name(res.m_host);
@@ -990,22 +952,14 @@ namespace core
 			res.m_host = normalize_ipv6(res.m_host.begin(), res.m_host.end(), allocator);
 		}
 
+		res.m_port = String{url.port(), allocator};
+
 		// decode and normalize path
-		decode_str(res.m_path);
+		res.m_path = decodeToString(url.path(), false, allocator);
 		normalize_path(res.m_path, allocator);
 
-		// parse query
-		if (query_begin)
-		{
-			auto parsedQuery = UrlQuery::parse(StringView{query_begin, query_end}, allocator);
-			if (parsedQuery.isError())
-			{
-				return parsedQuery.releaseError();
-			}
-			res.m_query = parsedQuery.releaseValue();
-		}
-
-		decode_str(res.m_fragment);
+		res.m_query = UrlQuery::fromView(url.query(), allocator);
+		res.m_fragment = decodeToString(url.fragment(), false, allocator);
 		return res;
 	}
 
@@ -0,0 +1,571 @@
+#include "core/Utf8.h"
+#include "core/Intrinsics.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+namespace core
+{
+	struct Utf8AcceptRange
+	{
+		uint8_t lo, hi;
+	};
+
+	// the accepted range of the second byte of a sequence, the rest of the continuation bytes are always 0x80-0xBF
+	static constexpr Utf8AcceptRange UTF8_ACCEPT_RANGES[5] = {
+		Utf8AcceptRange{0x80, 0xbf},
+		Utf8AcceptRange{0xa0, 0xbf},
+		Utf8AcceptRange{0x80, 0x9f},
+		Utf8AcceptRange{0x90, 0xbf},
+		Utf8AcceptRange{0x80, 0x8f},
+	};
+
+	static constexpr uint8_t UTF8_XX = 0xf1;
+	static constexpr uint8_t UTF8_AS = 0xf0;
+
+	// for each lead byte the size of its sequence in the low 3 bits and the index of the accepted range of its second
+	// byte in the high 4 bits, invalid lead bytes are UTF8_XX
+	static constexpr auto UTF8_ACCEPT_SIZES = [] {
+		std::array<uint8_t, 256> res{};
+		for (size_t i = 0; i < res.size(); ++i)
+		{
+			if (i < 0x80)
+			{
+				res[i] = UTF8_AS;
+			}
+			else if (i < 0xc2 || i > 0xf4)
+			{
+				res[i] = UTF8_XX;
+			}
+			else if (i < 0xe0)
+			{
+				res[i] = 0x02;
+			}
+			else if (i == 0xe0)
+			{
+				res[i] = 0x13;
+			}
+			else if (i == 0xed)
+			{
+				res[i] = 0x23;
+			}
+			else if (i < 0xf0)
+			{
+				res[i] = 0x03;
+			}
+			else if (i == 0xf0)
+			{
+				res[i] = 0x34;
+			}
+			else if (i < 0xf4)
+			{
+				res[i] = 0x04;
+			}
+			else
+			{
+				res[i] = 0x44;
+			}
+		}
+		return res;
+	}();
+
+	// decodes one rune and returns its size, invalid sequences decode to -1 with a size of 1, the continuation bytes
+	// are checked in order so it stops at the first byte which doesn't belong to the sequence
+	inline static size_t utf8DecodeScalar(const uint8_t* ptr, size_t count, int32_t& rune)
+	{
+		if (count == 0)
+		{
+			rune = 0;
+			return 0;
+		}
+
+		auto b0 = ptr[0];
+		if (b0 < 0x80)
+		{
+			rune = b0;
+			return 1;
+		}
+
+		rune = -1;
+		// 2 byte sequences cover most scripts so they skip the tables
+		if (b0 < 0xe0)
+		{
+			if (b0 < 0xc2 || count < 2 || (ptr[1] & 0xc0) != 0x80)
+			{
+				return 1;
+			}
+			rune = int32_t(b0 & 0x1f) << 6 | int32_t(ptr[1] & 0x3f);
+			return 2;
+		}
+
+		auto x = UTF8_ACCEPT_SIZES[b0];
+		if (x == UTF8_XX)
+		{
+			return 1;
+		}
+
+		auto size = size_t(x & 7);
+		auto range = UTF8_ACCEPT_RANGES[x >> 4];
+		if (count < 2 || ptr[1] < range.lo || range.hi < ptr[1])
+		{
+			return 1;
+		}
+
+		if (count < 3 || (ptr[2] & 0xc0) != 0x80)
+		{
+			return 1;
+		}
+		if (size == 3)
+		{
+			rune = int32_t(b0 & 0x0f) << 12 | int32_t(ptr[1] & 0x3f) << 6 | int32_t(ptr[2] & 0x3f);
+			return 3;
+		}
+
+		if (count < 4 || (ptr[3] & 0xc0) != 0x80)
+		{
+			return 1;
+		}
+		rune = int32_t(b0 & 0x07) << 18 | int32_t(ptr[1] & 0x3f) << 12 | int32_t(ptr[2] & 0x3f) << 6 |
+			   int32_t(ptr[3] & 0x3f);
+		return 4;
+	}
+
+	inline static size_t utf8EncodeScalar(uint32_t rune, char* out)
+	{
+		if (rune < 0x80)
+		{
+			out[0] = char(rune);
+			return 1;
+		}
+		else if (rune < 0x800)
+		{
+			out[0] = char(0xc0 | (rune >> 6));
+			out[1] = char(0x80 | (rune & 0x3f));
+			return 2;
+		}
+		else if (rune < 0x10000)
+		{
+			out[0] = char(0xe0 | (rune >> 12));
+			out[1] = char(0x80 | ((rune >> 6) & 0x3f));
+			out[2] = char(0x80 | (rune & 0x3f));
+			return 3;
+		}
+		else
+		{
+			out[0] = char(0xf0 | (rune >> 18));
+			out[1] = char(0x80 | ((rune >> 12) & 0x3f));
+			out[2] = char(0x80 | ((rune >> 6) & 0x3f));
+			out[3] = char(0x80 | (rune & 0x3f));
+			return 4;
+		}
+	}
+
+	// the count of leading ascii bytes in the 8 bytes at ptr
+	inline static size_t utf8AsciiPrefix8(const char* ptr)
+	{
+		uint64_t word = 0;
+		::memcpy(&word, ptr, sizeof(word));
+		auto nonAscii = word & 0x8080808080808080ULL;
+		return nonAscii == 0 ? 8 : size_t(std::countr_zero(nonAscii) / 8);
+	}
+
+	inline static bool utf8ValidateScalar(const char* ptr, size_t count)
+	{
+		auto bytes = reinterpret_cast<const uint8_t*>(ptr);
+		size_t i = 0;
+		while (i < count)
+		{
+			if (i + 8 <= count)
+			{
+				if (auto ascii = utf8AsciiPrefix8(ptr + i); ascii > 0)
+				{
+					i += ascii;
+					continue;
+				}
+			}
+
+			int32_t rune = 0;
+			i += utf8DecodeScalar(bytes + i, count - i, rune);
+			if (rune < 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	inline static size_t utf8CountRunesScalar(const char* ptr, size_t count)
+	{
+		size_t continuations = 0;
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			uint64_t word = 0;
+			::memcpy(&word, ptr + i, sizeof(word));
+			// a continuation byte has its high bit set and the bit after it cleared, the multiplication adds up the
+			// flags of the 8 bytes into the top byte
+			auto flags = ((word & ~(word << 1)) >> 7) & 0x0101010101010101ULL;
+			continuations += (flags * 0x0101010101010101ULL) >> 56;
+		}
+		for (; i < count; ++i)
+		{
+			continuations += (ptr[i] & 0xc0) == 0x80;
+		}
+		return count - continuations;
+	}
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+	// the error flags of the lookup validation from "Validating UTF-8 In Less Than One Instruction Per Byte" by John
+	// Keiser and Daniel Lemire, each flag is an error that a pair of consecutive bytes can have and a pair has it when
+	// it's set in the lookups of the high nibble of the first byte, the low nibble of the first byte and the high
+	// nibble of the second byte
+
+	// 11______ 0_______ or 11______ 11______
+	static constexpr uint8_t UTF8_TOO_SHORT = 1 << 0;
+	// 0_______ 10______
+	static constexpr uint8_t UTF8_TOO_LONG = 1 << 1;
+	// 11100000 100_____
+	static constexpr uint8_t UTF8_OVERLONG_3 = 1 << 2;
+	// 11110100 1001____, 11110100 101_____ and every lead byte above 11110100
+	static constexpr uint8_t UTF8_TOO_LARGE = 1 << 3;
+	// 11101101 101_____
+	static constexpr uint8_t UTF8_SURROGATE = 1 << 4;
+	// 1100000_ 10______
+	static constexpr uint8_t UTF8_OVERLONG_2 = 1 << 5;
+	// 11110101 1000____ and every lead byte above it
+	static constexpr uint8_t UTF8_TOO_LARGE_1000 = 1 << 6;
+	// 11110000 1000____
+	static constexpr uint8_t UTF8_OVERLONG_4 = 1 << 6;
+	// 10______ 10______
+	static constexpr uint8_t UTF8_TWO_CONTS = 1 << 7;
+	// the errors which don't depend on the low nibble of the first byte
+	static constexpr uint8_t UTF8_CARRY = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS;
+
+	// the blocks of input are validated by looking at each byte and the 3 bytes before it, so the state carries the
+	// previous block over
+	struct Utf8Avx2State
+	{
+		__m256i error;
+		__m256i prevInput;
+		__m256i prevIncomplete;
+	};
+
+	// the bytes of input shifted right by N with the last N bytes of prevInput shifted in
+	template <int N>
+	TAHA_TARGET_AVX2 inline static __m256i utf8PrevAvx2(__m256i input, __m256i prevInput)
+	{
+		return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prevInput, input, 0x21), 16 - N);
+	}
+
+	TAHA_TARGET_AVX2 inline static __m256i utf8LookupAvx2(__m256i nibbles, __m128i table)
+	{
+		return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(table), nibbles);
+	}
+
+	TAHA_TARGET_AVX2 inline static void utf8CheckBlockAvx2(Utf8Avx2State& state, __m256i input)
+	{
+		if (_mm256_movemask_epi8(input) == 0)
+		{
+			// an ascii block is valid but it can't complete a sequence which the previous block ended with
+			state.error = _mm256_or_si256(state.error, state.prevIncomplete);
+			state.prevIncomplete = _mm256_setzero_si256();
+			state.prevInput = input;
+			return;
+		}
+
+		auto lowNibble = _mm256_set1_epi8(0x0f);
+		auto prev1 = utf8PrevAvx2<1>(input, state.prevInput);
+		auto byte1High = utf8LookupAvx2(
+			_mm256_and_si256(_mm256_srli_epi16(prev1, 4), lowNibble),
+			_mm_setr_epi8(
+				UTF8_TOO_LONG,
+				UTF8_TOO_LONG,
+				UTF8_TOO_LONG,
+				UTF8_TOO_LONG,
+				UTF8_TOO_LONG,
+				UTF8_TOO_LONG,
+				UTF8_TOO_LONG,
+				UTF8_TOO_LONG,
+				char(UTF8_TWO_CONTS),
+				char(UTF8_TWO_CONTS),
+				char(UTF8_TWO_CONTS),
+				char(UTF8_TWO_CONTS),
+				UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+				UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4));
+		auto byte1Low = utf8LookupAvx2(
+			_mm256_and_si256(prev1, lowNibble),
+			_mm_setr_epi8(
+				char(UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4),
+				char(UTF8_CARRY | UTF8_OVERLONG_2),
+				char(UTF8_CARRY),
+				char(UTF8_CARRY),
+				char(UTF8_CARRY | UTF8_TOO_LARGE),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+				char(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000)));
+		auto byte2High = utf8LookupAvx2(
+			_mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble),
+			_mm_setr_epi8(
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT,
+				char(
+					UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 |
+					UTF8_OVERLONG_4),
+				char(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE),
+				char(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+				char(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT,
+				UTF8_TOO_SHORT));
+		auto special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+		// the third and fourth bytes of 3 and 4 byte sequences must be continuation bytes, those are the only pairs of
+		// continuation bytes which are allowed so the TWO_CONTS flag is flipped there
+		auto prev2 = utf8PrevAvx2<2>(input, state.prevInput);
+		auto prev3 = utf8PrevAvx2<3>(input, state.prevInput);
+		auto isThirdByte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xe0 - 0x80)));
+		auto isFourthByte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xf0 - 0x80)));
+		auto must23 = _mm256_and_si256(_mm256_or_si256(isThirdByte, isFourthByte), _mm256_set1_epi8(char(0x80)));
+		state.error = _mm256_or_si256(state.error, _mm256_xor_si256(must23, special));
+
+		// a lead byte in the last 3 bytes which needs more bytes than the block has left
+		alignas(32) static constexpr uint8_t MAX_VALUE[32] = {
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1,
+		};
+		auto maxValue = _mm256_load_si256(reinterpret_cast<const __m256i*>(MAX_VALUE));
+		state.prevIncomplete = _mm256_subs_epu8(input, maxValue);
+		state.prevInput = input;
+	}
+
+	TAHA_TARGET_AVX2 static bool utf8ValidateAvx2(const char* ptr, size_t count)
+	{
+		Utf8Avx2State state{_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+		size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			utf8CheckBlockAvx2(state, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + i)));
+		}
+		if (i < count)
+		{
+			// the tail is padded with zeros, so a truncated sequence at the end is followed by ascii which is an error
+			alignas(32) char tail[32] = {};
+			::memcpy(tail, ptr + i, count - i);
+			utf8CheckBlockAvx2(state, _mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+		}
+		auto error = _mm256_or_si256(state.error, state.prevIncomplete);
+		return _mm256_testz_si256(error, error) != 0;
+	}
+
+	TAHA_TARGET_AVX2 static size_t utf8CountRunesAvx2(const char* ptr, size_t count)
+	{
+		// continuation bytes (0x80-0xBF) are the ones below 0xC0 as signed bytes
+		auto limit = _mm256_set1_epi8(char(0xc0));
+		size_t continuations = 0;
+		size_t i = 0;
+		for (; i + 64 <= count; i += 64)
+		{
+			auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + i));
+			auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + i + 32));
+			auto maskA = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit, a))));
+			auto maskB = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit, b))));
+			continuations += std::popcount(maskA | maskB << 32);
+		}
+		return i - continuations + utf8CountRunesScalar(ptr + i, count - i);
+	}
+#endif
+
+	bool Utf8::validate(const char* ptr, size_t count)
+	{
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+		if (cpuFeatures().avx2)
+		{
+			return utf8ValidateAvx2(ptr, count);
+		}
+#endif
+		return utf8ValidateScalar(ptr, count);
+	}
+
+	size_t Utf8::countRunes(const char* ptr, size_t count)
+	{
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+		if (cpuFeatures().avx2)
+		{
+			return utf8CountRunesAvx2(ptr, count);
+		}
+#endif
+		return utf8CountRunesScalar(ptr, count);
+	}
+
+	// Rune::decode decodes ascii inline and calls this for the rest, the decoding stops at the first byte which isn't
+	// part of the sequence so it never reads past a null byte
+	Rune Rune::decodeMultiByte(const char* ptr)
+	{
+		if (ptr == nullptr)
+		{
+			return Rune{};
+		}
+
+		int32_t value = 0;
+		utf8DecodeScalar(reinterpret_cast<const uint8_t*>(ptr), 4, value);
+		return Rune{value};
+	}
+
+	size_t Utf8::decode(const char* ptr, size_t count, Rune& rune)
+	{
+		int32_t value = 0;
+		auto size = utf8DecodeScalar(reinterpret_cast<const uint8_t*>(ptr), count, value);
+		rune = Rune{value};
+		return size;
+	}
+
+	size_t Utf8::toUtf16(const char* ptr, size_t count, char16_t* out)
+	{
+		auto begin = out;
+		size_t i = 0;
+		while (i < count)
+		{
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+			if (i + 16 <= count)
+			{
+				// widens the whole block, which fits since out is never ahead of the input, and keeps its ascii prefix
+				auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i));
+				auto zero = _mm_setzero_si128();
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(v, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(v, zero));
+				auto mask = uint32_t(_mm_movemask_epi8(v));
+				auto ascii = mask == 0 ? 16 : size_t(std::countr_zero(mask));
+				out += ascii;
+				i += ascii;
+				if (ascii == 16)
+				{
+					continue;
+				}
+			}
+#endif
+			// a run of non ascii runes is decoded one by one and the next ascii byte goes back to the vector loop
+			do
+			{
+				int32_t rune = 0;
+				i += utf8DecodeScalar(reinterpret_cast<const uint8_t*>(ptr + i), count - i, rune);
+				if (rune < 0)
+				{
+					rune = 0xfffd;
+				}
+
+				if (rune >= 0x10000)
+				{
+					rune -= 0x10000;
+					*out++ = char16_t(0xd800 + (rune >> 10));
+					*out++ = char16_t(0xdc00 + (rune & 0x3ff));
+				}
+				else
+				{
+					*out++ = char16_t(rune);
+				}
+			} while (i < count && (ptr[i] & 0x80) != 0);
+		}
+		return size_t(out - begin);
+	}
+
+	size_t Utf8::toUtf32(const char* ptr, size_t count, char32_t* out)
+	{
+		auto begin = out;
+		size_t i = 0;
+		while (i < count)
+		{
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+			if (i + 16 <= count)
+			{
+				auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i));
+				auto zero = _mm_setzero_si128();
+				auto lo = _mm_unpacklo_epi8(v, zero);
+				auto hi = _mm_unpackhi_epi8(v, zero);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(lo, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(hi, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(hi, zero));
+				auto mask = uint32_t(_mm_movemask_epi8(v));
+				auto ascii = mask == 0 ? 16 : size_t(std::countr_zero(mask));
+				out += ascii;
+				i += ascii;
+				if (ascii == 16)
+				{
+					continue;
+				}
+			}
+#endif
+			do
+			{
+				int32_t rune = 0;
+				i += utf8DecodeScalar(reinterpret_cast<const uint8_t*>(ptr + i), count - i, rune);
+				*out++ = char32_t(rune < 0 ? 0xfffd : rune);
+			} while (i < count && (ptr[i] & 0x80) != 0);
+		}
+		return size_t(out - begin);
+	}
+
+	size_t Utf8::fromUtf16(const char16_t* ptr, size_t count, char* out)
+	{
+		auto begin = out;
+		size_t i = 0;
+		while (i < count)
+		{
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+			if (i + 8 <= count)
+			{
+				// narrows the whole block, which fits since out has room for 3 bytes per code unit, and keeps its ascii
+				// prefix
+				auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(v, v));
+				auto isAscii = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(short(0xff80))), _mm_setzero_si128());
+				auto mask = ~uint32_t(_mm_movemask_epi8(isAscii)) & 0xffff;
+				auto ascii = mask == 0 ? 8 : size_t(std::countr_zero(mask) / 2);
+				out += ascii;
+				i += ascii;
+				if (ascii == 8)
+				{
+					continue;
+				}
+			}
+#endif
+			uint32_t rune = ptr[i++];
+			if (rune >= 0xd800 && rune < 0xe000)
+			{
+				if (rune < 0xdc00 && i < count && ptr[i] >= 0xdc00 && ptr[i] < 0xe000)
+				{
+					rune = 0x10000 + ((rune - 0xd800) << 10) + (ptr[i++] - 0xdc00);
+				}
+				else
+				{
+					rune = 0xfffd;
+				}
+			}
+			out += utf8EncodeScalar(rune, out);
+		}
+		return size_t(out - begin);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "core/OS.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace core
+{
+	inline static uintptr_t alignUp(uintptr_t value, uintptr_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	inline static uintptr_t alignDown(uintptr_t value, uintptr_t alignment)
+	{
+		return value & ~(alignment - 1);
+	}
+
+	// writes to one byte in each page of the range so the os backs all of them with memory now instead of on the
+	// first access
+	inline static void touchPages(void* ptr, size_t size)
+	{
+		auto pageSize = OS::pageSize();
+		for (auto it = (volatile char*)ptr; it < (volatile char*)ptr + size; it += pageSize)
+		{
+			*it = *it;
+		}
+	}
+}
\ No newline at end of file
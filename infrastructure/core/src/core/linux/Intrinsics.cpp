@@ -1,5 +1,9 @@
 #include "core/Intrinsics.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
 namespace core
 {
 	static union
@@ -34,4 +38,27 @@ namespace core
 	{
 		return __builtin_clzll(v);
 	}
+
+	const CPUFeatures& cpuFeatures()
+	{
+		static CPUFeatures features = [] {
+			CPUFeatures res{};
+#if defined(__x86_64__) || defined(__i386__)
+			__builtin_cpu_init();
+			res.ssse3 = __builtin_cpu_supports("ssse3");
+			res.sse42 = __builtin_cpu_supports("sse4.2");
+			res.avx2 = __builtin_cpu_supports("avx2");
+			res.bmi2 = __builtin_cpu_supports("bmi2");
+
+			// older compilers don't know the sha feature name so we ask cpuid directly
+			unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+			if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+			{
+				res.sha = (ebx & (1 << 29)) != 0;
+			}
+#endif
+			return res;
+		}();
+		return features;
+	}
 }
\ No newline at end of file
@@ -1,11 +1,77 @@
 #include "core/OS.h"
 
+#include <dirent.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
+#include <cstdio>
+#include <cstring>
+
 namespace core
 {
 	uint64_t OS::pageSize()
 	{
 		return uint64_t(sysconf(_SC_PAGESIZE));
 	}
-}
\ No newline at end of file
+
+	uint64_t OS::hugePageSize()
+	{
+		static uint64_t size = []() -> uint64_t {
+			auto file = ::fopen("/proc/meminfo", "r");
+			if (file == nullptr)
+			{
+				return 0;
+			}
+
+			uint64_t res = 0;
+			char line[256];
+			while (::fgets(line, sizeof(line), file))
+			{
+				unsigned long long sizeInKB = 0;
+				if (::sscanf(line, "Hugepagesize: %llu kB", &sizeInKB) == 1)
+				{
+					res = uint64_t(sizeInKB) * 1024;
+					break;
+				}
+			}
+			::fclose(file);
+			return res;
+		}();
+		return size;
+	}
+
+	int OS::numaNodesCount()
+	{
+		static int count = []() -> int {
+			auto dir = ::opendir("/sys/devices/system/node");
+			if (dir == nullptr)
+			{
+				return 1;
+			}
+
+			int res = 0;
+			while (auto entry = ::readdir(dir))
+			{
+				int node = 0;
+				if (::sscanf(entry->d_name, "node%d", &node) == 1)
+				{
+					++res;
+				}
+			}
+			::closedir(dir);
+			return res > 0 ? res : 1;
+		}();
+		return count;
+	}
+
+	int OS::currentNumaNode()
+	{
+		unsigned int cpu = 0;
+		unsigned int node = 0;
+		if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+		{
+			return 0;
+		}
+		return int(node);
+	}
+}
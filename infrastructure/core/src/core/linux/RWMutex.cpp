@@ -0,0 +1,70 @@
+#include "core/RWMutex.h"
+#include "core/Assert.h"
+
+#include <pthread.h>
+
+namespace core
+{
+	// pthread_rwlock_t is 56 bytes with glibc on x86_64 so it fits in a single cache line between the paddings
+	struct RWMutex::IRWMutex
+	{
+		std::byte paddingBefore[64];
+		pthread_rwlock_t handle;
+		std::byte paddingAfter[64];
+	};
+
+	RWMutex::RWMutex(Allocator* allocator)
+	{
+		m_mutex = unique_from<IRWMutex>(allocator);
+		[[maybe_unused]] auto res = pthread_rwlock_init(&m_mutex->handle, nullptr);
+		assertTrue(res == 0);
+	}
+
+	RWMutex::RWMutex(RWMutex&& other) noexcept = default;
+	RWMutex& RWMutex::operator=(RWMutex&& other) noexcept = default;
+
+	RWMutex::~RWMutex()
+	{
+		if (m_mutex)
+		{
+			[[maybe_unused]] auto res = pthread_rwlock_destroy(&m_mutex->handle);
+			assertTrue(res == 0);
+		}
+	}
+
+	void RWMutex::lock()
+	{
+		[[maybe_unused]] auto res = pthread_rwlock_wrlock(&m_mutex->handle);
+		assertTrue(res == 0);
+	}
+
+	bool RWMutex::tryLock()
+	{
+		auto res = pthread_rwlock_trywrlock(&m_mutex->handle);
+		return res == 0;
+	}
+
+	void RWMutex::unlock()
+	{
+		[[maybe_unused]] auto res = pthread_rwlock_unlock(&m_mutex->handle);
+		assertTrue(res == 0);
+	}
+
+	void RWMutex::lockShared()
+	{
+		[[maybe_unused]] auto res = pthread_rwlock_rdlock(&m_mutex->handle);
+		assertTrue(res == 0);
+	}
+
+	bool RWMutex::tryLockShared()
+	{
+		auto res = pthread_rwlock_tryrdlock(&m_mutex->handle);
+		return res == 0;
+	}
+
+	void RWMutex::unlockShared()
+	{
+		[[maybe_unused]] auto res = pthread_rwlock_unlock(&m_mutex->handle);
+		assertTrue(res == 0);
+	}
+}
\ No newline at end of file
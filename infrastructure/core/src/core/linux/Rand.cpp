@@ -2,14 +2,25 @@
 
 #include <sys/random.h>
 
+#include <cerrno>
+
 namespace core
 {
-	bool Rand::cryptoRand(Span<std::byte> buffer)
+	bool Rand::osCryptoRand(Span<std::byte> buffer)
 	{
 		size_t s = 0;
 		while (s < buffer.count())
 		{
-			s += getrandom((char*)buffer.data() + s, buffer.count() - s, 0);
+			auto res = getrandom((char*)buffer.data() + s, buffer.count() - s, 0);
+			if (res < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				return false;
+			}
+			s += size_t(res);
 		}
 		return true;
 	}
@@ -1,34 +1,205 @@
 #include "core/VirtualMem.h"
 #include "core/Assert.h"
+#include "core/OS.h"
+#include "core/VirtualMemPages.h"
 
 #include <tracy/Tracy.hpp>
 
+#include <linux/mempolicy.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 namespace core
 {
+	// allocations smaller than a huge page are mapped with normal pages, there's no point in using a huge page for them
+	inline static bool isHugeSized(size_t size, int flags)
+	{
+		auto hugePageSize = OS::hugePageSize();
+		return (flags & (VirtualMem::FLAGS_HUGE_PAGES | VirtualMem::FLAGS_TRANSPARENT_HUGE_PAGES)) != 0 &&
+			   hugePageSize != 0 && size >= hugePageSize;
+	}
+
+	// the actual size of the mapping which backs an allocation of the given size
+	inline static size_t mappingSize(size_t size, int flags)
+	{
+		if (isHugeSized(size, flags))
+		{
+			return alignUp(size, OS::hugePageSize());
+		}
+		return alignUp(size, OS::pageSize());
+	}
+
+	// maps memory with the given alignment by over-reserving then trimming the head and tail of the mapping
+	inline static void* mapAligned(size_t size, size_t alignment, int protection, int mapFlags)
+	{
+		if (alignment <= OS::pageSize())
+		{
+			return mmap(nullptr, size, protection, mapFlags, -1, 0);
+		}
+
+		auto ptr = mmap(nullptr, size + alignment, protection, mapFlags, -1, 0);
+		if (ptr == MAP_FAILED)
+		{
+			return ptr;
+		}
+
+		auto begin = uintptr_t(ptr);
+		auto alignedBegin = alignUp(begin, alignment);
+		if (alignedBegin > begin)
+		{
+			munmap(ptr, alignedBegin - begin);
+		}
+		auto tailSize = (begin + size + alignment) - (alignedBegin + size);
+		if (tailSize > 0)
+		{
+			munmap((void*)(alignedBegin + size), tailSize);
+		}
+		return (void*)alignedBegin;
+	}
+
+	// numa binding is a hint, if it fails (no numa support, invalid node, etc.) the memory is still usable
+	inline static void bindToNumaNode(void* ptr, size_t size, int numaNode)
+	{
+		if (numaNode == VirtualMem::NUMA_NODE_LOCAL)
+		{
+			numaNode = OS::currentNumaNode();
+		}
+
+		constexpr size_t MAX_NODES = 1024;
+		constexpr size_t BITS_PER_WORD = sizeof(unsigned long) * 8;
+		if (numaNode < 0 || size_t(numaNode) >= MAX_NODES)
+		{
+			return;
+		}
+
+		unsigned long nodeMask[MAX_NODES / BITS_PER_WORD] = {};
+		nodeMask[numaNode / BITS_PER_WORD] = 1UL << (numaNode % BITS_PER_WORD);
+		syscall(SYS_mbind, ptr, size, MPOL_BIND, nodeMask, MAX_NODES + 1, 0);
+	}
+
+	inline static void prefault(void* ptr, size_t size)
+	{
+#ifdef MADV_POPULATE_WRITE
+		if (madvise(ptr, size, MADV_POPULATE_WRITE) == 0)
+		{
+			return;
+		}
+#endif
+
+		// older kernels don't have MADV_POPULATE_WRITE, so we touch the pages ourselves
+		touchPages(ptr, size);
+	}
+
 	Span<std::byte> VirtualMem::alloc(size_t size, size_t)
 	{
-		auto res = (std::byte*)mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (size == 0)
+		{
+			return Span<std::byte>{};
+		}
+
+		auto hugeSized = isHugeSized(size, m_flags);
+		auto mapSize = mappingSize(size, m_flags);
+		auto alignment = hugeSized ? OS::hugePageSize() : OS::pageSize();
+
+		void* ptr = MAP_FAILED;
+		if (m_flags & FLAGS_HUGE_PAGES)
+		{
+			// explicit huge pages are reserved at map time so there's no point in the reserve/commit dance, we map
+			// the memory as read/write from the start and make commit/release no-ops
+			if (hugeSized)
+			{
+				ptr = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			}
+
+			if (ptr == MAP_FAILED)
+			{
+				ptr = mapAligned(mapSize, alignment, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS);
+				if (ptr != MAP_FAILED && hugeSized)
+				{
+					madvise(ptr, mapSize, MADV_HUGEPAGE);
+				}
+			}
+		}
+		else
+		{
+			ptr = mapAligned(mapSize, alignment, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS);
+			if (ptr != MAP_FAILED && (m_flags & FLAGS_TRANSPARENT_HUGE_PAGES))
+			{
+				madvise(ptr, mapSize, MADV_HUGEPAGE);
+			}
+		}
+
+		if (ptr == MAP_FAILED)
+		{
+			return Span<std::byte>{};
+		}
+
+		// bind before the first touch, otherwise the pages will be placed according to the default policy
+		if (m_numaNode != NUMA_NODE_ANY)
+		{
+			bindToNumaNode(ptr, mapSize, m_numaNode);
+		}
+
+		if ((m_flags & FLAGS_HUGE_PAGES) && (m_flags & FLAGS_PREFAULT))
+		{
+			prefault(ptr, mapSize);
+		}
+
+		auto res = (std::byte*)ptr;
 		TracyAllocS(res, size, 10);
 		return Span<std::byte>{res, size};
 	}
 
 	void VirtualMem::commit(Span<std::byte> bytes)
 	{
-		[[maybe_unused]] auto res = mprotect(bytes.data(), bytes.sizeInBytes(), PROT_READ | PROT_WRITE);
+		if (bytes.empty() || (m_flags & FLAGS_HUGE_PAGES))
+		{
+			return;
+		}
+
+		// mprotect works on whole pages, so we commit every page the range touches
+		auto pageSize = OS::pageSize();
+		auto begin = alignDown(uintptr_t(bytes.data()), pageSize);
+		auto end = alignUp(uintptr_t(bytes.data() + bytes.sizeInBytes()), pageSize);
+
+		[[maybe_unused]] auto res = mprotect((void*)begin, end - begin, PROT_READ | PROT_WRITE);
 		assertTrue(res == 0);
+
+		if (m_flags & FLAGS_PREFAULT)
+		{
+			prefault((void*)begin, end - begin);
+		}
 	}
 
 	void VirtualMem::release(Span<std::byte> bytes)
 	{
-		[[maybe_unused]] auto res = mprotect(bytes.data(), bytes.sizeInBytes(), PROT_NONE);
+		if (bytes.empty() || (m_flags & FLAGS_HUGE_PAGES))
+		{
+			return;
+		}
+
+		// only release the pages which are fully inside the range, the partial pages at the edges might be in use
+		auto pageSize = OS::pageSize();
+		auto begin = alignUp(uintptr_t(bytes.data()), pageSize);
+		auto end = alignDown(uintptr_t(bytes.data() + bytes.sizeInBytes()), pageSize);
+		if (begin >= end)
+		{
+			return;
+		}
+
+		[[maybe_unused]] auto res = mprotect((void*)begin, end - begin, PROT_NONE);
 		assertTrue(res == 0);
 	}
 
 	void VirtualMem::free(Span<std::byte> bytes)
 	{
+		if (bytes.data() == nullptr)
+		{
+			return;
+		}
+
 		TracyFreeS(bytes.data(), 10);
-		munmap(bytes.data(), bytes.sizeInBytes());
+		munmap(bytes.data(), mappingSize(bytes.sizeInBytes(), m_flags));
 	}
 }
\ No newline at end of file
@@ -8,4 +8,20 @@ namespace core
 	{
 		return uint64_t(sysconf(_SC_PAGESIZE));
 	}
-}
\ No newline at end of file
+
+	uint64_t OS::hugePageSize()
+	{
+		// macos doesn't expose huge pages to user space
+		return 0;
+	}
+
+	int OS::numaNodesCount()
+	{
+		return 1;
+	}
+
+	int OS::currentNumaNode()
+	{
+		return 0;
+	}
+}
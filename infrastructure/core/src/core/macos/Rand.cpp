@@ -4,8 +4,17 @@
 
 namespace core
 {
-	bool Rand::cryptoRand(Span<std::byte> buffer)
+	bool Rand::osCryptoRand(Span<std::byte> buffer)
 	{
-		return getentropy(buffer.data(), buffer.count()) == 0;
+		// getentropy fails for more than 256 bytes at a time
+		for (size_t i = 0; i < buffer.count(); i += 256)
+		{
+			auto count = buffer.count() - i < 256 ? buffer.count() - i : 256;
+			if (getentropy(buffer.data() + i, count) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
 	}
 }
\ No newline at end of file
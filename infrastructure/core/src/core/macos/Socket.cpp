@@ -4,6 +4,7 @@
 
 #include <fcntl.h>
 #include <netdb.h>
+#include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -198,28 +199,23 @@ namespace core
 
 		uint16_t listeningPort() override
 		{
-			sockaddr addr{};
+			// the port is read straight from the address instead of formatting it with getnameinfo and parsing it back
+			sockaddr_storage addr{};
 			socklen_t size = sizeof(addr);
-			if (getsockname(m_handle, &addr, &size) != 0)
+			if (getsockname(m_handle, (sockaddr*)&addr, &size) != 0)
 			{
 				return 0;
 			}
 
-			char portName[6] = {0};
-			if (getnameinfo(&addr, size, NULL, 0, portName, sizeof(portName), NI_NUMERICSERV) != 0)
-			{
-				return 0;
-			}
-
-			errno = 0;
-			auto endPtr = portName;
-			auto res = strtoul(portName, &endPtr, 10);
-			if (errno == ERANGE || endPtr != portName + strlen(portName))
+			switch (addr.ss_family)
 			{
+			case AF_INET:
+				return ntohs(((sockaddr_in*)&addr)->sin_port);
+			case AF_INET6:
+				return ntohs(((sockaddr_in6*)&addr)->sin6_port);
+			default:
 				return 0;
 			}
-			assertTrue(res <= UINT16_MAX);
-			return uint16_t(res);
 		}
 
 		size_t read(void* buffer, size_t size) override
@@ -1,5 +1,7 @@
 #include "core/VirtualMem.h"
 #include "core/Assert.h"
+#include "core/OS.h"
+#include "core/VirtualMemPages.h"
 
 #include <tracy/Tracy.hpp>
 
@@ -7,28 +9,79 @@
 
 namespace core
 {
+	// NOTE: macos has no user facing huge pages or numa support, so those flags are ignored except for
+	// FLAGS_HUGE_PAGES which still commits the memory at allocation time to keep the same semantics on all platforms
 	Span<std::byte> VirtualMem::alloc(size_t size, size_t)
 	{
-		auto res = (std::byte*)mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (size == 0)
+		{
+			return Span<std::byte>{};
+		}
+
+		auto protection = (m_flags & FLAGS_HUGE_PAGES) ? PROT_READ | PROT_WRITE : PROT_NONE;
+		auto ptr = mmap(nullptr, size, protection, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ptr == MAP_FAILED)
+		{
+			return Span<std::byte>{};
+		}
+
+		if ((m_flags & FLAGS_HUGE_PAGES) && (m_flags & FLAGS_PREFAULT))
+		{
+			touchPages(ptr, size);
+		}
+
+		auto res = (std::byte*)ptr;
 		TracyAllocS(res, size, 10);
 		return Span<std::byte>{res, size};
 	}
 
 	void VirtualMem::commit(Span<std::byte> bytes)
 	{
-		[[maybe_unused]] auto res = mprotect(bytes.data(), bytes.sizeInBytes(), PROT_READ | PROT_WRITE);
+		if (bytes.empty() || (m_flags & FLAGS_HUGE_PAGES))
+		{
+			return;
+		}
+
+		auto pageSize = OS::pageSize();
+		auto begin = alignDown(uintptr_t(bytes.data()), pageSize);
+		auto end = alignUp(uintptr_t(bytes.data() + bytes.sizeInBytes()), pageSize);
+
+		[[maybe_unused]] auto res = mprotect((void*)begin, end - begin, PROT_READ | PROT_WRITE);
 		assertTrue(res == 0);
+
+		if (m_flags & FLAGS_PREFAULT)
+		{
+			touchPages((void*)begin, end - begin);
+		}
 	}
 
 	void VirtualMem::release(Span<std::byte> bytes)
 	{
-		[[maybe_unused]] auto res = mprotect(bytes.data(), bytes.sizeInBytes(), PROT_NONE);
+		if (bytes.empty() || (m_flags & FLAGS_HUGE_PAGES))
+		{
+			return;
+		}
+
+		auto pageSize = OS::pageSize();
+		auto begin = alignUp(uintptr_t(bytes.data()), pageSize);
+		auto end = alignDown(uintptr_t(bytes.data() + bytes.sizeInBytes()), pageSize);
+		if (begin >= end)
+		{
+			return;
+		}
+
+		[[maybe_unused]] auto res = mprotect((void*)begin, end - begin, PROT_NONE);
 		assertTrue(res == 0);
 	}
 
 	void VirtualMem::free(Span<std::byte> bytes)
 	{
+		if (bytes.data() == nullptr)
+		{
+			return;
+		}
+
 		TracyFreeS(bytes.data(), 10);
 		munmap(bytes.data(), bytes.sizeInBytes());
 	}
-}
\ No newline at end of file
+}
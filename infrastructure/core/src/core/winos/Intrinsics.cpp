@@ -44,4 +44,34 @@ namespace core
 			return 64;
 		}
 	}
+
+	const CPUFeatures& cpuFeatures()
+	{
+		static CPUFeatures features = [] {
+			CPUFeatures res{};
+#if defined(_M_X64) || defined(_M_AMD64) || defined(_M_IX86)
+			int info[4] = {};
+			__cpuid(info, 0);
+			auto maxLeaf = info[0];
+
+			__cpuid(info, 1);
+			res.ssse3 = (info[2] & (1 << 9)) != 0;
+			res.sse42 = (info[2] & (1 << 20)) != 0;
+			// avx needs the os to save the ymm registers on context switches
+			auto osxsave = (info[2] & (1 << 27)) != 0;
+			auto avx = (info[2] & (1 << 28)) != 0;
+			auto ymmEnabled = osxsave && (_xgetbv(0) & 6) == 6;
+
+			if (maxLeaf >= 7)
+			{
+				__cpuidex(info, 7, 0);
+				res.avx2 = avx && ymmEnabled && (info[1] & (1 << 5)) != 0;
+				res.bmi2 = (info[1] & (1 << 8)) != 0;
+				res.sha = (info[1] & (1 << 29)) != 0;
+			}
+#endif
+			return res;
+		}();
+		return features;
+	}
 }
\ No newline at end of file
@@ -10,4 +10,31 @@ namespace core
 		GetSystemInfo(&info);
 		return uint64_t(info.dwPageSize);
 	}
-}
\ No newline at end of file
+
+	uint64_t OS::hugePageSize()
+	{
+		return uint64_t(GetLargePageMinimum());
+	}
+
+	int OS::numaNodesCount()
+	{
+		ULONG highestNode = 0;
+		if (GetNumaHighestNodeNumber(&highestNode) == FALSE)
+		{
+			return 1;
+		}
+		return int(highestNode) + 1;
+	}
+
+	int OS::currentNumaNode()
+	{
+		PROCESSOR_NUMBER processor{};
+		GetCurrentProcessorNumberEx(&processor);
+		USHORT node = 0;
+		if (GetNumaProcessorNodeEx(&processor, &node) == FALSE)
+		{
+			return 0;
+		}
+		return int(node);
+	}
+}
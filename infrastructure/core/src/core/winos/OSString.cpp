@@ -1,45 +1,32 @@
 #include "core/OSString.h"
-
-#include <Windows.h>
+#include "core/Utf8.h"
 
 namespace core
 {
 	OSString::OSString(StringView str, Allocator* allocator)
 		: m_buffer(allocator)
 	{
-		auto countNeeded = MultiByteToWideChar(CP_UTF8, 0, str.begin(), DWORD(str.count()), nullptr, 0);
-
-		// +1 for the null termination
-		auto sizeInBytes = (countNeeded + 1) * sizeof(TCHAR);
-		m_buffer.resize(sizeInBytes);
-		MultiByteToWideChar(CP_UTF8, 0, str.begin(), DWORD(str.count()), (TCHAR*)m_buffer.data(), countNeeded);
-
-		auto ptr = (TCHAR*)m_buffer.data();
-		ptr[countNeeded] = TCHAR{0};
+		// no rune is longer in utf16 than in utf8 so str.count() code units are enough, +1 for the null termination
+		m_buffer.resize((str.count() + 1) * sizeof(char16_t));
+		auto ptr = (char16_t*)m_buffer.data();
+		auto count = Utf8::toUtf16(str.begin(), str.count(), ptr);
+		ptr[count] = char16_t{0};
+		m_buffer.resize((count + 1) * sizeof(char16_t));
 	}
 
 	String OSString::toUtf8(Allocator* allocator) const
 	{
-		auto countNeeded = WideCharToMultiByte(
-			CP_UTF8, NULL, (LPTSTR)m_buffer.data(), int(m_buffer.count() / sizeof(TCHAR)), NULL, 0, NULL, NULL);
-		if (countNeeded == 0)
+		auto ptr = (const char16_t*)m_buffer.data();
+		auto count = m_buffer.count() / sizeof(char16_t);
+		// the buffer ends with a null termination
+		if (count > 0 && ptr[count - 1] == 0)
 		{
-			return String{allocator};
+			--count;
 		}
 
 		String str{allocator};
-		// countNeeded includes null byte
-		str.resize(countNeeded - 1);
-
-		countNeeded = WideCharToMultiByte(
-			CP_UTF8,
-			NULL,
-			(LPTSTR)m_buffer.data(),
-			int(m_buffer.count() / sizeof(TCHAR)),
-			str.data(),
-			int(str.count()),
-			NULL,
-			NULL);
+		str.resize(count * 3);
+		str.resize(Utf8::fromUtf16(ptr, count, str.data()));
 		return str;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "core/RWMutex.h"
+
+#include <Windows.h>
+
+namespace core
+{
+	// an SRWLOCK is a single pointer sized word
+	struct RWMutex::IRWMutex
+	{
+		std::byte paddingBefore[64];
+		SRWLOCK lock;
+		std::byte paddingAfter[64];
+	};
+
+	RWMutex::RWMutex(Allocator* allocator)
+	{
+		m_mutex = unique_from<IRWMutex>(allocator);
+		InitializeSRWLock(&m_mutex->lock);
+	}
+
+	RWMutex::RWMutex(RWMutex&& other) noexcept = default;
+	RWMutex& RWMutex::operator=(RWMutex&& other) noexcept = default;
+
+	// slim reader writer locks don't need to be destroyed
+	RWMutex::~RWMutex() = default;
+
+	void RWMutex::lock()
+	{
+		AcquireSRWLockExclusive(&m_mutex->lock);
+	}
+
+	bool RWMutex::tryLock()
+	{
+		return TryAcquireSRWLockExclusive(&m_mutex->lock);
+	}
+
+	void RWMutex::unlock()
+	{
+		ReleaseSRWLockExclusive(&m_mutex->lock);
+	}
+
+	void RWMutex::lockShared()
+	{
+		AcquireSRWLockShared(&m_mutex->lock);
+	}
+
+	bool RWMutex::tryLockShared()
+	{
+		return TryAcquireSRWLockShared(&m_mutex->lock);
+	}
+
+	void RWMutex::unlockShared()
+	{
+		ReleaseSRWLockShared(&m_mutex->lock);
+	}
+}
\ No newline at end of file
@@ -5,7 +5,7 @@
 
 namespace core
 {
-	bool Rand::cryptoRand(Span<std::byte> buffer)
+	bool Rand::osCryptoRand(Span<std::byte> buffer)
 	{
 		auto res =
 			BCryptGenRandom(nullptr, (PUCHAR)buffer.data(), (ULONG)buffer.count(), BCRYPT_USE_SYSTEM_PREFERRED_RNG);
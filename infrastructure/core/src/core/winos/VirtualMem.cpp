@@ -1,4 +1,6 @@
 #include "core/VirtualMem.h"
+#include "core/OS.h"
+#include "core/VirtualMemPages.h"
 
 #include <tracy/Tracy.hpp>
 
@@ -6,26 +8,111 @@
 
 namespace core
 {
+	inline static void* virtualAlloc(size_t size, DWORD type, int numaNode)
+	{
+		if (numaNode == VirtualMem::NUMA_NODE_LOCAL)
+		{
+			numaNode = OS::currentNumaNode();
+		}
+
+		if (numaNode >= 0)
+		{
+			return VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, type, PAGE_READWRITE, DWORD(numaNode));
+		}
+		return VirtualAlloc(nullptr, size, type, PAGE_READWRITE);
+	}
+
+	// NOTE: windows has no transparent huge pages, so FLAGS_TRANSPARENT_HUGE_PAGES is ignored
 	Span<std::byte> VirtualMem::alloc(size_t size, size_t)
 	{
-		auto res = (std::byte*)VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_READWRITE);
+		if (size == 0)
+		{
+			return Span<std::byte>{};
+		}
+
+		void* ptr = nullptr;
+		if (m_flags & FLAGS_HUGE_PAGES)
+		{
+			// large pages need the SeLockMemoryPrivilege, and they must be reserved and committed at once
+			auto largePageSize = OS::hugePageSize();
+			if (largePageSize != 0 && size >= largePageSize)
+			{
+				ptr = virtualAlloc(
+					alignUp(size, largePageSize), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, m_numaNode);
+			}
+
+			if (ptr == nullptr)
+			{
+				ptr = virtualAlloc(size, MEM_RESERVE | MEM_COMMIT, m_numaNode);
+			}
+
+			if (ptr && (m_flags & FLAGS_PREFAULT))
+			{
+				touchPages(ptr, size);
+			}
+		}
+		else
+		{
+			ptr = virtualAlloc(size, MEM_RESERVE, m_numaNode);
+		}
+
+		if (ptr == nullptr)
+		{
+			return Span<std::byte>{};
+		}
+
+		auto res = (std::byte*)ptr;
 		TracyAllocS(res, size, 10);
 		return Span<std::byte>{res, size};
 	}
 
 	void VirtualMem::commit(Span<std::byte> bytes)
 	{
+		if (bytes.empty() || (m_flags & FLAGS_HUGE_PAGES))
+		{
+			return;
+		}
+
 		VirtualAlloc(bytes.data(), bytes.sizeInBytes(), MEM_COMMIT, PAGE_READWRITE);
+
+		if (m_flags & FLAGS_PREFAULT)
+		{
+			// commit works on every page the range touches, so we prefault all of them
+			auto pageSize = OS::pageSize();
+			auto begin = alignDown(uintptr_t(bytes.data()), pageSize);
+			auto end = alignUp(uintptr_t(bytes.data() + bytes.sizeInBytes()), pageSize);
+			touchPages((void*)begin, end - begin);
+		}
 	}
 
 	void VirtualMem::release(Span<std::byte> bytes)
 	{
-		VirtualFree(bytes.data(), bytes.sizeInBytes(), MEM_DECOMMIT);
+		if (bytes.empty() || (m_flags & FLAGS_HUGE_PAGES))
+		{
+			return;
+		}
+
+		// only decommit the pages which are fully inside the range, the partial pages at the edges might be in use
+		auto pageSize = OS::pageSize();
+		auto begin = alignUp(uintptr_t(bytes.data()), pageSize);
+		auto end = alignDown(uintptr_t(bytes.data() + bytes.sizeInBytes()), pageSize);
+		if (begin >= end)
+		{
+			return;
+		}
+
+		VirtualFree((void*)begin, end - begin, MEM_DECOMMIT);
 	}
 
 	void VirtualMem::free(Span<std::byte> bytes)
 	{
+		if (bytes.data() == nullptr)
+		{
+			return;
+		}
+
 		TracyFreeS(bytes.data(), 10);
-		VirtualFree(bytes.data(), bytes.sizeInBytes(), MEM_RELEASE);
+		// MEM_RELEASE requires the size to be 0, it releases the whole reservation
+		VirtualFree(bytes.data(), 0, MEM_RELEASE);
 	}
-}
\ No newline at end of file
+}
@@ -35,14 +35,19 @@ namespace core::ws
 		return {};
 	}
 
-	HumanError Client::sendHandshake(const Url& url, const String& base64Key)
+	HumanError Client::sendHandshake(const UrlView& url, StringView base64Key)
 	{
-		auto pathResult = url.pathWithQueryAndFragment(m_allocator);
-		if (pathResult.isError())
+		// the url is still encoded as it was written which is what the request line expects, minus the fragment which
+		// isn't part of the request target
+		auto path = url.pathWithQueryAndFragment();
+		if (auto fragmentIndex = path.find(Rune{'#'}); fragmentIndex != SIZE_MAX)
 		{
-			return pathResult.releaseError();
+			path = path.sliceLeft(fragmentIndex);
+		}
+		if (path.count() == 0)
+		{
+			path = "/"_sv;
 		}
-		auto path = pathResult.releaseValue();
 
 		MemoryStream request{m_allocator};
 		strf(&request, "GET {} HTTP/1.1\r\n"_sv, path);
@@ -83,7 +88,7 @@ namespace core::ws
 		return httpString;
 	}
 
-	HumanError Client::handshake(const Url& url)
+	HumanError Client::handshake(const UrlView& url)
 	{
 		std::byte rawKey[16] = {};
 		Span<std::byte> key{rawKey, sizeof(rawKey)};
@@ -93,7 +98,10 @@ namespace core::ws
 			return errf(m_allocator, "failed to generate random key"_sv);
 		}
 
-		auto base64Key = Base64::encode(key, m_allocator);
+		char base64KeyBuffer[Base64::encodedCount(sizeof(rawKey))];
+		auto base64KeyCount =
+			Base64::encode(key, Span<char>{base64KeyBuffer, sizeof(base64KeyBuffer)}, Base64::ALPHABET_STANDARD);
+		auto base64Key = StringView{base64KeyBuffer, base64KeyCount};
 		auto err = sendHandshake(url, base64Key);
 		if (err)
 		{
@@ -118,8 +126,10 @@ namespace core::ws
 		SHA1Hasher hasher;
 		hasher.hash(base64Key);
 		hasher.hash("258EAFA5-E914-47DA-95CA-C5AB0DC85B11"_sv);
-		auto expectedBase64 = Base64::encode(hasher.final().asBytes(), m_allocator);
-		if (expectedBase64 != handshake.key())
+		char expectedBuffer[Base64::encodedCount(SHA1::DIGEST_SIZE)];
+		auto expectedCount = Base64::encode(
+			hasher.final().asBytes(), Span<char>{expectedBuffer, sizeof(expectedBuffer)}, Base64::ALPHABET_STANDARD);
+		if (StringView{expectedBuffer, expectedCount} != handshake.key())
 		{
 			return errf(m_allocator, "invalid websocket accept header"_sv);
 		}
@@ -154,8 +164,10 @@ namespace core::ws
 		SHA1Hasher hasher;
 		hasher.hash(handshake.key());
 		hasher.hash("258EAFA5-E914-47DA-95CA-C5AB0DC85B11"_sv);
-		auto base64 = Base64::encode(hasher.final().asBytes(), m_allocator);
-		auto reply = strf(m_allocator, StringView{REPLY}, base64);
+		char base64[Base64::encodedCount(SHA1::DIGEST_SIZE)];
+		auto base64Count =
+			Base64::encode(hasher.final().asBytes(), Span<char>{base64, sizeof(base64)}, Base64::ALPHABET_STANDARD);
+		auto reply = strf(m_allocator, StringView{REPLY}, StringView{base64, base64Count});
 		return write(StringView{reply});
 	}
 
@@ -254,12 +266,12 @@ namespace core::ws
 	Result<Client>
 	Client::connect(StringView url, size_t maxHandshakeSize, size_t maxMessageSize, Log* log, Allocator* allocator)
 	{
-		auto parsedUrlResult = Url::parse(url, allocator);
+		auto parsedUrlResult = UrlView::parse(url);
 		if (parsedUrlResult.isError())
 		{
-			return parsedUrlResult.releaseError();
+			return errf(allocator, "{}"_sv, UrlView::errorMessage(parsedUrlResult.error()));
 		}
-		auto parsedUrl = parsedUrlResult.releaseValue();
+		auto parsedUrl = parsedUrlResult.value();
 
 		auto socket = Socket::open(allocator, Socket::FAMILY_IPV4, Socket::TYPE_TCP);
 		if (socket == nullptr)
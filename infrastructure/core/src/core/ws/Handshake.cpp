@@ -86,13 +86,14 @@ namespace core::ws
 	{
 		ZoneScoped;
 
-		auto lines = response.split("\r\n"_sv, true, allocator);
-		if (lines.count() == 0)
+		auto lines = response.split("\r\n"_sv, true);
+		auto it = lines.begin();
+		if (it == lines.end())
 		{
 			return errf(allocator, "failed to parse empty handshake response"_sv);
 		}
 
-		auto statusLine = lines[0];
+		auto statusLine = *it;
 		if (statusLine.startsWithIgnoreCase("HTTP/1.1 101"_sv) == false)
 		{
 			return errf(allocator, "unexpected handshake HTTP upgrade response, {}"_sv, statusLine);
@@ -100,9 +101,9 @@ namespace core::ws
 
 		int validResponse = 0;
 		StringView responseKey{};
-		for (size_t i = 1; i < lines.count(); ++i)
+		for (++it; it != lines.end(); ++it)
 		{
-			auto line = lines[i];
+			auto line = *it;
 
 			auto colonIndex = line.find(Rune{':'}, 0);
 			if (colonIndex == SIZE_MAX)
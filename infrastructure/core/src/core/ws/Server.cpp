@@ -6,12 +6,12 @@ namespace core::ws
 	Result<Server>
 	Server::connect(StringView url, size_t maxHandshakeSize, size_t maxMessageSize, Log* log, Allocator* allocator)
 	{
-		auto parsedUrlResult = Url::parse(url, allocator);
+		auto parsedUrlResult = UrlView::parse(url);
 		if (parsedUrlResult.isError())
 		{
-			return parsedUrlResult.releaseError();
+			return errf(allocator, "{}"_sv, UrlView::errorMessage(parsedUrlResult.error()));
 		}
-		auto parsedUrl = parsedUrlResult.releaseValue();
+		auto parsedUrl = parsedUrlResult.value();
 
 		auto socket = Socket::open(allocator, Socket::FAMILY_IPV4, Socket::TYPE_TCP);
 		if (socket == nullptr)
@@ -0,0 +1,148 @@
+#include <core/Base64.h>
+#include <core/Hex.h>
+#include <core/Mallocator.h>
+#include <core/MemoryStream.h>
+#include <core/String.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <openssl/bio.h>
+#include <openssl/evp.h>
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// the openssl bio chain core::Base64 used to be
+std::string bioEncode(const std::vector<std::byte>& bytes)
+{
+	auto b64 = BIO_new(BIO_f_base64());
+	BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
+	auto mem = BIO_new(BIO_s_mem());
+	b64 = BIO_push(b64, mem);
+	BIO_write(b64, bytes.data(), int(bytes.size()));
+	BIO_flush(b64);
+
+	char* encodedString = nullptr;
+	auto len = BIO_get_mem_data(mem, &encodedString);
+	std::string result{encodedString, size_t(len)};
+	BIO_free_all(b64);
+	return result;
+}
+
+std::vector<std::byte> bioDecode(const std::string& str)
+{
+	auto b64 = BIO_new(BIO_f_base64());
+	BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
+	auto mem = BIO_new_mem_buf(str.data(), int(str.size()));
+	b64 = BIO_push(b64, mem);
+
+	std::vector<std::byte> decoded(str.size() / 4 * 3 + 1);
+	auto len = BIO_read(b64, decoded.data(), int(decoded.size()));
+	decoded.resize(len);
+	BIO_free_all(b64);
+	return decoded;
+}
+
+void benchBase64(size_t size, std::mt19937_64& gen)
+{
+	core::Mallocator allocator;
+	std::vector<std::byte> bytes(size);
+	for (auto& b: bytes)
+	{
+		b = std::byte(gen());
+	}
+	core::Span<const std::byte> span{bytes.data(), bytes.size()};
+	auto encoded = core::Base64::encode(span, &allocator);
+	std::string encodedString{encoded.data(), encoded.count()};
+	// EVP_EncodeBlock null terminates its output
+	std::vector<char> chars(encoded.count() + 1);
+	std::vector<std::byte> decoded(bytes.size());
+
+	ankerl::nanobench::Bench bench{};
+	bench.title(fmt::format("base64 {} bytes", size)).unit("byte").batch(size).relative(true);
+	if (size >= 1024 * 1024)
+	{
+		bench.minEpochIterations(1);
+	}
+
+	bench.run("openssl bio encode", [&] { ankerl::nanobench::doNotOptimizeAway(bioEncode(bytes)); });
+	bench.run("openssl EVP_EncodeBlock", [&] {
+		auto res = EVP_EncodeBlock((unsigned char*)chars.data(), (const unsigned char*)bytes.data(), int(size));
+		ankerl::nanobench::doNotOptimizeAway(res);
+	});
+	bench.run("core::Base64::encode into a span", [&] {
+		auto out = core::Span<char>{chars.data(), encoded.count()};
+		auto res = core::Base64::encode(span, out, core::Base64::ALPHABET_STANDARD);
+		ankerl::nanobench::doNotOptimizeAway(res);
+	});
+	bench.run("core::Base64::encode into a string", [&] {
+		ankerl::nanobench::doNotOptimizeAway(core::Base64::encode(span, &allocator));
+	});
+
+	bench.run("openssl bio decode", [&] { ankerl::nanobench::doNotOptimizeAway(bioDecode(encodedString)); });
+	bench.run("openssl EVP_DecodeBlock", [&] {
+		auto res =
+			EVP_DecodeBlock((unsigned char*)decoded.data(), (const unsigned char*)encoded.data(), int(encoded.count()));
+		ankerl::nanobench::doNotOptimizeAway(res);
+	});
+	bench.run("core::Base64::decode into a span", [&] {
+		auto out = core::Span<std::byte>{decoded.data(), decoded.size()};
+		auto res = core::Base64::decode(encoded, out, core::Base64::ALPHABET_STANDARD);
+		ankerl::nanobench::doNotOptimizeAway(res);
+	});
+}
+
+void benchHex(size_t size, std::mt19937_64& gen)
+{
+	core::Mallocator allocator;
+	std::vector<std::byte> bytes(size);
+	for (auto& b: bytes)
+	{
+		b = std::byte(gen());
+	}
+	core::Span<const std::byte> span{bytes.data(), bytes.size()};
+	std::vector<char> chars(core::Hex::encodedCount(size));
+	std::vector<std::byte> decoded(size);
+
+	ankerl::nanobench::Bench bench{};
+	bench.title(fmt::format("hex {} bytes", size)).unit("byte").batch(size).relative(true);
+	if (size >= 1024 * 1024)
+	{
+		bench.minEpochIterations(1);
+	}
+
+	// the way fin::LockInfo named its lock
+	bench.run("strf a byte at a time", [&] {
+		core::MemoryStream stream{&allocator};
+		for (auto b: bytes)
+		{
+			core::strf(&stream, "{:02x}"_sv, b);
+		}
+		ankerl::nanobench::doNotOptimizeAway(stream.releaseString());
+	});
+	bench.run("core::Hex::encode into a span", [&] {
+		ankerl::nanobench::doNotOptimizeAway(core::Hex::encode(span, core::Span<char>{chars.data(), chars.size()}));
+	});
+	bench.run("core::Hex::decode into a span", [&] {
+		auto str = core::StringView{chars.data(), chars.size()};
+		ankerl::nanobench::doNotOptimizeAway(core::Hex::decode(str, core::Span<std::byte>{decoded.data(), size}));
+	});
+}
+
+int main(int argc, char** argv)
+{
+	std::mt19937_64 gen{42};
+	for (size_t size = 16; size <= 16 * 1024 * 1024; size *= 16)
+	{
+		benchBase64(size, gen);
+	}
+	for (size_t size: {20, 4096, 1024 * 1024})
+	{
+		benchHex(size, gen);
+	}
+	return EXIT_SUCCESS;
+}
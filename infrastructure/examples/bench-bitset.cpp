@@ -0,0 +1,147 @@
+#include <core/BitSet.h>
+#include <core/Hash.h>
+#include <core/Mallocator.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <random>
+
+// one step of a backwards liveness analysis over a block, live_in = use | (live_out - def), with sets of about a
+// quarter of the variables live which is typical of the dataflow sets of a compiler
+void benchLiveness(core::Allocator* allocator, size_t variablesCount)
+{
+	std::mt19937_64 gen{42};
+	core::BitSet useBits{allocator, variablesCount}, defBits{allocator, variablesCount},
+		outBits{allocator, variablesCount};
+	core::Set<size_t> useSet{allocator}, defSet{allocator}, outSet{allocator};
+	for (size_t i = 0; i < variablesCount; ++i)
+	{
+		if (gen() % 8 == 0)
+		{
+			useBits.set(i);
+			useSet.insert(i);
+		}
+		if (gen() % 8 == 0)
+		{
+			defBits.set(i);
+			defSet.insert(i);
+		}
+		if (gen() % 4 == 0)
+		{
+			outBits.set(i);
+			outSet.insert(i);
+		}
+	}
+
+	ankerl::nanobench::Bench bench{};
+	bench.title("liveness step with " + std::to_string(variablesCount) + " variables").relative(true);
+	bench.minEpochIterations(variablesCount < 1024 ? 10000 : 100);
+
+	bench.run("core::Set<size_t>", [&] {
+		core::Set<size_t> in{allocator};
+		for (auto v: outSet)
+		{
+			if (defSet.lookup(v) == defSet.end())
+			{
+				in.insert(v);
+			}
+		}
+		for (auto v: useSet)
+		{
+			in.insert(v);
+		}
+		ankerl::nanobench::doNotOptimizeAway(in.count());
+	});
+
+	bench.run("core::BitSet", [&] {
+		auto in = outBits;
+		in.andNot(defBits);
+		in |= useBits;
+		ankerl::nanobench::doNotOptimizeAway(in.popcount());
+	});
+}
+
+// visiting the members of a set like a register allocator walking the live variables
+void benchIterate(core::Allocator* allocator, size_t variablesCount)
+{
+	std::mt19937_64 gen{7};
+	core::BitSet bits{allocator, variablesCount};
+	core::Set<size_t> set{allocator};
+	for (size_t i = 0; i < variablesCount; ++i)
+	{
+		if (gen() % 4 == 0)
+		{
+			bits.set(i);
+			set.insert(i);
+		}
+	}
+
+	ankerl::nanobench::Bench bench{};
+	bench.title("iterate " + std::to_string(set.count()) + " of " + std::to_string(variablesCount) + " variables");
+	bench.relative(true).unit("member").batch(set.count());
+	bench.minEpochIterations(variablesCount < 1024 ? 10000 : 100);
+
+	bench.run("core::Set<size_t>", [&] {
+		size_t sum = 0;
+		for (auto v: set)
+		{
+			sum += v;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("core::BitSet iterator", [&] {
+		size_t sum = 0;
+		for (auto v: bits)
+		{
+			sum += v;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("core::BitSet::forEach", [&] {
+		size_t sum = 0;
+		bits.forEach([&](size_t v) { sum += v; });
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+}
+
+void benchFixed()
+{
+	std::mt19937_64 gen{1};
+	core::FixedBitSet<256> a, b;
+	for (size_t i = 0; i < 256; ++i)
+	{
+		a.set(i, gen() % 2);
+		b.set(i, gen() % 2);
+	}
+
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::FixedBitSet<256>").minEpochIterations(100000);
+	bench.run("or + popcount", [&] {
+		auto c = a;
+		c |= b;
+		ankerl::nanobench::doNotOptimizeAway(c.popcount());
+	});
+	bench.run("and + findFirst", [&] {
+		auto c = a;
+		c &= b;
+		ankerl::nanobench::doNotOptimizeAway(c.findFirst());
+	});
+}
+
+int main()
+{
+	core::Mallocator mallocator;
+	for (size_t count: {64, 1024, 16 * 1024})
+	{
+		benchLiveness(&mallocator, count);
+	}
+	for (size_t count: {64, 1024, 16 * 1024})
+	{
+		benchIterate(&mallocator, count);
+	}
+	benchFixed();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,224 @@
+#include <core/Array.h>
+#include <core/BTree.h>
+#include <core/Hash.h>
+#include <core/Mallocator.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <algorithm>
+#include <string>
+
+constexpr size_t LOOKUPS_COUNT = 1 << 16;
+constexpr size_t SCANS_COUNT = 1 << 10;
+constexpr uint64_t SCAN_WIDTH = 1 << 10;
+
+// random keys which are spread enough that the range scans cover a handful of them
+core::Array<uint64_t> makeKeys(core::Allocator* allocator, size_t count)
+{
+	ankerl::nanobench::Rng rng{42};
+	core::Array<uint64_t> res{allocator};
+	res.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		res.push(rng.bounded(uint32_t(count * 64)));
+	}
+	return res;
+}
+
+// keeps the array sorted by moving the bigger elements one step to make room for the new key
+void sortedArrayInsert(core::Array<uint64_t>& array, uint64_t key)
+{
+	auto it = std::lower_bound(array.begin(), array.end(), key);
+	if (it != array.end() && *it == key)
+	{
+		return;
+	}
+	auto index = size_t(it - array.begin());
+	array.push(key);
+	std::move_backward(array.begin() + index, array.end() - 1, array.end());
+	array[index] = key;
+}
+
+bool sortedArrayContains(const core::Array<uint64_t>& array, uint64_t key)
+{
+	return std::binary_search(array.begin(), array.end(), key);
+}
+
+int main()
+{
+	core::Mallocator mallocator;
+
+	for (size_t count: {1 << 10, 1 << 16, 1 << 20})
+	{
+		auto keys = makeKeys(&mallocator, count);
+		auto name = std::to_string(count);
+
+		{
+			ankerl::nanobench::Bench bench{};
+			bench.title("insert " + name + " random keys").unit("insert").batch(count).relative(true);
+			bench.minEpochIterations(count <= (1 << 10) ? 100 : 1);
+
+			// inserting into the middle of a sorted array is quadratic so it's left out of the big runs
+			if (count <= (1 << 16))
+			{
+				bench.run("sorted core::Array", [&] {
+					core::Array<uint64_t> array{&mallocator};
+					for (auto key: keys)
+					{
+						sortedArrayInsert(array, key);
+					}
+					ankerl::nanobench::doNotOptimizeAway(array.count());
+				});
+			}
+
+			bench.run("core::Set + sort", [&] {
+				core::Set<uint64_t> set{&mallocator};
+				for (auto key: keys)
+				{
+					set.insert(key);
+				}
+				core::Array<uint64_t> sorted{&mallocator};
+				sorted.reserve(set.count());
+				for (auto key: set)
+				{
+					sorted.push(key);
+				}
+				std::sort(sorted.begin(), sorted.end());
+				ankerl::nanobench::doNotOptimizeAway(sorted.count());
+			});
+
+			bench.run("core::BTreeSet", [&] {
+				core::BTreeSet<uint64_t> tree{&mallocator};
+				for (auto key: keys)
+				{
+					tree.insert(key);
+				}
+				ankerl::nanobench::doNotOptimizeAway(tree.count());
+			});
+
+			bench.run("core::BTreeSet assignSorted", [&] {
+				core::Array<uint64_t> sorted{keys};
+				std::sort(sorted.begin(), sorted.end());
+				sorted.resize(size_t(std::unique(sorted.begin(), sorted.end()) - sorted.begin()));
+				core::BTreeSet<uint64_t> tree{&mallocator};
+				tree.assignSorted(sorted);
+				ankerl::nanobench::doNotOptimizeAway(tree.count());
+			});
+		}
+
+		core::Array<uint64_t> sorted{keys};
+		std::sort(sorted.begin(), sorted.end());
+		sorted.resize(size_t(std::unique(sorted.begin(), sorted.end()) - sorted.begin()));
+		core::Set<uint64_t> set{&mallocator};
+		core::BTreeSet<uint64_t> tree{&mallocator};
+		for (auto key: keys)
+		{
+			set.insert(key);
+			tree.insert(key);
+		}
+
+		// half of the lookups hit and half of them miss
+		core::Array<uint64_t> queries{&mallocator};
+		queries.reserve(LOOKUPS_COUNT);
+		for (size_t i = 0; i < LOOKUPS_COUNT; ++i)
+		{
+			queries.push(keys[(i * 7919) % count] + (i & 1));
+		}
+
+		{
+			ankerl::nanobench::Bench bench{};
+			bench.title("lookup in " + name + " keys").unit("lookup").batch(LOOKUPS_COUNT).relative(true);
+
+			bench.run("sorted core::Array", [&] {
+				size_t found = 0;
+				for (size_t i = 0; i < LOOKUPS_COUNT; ++i)
+				{
+					found += sortedArrayContains(sorted, queries[i]);
+				}
+				ankerl::nanobench::doNotOptimizeAway(found);
+			});
+
+			bench.run("core::Set", [&] {
+				size_t found = 0;
+				for (size_t i = 0; i < LOOKUPS_COUNT; ++i)
+				{
+					found += set.lookup(queries[i]) != set.end();
+				}
+				ankerl::nanobench::doNotOptimizeAway(found);
+			});
+
+			bench.run("core::BTreeSet", [&] {
+				size_t found = 0;
+				for (size_t i = 0; i < LOOKUPS_COUNT; ++i)
+				{
+					found += tree.lookup(queries[i]) != tree.end();
+				}
+				ankerl::nanobench::doNotOptimizeAway(found);
+			});
+		}
+
+		{
+			ankerl::nanobench::Bench bench{};
+			bench.title("scan " + std::to_string(SCAN_WIDTH) + " wide ranges in " + name + " keys");
+			bench.unit("scan").batch(SCANS_COUNT).relative(true);
+
+			bench.run("sorted core::Array", [&] {
+				uint64_t sum = 0;
+				for (size_t i = 0; i < SCANS_COUNT; ++i)
+				{
+					auto from = queries[i];
+					auto it = std::lower_bound(sorted.begin(), sorted.end(), from);
+					for (; it != sorted.end() && *it < from + SCAN_WIDTH; ++it)
+					{
+						sum += *it;
+					}
+				}
+				ankerl::nanobench::doNotOptimizeAway(sum);
+			});
+
+			// a hash set has no order so each query walks all the keys to collect the ones in the range then sorts
+			// them, it's too slow to run on the big sets
+			if (count <= (1 << 16))
+			{
+				bench.run("core::Set + sort", [&] {
+					uint64_t sum = 0;
+					core::Array<uint64_t> matches{&mallocator};
+					for (size_t i = 0; i < SCANS_COUNT; ++i)
+					{
+						auto from = queries[i];
+						matches.clear();
+						for (auto key: set)
+						{
+							if (key >= from && key < from + SCAN_WIDTH)
+							{
+								matches.push(key);
+							}
+						}
+						std::sort(matches.begin(), matches.end());
+						for (auto key: matches)
+						{
+							sum += key;
+						}
+					}
+					ankerl::nanobench::doNotOptimizeAway(sum);
+				});
+			}
+
+			bench.run("core::BTreeSet", [&] {
+				uint64_t sum = 0;
+				for (size_t i = 0; i < SCANS_COUNT; ++i)
+				{
+					auto from = queries[i];
+					for (auto it = tree.lowerBound(from); it != tree.end() && *it < from + SCAN_WIDTH; ++it)
+					{
+						sum += *it;
+					}
+				}
+				ankerl::nanobench::doNotOptimizeAway(sum);
+			});
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include <core/Array.h>
+#include <core/ConcurrentMap.h>
+#include <core/Lock.h>
+#include <core/Mallocator.h>
+#include <core/Mutex.h>
+#include <core/Thread.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+constexpr size_t KEYS_COUNT = 1 << 20;
+constexpr size_t OPS_PER_THREAD = 1 << 20;
+
+// the baseline, a single Map behind a single Mutex like the ws-server example used to do
+struct LockedMap
+{
+	core::Mutex mutex;
+	core::Map<uint64_t, uint64_t> map;
+
+	explicit LockedMap(core::Allocator* allocator)
+		: mutex(allocator),
+		  map(allocator)
+	{}
+
+	bool lookup(uint64_t key)
+	{
+		auto lock = core::lockGuard(mutex);
+		return map.lookup(key) != map.end();
+	}
+
+	void insert(uint64_t key)
+	{
+		auto lock = core::lockGuard(mutex);
+		map.insert(key, key);
+	}
+
+	void remove(uint64_t key)
+	{
+		auto lock = core::lockGuard(mutex);
+		map.remove(key);
+	}
+};
+
+struct ShardedMap
+{
+	core::ConcurrentMap<uint64_t, uint64_t> map;
+
+	explicit ShardedMap(core::Allocator* allocator)
+		: map(allocator)
+	{}
+
+	bool lookup(uint64_t key)
+	{
+		return map.contains(key);
+	}
+
+	void insert(uint64_t key)
+	{
+		map.insert(key, key);
+	}
+
+	void remove(uint64_t key)
+	{
+		map.remove(key);
+	}
+};
+
+// each thread does random operations, writePercent of them are an insert or a remove and the rest are lookups
+template <typename TMap>
+void benchThreads(
+	ankerl::nanobench::Bench& bench,
+	const std::string& name,
+	core::Allocator* allocator,
+	size_t threadsCount,
+	uint32_t writePercent)
+{
+	TMap map{allocator};
+	for (uint64_t i = 0; i < KEYS_COUNT; ++i)
+	{
+		map.insert(i);
+	}
+
+	bench.run(name, [&] {
+		core::Array<core::Thread> threads{allocator};
+		for (size_t i = 0; i < threadsCount; ++i)
+		{
+			threads.push(core::Thread{allocator, [&map, writePercent, i] {
+				ankerl::nanobench::Rng rng{42 + i};
+				size_t found = 0;
+				for (size_t j = 0; j < OPS_PER_THREAD; ++j)
+				{
+					auto key = rng.bounded(uint32_t(KEYS_COUNT * 2));
+					auto op = rng.bounded(100);
+					if (op < writePercent / 2)
+					{
+						map.insert(key);
+					}
+					else if (op < writePercent)
+					{
+						map.remove(key);
+					}
+					else
+					{
+						found += map.lookup(key);
+					}
+				}
+				ankerl::nanobench::doNotOptimizeAway(found);
+			}});
+		}
+		for (auto& thread: threads)
+		{
+			thread.join();
+		}
+	});
+}
+
+// lookups only on a map which every thread shares, prints the throughput of each threads count next to how much faster
+// it is than a single thread, with enough cores the speedup should follow the threads count
+void readScaling(core::Allocator* allocator, size_t maxThreads)
+{
+	ShardedMap map{allocator};
+	for (uint64_t i = 0; i < KEYS_COUNT; ++i)
+	{
+		map.insert(i);
+	}
+
+	::printf("ConcurrentMap read scaling\n");
+	double singleThreadOpsPerSecond = 0;
+	for (size_t threadsCount = 1; threadsCount <= maxThreads; threadsCount *= 2)
+	{
+		auto start = std::chrono::steady_clock::now();
+		core::Array<core::Thread> threads{allocator};
+		for (size_t i = 0; i < threadsCount; ++i)
+		{
+			threads.push(core::Thread{allocator, [&map, i] {
+				ankerl::nanobench::Rng rng{42 + i};
+				size_t found = 0;
+				for (size_t j = 0; j < OPS_PER_THREAD; ++j)
+				{
+					found += map.lookup(rng.bounded(uint32_t(KEYS_COUNT)));
+				}
+				ankerl::nanobench::doNotOptimizeAway(found);
+			}});
+		}
+		for (auto& thread: threads)
+		{
+			thread.join();
+		}
+		auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		auto opsPerSecond = double(OPS_PER_THREAD * threadsCount) / seconds;
+		if (threadsCount == 1)
+		{
+			singleThreadOpsPerSecond = opsPerSecond;
+		}
+		::printf(
+			"%3zu threads: %8.2f M lookups/s, %5.2fx of 1 thread\n",
+			threadsCount,
+			opsPerSecond / 1e6,
+			opsPerSecond / singleThreadOpsPerSecond);
+	}
+}
+
+int main()
+{
+	core::Mallocator mallocator;
+
+	auto maxThreads = size_t(core::Thread::hardware_concurrency());
+	readScaling(&mallocator, maxThreads * 2 < 8 ? 8 : maxThreads * 2);
+
+	for (uint32_t writePercent: {0, 10, 50})
+	{
+		ankerl::nanobench::Bench bench{};
+		bench.title("concurrent map " + std::to_string(writePercent) + "% writes").unit("op").epochs(1);
+		bench.minEpochIterations(1).relative(true);
+		for (size_t threadsCount = 1; threadsCount <= maxThreads * 2; threadsCount *= 2)
+		{
+			bench.batch(OPS_PER_THREAD * threadsCount);
+			auto suffix = " " + std::to_string(threadsCount) + " threads";
+			benchThreads<LockedMap>(bench, "Mutex + Map" + suffix, &mallocator, threadsCount, writePercent);
+			benchThreads<ShardedMap>(bench, "ConcurrentMap" + suffix, &mallocator, threadsCount, writePercent);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+#include <core/Deque.h>
+#include <core/Mallocator.h>
+#include <core/ProfilingAllocator.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <cstdio>
+#include <deque>
+#include <string>
+
+// the linked list Queue which Deque replaced, kept here to compare against
+template <typename T>
+class LinkedQueue
+{
+	struct Node
+	{
+		Node* next = nullptr;
+		T value;
+	};
+
+	core::Allocator* m_allocator = nullptr;
+	Node* m_head = nullptr;
+	Node* m_tail = nullptr;
+
+public:
+	explicit LinkedQueue(core::Allocator* allocator)
+		: m_allocator(allocator)
+	{}
+
+	~LinkedQueue()
+	{
+		while (m_head)
+		{
+			pop_front();
+		}
+	}
+
+	void push_back(T value)
+	{
+		auto node = m_allocator->allocSingleT<Node>();
+		m_allocator->commitSingleT(node);
+		new (node) Node{nullptr, value};
+		if (m_tail)
+		{
+			m_tail->next = node;
+		}
+		else
+		{
+			m_head = node;
+		}
+		m_tail = node;
+	}
+
+	T& front()
+	{
+		return m_head->value;
+	}
+
+	void pop_front()
+	{
+		auto node = m_head;
+		m_head = m_head->next;
+		if (m_head == nullptr)
+		{
+			m_tail = nullptr;
+		}
+		node->~Node();
+		m_allocator->releaseSingleT(node);
+		m_allocator->freeSingleT(node);
+	}
+};
+
+constexpr size_t OPS_COUNT = 1 << 20;
+
+// keeps a window of elements in the queue like a task queue which is drained while it's being filled
+template <typename TQueue>
+uint64_t slidingWindow(TQueue& queue, size_t window)
+{
+	uint64_t sum = 0;
+	for (size_t i = 0; i < OPS_COUNT; ++i)
+	{
+		queue.push_back(i);
+		if (i >= window)
+		{
+			sum += queue.front();
+			queue.pop_front();
+		}
+	}
+	for (size_t i = 0; i < window; ++i)
+	{
+		sum += queue.front();
+		queue.pop_front();
+	}
+	return sum;
+}
+
+int main()
+{
+	core::Mallocator mallocator;
+
+	for (size_t window: {16, 1024, 64 * 1024})
+	{
+		ankerl::nanobench::Bench bench{};
+		bench.title("queue with " + std::to_string(window) + " elements").unit("push+pop").batch(OPS_COUNT);
+		bench.relative(true).performanceCounters(true);
+
+		bench.run("LinkedQueue", [&] {
+			LinkedQueue<uint64_t> queue{&mallocator};
+			ankerl::nanobench::doNotOptimizeAway(slidingWindow(queue, window));
+		});
+
+		bench.run("core::Deque", [&] {
+			core::Deque<uint64_t> queue{&mallocator};
+			ankerl::nanobench::doNotOptimizeAway(slidingWindow(queue, window));
+		});
+
+		bench.run("std::deque", [&] {
+			std::deque<uint64_t> queue;
+			ankerl::nanobench::doNotOptimizeAway(slidingWindow(queue, window));
+		});
+	}
+
+	// samples every allocation so the stats count all of them
+	for (size_t window: {16, 1024})
+	{
+		core::ProfilingAllocator linkedCounter{&mallocator, 0};
+		{
+			LinkedQueue<uint64_t> queue{&linkedCounter};
+			slidingWindow(queue, window);
+		}
+		core::ProfilingAllocator dequeCounter{&mallocator, 0};
+		{
+			core::Deque<uint64_t> queue{&dequeCounter};
+			slidingWindow(queue, window);
+		}
+		::printf(
+			"%zu push+pop with %zu elements: LinkedQueue allocated %zu times, core::Deque allocated %zu times\n",
+			OPS_COUNT,
+			window,
+			size_t(linkedCounter.stats().allocatedCount),
+			size_t(dequeCounter.stats().allocatedCount));
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#include <core/Digest.h>
+#include <core/Mallocator.h>
+#include <core/SHA1.h>
+#include <core/ThreadPool.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <fmt/format.h>
+
+#include <openssl/sha.h>
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+void benchDigest(size_t size, core::ThreadPool& pool, core::Allocator* allocator, std::mt19937_64& gen)
+{
+	std::vector<std::byte> bytes(size);
+	for (auto& b: bytes)
+	{
+		b = std::byte(gen());
+	}
+	core::Span<const std::byte> span{bytes.data(), bytes.size()};
+
+	// nanobench reports the throughput of a byte per op as bytes per second
+	ankerl::nanobench::Bench bench{};
+	bench.title(fmt::format("digest {} bytes", size)).unit("byte").batch(size).relative(true);
+	if (size >= 1024 * 1024)
+	{
+		bench.minEpochIterations(1);
+	}
+
+	bench.run("core::SHA1", [&] {
+		ankerl::nanobench::doNotOptimizeAway(core::SHA1::hash(core::Span<std::byte>{bytes.data(), bytes.size()}));
+	});
+	bench.run("openssl SHA256", [&] {
+		unsigned char digest[SHA256_DIGEST_LENGTH];
+		ankerl::nanobench::doNotOptimizeAway(::SHA256((const unsigned char*)bytes.data(), bytes.size(), digest));
+	});
+	bench.run("core::Digest::sha256", [&] { ankerl::nanobench::doNotOptimizeAway(core::Digest::sha256(span)); });
+	bench.run("core::Digest::blake3", [&] { ankerl::nanobench::doNotOptimizeAway(core::Digest::blake3(span)); });
+	bench.run(fmt::format("core::Digest::blake3 on {} threads", pool.threadsCount()), [&] {
+		ankerl::nanobench::doNotOptimizeAway(core::Digest::blake3(span, &pool, allocator));
+	});
+}
+
+int main(int argc, char** argv)
+{
+	core::Mallocator allocator;
+	core::ThreadPool pool{&allocator};
+
+	std::mt19937_64 gen{42};
+	for (size_t size: {64, 4096, 1024 * 1024, 64 * 1024 * 1024})
+	{
+		benchDigest(size, pool, &allocator, gen);
+	}
+	return EXIT_SUCCESS;
+}
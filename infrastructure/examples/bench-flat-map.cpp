@@ -0,0 +1,156 @@
+#include <core/FlatMap.h>
+#include <core/Hash.h>
+#include <core/Mallocator.h>
+#include <core/String.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <random>
+
+constexpr size_t LOOKUPS_COUNT = 1024;
+
+// small integer keyed tables like an enum to handler table
+void benchIntegers(core::Allocator* allocator, size_t count)
+{
+	std::mt19937_64 gen{42};
+	core::Array<uint64_t> keys{allocator};
+	for (size_t i = 0; i < count; ++i)
+	{
+		keys.push(gen());
+	}
+	core::Array<uint64_t> queries{allocator};
+	for (size_t i = 0; i < LOOKUPS_COUNT; ++i)
+	{
+		queries.push(keys[gen() % count]);
+	}
+
+	core::Map<uint64_t, uint64_t> map{allocator};
+	core::FlatMap<uint64_t, uint64_t> flat{allocator};
+	for (auto key: keys)
+	{
+		map.insert(key, key);
+		flat.insert(key, key);
+	}
+
+	ankerl::nanobench::Bench bench{};
+	bench.title("lookup in " + std::to_string(count) + " integer keys");
+	bench.relative(true).unit("lookup").batch(LOOKUPS_COUNT);
+
+	bench.run("core::Map", [&] {
+		uint64_t sum = 0;
+		for (auto key: queries)
+		{
+			sum += map.lookup(key)->value;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("core::FlatMap", [&] {
+		uint64_t sum = 0;
+		for (auto key: queries)
+		{
+			sum += flat.lookup(key)->value;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+}
+
+// string keyed tables like command line options, http headers or url query parameters, they are built once then
+// looked up a few times so building them is part of the cost
+void benchStrings(core::Allocator* allocator, size_t count)
+{
+	std::mt19937_64 gen{7};
+	core::Array<core::String> keys{allocator};
+	for (size_t i = 0; i < count; ++i)
+	{
+		keys.push(core::strf(allocator, "x-header-{}"_sv, gen() % 100000));
+	}
+	core::Array<core::StringView> queries{allocator};
+	for (size_t i = 0; i < LOOKUPS_COUNT; ++i)
+	{
+		queries.push(keys[gen() % count]);
+	}
+
+	core::Map<core::StringView, size_t> map{allocator};
+	core::FlatMap<core::StringView, size_t> flat{allocator};
+	for (size_t i = 0; i < count; ++i)
+	{
+		map.insert(keys[i], i);
+		flat.insert(keys[i], i);
+	}
+
+	{
+		ankerl::nanobench::Bench bench{};
+		bench.title("lookup in " + std::to_string(count) + " string keys");
+		bench.relative(true).unit("lookup").batch(LOOKUPS_COUNT);
+
+		bench.run("core::Map", [&] {
+			size_t sum = 0;
+			for (auto key: queries)
+			{
+				sum += map.lookup(key)->value;
+			}
+			ankerl::nanobench::doNotOptimizeAway(sum);
+		});
+
+		bench.run("core::FlatMap", [&] {
+			size_t sum = 0;
+			for (auto key: queries)
+			{
+				sum += flat.lookup(key)->value;
+			}
+			ankerl::nanobench::doNotOptimizeAway(sum);
+		});
+	}
+
+	{
+		ankerl::nanobench::Bench bench{};
+		bench.title("build a table of " + std::to_string(count) + " string keys");
+		bench.relative(true);
+
+		bench.run("core::Map insert", [&] {
+			core::Map<core::StringView, size_t> table{allocator};
+			for (size_t i = 0; i < count; ++i)
+			{
+				table.insert(keys[i], i);
+			}
+			ankerl::nanobench::doNotOptimizeAway(table.count());
+		});
+
+		bench.run("core::FlatMap insert", [&] {
+			core::FlatMap<core::StringView, size_t> table{allocator};
+			for (size_t i = 0; i < count; ++i)
+			{
+				table.insert(keys[i], i);
+			}
+			ankerl::nanobench::doNotOptimizeAway(table.count());
+		});
+
+		bench.run("core::FlatMap build", [&] {
+			core::Array<core::KeyValue<core::StringView, size_t>> entries{allocator};
+			entries.reserve(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				entries.push(core::KeyValue<core::StringView, size_t>{keys[i], i});
+			}
+			core::FlatMap<core::StringView, size_t> table{allocator};
+			table.build(std::move(entries));
+			ankerl::nanobench::doNotOptimizeAway(table.count());
+		});
+	}
+}
+
+int main()
+{
+	core::Mallocator mallocator;
+	for (size_t count: {4, 16, 64, 256})
+	{
+		benchIntegers(&mallocator, count);
+	}
+	for (size_t count: {4, 16, 64, 256})
+	{
+		benchStrings(&mallocator, count);
+	}
+	return EXIT_SUCCESS;
+}
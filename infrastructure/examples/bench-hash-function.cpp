@@ -0,0 +1,144 @@
+#include <core/Array.h>
+#include <core/Hash.h>
+#include <core/HashFunction.h>
+#include <core/Mallocator.h>
+#include <core/String.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+void benchThroughput(core::Allocator* allocator)
+{
+	ankerl::nanobench::Bench bench{};
+	bench.title("hash throughput").unit("byte").relative(true).performanceCounters(true);
+
+	for (size_t size: {8, 16, 32, 64, 256, 1024, 64 * 1024})
+	{
+		core::Buffer buffer{allocator};
+		ankerl::nanobench::Rng rng{42};
+		for (size_t i = 0; i < size; ++i)
+		{
+			buffer.push(std::byte(rng()));
+		}
+		core::Span<const std::byte> bytes{buffer};
+
+		auto suffix = " " + std::to_string(size) + " bytes";
+		bench.batch(size);
+
+		bench.run("fnva" + suffix, [&] { ankerl::nanobench::doNotOptimizeAway(core::fnva(bytes)); });
+		bench.run("murmurHash" + suffix, [&] { ankerl::nanobench::doNotOptimizeAway(core::murmurHash(bytes)); });
+		bench.run("wyhash" + suffix, [&] { ankerl::nanobench::doNotOptimizeAway(core::wyhash(bytes, 0)); });
+		bench.run("hashBytes" + suffix, [&] { ankerl::nanobench::doNotOptimizeAway(core::hashBytes(bytes)); });
+	}
+}
+
+void benchIntegers()
+{
+	ankerl::nanobench::Bench bench{};
+	bench.title("integer hash").unit("hash").relative(true).performanceCounters(true);
+
+	uint64_t value = 0;
+	bench.run("hashBytes(uint64_t)", [&] {
+		++value;
+		ankerl::nanobench::doNotOptimizeAway(
+			core::hashBytes(core::Span<const std::byte>{reinterpret_cast<const std::byte*>(&value), sizeof(value)}));
+	});
+
+	bench.run("Hash<uint64_t>", [&] {
+		++value;
+		ankerl::nanobench::doNotOptimizeAway(core::Hash<uint64_t>{}(value, 0));
+	});
+}
+
+// counts how many keys share a bucket with a previous key when the hashes are reduced to the given bits count, a good
+// hash function stays close to the expected count of a uniformly random function
+template <typename TFunc>
+void reportCollisions(core::Allocator* allocator, const char* name, size_t keysCount, size_t bits, TFunc&& hash)
+{
+	core::Array<uint8_t> buckets{allocator};
+	buckets.resize(size_t(1) << bits);
+	size_t lowCollisions = 0;
+	size_t highCollisions = 0;
+	core::Array<uint8_t> highBuckets{allocator};
+	highBuckets.resize(size_t(1) << bits);
+	for (size_t i = 0; i < keysCount; ++i)
+	{
+		auto h = uint64_t(hash(i));
+		auto low = h & ((uint64_t(1) << bits) - 1);
+		auto high = h >> (64 - bits);
+		lowCollisions += buckets[low];
+		highCollisions += highBuckets[high];
+		buckets[low] = 1;
+		highBuckets[high] = 1;
+	}
+
+	// expected number of keys which land in an already used bucket
+	double n = double(keysCount), m = double(size_t(1) << bits);
+	double expected = n - m * (1.0 - std::pow(1.0 - 1.0 / m, n));
+	::printf(
+		"%-40s low bits collisions: %8zu, high bits collisions: %8zu, expected: %8.0f\n",
+		name,
+		lowCollisions,
+		highCollisions,
+		expected);
+}
+
+void reportQuality(core::Allocator* allocator)
+{
+	constexpr size_t KEYS_COUNT = 1 << 20;
+	constexpr size_t BITS = 22;
+
+	::printf("sequential integer keys\n");
+	reportCollisions(allocator, "fnva", KEYS_COUNT, BITS, [](uint64_t i) {
+		return core::fnva(core::Span<const std::byte>{reinterpret_cast<const std::byte*>(&i), sizeof(i)});
+	});
+	reportCollisions(allocator, "murmurHash", KEYS_COUNT, BITS, [](uint64_t i) {
+		return core::murmurHash(core::Span<const std::byte>{reinterpret_cast<const std::byte*>(&i), sizeof(i)});
+	});
+	reportCollisions(allocator, "Hash<uint64_t>", KEYS_COUNT, BITS, [](uint64_t i) {
+		return core::Hash<uint64_t>{}(i, 0xc70f6907UL);
+	});
+
+	::printf("string keys like \"user-<i>\"\n");
+	core::String key{allocator};
+	reportCollisions(allocator, "fnva", KEYS_COUNT, BITS, [&](uint64_t i) {
+		key = core::strf(allocator, "user-{}"_sv, i);
+		return core::fnva(core::Span<const std::byte>{key});
+	});
+	reportCollisions(allocator, "murmurHash", KEYS_COUNT, BITS, [&](uint64_t i) {
+		key = core::strf(allocator, "user-{}"_sv, i);
+		return core::murmurHash(core::Span<const std::byte>{key});
+	});
+	reportCollisions(allocator, "hashBytes", KEYS_COUNT, BITS, [&](uint64_t i) {
+		key = core::strf(allocator, "user-{}"_sv, i);
+		return core::hashBytes(core::Span<const std::byte>{key});
+	});
+
+	::printf("1KB keys which only differ in 8 bytes\n");
+	core::Buffer longKey{allocator};
+	longKey.resize(1024);
+	reportCollisions(allocator, "murmurHash", KEYS_COUNT, BITS, [&](uint64_t i) {
+		::memcpy(longKey.data() + 512, &i, sizeof(i));
+		return core::murmurHash(core::Span<const std::byte>{longKey});
+	});
+	reportCollisions(allocator, "hashBytes", KEYS_COUNT, BITS, [&](uint64_t i) {
+		::memcpy(longKey.data() + 512, &i, sizeof(i));
+		return core::hashBytes(core::Span<const std::byte>{longKey});
+	});
+}
+
+int main()
+{
+	core::Mallocator mallocator;
+
+	benchThroughput(&mallocator);
+	benchIntegers();
+	reportQuality(&mallocator);
+
+	return EXIT_SUCCESS;
+}
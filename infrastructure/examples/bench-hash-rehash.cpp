@@ -0,0 +1,94 @@
+#include <core/Array.h>
+#include <core/Hash.h>
+#include <core/Mallocator.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// inserts the keys one at a time and prints the latency distribution of a single insert, the tail is dominated by the
+// inserts which trigger a rehash
+void reportInsertLatency(core::Allocator* allocator, size_t count, bool incremental)
+{
+	core::Array<uint64_t> latencies{allocator};
+	latencies.reserve(count);
+
+	core::Map<uint64_t, uint64_t> map{allocator};
+	map.setIncrementalRehash(incremental);
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto key = i * 0x9E3779B97F4A7C15ULL;
+		auto start = std::chrono::steady_clock::now();
+		map.insert(key, i);
+		auto end = std::chrono::steady_clock::now();
+		latencies.push(uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+	}
+	ankerl::nanobench::doNotOptimizeAway(map);
+
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double p) { return latencies[size_t(double(latencies.count() - 1) * p)]; };
+	::printf(
+		"%-12s %9zu inserts: p50 %6llu ns, p99 %6llu ns, p99.9 %6llu ns, max %10llu ns\n",
+		incremental ? "incremental" : "stop the world",
+		count,
+		(unsigned long long)percentile(0.5),
+		(unsigned long long)percentile(0.99),
+		(unsigned long long)percentile(0.999),
+		(unsigned long long)latencies[latencies.count() - 1]);
+}
+
+void benchThroughput(core::Allocator* allocator, size_t count)
+{
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::Map rehash modes").unit("op").batch(count).epochs(1).minEpochIterations(1);
+
+	for (bool incremental: {false, true})
+	{
+		const char* mode = incremental ? "incremental" : "stop the world";
+		bench.run(std::string{"insert "} + mode, [&] {
+			core::Map<uint64_t, uint64_t> map{allocator};
+			map.setIncrementalRehash(incremental);
+			for (size_t i = 0; i < count; ++i)
+			{
+				map.insert(i * 0x9E3779B97F4A7C15ULL, i);
+			}
+			ankerl::nanobench::doNotOptimizeAway(map);
+		});
+
+		core::Map<uint64_t, uint64_t> map{allocator};
+		map.setIncrementalRehash(incremental);
+		bench.run(std::string{"insert and lookup "} + mode, [&] {
+			uint64_t sum = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto key = i * 0x9E3779B97F4A7C15ULL;
+				map.insert(key, i);
+				sum += map.lookup(key)->value;
+			}
+			ankerl::nanobench::doNotOptimizeAway(sum);
+		});
+	}
+}
+
+// usage: bench-hash-rehash [entries count], the default is 4M
+int main(int argc, char** argv)
+{
+	core::Mallocator mallocator;
+
+	size_t count = 4'000'000;
+	if (argc > 1)
+	{
+		count = std::strtoull(argv[1], nullptr, 10);
+	}
+
+	reportInsertLatency(&mallocator, count, false);
+	reportInsertLatency(&mallocator, count, true);
+	benchThroughput(&mallocator, count);
+
+	return EXIT_SUCCESS;
+}
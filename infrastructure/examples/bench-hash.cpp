@@ -0,0 +1,227 @@
+#include <core/Array.h>
+#include <core/Hash.h>
+#include <core/Mallocator.h>
+#include <core/String.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+
+// returns the keys in a shuffled order so that the lookups don't walk the table sequentially
+core::Array<uint64_t> shuffledKeys(core::Allocator* allocator, size_t count, uint64_t seed)
+{
+	core::Array<uint64_t> keys{allocator};
+	keys.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		keys.push(i * 0x9E3779B97F4A7C15ULL);
+	}
+
+	ankerl::nanobench::Rng rng{seed};
+	for (size_t i = count; i > 1; --i)
+	{
+		auto j = rng.bounded(uint32_t(i));
+		std::swap(keys[i - 1], keys[j]);
+	}
+	return keys;
+}
+
+void benchSize(ankerl::nanobench::Bench& bench, core::Allocator* allocator, size_t count)
+{
+	auto keys = shuffledKeys(allocator, count, 42);
+	auto missingKeys = shuffledKeys(allocator, count, 43);
+	for (auto& key: missingKeys)
+	{
+		key += 1;
+	}
+
+	auto suffix = " " + std::to_string(count);
+	bench.batch(count);
+
+	bench.run("core::Map insert" + suffix, [&] {
+		core::Map<uint64_t, uint64_t> map{allocator};
+		for (auto key: keys)
+		{
+			map.insert(key, key);
+		}
+		ankerl::nanobench::doNotOptimizeAway(map);
+	});
+
+	bench.run("std::unordered_map insert" + suffix, [&] {
+		std::unordered_map<uint64_t, uint64_t> map;
+		for (auto key: keys)
+		{
+			map.emplace(key, key);
+		}
+		ankerl::nanobench::doNotOptimizeAway(map);
+	});
+
+	core::Map<uint64_t, uint64_t> map{allocator};
+	std::unordered_map<uint64_t, uint64_t> stdMap;
+	for (auto key: keys)
+	{
+		map.insert(key, key);
+		stdMap.emplace(key, key);
+	}
+
+	bench.run("core::Map lookup hit" + suffix, [&] {
+		uint64_t sum = 0;
+		for (auto key: keys)
+		{
+			sum += map.lookup(key)->value;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("std::unordered_map lookup hit" + suffix, [&] {
+		uint64_t sum = 0;
+		for (auto key: keys)
+		{
+			sum += stdMap.find(key)->second;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("core::Map lookup miss" + suffix, [&] {
+		size_t found = 0;
+		for (auto key: missingKeys)
+		{
+			found += map.lookup(key) != map.end();
+		}
+		ankerl::nanobench::doNotOptimizeAway(found);
+	});
+
+	bench.run("std::unordered_map lookup miss" + suffix, [&] {
+		size_t found = 0;
+		for (auto key: missingKeys)
+		{
+			found += stdMap.find(key) != stdMap.end();
+		}
+		ankerl::nanobench::doNotOptimizeAway(found);
+	});
+
+	// each run removes half of the keys then puts them back
+	bench.run("core::Map remove and reinsert" + suffix, [&] {
+		for (size_t i = 0; i < count; i += 2)
+		{
+			map.remove(keys[i]);
+		}
+		for (size_t i = 0; i < count; i += 2)
+		{
+			map.insert(keys[i], keys[i]);
+		}
+	});
+
+	bench.run("std::unordered_map remove and reinsert" + suffix, [&] {
+		for (size_t i = 0; i < count; i += 2)
+		{
+			stdMap.erase(keys[i]);
+		}
+		for (size_t i = 0; i < count; i += 2)
+		{
+			stdMap.emplace(keys[i], keys[i]);
+		}
+	});
+}
+
+// looks up string keys with views into a bigger buffer like a parser would, the keys are longer than the small string
+// optimization so converting the view to a String allocates
+void benchStringKeys(core::Allocator* allocator)
+{
+	constexpr size_t COUNT = 10000;
+	core::Map<core::String, uint64_t> map{allocator};
+	core::String text{allocator};
+	core::Array<core::StringView> views{allocator};
+	for (size_t i = 0; i < COUNT; ++i)
+	{
+		auto key = core::strf(allocator, "https://example.com/api/v1/accounts/{}/settings"_sv, i);
+		map.insert(key, i);
+		text.push(key);
+	}
+	for (size_t i = 0, offset = 0; i < COUNT; ++i)
+	{
+		auto end = text.find("/settings"_sv, offset) + 9;
+		views.push(core::StringView{text}.slice(offset, end));
+		offset = end;
+	}
+
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::Map<String> lookup").unit("op").batch(COUNT).relative(true).performanceCounters(true);
+
+	bench.run("lookup String{view}", [&] {
+		uint64_t sum = 0;
+		for (auto view: views)
+		{
+			sum += map.lookup(core::String{view, allocator})->value;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("lookup view", [&] {
+		uint64_t sum = 0;
+		for (auto view: views)
+		{
+			sum += map.lookup(view)->value;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	core::Array<size_t> hashes{allocator};
+	for (auto view: views)
+	{
+		hashes.push(core::Hash<core::String>{}(view, map.seed().value()));
+	}
+	bench.run("lookupWithHash view", [&] {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < COUNT; ++i)
+		{
+			sum += map.lookupWithHash(views[i], hashes[i])->value;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("insert existing String{view}", [&] {
+		for (auto view: views)
+		{
+			map.insert(core::String{view, allocator}, uint64_t(0));
+		}
+	});
+
+	bench.run("insert existing view", [&] {
+		for (auto view: views)
+		{
+			map.insert(view, uint64_t(0));
+		}
+	});
+}
+
+// usage: bench-hash [max entries count], the default max is 10M since bigger tables take a long time to build
+int main(int argc, char** argv)
+{
+	core::Mallocator mallocator;
+
+	size_t maxCount = 10'000'000;
+	if (argc > 1)
+	{
+		maxCount = std::strtoull(argv[1], nullptr, 10);
+	}
+
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::Map vs std::unordered_map").unit("op").performanceCounters(true);
+
+	for (size_t count = 1000; count <= maxCount; count *= 10)
+	{
+		if (count >= 1'000'000)
+		{
+			bench.epochs(1).minEpochIterations(1);
+		}
+		benchSize(bench, &mallocator, count);
+	}
+
+	benchStringKeys(&mallocator);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#include <core/Rune.h>
+#include <core/StringView.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <string>
+
+// the per byte comparison which StringView::equalsIgnoreCase used before, every byte goes through utf8proc
+bool runeEqualsIgnoreCase(core::StringView a, core::StringView b)
+{
+	if (a.count() != b.count())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < a.count(); ++i)
+	{
+		if (core::Rune::decode(a.data() + i).lower() != core::Rune::decode(b.data() + i).lower())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// the per byte search which StringView::findIgnoreCase used for short haystacks, the Rabin-Karp hash it used for
+// longer ones folded every byte the same way
+size_t runeFindIgnoreCase(core::StringView self, core::StringView target)
+{
+	for (size_t i = 0; i + target.count() <= self.count(); ++i)
+	{
+		if (runeEqualsIgnoreCase(self.slice(i, i + target.count()), target))
+		{
+			return i;
+		}
+	}
+	return SIZE_MAX;
+}
+
+// the headers of a websocket handshake request as browsers send them
+const core::StringView HEADERS[][2] = {
+	{"Host"_sv, "server.example.com"_sv},
+	{"User-Agent"_sv, "Mozilla/5.0 (X11; Linux x86_64; rv:124.0) Gecko/20100101 Firefox/124.0"_sv},
+	{"Accept"_sv, "*/*"_sv},
+	{"Accept-Language"_sv, "en-US,en;q=0.5"_sv},
+	{"Accept-Encoding"_sv, "gzip, deflate, br"_sv},
+	{"Sec-WebSocket-Version"_sv, "13"_sv},
+	{"Origin"_sv, "https://example.com"_sv},
+	{"Sec-WebSocket-Extensions"_sv, "permessage-deflate"_sv},
+	{"Sec-WebSocket-Key"_sv, "dGhlIHNhbXBsZSBub25jZQ=="_sv},
+	{"Connection"_sv, "keep-alive, Upgrade"_sv},
+	{"Pragma"_sv, "no-cache"_sv},
+	{"Cache-Control"_sv, "no-cache"_sv},
+	{"Upgrade"_sv, "websocket"_sv},
+};
+
+// does the header matching of ws::Handshake::read with the given comparison functions
+template <typename TEquals, typename TFind>
+size_t matchHandshake(TEquals&& equals, TFind&& find)
+{
+	size_t matched = 0;
+	for (const auto& [name, value]: HEADERS)
+	{
+		if (equals(name, "upgrade"_sv))
+		{
+			matched += equals(value, "websocket"_sv);
+		}
+		else if (equals(name, "sec-websocket-version"_sv))
+		{
+			matched += equals(value, "13"_sv);
+		}
+		else if (equals(name, "connection"_sv))
+		{
+			matched += find(value, "upgrade"_sv) != SIZE_MAX;
+		}
+		else if (equals(name, "sec-websocket-key"_sv))
+		{
+			matched += 1;
+		}
+	}
+	return matched;
+}
+
+int main()
+{
+	{
+		ankerl::nanobench::Bench bench{};
+		bench.title("match the headers of a websocket handshake");
+		bench.relative(true).unit("handshake");
+
+		bench.run("per rune utf8proc", [&] {
+			ankerl::nanobench::doNotOptimizeAway(matchHandshake(runeEqualsIgnoreCase, runeFindIgnoreCase));
+		});
+		bench.run("core::StringView", [&] {
+			ankerl::nanobench::doNotOptimizeAway(matchHandshake(
+				[](core::StringView a, core::StringView b) { return a.equalsIgnoreCase(b); },
+				[](core::StringView a, core::StringView b) { return a.findIgnoreCase(b); }));
+		});
+	}
+
+	for (size_t count: {16, 64, 1024})
+	{
+		std::string lower, upper;
+		for (size_t i = 0; i < count; ++i)
+		{
+			lower.push_back(char('a' + i % 26));
+			upper.push_back(char('A' + i % 26));
+		}
+		core::StringView a{lower.data(), lower.size()};
+		core::StringView b{upper.data(), upper.size()};
+
+		ankerl::nanobench::Bench bench{};
+		bench.title("equalsIgnoreCase of " + std::to_string(count) + " bytes");
+		bench.relative(true).unit("byte").batch(count);
+
+		bench.run("per rune utf8proc", [&] { ankerl::nanobench::doNotOptimizeAway(runeEqualsIgnoreCase(a, b)); });
+		bench.run("core::StringView", [&] { ankerl::nanobench::doNotOptimizeAway(a.equalsIgnoreCase(b)); });
+	}
+	return EXIT_SUCCESS;
+}
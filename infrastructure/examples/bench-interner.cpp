@@ -0,0 +1,245 @@
+#include <core/Interner.h>
+#include <core/Mallocator.h>
+#include <core/MemoryStream.h>
+#include <core/Msgpack.h>
+#include <core/String.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <iterator>
+
+static const core::StringView KEYWORDS[] = {
+	"boolean"_sv,
+	"class"_sv,
+	"else"_sv,
+	"false"_sv,
+	"if"_sv,
+	"int"_sv,
+	"String"_sv,
+	"length"_sv,
+	"main"_sv,
+	"new"_sv,
+	"public"_sv,
+	"return"_sv,
+	"static"_sv,
+	"this"_sv,
+	"true"_sv,
+	"void"_sv,
+	"while"_sv,
+};
+
+// a big MiniJava like program with a few hundred distinct identifiers which repeat a lot like in real code
+core::String makeProgram(core::Allocator* allocator, size_t classesCount)
+{
+	core::String res{allocator};
+	for (size_t i = 0; i < classesCount; ++i)
+	{
+		res.push(core::strf(
+			allocator,
+			"class Class{} {{\n"
+			"\tpublic int method{}(int count, boolean flag) {{\n"
+			"\t\tint index;\n"
+			"\t\tint[] values;\n"
+			"\t\tindex = 0;\n"
+			"\t\tvalues = new int[count];\n"
+			"\t\twhile (index < values.length) {{\n"
+			"\t\t\tif (flag) values[index] = index * {}; else values[index] = this.helper{}(index);\n"
+			"\t\t\tindex = index + 1;\n"
+			"\t\t}}\n"
+			"\t\treturn values[0];\n"
+			"\t}}\n"
+			"}}\n"_sv,
+			i % 97,
+			i % 13,
+			i,
+			i % 31));
+	}
+	return res;
+}
+
+bool isIdBegin(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+bool isIdPart(char c)
+{
+	return isIdBegin(c) || (c >= '0' && c <= '9');
+}
+
+// calls f(StringView) for each identifier or keyword in the program like the minijava Scanner does
+template <typename F>
+void scanIds(core::StringView program, F&& f)
+{
+	for (size_t i = 0; i < program.count();)
+	{
+		if (isIdBegin(program[i]) == false)
+		{
+			++i;
+			continue;
+		}
+		auto begin = i;
+		while (i < program.count() && isIdPart(program[i]))
+		{
+			++i;
+		}
+		f(program.slice(begin, i));
+	}
+}
+
+int main()
+{
+	core::Mallocator mallocator;
+
+	auto program = makeProgram(&mallocator, 20000);
+	size_t idsCount = 0;
+	scanIds(program, [&](core::StringView) { ++idsCount; });
+
+	{
+		ankerl::nanobench::Bench bench{};
+		bench.title("scan a " + std::to_string(program.count() / 1024) + " KiB MiniJava program");
+		bench.unit("identifier").batch(idsCount).relative(true);
+
+		// what the scanner did before, keywords are compared one by one and identifiers stay as views
+		bench.run("compare keywords", [&] {
+			size_t keywords = 0;
+			scanIds(program, [&](core::StringView id) {
+				for (auto keyword: KEYWORDS)
+				{
+					if (id == keyword)
+					{
+						++keywords;
+						break;
+					}
+				}
+			});
+			ankerl::nanobench::doNotOptimizeAway(keywords);
+		});
+
+		// a symbol table which owns a copy of each identifier, what a later stage would build without an interner
+		bench.run("core::Map<core::String> symbol table", [&] {
+			core::Map<core::String, uint32_t> table{&mallocator};
+			size_t keywords = 0;
+			for (uint32_t i = 0; i < std::size(KEYWORDS); ++i)
+			{
+				table.insert(core::String{KEYWORDS[i], &mallocator}, i);
+			}
+			scanIds(program, [&](core::StringView id) {
+				auto it = table.lookup(id);
+				if (it == table.end())
+				{
+					table.insert(core::String{id, &mallocator}, uint32_t(table.count()));
+				}
+				else if (it->value < std::size(KEYWORDS))
+				{
+					++keywords;
+				}
+			});
+			ankerl::nanobench::doNotOptimizeAway(keywords);
+		});
+
+		bench.run("core::Interner", [&] {
+			core::Interner interner{&mallocator};
+			auto first = interner.intern(KEYWORDS[0]);
+			for (auto keyword: KEYWORDS)
+			{
+				interner.intern(keyword);
+			}
+			size_t keywords = 0;
+			scanIds(program, [&](core::StringView id) {
+				auto symbol = interner.intern(id);
+				keywords += (symbol.id() - first.id()) < std::size(KEYWORDS);
+			});
+			ankerl::nanobench::doNotOptimizeAway(keywords);
+		});
+
+		bench.run("core::ConcurrentInterner", [&] {
+			core::ConcurrentInterner interner{&mallocator};
+			size_t keywords = 0;
+			scanIds(program, [&](core::StringView id) { keywords += interner.intern(id).id() & 1; });
+			ankerl::nanobench::doNotOptimizeAway(keywords);
+		});
+	}
+
+	// a stream of records which all use the same few keys, some of them are too long to be stored inline in a String
+	constexpr size_t RECORDS_COUNT = 10000;
+	static const core::StringView FIELDS[] = {
+		"id"_sv,
+		"name"_sv,
+		"created_at"_sv,
+		"status"_sv,
+		"last_modified_by_user_identifier"_sv,
+		"description_length_in_characters"_sv,
+		"number_of_attached_documents"_sv,
+		"estimated_completion_timestamp"_sv,
+	};
+	core::MemoryStream encoded{&mallocator};
+	{
+		core::msgpack::Writer writer{&encoded, &mallocator};
+		core::Map<core::String, uint64_t> record{&mallocator};
+		for (uint64_t i = 0; i < std::size(FIELDS); ++i)
+		{
+			record.insert(core::String{FIELDS[i], &mallocator}, i);
+		}
+		for (size_t i = 0; i < RECORDS_COUNT; ++i)
+		{
+			if (auto err = core::msgpack::msgpack(writer, record))
+			{
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	{
+		ankerl::nanobench::Bench bench{};
+		bench.title("decode msgpack maps with repeated keys").unit("map").batch(RECORDS_COUNT).relative(true);
+
+		bench.run("core::Map<core::String, uint64_t>", [&] {
+			encoded.seek(0, core::Stream::SEEK_MODE_BEGIN);
+			core::msgpack::Reader reader{&encoded, &mallocator};
+			uint64_t sum = 0;
+			for (size_t i = 0; i < RECORDS_COUNT; ++i)
+			{
+				core::Map<core::String, uint64_t> record{&mallocator};
+				if (core::msgpack::msgpack(reader, record))
+				{
+					std::abort();
+				}
+				for (auto field: FIELDS)
+				{
+					sum += record.lookup(field)->value;
+				}
+			}
+			ankerl::nanobench::doNotOptimizeAway(sum);
+		});
+
+		// the reader of the records interns the fields it's interested in once
+		core::Interner interner{&mallocator};
+		core::Symbol fields[std::size(FIELDS)];
+		for (size_t i = 0; i < std::size(FIELDS); ++i)
+		{
+			fields[i] = interner.intern(FIELDS[i]);
+		}
+		bench.run("core::Map<core::Symbol, uint64_t>", [&] {
+			encoded.seek(0, core::Stream::SEEK_MODE_BEGIN);
+			core::msgpack::Reader reader{&encoded, &mallocator, &interner};
+			uint64_t sum = 0;
+			for (size_t i = 0; i < RECORDS_COUNT; ++i)
+			{
+				core::Map<core::Symbol, uint64_t> record{&mallocator};
+				if (core::msgpack::msgpack(reader, record))
+				{
+					std::abort();
+				}
+				for (auto field: fields)
+				{
+					sum += record.lookup(field)->value;
+				}
+			}
+			ankerl::nanobench::doNotOptimizeAway(sum);
+		});
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include <core/Number.h>
+#include <core/StringView.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <fmt/format.h>
+
+#include <charconv>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr size_t NUMBERS_COUNT = 1000;
+
+// numbers as they show up in the repo, ports and amounts are short and a few are as long as a uint64_t gets
+std::vector<std::string> generateInts(std::mt19937_64& gen)
+{
+	std::vector<std::string> res;
+	for (size_t i = 0; i < NUMBERS_COUNT; ++i)
+	{
+		auto value = gen();
+		switch (i % 4)
+		{
+		case 0:
+			value %= 65536;
+			break;
+		case 1:
+			value %= 1000000;
+			break;
+		case 2:
+			value %= 10000000000ULL;
+			break;
+		default:
+			break;
+		}
+		res.push_back(std::to_string(value));
+	}
+	return res;
+}
+
+// prices with two decimal digits and full precision doubles in the shortest form
+std::vector<std::string> generateFloats(std::mt19937_64& gen, bool prices)
+{
+	std::vector<std::string> res;
+	for (size_t i = 0; i < NUMBERS_COUNT; ++i)
+	{
+		if (prices)
+		{
+			res.push_back(fmt::format("{}.{:02}", gen() % 100000, gen() % 100));
+		}
+		else
+		{
+			std::uniform_real_distribution<double> dist{-1e6, 1e6};
+			res.push_back(fmt::format("{}", dist(gen)));
+		}
+	}
+	return res;
+}
+
+void benchParseInts(const std::vector<std::string>& numbers)
+{
+	ankerl::nanobench::Bench bench{};
+	bench.title("parse uint64").unit("number").batch(numbers.size()).relative(true);
+
+	bench.run("strtoul", [&] {
+		uint64_t sum = 0;
+		for (const auto& str: numbers)
+		{
+			char* end = nullptr;
+			sum += ::strtoull(str.c_str(), &end, 10);
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("std::from_chars", [&] {
+		uint64_t sum = 0;
+		for (const auto& str: numbers)
+		{
+			uint64_t value = 0;
+			std::from_chars(str.data(), str.data() + str.size(), value);
+			sum += value;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("core::parseUint", [&] {
+		uint64_t sum = 0;
+		for (const auto& str: numbers)
+		{
+			sum += core::parseUint(core::StringView{str.data(), str.size()}).value();
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+}
+
+void benchParseFloats(const std::string& name, const std::vector<std::string>& numbers)
+{
+	ankerl::nanobench::Bench bench{};
+	bench.title("parse " + name).unit("number").batch(numbers.size()).relative(true);
+
+	bench.run("strtod", [&] {
+		double sum = 0;
+		for (const auto& str: numbers)
+		{
+			sum += ::strtod(str.c_str(), nullptr);
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("std::from_chars", [&] {
+		double sum = 0;
+		for (const auto& str: numbers)
+		{
+			double value = 0;
+			std::from_chars(str.data(), str.data() + str.size(), value);
+			sum += value;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+
+	bench.run("core::parseFloat", [&] {
+		double sum = 0;
+		for (const auto& str: numbers)
+		{
+			sum += core::parseFloat(core::StringView{str.data(), str.size()}).value();
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+}
+
+template <typename T, typename TFormat>
+void benchFormat(const std::string& name, const std::vector<T>& numbers, TFormat&& format)
+{
+	ankerl::nanobench::Bench bench{};
+	bench.title("format " + name).unit("number").batch(numbers.size()).relative(true);
+
+	char buffer[64];
+	bench.run("fmt::format_to with a runtime format", [&] {
+		size_t size = 0;
+		for (auto value: numbers)
+		{
+			size += fmt::format_to(buffer, fmt::runtime("{}"), value) - buffer;
+		}
+		ankerl::nanobench::doNotOptimizeAway(size);
+	});
+
+	bench.run("std::to_chars", [&] {
+		size_t size = 0;
+		for (auto value: numbers)
+		{
+			size += std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer;
+		}
+		ankerl::nanobench::doNotOptimizeAway(size);
+	});
+
+	bench.run("core::format", [&] {
+		size_t size = 0;
+		for (auto value: numbers)
+		{
+			size += format(value, buffer);
+		}
+		ankerl::nanobench::doNotOptimizeAway(size);
+	});
+}
+
+int main(int argc, char** argv)
+{
+	std::mt19937_64 gen{42};
+
+	auto ints = generateInts(gen);
+	benchParseInts(ints);
+	benchParseFloats("prices", generateFloats(gen, true));
+	benchParseFloats("doubles", generateFloats(gen, false));
+
+	std::vector<int64_t> intValues;
+	for (const auto& str: ints)
+	{
+		intValues.push_back(int64_t(core::parseUint(core::StringView{str.data(), str.size()}).value() >> 1));
+	}
+	benchFormat("int64", intValues, [](int64_t value, char* out) { return core::formatInt(value, out); });
+
+	std::vector<double> floatValues;
+	for (const auto& str: generateFloats(gen, false))
+	{
+		floatValues.push_back(core::parseFloat(core::StringView{str.data(), str.size()}).value());
+	}
+	benchFormat("double", floatValues, [](double value, char* out) { return core::formatFloat(value, out); });
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include <core/File.h>
+#include <core/Mallocator.h>
+#include <core/ProfilingAllocator.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+constexpr size_t ALLOCATIONS_COUNT = 1024;
+
+void benchAllocFree(ankerl::nanobench::Bench& bench, const char* name, core::Allocator* allocator)
+{
+	ankerl::nanobench::Rng rng{42};
+	core::Span<std::byte> allocations[ALLOCATIONS_COUNT];
+	bench.run(name, [&] {
+		for (size_t i = 0; i < ALLOCATIONS_COUNT; ++i)
+		{
+			allocations[i] = allocator->alloc(16 + rng.bounded(1024), alignof(std::max_align_t));
+		}
+		for (size_t i = 0; i < ALLOCATIONS_COUNT; ++i)
+		{
+			allocator->free(allocations[i]);
+		}
+		ankerl::nanobench::doNotOptimizeAway(allocations);
+	});
+}
+
+int main(int argc, char** argv)
+{
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::ProfilingAllocator overhead")
+		.unit("alloc/free")
+		.batch(ALLOCATIONS_COUNT)
+		.relative(true)
+		.performanceCounters(true);
+
+	core::Mallocator mallocator;
+	benchAllocFree(bench, "Mallocator", &mallocator);
+
+	core::ProfilingAllocator defaultRate{&mallocator};
+	benchAllocFree(bench, "ProfilingAllocator default sample rate", &defaultRate);
+
+	core::ProfilingAllocator highRate{&mallocator, 16 * 1024};
+	benchAllocFree(bench, "ProfilingAllocator 16KB sample rate", &highRate);
+
+	core::ProfilingAllocator everything{&mallocator, 0};
+	benchAllocFree(bench, "ProfilingAllocator sample everything", &everything);
+
+	// the profile of the last run can be inspected with `pprof -http=: heap.pb`
+	if (argc > 1)
+	{
+		auto file = core::File::open(
+			&mallocator, core::StringView{argv[1]}, core::File::IO_MODE_WRITE, core::File::OPEN_MODE_CREATE_OVERWRITE);
+		if (file)
+		{
+			highRate.writePprof(file.get());
+		}
+	}
+	highRate.writeReport(core::File::STDOUT, 5);
+
+	return EXIT_SUCCESS;
+}
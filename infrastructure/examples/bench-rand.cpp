@@ -0,0 +1,75 @@
+#include <core/Rand.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+constexpr size_t FILL_SIZE = 1024 * 1024;
+
+int main(int argc, char** argv)
+{
+	ankerl::nanobench::Bench bench{};
+	bench.title("pick one of 8").unit("pick").relative(true);
+
+	// what Chan select used to do for every call
+	bench.run("std::random_device", [&] {
+		std::random_device device;
+		std::uniform_int_distribution<size_t> dist(0, 7);
+		ankerl::nanobench::doNotOptimizeAway(dist(device));
+	});
+
+	std::mt19937_64 mt{42};
+	bench.run("std::mt19937_64", [&] {
+		std::uniform_int_distribution<size_t> dist(0, 7);
+		ankerl::nanobench::doNotOptimizeAway(dist(mt));
+	});
+
+	bench.run("Rand::cryptoRand", [&] {
+		uint64_t value = 0;
+		core::Rand::cryptoRand(core::Span<std::byte>{reinterpret_cast<std::byte*>(&value), sizeof(value)});
+		ankerl::nanobench::doNotOptimizeAway(value % 8);
+	});
+
+	bench.run("FastRand::threadLocal().uniform", [&] {
+		ankerl::nanobench::doNotOptimizeAway(core::FastRand::threadLocal().uniform(8));
+	});
+
+	core::FastRand rand;
+	bench.run("FastRand::next", [&] { ankerl::nanobench::doNotOptimizeAway(rand.next()); });
+
+	std::vector<std::byte> bytes(FILL_SIZE);
+	core::Span<std::byte> span{bytes.data(), bytes.size()};
+
+	ankerl::nanobench::Bench fill{};
+	fill.title("fill 1 MiB").unit("byte").batch(FILL_SIZE).relative(true);
+	fill.run("std::mt19937_64", [&] {
+		for (size_t i = 0; i < FILL_SIZE; i += sizeof(uint64_t))
+		{
+			auto value = mt();
+			::memcpy(bytes.data() + i, &value, sizeof(value));
+		}
+		ankerl::nanobench::doNotOptimizeAway(bytes.data());
+	});
+	fill.run("Rand::cryptoRand", [&] {
+		core::Rand::cryptoRand(span);
+		ankerl::nanobench::doNotOptimizeAway(bytes.data());
+	});
+	fill.run("FastRand::next", [&] {
+		for (size_t i = 0; i < FILL_SIZE; i += sizeof(uint64_t))
+		{
+			auto value = rand.next();
+			::memcpy(bytes.data() + i, &value, sizeof(value));
+		}
+		ankerl::nanobench::doNotOptimizeAway(bytes.data());
+	});
+	fill.run("FastRand::fill", [&] {
+		rand.fill(span);
+		ankerl::nanobench::doNotOptimizeAway(bytes.data());
+	});
+
+	return EXIT_SUCCESS;
+}
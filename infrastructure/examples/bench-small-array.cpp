@@ -0,0 +1,54 @@
+#include <core/Array.h>
+#include <core/Mallocator.h>
+#include <core/SmallArray.h>
+#include <core/StringView.h>
+#include <core/Url.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+int main(int argc, char** argv)
+{
+	core::Mallocator mallocator;
+
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::SmallArray vs core::Array").relative(true).performanceCounters(true);
+
+	bench.run("Array push 4 elements", [&] {
+		core::Array<int> numbers{&mallocator};
+		for (int i = 0; i < 4; ++i)
+		{
+			numbers.push(i);
+		}
+		ankerl::nanobench::doNotOptimizeAway(numbers);
+	});
+
+	bench.run("SmallArray<int, 4> push 4 elements", [&] {
+		core::SmallArray<int, 4> numbers{&mallocator};
+		for (int i = 0; i < 4; ++i)
+		{
+			numbers.push(i);
+		}
+		ankerl::nanobench::doNotOptimizeAway(numbers);
+	});
+
+	auto path = "/home/user/projects/taha/infrastructure/core"_sv;
+
+	bench.run("StringView::split into Array", [&] {
+		auto parts = path.split("/"_sv, true, &mallocator);
+		ankerl::nanobench::doNotOptimizeAway(parts);
+	});
+
+	bench.run("StringView::split into SmallArray<StringView, 8>", [&] {
+		core::SmallArray<core::StringView, 8> parts{&mallocator};
+		path.split("/"_sv, true, parts);
+		ankerl::nanobench::doNotOptimizeAway(parts);
+	});
+
+	bench.run("Url::parse with query", [&] {
+		auto url = core::Url::parse("https://example.com/a/./b/../c?name=alice&limit=10&sort=asc"_sv, &mallocator);
+		ankerl::nanobench::doNotOptimizeAway(url);
+	});
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+#include <core/Array.h>
+#include <core/Mallocator.h>
+#include <core/SmallArray.h>
+#include <core/StringView.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+int main(int argc, char** argv)
+{
+	core::Mallocator mallocator;
+
+	auto response = "HTTP/1.1 101 Switching Protocols\r\n"
+					"Upgrade: websocket\r\n"
+					"Connection: Upgrade\r\n"
+					"Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n"
+					"Server: taha\r\n"
+					"Date: Mon, 19 Oct 2026 12:00:00 GMT\r\n"
+					"\r\n"_sv;
+
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::StringView split").relative(true).performanceCounters(true);
+
+	bench.run("HTTP header lines split into Array", [&] {
+		size_t headers = 0;
+		for (auto line: response.split("\r\n"_sv, true, &mallocator))
+		{
+			headers += line.count() > 0 && line.find(core::Rune{':'}, 0) != SIZE_MAX;
+		}
+		ankerl::nanobench::doNotOptimizeAway(headers);
+	});
+
+	bench.run("HTTP header lines split into SmallArray<StringView, 16>", [&] {
+		core::SmallArray<core::StringView, 16> lines{&mallocator};
+		response.split("\r\n"_sv, true, lines);
+		size_t headers = 0;
+		for (auto line: lines)
+		{
+			headers += line.count() > 0 && line.find(core::Rune{':'}, 0) != SIZE_MAX;
+		}
+		ankerl::nanobench::doNotOptimizeAway(headers);
+	});
+
+	bench.run("HTTP header lines lazy split", [&] {
+		size_t headers = 0;
+		for (auto line: response.split("\r\n"_sv, true))
+		{
+			headers += line.count() > 0 && line.find(core::Rune{':'}, 0) != SIZE_MAX;
+		}
+		ankerl::nanobench::doNotOptimizeAway(headers);
+	});
+
+	bench.run("HTTP header lines()", [&] {
+		size_t headers = 0;
+		for (auto line: response.lines())
+		{
+			headers += line.count() > 0 && line.find(core::Rune{':'}, 0) != SIZE_MAX;
+		}
+		ankerl::nanobench::doNotOptimizeAway(headers);
+	});
+
+	// a csv row where only the first fields are needed, the lazy split doesn't scan the rest of the row
+	auto row = "42,alice,alice@example.com,2026-10-19,active,admin,cairo,egypt,+20100000000,notes about the user,"
+			   "more notes,even more notes,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20"_sv;
+
+	ankerl::nanobench::Bench csv{};
+	csv.title("core::StringView csv first 2 fields").relative(true).performanceCounters(true);
+
+	csv.run("split into Array", [&] {
+		auto fields = row.split(","_sv, false, &mallocator);
+		ankerl::nanobench::doNotOptimizeAway(fields[1]);
+	});
+
+	csv.run("lazy split", [&] {
+		auto it = row.split(","_sv, false).begin();
+		++it;
+		ankerl::nanobench::doNotOptimizeAway(*it);
+	});
+
+	auto sentence = "  the quick brown fox\tjumps over\r\nthe lazy dog  "_sv;
+	ankerl::nanobench::Bench words{};
+	words.title("core::StringView words").relative(true).performanceCounters(true);
+
+	words.run("split on space into Array", [&] {
+		auto parts = sentence.split(" "_sv, true, &mallocator);
+		ankerl::nanobench::doNotOptimizeAway(parts.count());
+	});
+
+	words.run("fields()", [&] {
+		size_t count = 0;
+		for (auto field: sentence.fields())
+		{
+			count += field.count();
+		}
+		ankerl::nanobench::doNotOptimizeAway(count);
+	});
+
+	return EXIT_SUCCESS;
+}
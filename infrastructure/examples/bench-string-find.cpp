@@ -0,0 +1,126 @@
+#include <core/Mallocator.h>
+#include <core/String.h>
+#include <core/StringView.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <random>
+#include <string>
+#include <string_view>
+
+// the Rabin-Karp search which StringView::find used before
+size_t rabinKarpFind(std::string_view self, std::string_view target)
+{
+	constexpr uint32_t PRIME = 16777619;
+	if (target.size() > self.size())
+	{
+		return SIZE_MAX;
+	}
+
+	uint32_t hash = 0, pow = 1, h = 0;
+	for (auto c: target)
+	{
+		hash = hash * PRIME + uint32_t(c);
+	}
+	auto sq = PRIME;
+	for (size_t i = target.size(); i > 0; i >>= 1)
+	{
+		if ((i & 1) != 0)
+		{
+			pow *= sq;
+		}
+		sq *= sq;
+	}
+
+	for (size_t i = 0; i < target.size(); ++i)
+	{
+		h = h * PRIME + uint32_t(self[i]);
+	}
+	if (h == hash && self.substr(0, target.size()) == target)
+	{
+		return 0;
+	}
+	for (size_t i = target.size(); i < self.size();)
+	{
+		h *= PRIME;
+		h += uint32_t(self[i]);
+		h -= pow * uint32_t(self[i - target.size()]);
+		i += 1;
+		if (h == hash && self.substr(i - target.size(), target.size()) == target)
+		{
+			return i - target.size();
+		}
+	}
+	return SIZE_MAX;
+}
+
+// english like text where the needle only shows up at the very end (or the very beginning for findLast) so each
+// search scans the whole haystack
+std::string makeHaystack(size_t count, std::string_view needle, bool atEnd)
+{
+	static const char* WORDS[] = {"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "host", "content"};
+	std::mt19937 gen{42};
+	std::string res;
+	while (res.size() + needle.size() < count)
+	{
+		res += WORDS[gen() % std::size(WORDS)];
+		res += gen() % 8 == 0 ? "\r\n" : " ";
+	}
+	res.resize(count - needle.size(), ' ');
+	return atEnd ? res + std::string{needle} : std::string{needle} + res;
+}
+
+int main()
+{
+	std::string longNeedle;
+	for (int i = 0; i < 20; ++i)
+	{
+		longNeedle += "content-length: 100\r\n";
+	}
+
+	// a split delimiter, the end of an http header, a header name and longer needles
+	std::string needles[] = {
+		"|",
+		"\r\n\r\n",
+		", ",
+		"sec-websocket-key",
+		"a longer needle of about sixty four bytes for the vector filter",
+		longNeedle,
+	};
+
+	for (size_t haystackCount: {64, 4 * 1024, 1024 * 1024})
+	{
+		for (const auto& needle: needles)
+		{
+			if (needle.size() > haystackCount)
+			{
+				continue;
+			}
+			auto haystack = makeHaystack(haystackCount, needle, true);
+			auto reversed = makeHaystack(haystackCount, needle, false);
+			core::StringView view{haystack.data(), haystack.size()};
+			core::StringView reversedView{reversed.data(), reversed.size()};
+			core::StringView target{needle.data(), needle.size()};
+
+			ankerl::nanobench::Bench bench{};
+			bench.title(
+				"find a " + std::to_string(needle.size()) + " bytes needle in " + std::to_string(haystackCount) +
+				" bytes");
+			bench.relative(true).unit("byte").batch(haystackCount);
+
+			bench.run("Rabin-Karp", [&] { ankerl::nanobench::doNotOptimizeAway(rabinKarpFind(haystack, needle)); });
+			bench.run("std::string_view::find", [&] {
+				ankerl::nanobench::doNotOptimizeAway(std::string_view{haystack}.find(needle));
+			});
+			bench.run("core::StringView::find", [&] { ankerl::nanobench::doNotOptimizeAway(view.find(target)); });
+			bench.run("std::string_view::rfind", [&] {
+				ankerl::nanobench::doNotOptimizeAway(std::string_view{reversed}.rfind(needle));
+			});
+			bench.run("core::StringView::findLast", [&] {
+				ankerl::nanobench::doNotOptimizeAway(reversedView.findLast(target));
+			});
+		}
+	}
+	return EXIT_SUCCESS;
+}
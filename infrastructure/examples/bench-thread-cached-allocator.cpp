@@ -0,0 +1,74 @@
+#include <core/Array.h>
+#include <core/FastLeak.h>
+#include <core/Mallocator.h>
+#include <core/Thread.h>
+#include <core/ThreadCachedAllocator.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <string>
+
+constexpr size_t ALLOCATIONS_COUNT = 128;
+
+void allocFree(core::Allocator* allocator, ankerl::nanobench::Rng& rng, core::Span<std::byte>* allocations)
+{
+	for (size_t i = 0; i < ALLOCATIONS_COUNT; ++i)
+	{
+		allocations[i] = allocator->alloc(16 + rng.bounded(1024), alignof(std::max_align_t));
+	}
+	for (size_t i = 0; i < ALLOCATIONS_COUNT; ++i)
+	{
+		allocator->free(allocations[i]);
+	}
+	ankerl::nanobench::doNotOptimizeAway(allocations);
+}
+
+void benchAllocFree(ankerl::nanobench::Bench& bench, const char* name, core::Allocator* allocator, size_t threadsCount)
+{
+	core::Mallocator mallocator;
+	bench.run(name, [&] {
+		core::Array<core::Thread> threads{&mallocator};
+		for (size_t i = 0; i < threadsCount; ++i)
+		{
+			threads.push(core::Thread{&mallocator, [allocator, i] {
+				ankerl::nanobench::Rng rng{42 + i};
+				core::Span<std::byte> allocations[ALLOCATIONS_COUNT];
+				for (size_t j = 0; j < 512; ++j)
+				{
+					allocFree(allocator, rng, allocations);
+				}
+			}});
+		}
+		for (auto& thread: threads)
+		{
+			thread.join();
+		}
+	});
+}
+
+int main()
+{
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::ThreadCachedAllocator").unit("alloc/free").relative(true).performanceCounters(true);
+
+	for (size_t threadsCount: {1, 4, 16})
+	{
+		bench.batch(ALLOCATIONS_COUNT * 512 * threadsCount);
+		auto suffix = std::to_string(threadsCount) + " threads";
+
+		core::Mallocator mallocator;
+		benchAllocFree(bench, ("Mallocator " + suffix).c_str(), &mallocator, threadsCount);
+
+		core::FastLeak fastLeak;
+		benchAllocFree(bench, ("FastLeak " + suffix).c_str(), &fastLeak, threadsCount);
+
+		core::ThreadCachedAllocator cachedMallocator{&mallocator};
+		benchAllocFree(bench, ("ThreadCachedAllocator(Mallocator) " + suffix).c_str(), &cachedMallocator, threadsCount);
+
+		core::ThreadCachedAllocator cachedFastLeak{&fastLeak};
+		benchAllocFree(bench, ("ThreadCachedAllocator(FastLeak) " + suffix).c_str(), &cachedFastLeak, threadsCount);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+#include <core/Mallocator.h>
+#include <core/ProfilingAllocator.h>
+#include <core/Url.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+
+// the urls of test_url.cpp plus a couple of the ones we connect to
+const core::StringView URLS[] = {
+	"http://www.google.com"_sv,
+	"http://www.google.com/"_sv,
+	"http://www.google.com/file%20one%26two"_sv,
+	"ftp://webmaster@www.google.com/"_sv,
+	"ftp://john%20doe@www.google.com/"_sv,
+	"http://www.google.com/?"_sv,
+	"http://www.google.com/?foo=bar?"_sv,
+	"http://www.google.com/?q=go%20language"_sv,
+	"mailto:webmaster@golang.org"_sv,
+	"http://[2b01:e34:ef40:7730:8e70:5aff:fefe:edac]:8080/foo"_sv,
+	"http://www.google.com/?#id_token=abcd%20efh"_sv,
+	"/path/to/file"_sv,
+	"filename"_sv,
+	"https://users.moustapha.xyz/account/login"_sv,
+	"ws://127.0.0.1:9001/runCase?casetuple=1.1.1&agent=taha2"_sv,
+	"https://user@example.com:8080/api/v1/accounts?name=alice&limit=10#top"_sv,
+};
+constexpr size_t URLS_COUNT = sizeof(URLS) / sizeof(*URLS);
+
+int main(int argc, char** argv)
+{
+	core::Mallocator mallocator;
+	// samples every allocation, it's used to report the number of heap allocations per url
+	core::ProfilingAllocator counter{&mallocator, 0};
+
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::Url parsing").unit("url").batch(URLS_COUNT).performanceCounters(true);
+
+	bench.run("Url::parse", [&] {
+		for (auto str: URLS)
+		{
+			auto url = core::Url::parse(str, &mallocator);
+			ankerl::nanobench::doNotOptimizeAway(url);
+		}
+	});
+
+	bench.run("UrlView::parse", [&] {
+		for (auto str: URLS)
+		{
+			auto url = core::UrlView::parse(str);
+			ankerl::nanobench::doNotOptimizeAway(url);
+		}
+	});
+
+	// what a request handler does, it needs the decoded path and a query parameter
+	bench.run("UrlView::parse + decode path + query find", [&] {
+		for (auto str: URLS)
+		{
+			auto url = core::UrlView::parse(str);
+			char path[core::UrlView::MAX_COUNT];
+			auto count = core::UrlView::decode(url.value().path(), core::Span<char>{path, sizeof(path)});
+			auto it = url.value().query().find("q"_sv);
+			ankerl::nanobench::doNotOptimizeAway(count);
+			ankerl::nanobench::doNotOptimizeAway(it);
+		}
+	});
+
+	for (auto str: URLS)
+	{
+		auto url = core::Url::parse(str, &counter);
+		ankerl::nanobench::doNotOptimizeAway(url);
+	}
+	auto urlAllocations = counter.stats().allocatedCount;
+	for (auto str: URLS)
+	{
+		auto url = core::UrlView::parse(str);
+		ankerl::nanobench::doNotOptimizeAway(url);
+	}
+	fmt::print(
+		"{} urls allocated {} times on the heap with Url::parse and {} times with UrlView::parse\n",
+		URLS_COUNT,
+		urlAllocations,
+		counter.stats().allocatedCount - urlAllocations);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+#include <core/Rune.h>
+#include <core/StringView.h>
+#include <core/Utf8.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <utf8proc.h>
+
+#include <string>
+
+// the validation which StringView::isValidUtf8 used before, one sequence at a time with the lead byte table of go's
+// unicode/utf8
+bool tableValidate(const char* ptr, size_t count)
+{
+	auto bytes = reinterpret_cast<const uint8_t*>(ptr);
+	for (size_t i = 0; i < count;)
+	{
+		auto byte = bytes[i];
+		if (byte < 0x80)
+		{
+			++i;
+			continue;
+		}
+
+		size_t size = byte >= 0xf0 ? 4 : byte >= 0xe0 ? 3 : byte >= 0xc2 ? 2 : 0;
+		if (size == 0 || byte > 0xf4 || i + size > count)
+		{
+			return false;
+		}
+		auto lo = byte == 0xe0 ? 0xa0 : byte == 0xf0 ? 0x90 : 0x80;
+		auto hi = byte == 0xed ? 0x9f : byte == 0xf4 ? 0x8f : 0xbf;
+		if (bytes[i + 1] < lo || bytes[i + 1] > hi)
+		{
+			return false;
+		}
+		for (size_t j = 2; j < size; ++j)
+		{
+			if ((bytes[i + j] & 0xc0) != 0x80)
+			{
+				return false;
+			}
+		}
+		i += size;
+	}
+	return true;
+}
+
+// the byte at a time loop which Rune::count used before
+size_t byteCountRunes(const char* begin, const char* end)
+{
+	size_t result = 0;
+	while (begin != nullptr && *begin != '\0' && begin < end)
+	{
+		result += ((*begin & 0xC0) != 0x80);
+		++begin;
+	}
+	return result;
+}
+
+// the decoding which Rune::decode did before, it looked for a null byte in the next 4 bytes then called utf8proc
+int32_t utf8procDecode(const char* ptr)
+{
+	size_t count = 1;
+	while (count < 4 && ptr[count] != 0)
+	{
+		++count;
+	}
+	int32_t rune = 0;
+	utf8proc_iterate(reinterpret_cast<const utf8proc_uint8_t*>(ptr), utf8proc_ssize_t(count), &rune);
+	return rune;
+}
+
+// a utf16 conversion a rune at a time
+size_t runeToUtf16(const char* ptr, size_t count, char16_t* out)
+{
+	auto begin = out;
+	for (auto it = ptr, end = ptr + count; it < end; it = core::Rune::next(it))
+	{
+		auto rune = int(core::Rune::decode(it));
+		if (rune >= 0x10000)
+		{
+			rune -= 0x10000;
+			*out++ = char16_t(0xd800 + (rune >> 10));
+			*out++ = char16_t(0xdc00 + (rune & 0x3ff));
+		}
+		else
+		{
+			*out++ = char16_t(rune);
+		}
+	}
+	return size_t(out - begin);
+}
+
+std::string repeat(std::string_view text, size_t count)
+{
+	std::string res;
+	while (res.size() + text.size() <= count)
+	{
+		res += text;
+	}
+	return res;
+}
+
+int main()
+{
+	// the mixed script line of test.txt, plain ascii source code and arabic prose
+	struct Input
+	{
+		const char* name;
+		std::string text;
+	};
+	Input inputs[] = {
+		{"mixed script", repeat("Hello يا عالم 🌎!\n", 64 * 1024)},
+		{"ascii source", repeat("\tfor (size_t i = 0; i < count; ++i)\n\t{\n\t\tsum += values[i];\n\t}\n", 64 * 1024)},
+		{"arabic", repeat("مرحبا بالعالم، هذا نص عربي طويل للاختبار. ", 64 * 1024)},
+	};
+
+	for (const auto& [name, text]: inputs)
+	{
+		auto ptr = text.data();
+		auto count = text.size();
+
+		{
+			ankerl::nanobench::Bench bench{};
+			bench.title(std::string{"validate "} + name);
+			bench.relative(true).unit("byte").batch(count);
+			bench.run("lead byte table", [&] { ankerl::nanobench::doNotOptimizeAway(tableValidate(ptr, count)); });
+			bench.run("core::Utf8::validate", [&] {
+				ankerl::nanobench::doNotOptimizeAway(core::Utf8::validate(ptr, count));
+			});
+		}
+
+		{
+			ankerl::nanobench::Bench bench{};
+			bench.title(std::string{"count runes of "} + name);
+			bench.relative(true).unit("byte").batch(count);
+			bench.run("byte at a time", [&] {
+				ankerl::nanobench::doNotOptimizeAway(byteCountRunes(ptr, ptr + count));
+			});
+			bench.run("core::Rune::count", [&] {
+				ankerl::nanobench::doNotOptimizeAway(core::Rune::count(ptr, ptr + count));
+			});
+		}
+
+		{
+			ankerl::nanobench::Bench bench{};
+			bench.title(std::string{"decode the runes of "} + name);
+			bench.relative(true).unit("byte").batch(count);
+			bench.run("utf8proc_iterate", [&] {
+				int32_t sum = 0;
+				for (auto it = ptr; it < ptr + count; it = core::Rune::next(it))
+				{
+					sum += utf8procDecode(it);
+				}
+				ankerl::nanobench::doNotOptimizeAway(sum);
+			});
+			bench.run("core::Rune::decode", [&] {
+				int32_t sum = 0;
+				for (auto it = ptr; it < ptr + count; it = core::Rune::next(it))
+				{
+					sum += core::Rune::decode(it);
+				}
+				ankerl::nanobench::doNotOptimizeAway(sum);
+			});
+		}
+
+		{
+			std::u16string utf16(count, u'\0');
+			ankerl::nanobench::Bench bench{};
+			bench.title(std::string{"convert to utf16 "} + name);
+			bench.relative(true).unit("byte").batch(count);
+			bench.run("a rune at a time", [&] {
+				ankerl::nanobench::doNotOptimizeAway(runeToUtf16(ptr, count, utf16.data()));
+			});
+			bench.run("core::Utf8::toUtf16", [&] {
+				ankerl::nanobench::doNotOptimizeAway(core::Utf8::toUtf16(ptr, count, utf16.data()));
+			});
+		}
+	}
+	return EXIT_SUCCESS;
+}
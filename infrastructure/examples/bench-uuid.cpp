@@ -0,0 +1,132 @@
+#include <core/Mallocator.h>
+#include <core/Rand.h>
+#include <core/String.h>
+#include <core/UUID.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+#include <fmt/format.h>
+
+#include <sqlite3.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+constexpr size_t INSERTS_COUNT = 200000;
+
+// what UUID::generate used to be, a trip to the os for every uuid
+core::UUID generateFromOS()
+{
+	core::UUID uuid;
+	std::byte bytes[16];
+	core::Rand::osCryptoRand(core::Span<std::byte>{bytes, sizeof(bytes)});
+	for (size_t i = 0; i < 16; ++i)
+	{
+		uuid[i] = uint8_t(bytes[i]);
+	}
+	uuid[6] = (uuid[6] & 0x0f) | 0x40;
+	uuid[8] = (uuid[8] & 0x3f) | 0x80;
+	return uuid;
+}
+
+// inserts the keys into a table keyed by them like the ledger tables, with a small page cache so the inserts which
+// land all over the index have to go to the file
+void insertKeys(const std::vector<core::UUID>& keys)
+{
+	auto path = "bench-uuid.sqlite3";
+	std::remove(path);
+
+	sqlite3* db = nullptr;
+	sqlite3_open(path, &db);
+	sqlite3_exec(db, "PRAGMA journal_mode = OFF; PRAGMA synchronous = OFF;", nullptr, nullptr, nullptr);
+	sqlite3_exec(db, "PRAGMA cache_size = -2000;", nullptr, nullptr, nullptr);
+	sqlite3_exec(
+		db, "CREATE TABLE entries (id BLOB PRIMARY KEY, amount INTEGER) WITHOUT ROWID;", nullptr, nullptr, nullptr);
+
+	sqlite3_stmt* stmt = nullptr;
+	sqlite3_prepare_v2(db, "INSERT INTO entries (id, amount) VALUES (?, ?);", -1, &stmt, nullptr);
+	sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		sqlite3_bind_blob(stmt, 1, &keys[i][0], 16, SQLITE_STATIC);
+		sqlite3_bind_int64(stmt, 2, int64_t(i));
+		sqlite3_step(stmt);
+		sqlite3_reset(stmt);
+	}
+	sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+	sqlite3_finalize(stmt);
+	sqlite3_close(db);
+
+	std::remove(path);
+}
+
+int main(int argc, char** argv)
+{
+	core::Mallocator allocator;
+
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::UUID").unit("uuid").relative(true);
+
+	bench.run("UUID from the os per call", [&] { ankerl::nanobench::doNotOptimizeAway(generateFromOS()); });
+	bench.run("UUID::generate", [&] { ankerl::nanobench::doNotOptimizeAway(core::UUID::generate()); });
+	bench.run("UUID::generateV7", [&] { ankerl::nanobench::doNotOptimizeAway(core::UUID::generateV7()); });
+
+	auto id = core::UUID::generate();
+	char buffer[core::UUID::STRING_SIZE];
+	core::Span<char> out{buffer, sizeof(buffer)};
+	bench.run("fmt format byte by byte", [&] {
+		auto end = fmt::format_to(
+			buffer,
+			"{:02x}{:02x}{:02x}{:02x}-{:02x}{:02x}-{:02x}{:02x}-{:02x}{:02x}-{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}",
+			id[0],
+			id[1],
+			id[2],
+			id[3],
+			id[4],
+			id[5],
+			id[6],
+			id[7],
+			id[8],
+			id[9],
+			id[10],
+			id[11],
+			id[12],
+			id[13],
+			id[14],
+			id[15]);
+		ankerl::nanobench::doNotOptimizeAway(end);
+	});
+	bench.run("UUID::format", [&] {
+		id.format(out);
+		ankerl::nanobench::doNotOptimizeAway(buffer);
+	});
+
+	auto str = core::strf(&allocator, "{}"_sv, id);
+	core::String undashed{&allocator};
+	for (auto part: core::StringView{str}.split("-"_sv, true))
+	{
+		undashed.push(part);
+	}
+	// the form without dashes goes through the digit by digit loop which all the forms used to go through
+	bench.run("UUID::parse digit by digit", [&] {
+		ankerl::nanobench::doNotOptimizeAway(core::UUID::parse(undashed, &allocator));
+	});
+	bench.run("UUID::parse", [&] { ankerl::nanobench::doNotOptimizeAway(core::UUID::parse(str, &allocator)); });
+
+	std::vector<core::UUID> v4Keys(INSERTS_COUNT);
+	std::vector<core::UUID> v7Keys(INSERTS_COUNT);
+	for (size_t i = 0; i < INSERTS_COUNT; ++i)
+	{
+		v4Keys[i] = core::UUID::generate();
+		v7Keys[i] = core::UUID::generateV7();
+	}
+
+	ankerl::nanobench::Bench sqlite{};
+	sqlite.title("sqlite inserts").unit("insert").batch(INSERTS_COUNT).epochs(3).minEpochIterations(1).relative(true);
+	sqlite.run("UUID v4 primary key", [&] { insertKeys(v4Keys); });
+	sqlite.run("UUID v7 primary key", [&] { insertKeys(v7Keys); });
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include <core/Hash.h>
+#include <core/Mallocator.h>
+#include <core/OS.h>
+#include <core/VirtualMem.h>
+
+#define ANKERL_NANOBENCH_IMPLEMENT 1
+#include <nanobench.h>
+
+// big enough that the table doesn't fit in the TLB reach of normal 4KB pages
+constexpr size_t ENTRIES_COUNT = 8 * 1024 * 1024;
+constexpr size_t LOOKUPS_COUNT = 1024 * 1024;
+
+void benchMapLookup(ankerl::nanobench::Bench& bench, const char* name, core::Allocator* allocator)
+{
+	core::Map<uint64_t, uint64_t> map{allocator};
+	map.reserve(ENTRIES_COUNT);
+	for (uint64_t i = 0; i < ENTRIES_COUNT; ++i)
+	{
+		map.insert(i, i);
+	}
+
+	ankerl::nanobench::Rng rng{42};
+	bench.run(name, [&] {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < LOOKUPS_COUNT; ++i)
+		{
+			auto it = map.lookup(uint64_t(rng.bounded(ENTRIES_COUNT)));
+			sum += it->value;
+		}
+		ankerl::nanobench::doNotOptimizeAway(sum);
+	});
+}
+
+int main(int argc, char** argv)
+{
+	ankerl::nanobench::Bench bench{};
+	bench.title("core::Map random lookups")
+		.unit("lookup")
+		.batch(LOOKUPS_COUNT)
+		.relative(true)
+		.performanceCounters(true);
+
+	core::Mallocator mallocator;
+	benchMapLookup(bench, "Mallocator", &mallocator);
+
+	core::VirtualMem virtualMem;
+	benchMapLookup(bench, "VirtualMem", &virtualMem);
+
+	core::VirtualMem transparentHugePages{
+		core::VirtualMem::FLAGS_TRANSPARENT_HUGE_PAGES | core::VirtualMem::FLAGS_PREFAULT};
+	benchMapLookup(bench, "VirtualMem transparent huge pages", &transparentHugePages);
+
+	core::VirtualMem hugePages{core::VirtualMem::FLAGS_HUGE_PAGES | core::VirtualMem::FLAGS_PREFAULT};
+	benchMapLookup(bench, "VirtualMem huge pages", &hugePages);
+
+	core::VirtualMem localNode{
+		core::VirtualMem::FLAGS_TRANSPARENT_HUGE_PAGES | core::VirtualMem::FLAGS_PREFAULT,
+		core::VirtualMem::NUMA_NODE_LOCAL};
+	benchMapLookup(bench, "VirtualMem transparent huge pages local numa node", &localNode);
+
+	if (auto numaNodesCount = core::OS::numaNodesCount(); numaNodesCount > 1)
+	{
+		core::VirtualMem remoteNode{
+			core::VirtualMem::FLAGS_TRANSPARENT_HUGE_PAGES | core::VirtualMem::FLAGS_PREFAULT,
+			(core::OS::currentNumaNode() + 1) % numaNodesCount};
+		benchMapLookup(bench, "VirtualMem transparent huge pages remote numa node", &remoteNode);
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -4,8 +4,8 @@
 // -v "W:\Projects\taha2\test\autobahn-testsuite\reports:/reports"
 // -p 9011:9011 --name wstest crossbario/autobahn-testsuite wstest -m fuzzingclient -s /config/fuzzingclient.json
 
+#include <core/ConcurrentMap.h>
 #include <core/FastLeak.h>
-#include <core/Lock.h>
 #include <core/Log.h>
 #include <core/Thread.h>
 #include <core/Url.h>
@@ -33,20 +33,17 @@ class EchoServer
 
 	core::Allocator* m_allocator = nullptr;
 	core::ws::Server m_server;
-	core::Mutex m_mutex;
-	core::Set<core::Shared<ClientData>> m_clients;
+	core::ConcurrentMap<ClientData*, core::Shared<ClientData>> m_clients;
 	core::WaitGroup m_waitgroup;
 
 	void pushClient(const core::Shared<ClientData>& clientData)
 	{
-		auto lock = core::lockGuard(m_mutex);
-		m_clients.insert(clientData);
+		m_clients.insert(clientData.get(), clientData);
 	}
 
 	void popClient(const core::Shared<ClientData>& clientData)
 	{
-		auto lock = core::lockGuard(m_mutex);
-		m_clients.remove(clientData);
+		m_clients.remove(clientData.get());
 	}
 
 	static core::HumanError handleClient(const core::Shared<ClientData>& clientData)
@@ -92,7 +89,6 @@ class EchoServer
 	EchoServer(core::ws::Server server, core::Allocator* allocator)
 		: m_allocator(allocator),
 		  m_server(std::move(server)),
-		  m_mutex(allocator),
 		  m_clients(allocator),
 		  m_waitgroup(allocator)
 	{}
@@ -129,13 +125,7 @@ public:
 			clientData->thread = core::unique_from<core::Thread>(m_allocator, std::move(clientThread));
 		}
 
-		{
-			auto lock = core::lockGuard(m_mutex);
-			for (const auto& clientData: m_clients)
-			{
-				clientData->client.close();
-			}
-		}
+		m_clients.visitAll([](const auto& entry) { entry.value->client.close(); });
 		m_waitgroup.wait();
 	}
 
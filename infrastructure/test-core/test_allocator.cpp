@@ -1,9 +1,19 @@
 #include <doctest/doctest.h>
 
+#include <core/Array.h>
 #include <core/FastLeak.h>
+#include <core/Hash.h>
 #include <core/Mallocator.h>
+#include <core/MemoryStream.h>
+#include <core/OS.h>
+#include <core/ProfilingAllocator.h>
+#include <core/Thread.h>
+#include <core/ThreadCachedAllocator.h>
 #include <core/VirtualMem.h>
 
+#include <atomic>
+#include <cstring>
+
 TEST_CASE("basic core::Mallocator test")
 {
 	core::Mallocator allocator;
@@ -28,6 +38,47 @@ TEST_CASE("basic core::VirtualMem test")
 	allocator.free(core::Span<std::byte>{(std::byte*)ptr, sizeof(*ptr)});
 }
 
+TEST_CASE("core::VirtualMem flags")
+{
+	size_t size = 4 * 1024 * 1024;
+	int flagsList[] = {
+		core::VirtualMem::FLAGS_TRANSPARENT_HUGE_PAGES | core::VirtualMem::FLAGS_PREFAULT,
+		core::VirtualMem::FLAGS_HUGE_PAGES | core::VirtualMem::FLAGS_PREFAULT,
+	};
+
+	for (auto flags: flagsList)
+	{
+		core::VirtualMem allocator{flags, core::VirtualMem::NUMA_NODE_LOCAL};
+		auto bytes = allocator.alloc(size, alignof(int));
+		REQUIRE(bytes.data() != nullptr);
+		REQUIRE(bytes.sizeInBytes() == size);
+		allocator.commit(bytes);
+		bytes[0] = std::byte{42};
+		bytes[size - 1] = std::byte{24};
+		REQUIRE(bytes[0] == std::byte{42});
+		REQUIRE(bytes[size - 1] == std::byte{24});
+		allocator.release(bytes);
+		allocator.free(bytes);
+	}
+}
+
+TEST_CASE("core::VirtualMem partial page commits")
+{
+	core::VirtualMem allocator{core::VirtualMem::FLAGS_TRANSPARENT_HUGE_PAGES};
+	core::Map<int, int> map{&allocator};
+	for (int i = 0; i < 10000; ++i)
+	{
+		map.insert(i, i * 2);
+	}
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		auto it = map.lookup(i);
+		REQUIRE(it != map.end());
+		REQUIRE(it->value == i * 2);
+	}
+}
+
 TEST_CASE("basic core::FastLeak test")
 {
 	core::FastLeak allocator;
@@ -39,3 +90,201 @@ TEST_CASE("basic core::FastLeak test")
 	allocator.release(core::Span<std::byte>{(std::byte*)ptr, sizeof(*ptr)});
 	allocator.free(core::Span<std::byte>{(std::byte*)ptr, sizeof(*ptr)});
 }
+
+TEST_CASE("basic core::ProfilingAllocator test")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator allocator{&mallocator, 0};
+
+	core::Array<int> live{&allocator};
+	live.reserve(100);
+	for (int i = 0; i < 10; ++i)
+	{
+		core::Array<int> temp{&allocator};
+		temp.reserve(10);
+	}
+
+	auto stats = allocator.stats();
+	REQUIRE(stats.liveCount == 1);
+	REQUIRE(stats.liveBytes == 100 * sizeof(int));
+	REQUIRE(stats.allocatedCount == 11);
+	REQUIRE(stats.allocatedBytes == 200 * sizeof(int));
+	REQUIRE(stats.callSitesCount >= 1);
+
+	core::MemoryStream report{&mallocator};
+	allocator.writeReport(&report);
+	auto reportStr = report.releaseString();
+	REQUIRE(reportStr.count() > 0);
+	REQUIRE(core::StringView{reportStr}.startsWith("heap profile: live 400 bytes in 1 objects"_sv));
+
+	core::MemoryStream pprof{&mallocator};
+	allocator.writePprof(&pprof);
+	REQUIRE(pprof.releaseString().count() > 0);
+}
+
+TEST_CASE("core::ProfilingAllocator sampling")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator allocator{&mallocator, 1024};
+
+	constexpr size_t ALLOCATIONS_COUNT = 10000;
+	constexpr size_t ALLOCATION_SIZE = 128;
+	for (size_t i = 0; i < ALLOCATIONS_COUNT; ++i)
+	{
+		auto bytes = allocator.alloc(ALLOCATION_SIZE, alignof(std::max_align_t));
+		allocator.free(bytes);
+	}
+
+	// the sampled estimate should be in the same ballpark of the real numbers
+	auto stats = allocator.stats();
+	REQUIRE(stats.liveCount == 0);
+	REQUIRE(stats.allocatedBytes > ALLOCATIONS_COUNT * ALLOCATION_SIZE / 2);
+	REQUIRE(stats.allocatedBytes < ALLOCATIONS_COUNT * ALLOCATION_SIZE * 2);
+}
+
+TEST_CASE("core::ProfilingAllocator sampling with different rates on one thread")
+{
+	// each allocator keeps its own countdown, a shared one would sample the fast allocator at the slow rate and the
+	// slow allocator at the fast rate with the weights of the slow one
+	core::Mallocator mallocator;
+	core::ProfilingAllocator fast{&mallocator, 1024};
+	core::ProfilingAllocator slow{&mallocator, 1024 * 1024};
+
+	constexpr size_t ALLOCATIONS_COUNT = 10000;
+	constexpr size_t ALLOCATION_SIZE = 128;
+	for (size_t i = 0; i < ALLOCATIONS_COUNT; ++i)
+	{
+		fast.free(fast.alloc(ALLOCATION_SIZE, alignof(std::max_align_t)));
+		slow.free(slow.alloc(ALLOCATION_SIZE, alignof(std::max_align_t)));
+	}
+
+	auto fastStats = fast.stats();
+	REQUIRE(fastStats.allocatedBytes > ALLOCATIONS_COUNT * ALLOCATION_SIZE / 2);
+	REQUIRE(fastStats.allocatedBytes < ALLOCATIONS_COUNT * ALLOCATION_SIZE * 2);
+	// about one sample is expected so only an estimate which is way off is checked
+	REQUIRE(slow.stats().allocatedBytes < ALLOCATIONS_COUNT * ALLOCATION_SIZE * 20);
+}
+
+TEST_CASE("basic core::ThreadCachedAllocator test")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator backing{&mallocator, 0};
+	core::ThreadCachedAllocator allocator{&backing};
+
+	for (size_t size = 1; size <= core::ThreadCachedAllocator::MAX_BLOCK_SIZE * 2; size = size * 2 + 1)
+	{
+		auto bytes = allocator.alloc(size, alignof(std::max_align_t));
+		REQUIRE(bytes.sizeInBytes() == size);
+		REQUIRE((uintptr_t)bytes.data() % alignof(std::max_align_t) == 0);
+		allocator.commit(bytes);
+		::memset(bytes.data(), 0xAB, bytes.sizeInBytes());
+		allocator.release(bytes);
+		allocator.free(bytes);
+	}
+
+	// freed blocks are reused from the thread cache without touching the backing allocator
+	auto allocatedCount = backing.stats().allocatedCount;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		core::Array<int> arr{&allocator};
+		arr.push(1);
+	}
+	REQUIRE(backing.stats().allocatedCount == allocatedCount);
+
+	auto liveCount = backing.stats().liveCount;
+	allocator.flushThreadCache();
+	REQUIRE(backing.stats().liveCount < liveCount);
+}
+
+TEST_CASE("core::ThreadCachedAllocator returns everything to the backing allocator")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator backing{&mallocator, 0};
+
+	{
+		core::ThreadCachedAllocator allocator{&backing};
+		core::Array<core::Span<std::byte>> allocations{&mallocator};
+		for (size_t i = 0; i < 10000; ++i)
+		{
+			allocations.push(allocator.alloc(16 + i % 512, alignof(std::max_align_t)));
+		}
+		for (auto bytes: allocations)
+		{
+			allocator.free(bytes);
+		}
+	}
+
+	REQUIRE(backing.stats().liveCount == 0);
+	REQUIRE(backing.stats().liveBytes == 0);
+}
+
+TEST_CASE("core::ThreadCachedAllocator multiple threads")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator backing{&mallocator, 0};
+
+	{
+		core::ThreadCachedAllocator allocator{&backing};
+		auto liveCount = backing.stats().liveCount;
+
+		constexpr size_t THREADS_COUNT = 4;
+		std::atomic<size_t> mismatches = 0;
+		core::Array<core::Thread> threads{&mallocator};
+		for (size_t i = 0; i < THREADS_COUNT; ++i)
+		{
+			threads.push(core::Thread{&mallocator, [&allocator, &mismatches, i] {
+				for (size_t j = 0; j < 1000; ++j)
+				{
+					core::Array<size_t> arr{&allocator};
+					for (size_t k = 0; k < j % 64; ++k)
+					{
+						arr.push(i + k);
+					}
+					for (size_t k = 0; k < arr.count(); ++k)
+					{
+						if (arr[k] != i + k)
+						{
+							mismatches.fetch_add(1);
+						}
+					}
+				}
+			}});
+		}
+		for (auto& thread: threads)
+		{
+			thread.join();
+		}
+
+		REQUIRE(mismatches.load() == 0);
+
+		// exited threads give their cached blocks back, only the list of thread caches remains
+		REQUIRE(backing.stats().liveCount == liveCount + 1);
+	}
+
+	REQUIRE(backing.stats().liveCount == 0);
+}
+
+TEST_CASE("core::AllocatorScope")
+{
+	auto defaultAllocator = core::currentAllocator();
+	REQUIRE(defaultAllocator != nullptr);
+
+	core::Mallocator mallocator;
+	core::FastLeak fastLeak;
+	{
+		core::AllocatorScope outer{&mallocator};
+		REQUIRE(core::currentAllocator() == &mallocator);
+		{
+			core::AllocatorScope inner{&fastLeak};
+			REQUIRE(core::currentAllocator() == &fastLeak);
+
+			core::Allocator* otherThreadAllocator = nullptr;
+			core::Thread thread{
+				&mallocator, [&otherThreadAllocator] { otherThreadAllocator = core::currentAllocator(); }};
+			thread.join();
+			REQUIRE(otherThreadAllocator == defaultAllocator);
+		}
+		REQUIRE(core::currentAllocator() == &mallocator);
+	}
+	REQUIRE(core::currentAllocator() == defaultAllocator);
+}
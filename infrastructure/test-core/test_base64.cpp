@@ -0,0 +1,179 @@
+#include <doctest/doctest.h>
+
+#include <core/Base64.h>
+#include <core/Hex.h>
+#include <core/Mallocator.h>
+
+#include <random>
+#include <string>
+
+// base64 a bit at a time to check the codec against
+static std::string referenceBase64(const std::string& bytes, core::Base64::ALPHABET alphabet)
+{
+	const char* chars = alphabet == core::Base64::ALPHABET_STANDARD
+							? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
+							: "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+	std::string res;
+	size_t bitCount = bytes.size() * 8;
+	for (size_t bit = 0; bit < bitCount; bit += 6)
+	{
+		int value = 0;
+		for (size_t i = bit; i < bit + 6; ++i)
+		{
+			auto set = i < bitCount && (uint8_t(bytes[i / 8]) >> (7 - i % 8)) & 1;
+			value = (value << 1) | int(set);
+		}
+		res += chars[value];
+	}
+	while (alphabet == core::Base64::ALPHABET_STANDARD && res.size() % 4 != 0)
+	{
+		res += '=';
+	}
+	return res;
+}
+
+static core::Span<const std::byte> bytesOf(const std::string& str)
+{
+	return core::Span<const std::byte>{reinterpret_cast<const std::byte*>(str.data()), str.size()};
+}
+
+static std::string randomBytes(std::mt19937& gen, size_t count)
+{
+	std::string res(count, '\0');
+	for (auto& c: res)
+	{
+		c = char(gen());
+	}
+	return res;
+}
+
+TEST_CASE("core::Base64 rfc 4648 vectors")
+{
+	core::Mallocator allocator;
+	const char* vectors[][2] = {
+		{"", ""},
+		{"f", "Zg=="},
+		{"fo", "Zm8="},
+		{"foo", "Zm9v"},
+		{"foob", "Zm9vYg=="},
+		{"fooba", "Zm9vYmE="},
+		{"foobar", "Zm9vYmFy"},
+	};
+
+	for (auto [bytes, encoded]: vectors)
+	{
+		auto str = core::StringView{bytes};
+		auto res = core::Base64::encode(core::Span<const std::byte>{str}, &allocator);
+		REQUIRE(res == core::StringView{encoded});
+
+		auto decoded = core::Base64::decode(core::StringView{encoded}, &allocator);
+		REQUIRE(decoded.count() == str.count());
+		REQUIRE(core::StringView{decoded} == str);
+	}
+
+	REQUIRE(core::Base64::encode(bytesOf("\xfb\xff"), &allocator, core::Base64::ALPHABET_URL) == "-_8"_sv);
+	REQUIRE(core::StringView{core::Base64::decode("-_8"_sv, &allocator, core::Base64::ALPHABET_URL)} == "\xfb\xff"_sv);
+}
+
+TEST_CASE("core::Base64 round trip")
+{
+	core::Mallocator allocator;
+	std::mt19937 gen{46};
+	for (auto alphabet: {core::Base64::ALPHABET_STANDARD, core::Base64::ALPHABET_URL})
+	{
+		// every length around the vector blocks and a few big ones
+		for (size_t count = 0; count < 300; ++count)
+		{
+			auto bytes = randomBytes(gen, count < 200 ? count : count * 97);
+			auto expected = referenceBase64(bytes, alphabet);
+
+			REQUIRE(core::Base64::encodedCount(bytes.size(), alphabet) == expected.size());
+			auto encoded = core::Base64::encode(bytesOf(bytes), &allocator, alphabet);
+			REQUIRE(encoded == core::StringView{expected.data(), expected.size()});
+
+			REQUIRE(core::Base64::decodedCount(encoded) == bytes.size());
+			auto decoded = core::Base64::decode(encoded, &allocator, alphabet);
+			REQUIRE(core::StringView{decoded} == core::StringView{bytes.data(), bytes.size()});
+		}
+	}
+}
+
+TEST_CASE("core::Base64 invalid input")
+{
+	core::Mallocator allocator;
+	std::byte out[64];
+	auto decode = [&](core::StringView str, core::Base64::ALPHABET alphabet = core::Base64::ALPHABET_STANDARD) {
+		return core::Base64::decode(str, core::Span<std::byte>{out, sizeof(out)}, alphabet);
+	};
+
+	// unpadded input is fine but misplaced padding and impossible lengths aren't
+	REQUIRE(decode("Zg"_sv) == 1);
+	REQUIRE(decode("Zm8"_sv) == 2);
+	REQUIRE(decode("Zg=="_sv, core::Base64::ALPHABET_URL) == 1);
+	REQUIRE(decode("Z"_sv) == SIZE_MAX);
+	REQUIRE(decode("Zg="_sv) == SIZE_MAX);
+	REQUIRE(decode("Z==="_sv) == SIZE_MAX);
+	REQUIRE(decode("Zg==Zg=="_sv) == SIZE_MAX);
+	REQUIRE(decode("Zm9v\nYmFy"_sv) == SIZE_MAX);
+	REQUIRE(decode("-_8"_sv) == SIZE_MAX);
+	REQUIRE(decode("+/8"_sv, core::Base64::ALPHABET_URL) == SIZE_MAX);
+	REQUIRE(core::Base64::decode("Zm9v!mFy"_sv, &allocator).count() == 0);
+
+	// a bad character at every position of an input long enough for the vector path
+	std::mt19937 gen{7};
+	auto bytes = randomBytes(gen, 48);
+	auto encoded = referenceBase64(bytes, core::Base64::ALPHABET_STANDARD);
+	for (size_t i = 0; i < encoded.size(); ++i)
+	{
+		for (char c: {'\0', '=', '-', '.', '\x80', '\xff'})
+		{
+			// padding at the end is still valid base64, it just decodes to fewer bytes
+			if (c == '=' && i + 2 >= encoded.size())
+			{
+				continue;
+			}
+			auto copy = encoded;
+			copy[i] = c;
+			REQUIRE(decode(core::StringView{copy.data(), copy.size()}) == SIZE_MAX);
+		}
+	}
+}
+
+TEST_CASE("core::Hex")
+{
+	core::Mallocator allocator;
+	REQUIRE(core::Hex::encode(bytesOf("\x01\x23\x45\x67\x89\xab\xcd\xef"), &allocator) == "0123456789abcdef"_sv);
+	REQUIRE(core::StringView{core::Hex::decode("0123456789ABCDEFabcdef"_sv, &allocator)} ==
+			"\x01\x23\x45\x67\x89\xab\xcd\xef\xab\xcd\xef"_sv);
+
+	std::mt19937 gen{16};
+	for (size_t count = 0; count < 100; ++count)
+	{
+		auto bytes = randomBytes(gen, count);
+		std::string expected;
+		for (auto c: bytes)
+		{
+			expected += "0123456789abcdef"[uint8_t(c) >> 4];
+			expected += "0123456789abcdef"[uint8_t(c) & 0xF];
+		}
+
+		auto encoded = core::Hex::encode(bytesOf(bytes), &allocator);
+		REQUIRE(encoded == core::StringView{expected.data(), expected.size()});
+		auto decoded = core::Hex::decode(encoded, &allocator);
+		REQUIRE(core::StringView{decoded} == core::StringView{bytes.data(), bytes.size()});
+	}
+
+	std::byte out[64];
+	REQUIRE(core::Hex::decode("abc"_sv, core::Span<std::byte>{out, sizeof(out)}) == SIZE_MAX);
+	std::string hex(64, 'a');
+	for (size_t i = 0; i < hex.size(); ++i)
+	{
+		for (char c: {'g', 'G', '/', ':', '@', '`', '\x80'})
+		{
+			auto copy = hex;
+			copy[i] = c;
+			auto str = core::StringView{copy.data(), copy.size()};
+			REQUIRE(core::Hex::decode(str, core::Span<std::byte>{out, sizeof(out)}) == SIZE_MAX);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include <doctest/doctest.h>
+
+#include <core/BitSet.h>
+#include <core/Mallocator.h>
+#include <core/ProfilingAllocator.h>
+
+#include <bitset>
+#include <random>
+
+TEST_CASE("core::BitSet basics")
+{
+	core::Mallocator allocator;
+	core::BitSet set{&allocator};
+	REQUIRE(set.empty());
+	REQUIRE(set.none());
+	REQUIRE(set.findFirst() == core::BitSet::NOT_FOUND);
+	REQUIRE(set.begin() == set.end());
+
+	set.resize(130);
+	REQUIRE(set.count() == 130);
+	REQUIRE(set.popcount() == 0);
+	set.set(0);
+	set.set(63);
+	set.set(64);
+	set.set(129);
+	REQUIRE(set.test(63));
+	REQUIRE(set[64]);
+	REQUIRE(set.test(65) == false);
+	REQUIRE(set.popcount() == 4);
+
+	REQUIRE(set.findFirst() == 0);
+	REQUIRE(set.findNext(0) == 63);
+	REQUIRE(set.findNext(63) == 64);
+	REQUIRE(set.findNext(64) == 129);
+	REQUIRE(set.findNext(129) == core::BitSet::NOT_FOUND);
+
+	size_t expected[] = {0, 63, 64, 129};
+	size_t i = 0;
+	for (auto index: set)
+	{
+		REQUIRE(index == expected[i++]);
+	}
+	REQUIRE(i == 4);
+
+	set.reset(63);
+	set.flip(64);
+	set.flip(1);
+	set.set(2, true);
+	set.set(0, false);
+	REQUIRE(set.popcount() == 3);
+	REQUIRE(set.findFirst() == 1);
+
+	// the bits past the count stay zero so counting and comparing see only the real bits
+	set.setAll();
+	REQUIRE(set.popcount() == 130);
+	set.resize(200);
+	REQUIRE(set.popcount() == 130);
+	REQUIRE(set.test(130) == false);
+	set.resize(10);
+	REQUIRE(set.popcount() == 10);
+	set.resize(100);
+	REQUIRE(set.popcount() == 10);
+	set.resetAll();
+	REQUIRE(set.none());
+
+	core::BitSet other{&allocator, 100};
+	REQUIRE(set == other);
+	other.set(99);
+	REQUIRE(set != other);
+	set = other;
+	REQUIRE(set == other);
+	auto moved = std::move(set);
+	REQUIRE(moved == other);
+	REQUIRE(set.empty());
+}
+
+TEST_CASE("core::BitSet set operations")
+{
+	core::Mallocator allocator;
+	std::mt19937_64 gen{42};
+
+	// sizes around the vector widths so both the vector loops and their tails are exercised
+	for (size_t count: {1, 63, 64, 65, 127, 128, 200, 256, 257, 1000})
+	{
+		core::BitSet a{&allocator, count}, b{&allocator, count};
+		std::bitset<1000> ra, rb;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (gen() % 3 == 0)
+			{
+				a.set(i);
+				ra.set(i);
+			}
+			if (gen() % 2 == 0)
+			{
+				b.set(i);
+				rb.set(i);
+			}
+		}
+		REQUIRE(a.popcount() == ra.count());
+
+		auto check = [&](const core::BitSet& set, const std::bitset<1000>& ref) {
+			REQUIRE(set.popcount() == ref.count());
+			for (size_t i = 0; i < count; ++i)
+			{
+				REQUIRE(set.test(i) == ref.test(i));
+			}
+		};
+
+		auto c = a;
+		c &= b;
+		check(c, ra & rb);
+		REQUIRE(c.isSubsetOf(a));
+		REQUIRE(c.isSubsetOf(b));
+
+		c = a;
+		c |= b;
+		check(c, ra | rb);
+		REQUIRE(a.isSubsetOf(c));
+
+		c = a;
+		c ^= b;
+		check(c, ra ^ rb);
+
+		c = a;
+		c.andNot(b);
+		check(c, ra & ~rb);
+
+		size_t visited = 0;
+		a.forEach([&](size_t i) {
+			REQUIRE(ra.test(i));
+			++visited;
+		});
+		REQUIRE(visited == ra.count());
+	}
+}
+
+TEST_CASE("core::BitSet allocations")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator allocator{&mallocator, 0};
+	{
+		core::BitSet set{&allocator, 1000};
+		set.set(999);
+		auto copy = set;
+		copy.resize(5000);
+		copy.set(4999);
+		REQUIRE(copy.popcount() == 2);
+		REQUIRE(set.popcount() == 1);
+		set = std::move(copy);
+		REQUIRE(set.count() == 5000);
+	}
+	REQUIRE(allocator.stats().liveCount == 0);
+}
+
+TEST_CASE("core::FixedBitSet")
+{
+	core::FixedBitSet<100> a, b;
+	REQUIRE(a.count() == 100);
+	REQUIRE(a.none());
+	a.set(3);
+	a.set(64);
+	a.set(99);
+	b.set(64);
+	b.set(5);
+
+	auto c = a;
+	c &= b;
+	REQUIRE(c.popcount() == 1);
+	REQUIRE(c.findFirst() == 64);
+
+	c = a;
+	c |= b;
+	REQUIRE(c.popcount() == 4);
+	size_t expected[] = {3, 5, 64, 99};
+	size_t i = 0;
+	for (auto index: c)
+	{
+		REQUIRE(index == expected[i++]);
+	}
+
+	c ^= a;
+	REQUIRE(c.popcount() == 1);
+	REQUIRE(c.test(5));
+	REQUIRE(c != b);
+	c.andNot(b);
+	REQUIRE(c.none());
+
+	c.setAll();
+	REQUIRE(c.popcount() == 100);
+	REQUIRE(a.isSubsetOf(c));
+	c.resetAll();
+	REQUIRE(c.findFirst() == core::FixedBitSet<100>::NOT_FOUND);
+	static_assert(sizeof(core::FixedBitSet<128>) == 16);
+}
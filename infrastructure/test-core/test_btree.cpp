@@ -0,0 +1,276 @@
+#include <doctest/doctest.h>
+
+#include <core/BTree.h>
+#include <core/Mallocator.h>
+#include <core/ProfilingAllocator.h>
+#include <core/String.h>
+
+#include <map>
+#include <random>
+
+TEST_CASE("core::BTreeMap insert, lookup and remove")
+{
+	core::Mallocator allocator;
+	core::BTreeMap<int, int> map{&allocator};
+	REQUIRE(map.empty());
+	REQUIRE(map.begin() == map.end());
+	REQUIRE(map.lookup(1) == map.end());
+	REQUIRE(map.remove(1) == false);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		REQUIRE(map.insert(i * 2, i));
+	}
+	REQUIRE(map.insert(10, 100) == false);
+	REQUIRE(map.lookup(10)->value == 5);
+	REQUIRE(map.count() == 1000);
+
+	int expected = 0;
+	for (const auto& [key, value]: map)
+	{
+		REQUIRE(key == expected * 2);
+		REQUIRE(value == expected);
+		++expected;
+	}
+	REQUIRE(expected == 1000);
+
+	for (int i = 0; i < 2000; ++i)
+	{
+		auto it = map.lookup(i);
+		if (i % 2 == 0)
+		{
+			REQUIRE(it != map.end());
+			REQUIRE(it->value == i / 2);
+		}
+		else
+		{
+			REQUIRE(it == map.end());
+		}
+	}
+
+	for (int i = 0; i < 2000; i += 4)
+	{
+		REQUIRE(map.remove(i));
+	}
+	REQUIRE(map.count() == 500);
+	for (int i = 0; i < 2000; i += 2)
+	{
+		REQUIRE((map.lookup(i) != map.end()) == (i % 4 != 0));
+	}
+
+	map.clear();
+	REQUIRE(map.empty());
+	REQUIRE(map.insert(1, 1));
+	REQUIRE(map.count() == 1);
+}
+
+TEST_CASE("core::BTreeMap lowerBound and upperBound")
+{
+	core::Mallocator allocator;
+	core::BTreeMap<int, int> map{&allocator};
+	for (int i = 0; i < 500; ++i)
+	{
+		map.insert(i * 10, i);
+	}
+
+	REQUIRE(map.lowerBound(-5)->key == 0);
+	REQUIRE(map.lowerBound(100)->key == 100);
+	REQUIRE(map.lowerBound(101)->key == 110);
+	REQUIRE(map.upperBound(100)->key == 110);
+	REQUIRE(map.lowerBound(4990)->key == 4990);
+	REQUIRE(map.upperBound(4990) == map.end());
+	REQUIRE(map.lowerBound(5000) == map.end());
+
+	// scan [1000, 2000) which crosses a few leaves
+	int expected = 1000;
+	for (auto it = map.lowerBound(1000), end = map.lowerBound(2000); it != end; ++it)
+	{
+		REQUIRE(it->key == expected);
+		expected += 10;
+	}
+	REQUIRE(expected == 2000);
+
+	const auto& constMap = map;
+	int count = 0;
+	for (auto it = constMap.lowerBound(995), end = constMap.upperBound(1050); it != end; ++it)
+	{
+		++count;
+	}
+	REQUIRE(count == 6);
+}
+
+TEST_CASE("core::BTreeMap random operations")
+{
+	core::Mallocator allocator;
+	core::BTreeMap<uint32_t, uint32_t> map{&allocator};
+	std::map<uint32_t, uint32_t> reference;
+	std::mt19937 gen{42};
+
+	for (int round = 0; round < 3; ++round)
+	{
+		for (int i = 0; i < 20000; ++i)
+		{
+			auto key = uint32_t(gen() % 5000);
+			if (gen() % 3 == 0)
+			{
+				REQUIRE(map.remove(key) == (reference.erase(key) == 1));
+			}
+			else
+			{
+				REQUIRE(map.insert(key, uint32_t(i)) == reference.emplace(key, uint32_t(i)).second);
+			}
+		}
+
+		REQUIRE(map.count() == reference.size());
+		auto it = reference.begin();
+		for (const auto& entry: map)
+		{
+			REQUIRE(entry.key == it->first);
+			REQUIRE(entry.value == it->second);
+			++it;
+		}
+		REQUIRE(it == reference.end());
+
+		for (uint32_t key = 0; key < 5000; key += 7)
+		{
+			auto lower = map.lowerBound(key);
+			auto referenceLower = reference.lower_bound(key);
+			REQUIRE((lower == map.end()) == (referenceLower == reference.end()));
+			if (referenceLower != reference.end())
+			{
+				REQUIRE(lower->key == referenceLower->first);
+			}
+		}
+	}
+
+	// drain it completely so the tree shrinks back to nothing
+	for (auto [key, value]: reference)
+	{
+		REQUIRE(map.remove(key));
+	}
+	REQUIRE(map.empty());
+	REQUIRE(map.begin() == map.end());
+}
+
+// big keys make the nodes as narrow as they get so the tree grows deep and exercises the rebalancing of inner nodes
+struct BigKey
+{
+	uint32_t value = 0;
+	std::byte padding[252];
+
+	bool operator<(const BigKey& other) const
+	{
+		return value < other.value;
+	}
+};
+
+TEST_CASE("core::BTreeSet deep tree")
+{
+	core::Mallocator allocator;
+	core::BTreeSet<BigKey> set{&allocator};
+	std::map<uint32_t, bool> reference;
+	std::mt19937 gen{7};
+
+	for (int i = 0; i < 30000; ++i)
+	{
+		auto key = uint32_t(gen() % 3000);
+		if (gen() % 2 == 0)
+		{
+			REQUIRE(set.remove(BigKey{key}) == (reference.erase(key) == 1));
+		}
+		else
+		{
+			REQUIRE(set.insert(BigKey{key}) == reference.emplace(key, true).second);
+		}
+	}
+
+	REQUIRE(set.count() == reference.size());
+	auto it = reference.begin();
+	for (const auto& key: set)
+	{
+		REQUIRE(key.value == it->first);
+		++it;
+	}
+	REQUIRE(it == reference.end());
+}
+
+TEST_CASE("core::BTreeMap assignSorted")
+{
+	core::Mallocator allocator;
+	for (size_t count: {0, 1, 5, 100, 1000, 12345})
+	{
+		core::Array<core::KeyValue<int, int>> entries{&allocator};
+		for (size_t i = 0; i < count; ++i)
+		{
+			entries.push(core::KeyValue<int, int>{int(i * 3), int(i)});
+		}
+
+		core::BTreeMap<int, int> map{&allocator};
+		map.insert(-1, -1);
+		map.assignSorted(entries);
+		REQUIRE(map.count() == count);
+		REQUIRE(map.lookup(-1) == map.end());
+
+		size_t i = 0;
+		for (const auto& [key, value]: map)
+		{
+			REQUIRE(key == int(i * 3));
+			REQUIRE(value == int(i));
+			++i;
+		}
+		REQUIRE(i == count);
+
+		// the bulk loaded tree must keep working like an inserted one
+		for (size_t j = 0; j < count; j += 2)
+		{
+			REQUIRE(map.remove(int(j * 3)));
+			REQUIRE(map.insert(int(j * 3 + 1), 0));
+		}
+		REQUIRE(map.count() == count);
+		for (size_t j = 0; j < count; ++j)
+		{
+			REQUIRE((map.lookup(int(j * 3)) != map.end()) == (j % 2 == 1));
+		}
+	}
+}
+
+TEST_CASE("core::BTreeSet with string keys")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator allocator{&mallocator, 0};
+	{
+		core::BTreeSet<core::String> set{&allocator};
+		for (int i = 0; i < 300; ++i)
+		{
+			REQUIRE(set.insert(core::strf(&allocator, "key-{:04}"_sv, i)));
+		}
+		REQUIRE(set.insert(core::String{"key-0000"_sv, &allocator}) == false);
+		REQUIRE(set.lookup("key-0150"_sv) != set.end());
+		REQUIRE(set.lookup("key-1500"_sv) == set.end());
+		REQUIRE(*set.lowerBound("key-01"_sv) == "key-0100"_sv);
+		REQUIRE(*set.upperBound("key-0100"_sv) == "key-0101"_sv);
+		static_assert(std::is_same_v<decltype(set.lookup("key"_sv)), core::BTreeSet<core::String>::ConstIterator>);
+		static_assert(std::is_same_v<decltype(set.lowerBound("key"_sv)), core::BTreeSet<core::String>::ConstIterator>);
+		static_assert(std::is_same_v<decltype(set.upperBound("key"_sv)), core::BTreeSet<core::String>::ConstIterator>);
+
+		auto& self = set;
+		set = self;
+		REQUIRE(set.count() == 300);
+		set = std::move(self);
+		REQUIRE(set.count() == 300);
+
+		auto copy = set;
+		for (int i = 0; i < 300; i += 2)
+		{
+			REQUIRE(set.remove(core::strf(&allocator, "key-{:04}"_sv, i)));
+		}
+		REQUIRE(set.count() == 150);
+		REQUIRE(copy.count() == 300);
+		REQUIRE(*copy.begin() == "key-0000"_sv);
+
+		auto moved = std::move(copy);
+		REQUIRE(moved.count() == 300);
+		REQUIRE(copy.empty());
+	}
+	REQUIRE(allocator.stats().liveCount == 0);
+}
\ No newline at end of file
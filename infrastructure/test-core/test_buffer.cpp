@@ -19,3 +19,45 @@ TEST_CASE("core::Buffer basics")
 	REQUIRE(buffer[3] == std::byte{'l'});
 	REQUIRE(buffer[4] == std::byte{'o'});
 }
+
+TEST_CASE("core::Buffer small buffer optimization")
+{
+	core::Mallocator mallocator;
+	core::Buffer buffer{&mallocator};
+	REQUIRE(buffer.isInline());
+
+	for (int i = 0; i < 23; ++i)
+	{
+		buffer.push(std::byte(i));
+	}
+	REQUIRE(buffer.isInline());
+	REQUIRE(buffer.count() == 23);
+
+	auto copy = buffer;
+	REQUIRE(copy.isInline());
+
+	buffer.push(std::byte(23));
+	REQUIRE(buffer.isInline() == false);
+	REQUIRE(buffer.count() == 24);
+
+	buffer.resize(1000);
+	REQUIRE(buffer.count() == 1000);
+	for (int i = 0; i < 24; ++i)
+	{
+		REQUIRE(buffer[i] == std::byte(i));
+	}
+
+	auto moved = std::move(buffer);
+	REQUIRE(moved.count() == 1000);
+	REQUIRE(buffer.count() == 0);
+
+	moved.clear();
+	REQUIRE(moved.count() == 0);
+	moved.push("Hello"_sv);
+	REQUIRE(core::StringView{moved} == "Hello"_sv);
+
+	for (int i = 0; i < 23; ++i)
+	{
+		REQUIRE(copy[i] == std::byte(i));
+	}
+}
@@ -0,0 +1,120 @@
+#include <doctest/doctest.h>
+
+#include <core/ConcurrentMap.h>
+#include <core/Mallocator.h>
+#include <core/String.h>
+#include <core/Thread.h>
+
+#include <atomic>
+
+TEST_CASE("core::ConcurrentMap basics")
+{
+	core::Mallocator allocator;
+	core::ConcurrentMap<core::String, int> map{&allocator, 6};
+	REQUIRE(map.shardsCount() == 8);
+
+	REQUIRE(map.insert("one"_sv, 1));
+	REQUIRE(map.insert(core::String{"two"_sv, &allocator}, 2));
+	REQUIRE(map.insert("one"_sv, 3) == false);
+	REQUIRE(map.count() == 2);
+
+	int value = 0;
+	REQUIRE(map.visit("one"_sv, [&](const auto& entry) { value = entry.value; }));
+	REQUIRE(value == 1);
+	REQUIRE(map.visit("three"_sv, [&](const auto&) { value = 0; }) == false);
+	REQUIRE(value == 1);
+
+	REQUIRE(map.upsert("one"_sv, 0, [](int& v) { v += 10; }) == false);
+	REQUIRE(map.upsert("three"_sv, 3, [](int& v) { v += 10; }));
+	REQUIRE(map.visit("one"_sv, [&](const auto& entry) { value = entry.value; }));
+	REQUIRE(value == 11);
+
+	REQUIRE(map.eraseIf("one"_sv, [](const auto& entry) { return entry.value == 1; }) == false);
+	REQUIRE(map.eraseIf("one"_sv, [](const auto& entry) { return entry.value == 11; }));
+	REQUIRE(map.contains("one"_sv) == false);
+
+	auto snapshot = map.snapshot(&allocator);
+	REQUIRE(snapshot.count() == 2);
+	REQUIRE(snapshot.lookup("two"_sv)->value == 2);
+	REQUIRE(snapshot.lookup("three"_sv)->value == 3);
+
+	REQUIRE(map.remove("two"_sv));
+	REQUIRE(map.remove("two"_sv) == false);
+	map.clear();
+	REQUIRE(map.count() == 0);
+}
+
+TEST_CASE("core::ConcurrentMap many threads")
+{
+	core::Mallocator allocator;
+	core::ConcurrentMap<int, int> map{&allocator};
+
+	constexpr int THREADS_COUNT = 8;
+	constexpr int KEYS_COUNT = 10000;
+	std::atomic<int> insertedCount = 0;
+	std::atomic<int> missingCount = 0;
+	core::Array<core::Thread> threads{&allocator};
+	for (int t = 0; t < THREADS_COUNT; ++t)
+	{
+		threads.push(core::Thread{&allocator, [&] {
+									  for (int i = 0; i < KEYS_COUNT; ++i)
+									  {
+										  if (map.upsert(i, 1, [](int& v) { ++v; }))
+										  {
+											  ++insertedCount;
+										  }
+										  if (map.contains(i) == false)
+										  {
+											  ++missingCount;
+										  }
+									  }
+								  }});
+	}
+	for (auto& thread: threads)
+	{
+		thread.join();
+	}
+	REQUIRE(insertedCount == KEYS_COUNT);
+	REQUIRE(missingCount == 0);
+	REQUIRE(map.count() == KEYS_COUNT);
+
+	size_t visited = 0;
+	map.visitAll([&](const auto& entry) {
+		REQUIRE(entry.value == THREADS_COUNT);
+		++visited;
+	});
+	REQUIRE(visited == KEYS_COUNT);
+
+	// half the threads remove the odd keys while the other half reads the even keys
+	threads.clear();
+	for (int t = 0; t < THREADS_COUNT; ++t)
+	{
+		threads.push(core::Thread{&allocator, [&, t] {
+									  for (int i = 0; i < KEYS_COUNT; ++i)
+									  {
+										  if (t % 2 == 0 && i % 2 == 1)
+										  {
+											  map.remove(i);
+										  }
+										  else if (t % 2 == 1 && i % 2 == 0 && map.contains(i) == false)
+										  {
+											  ++missingCount;
+										  }
+									  }
+								  }});
+	}
+	for (auto& thread: threads)
+	{
+		thread.join();
+	}
+	REQUIRE(missingCount == 0);
+	REQUIRE(map.count() == KEYS_COUNT / 2);
+
+	REQUIRE(map.eraseIf([](const auto& entry) { return entry.key % 4 == 0; }) == KEYS_COUNT / 4);
+	REQUIRE(map.count() == KEYS_COUNT / 4);
+	auto snapshot = map.snapshot(&allocator);
+	for (const auto& [key, value]: snapshot)
+	{
+		REQUIRE(key % 4 == 2);
+	}
+}
@@ -0,0 +1,189 @@
+#include <doctest/doctest.h>
+
+#include <core/Deque.h>
+#include <core/Mallocator.h>
+#include <core/String.h>
+#include <core/Unique.h>
+
+TEST_CASE("core::Deque push and pop at both ends")
+{
+	core::Mallocator allocator;
+	core::Deque<int> deque{&allocator};
+	REQUIRE(deque.empty());
+
+	// move the head around the buffer a few times so the elements wrap
+	for (int round = 0; round < 5; ++round)
+	{
+		for (int i = 0; i < 6; ++i)
+		{
+			deque.push_back(i);
+		}
+		for (int i = 0; i < 6; ++i)
+		{
+			REQUIRE(deque.front() == i);
+			deque.pop_front();
+		}
+	}
+	REQUIRE(deque.empty());
+	REQUIRE(deque.capacity() == 8);
+
+	for (int i = 0; i < 100; ++i)
+	{
+		deque.push_back(i);
+		deque.push_front(-i - 1);
+	}
+	REQUIRE(deque.count() == 200);
+	REQUIRE(deque.capacity() == 256);
+	for (int i = 0; i < 200; ++i)
+	{
+		REQUIRE(deque[i] == i - 100);
+	}
+
+	REQUIRE(deque.front() == -100);
+	REQUIRE(deque.back() == 99);
+	deque.pop_back();
+	deque.pop_front();
+	REQUIRE(deque.front() == -99);
+	REQUIRE(deque.back() == 98);
+	REQUIRE(deque.count() == 198);
+}
+
+TEST_CASE("core::Deque spans")
+{
+	core::Mallocator allocator;
+	core::Deque<int> deque{&allocator};
+	REQUIRE(deque.firstSpan().count() == 0);
+	REQUIRE(deque.secondSpan().count() == 0);
+
+	for (int i = 0; i < 6; ++i)
+	{
+		deque.push_back(i);
+	}
+	REQUIRE(deque.firstSpan().count() == 6);
+	REQUIRE(deque.secondSpan().count() == 0);
+
+	// the capacity is 8 so the next pushes wrap around
+	deque.pop_front();
+	deque.pop_front();
+	deque.pop_front();
+	deque.pop_front();
+	for (int i = 6; i < 10; ++i)
+	{
+		deque.push_back(i);
+	}
+	REQUIRE(deque.capacity() == 8);
+	auto first = deque.firstSpan();
+	auto second = deque.secondSpan();
+	REQUIRE(first.count() + second.count() == deque.count());
+	REQUIRE(first.count() == 4);
+	int expected = 4;
+	for (auto v: first)
+	{
+		REQUIRE(v == expected++);
+	}
+	for (auto v: second)
+	{
+		REQUIRE(v == expected++);
+	}
+}
+
+TEST_CASE("core::Deque of non trivial types")
+{
+	core::Mallocator allocator;
+	core::Deque<core::String> strings{&allocator};
+	for (int i = 0; i < 20; ++i)
+	{
+		strings.push_front(core::strf(&allocator, "a string which doesn't fit in the small buffer {}"_sv, i));
+	}
+
+	auto copy = strings;
+	auto moved = std::move(strings);
+	REQUIRE(copy.count() == 20);
+	REQUIRE(moved.count() == 20);
+	for (int i = 0; i < 20; ++i)
+	{
+		REQUIRE(copy[i] == moved[i]);
+		REQUIRE(copy[i] == core::strf(&allocator, "a string which doesn't fit in the small buffer {}"_sv, 19 - i));
+	}
+	copy.clear();
+	REQUIRE(copy.empty());
+	copy.push_back(core::String{"a"_sv, &allocator});
+	REQUIRE(copy.front() == "a"_sv);
+
+	core::Deque<core::Unique<int>> uniques{&allocator};
+	uniques.reserve(100);
+	REQUIRE(uniques.capacity() == 128);
+	for (int i = 0; i < 100; ++i)
+	{
+		uniques.push_back(core::unique_from<int>(&allocator, i));
+	}
+	REQUIRE(uniques.capacity() == 128);
+	auto front = std::move(uniques.front());
+	uniques.pop_front();
+	REQUIRE(*front == 0);
+	REQUIRE(*uniques.front() == 1);
+}
+
+TEST_CASE("core::Deque copy and assignment")
+{
+	core::Mallocator allocator;
+	core::Deque<core::String> strings{&allocator};
+	// wrap the elements around the end of the buffer so the copy has to put them back in order
+	for (int i = 0; i < 6; ++i)
+	{
+		strings.push_back(core::strf(&allocator, "a string which doesn't fit in the small buffer {}"_sv, i));
+	}
+	for (int i = 0; i < 4; ++i)
+	{
+		strings.pop_front();
+	}
+	for (int i = 6; i < 10; ++i)
+	{
+		strings.push_back(core::strf(&allocator, "a string which doesn't fit in the small buffer {}"_sv, i));
+	}
+	REQUIRE(strings.capacity() == 8);
+
+	core::Deque<core::String> copy{strings};
+	REQUIRE(copy.count() == 6);
+	for (size_t i = 0; i < copy.count(); ++i)
+	{
+		REQUIRE(copy[i] == strings[i]);
+	}
+
+	core::Deque<core::String> assigned{&allocator};
+	assigned.push_back(core::String{"old"_sv, &allocator});
+	assigned = strings;
+	REQUIRE(assigned.count() == 6);
+	for (size_t i = 0; i < assigned.count(); ++i)
+	{
+		REQUIRE(assigned[i] == strings[i]);
+	}
+
+	auto& self = assigned;
+	assigned = self;
+	REQUIRE(assigned.count() == 6);
+	REQUIRE(assigned.front() == strings.front());
+
+	// assigning an empty deque releases the buffer and the deque is usable afterwards
+	core::Deque<core::String> empty{&allocator};
+	assigned = empty;
+	REQUIRE(assigned.empty());
+	REQUIRE(assigned.capacity() == 0);
+	assigned.push_back(core::String{"a"_sv, &allocator});
+	REQUIRE(assigned.count() == 1);
+	REQUIRE(assigned.front() == "a"_sv);
+
+	core::Deque<core::String> moved{&allocator};
+	moved.push_back(core::String{"old"_sv, &allocator});
+	moved = std::move(copy);
+	REQUIRE(copy.empty());
+	REQUIRE(moved.count() == 6);
+	for (size_t i = 0; i < moved.count(); ++i)
+	{
+		REQUIRE(moved[i] == strings[i]);
+	}
+
+	auto& movedSelf = moved;
+	moved = std::move(movedSelf);
+	REQUIRE(moved.count() == 6);
+}
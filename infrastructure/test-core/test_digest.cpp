@@ -0,0 +1,152 @@
+#include <doctest/doctest.h>
+
+#include <core/Digest.h>
+#include <core/File.h>
+#include <core/Mallocator.h>
+#include <core/ThreadPool.h>
+
+#include <openssl/sha.h>
+
+#include <random>
+#include <vector>
+
+// the input of the official blake3 test vectors
+static std::vector<std::byte> digestInput(size_t count)
+{
+	std::vector<std::byte> res(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		res[i] = std::byte(i % 251);
+	}
+	return res;
+}
+
+TEST_CASE("core::Digest sha256")
+{
+	core::Mallocator allocator;
+	const char* vectors[][2] = {
+		{"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+		{"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+		{"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+		 "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+	};
+	for (auto [input, expected]: vectors)
+	{
+		auto digest = core::Digest::sha256(core::StringView{input});
+		REQUIRE(core::strf(&allocator, "{}"_sv, digest) == core::StringView{expected});
+	}
+
+	// every length around the block and padding boundaries, fed whole and in pieces
+	std::mt19937 gen{47};
+	for (size_t count = 0; count < 300; ++count)
+	{
+		std::vector<std::byte> input(count);
+		for (auto& b: input)
+		{
+			b = std::byte(gen());
+		}
+
+		core::Digest expected{};
+		::SHA256((const unsigned char*)input.data(), input.size(), (unsigned char*)expected.asBytes().data());
+		REQUIRE(core::Digest::sha256(core::Span<const std::byte>{input.data(), input.size()}) == expected);
+
+		core::SHA256Hasher hasher;
+		for (size_t i = 0, step = 1; i < count; i += step, step += 13)
+		{
+			hasher.hash(core::Span<const std::byte>{input.data() + i, std::min(step, count - i)});
+		}
+		REQUIRE(hasher.final() == expected);
+	}
+}
+
+TEST_CASE("core::Digest blake3")
+{
+	core::Mallocator allocator;
+	struct Vector
+	{
+		size_t count;
+		const char* expected;
+	};
+	Vector vectors[] = {
+		{0, "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262"},
+		{1, "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213"},
+		{1023, "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11"},
+		{1024, "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7"},
+		{1025, "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444"},
+		{2048, "e776b6028c7cd22a4d0ba182a8bf62205d2ef576467e838ed6f2529b85fba24a"},
+		{2049, "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030"},
+		{3072, "b98cb0ff3623be03326b373de6b9095218513e64f1ee2edd2525c7ad1e5cffd2"},
+		{3073, "7124b49501012f81cc7f11ca069ec9226cecb8a2c850cfe644e327d22d3e1cd3"},
+		{4096, "015094013f57a5277b59d8475c0501042c0b642e531b0a1c8f58d2163229e969"},
+		{4097, "9b4052b38f1c5fc8b1f9ff7ac7b27cd242487b3d890d15c96a1c25b8aa0fb995"},
+		{5120, "9cadc15fed8b5d854562b26a9536d9707cadeda9b143978f319ab34230535833"},
+		{5121, "628bd2cb2004694adaab7bbd778a25df25c47b9d4155a55f8fbd79f2fe154cff"},
+		{6144, "3e2e5b74e048f3add6d21faab3f83aa44d3b2278afb83b80b3c35164ebeca205"},
+		{6145, "f1323a8631446cc50536a9f705ee5cb619424d46887f3c376c695b70e0f0507f"},
+		{7168, "61da957ec2499a95d6b8023e2b0e604ec7f6b50e80a9678b89d2628e99ada77a"},
+		{7169, "a003fc7a51754a9b3c7fae0367ab3d782dccf28855a03d435f8cfe74605e7817"},
+		{8192, "aae792484c8efe4f19e2ca7d371d8c467ffb10748d8a5a1ae579948f718a2a63"},
+		{8193, "bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b"},
+		{16384, "f875d6646de28985646f34ee13be9a576fd515f76b5b0a26bb324735041ddde4"},
+		{31744, "62b6960e1a44bcc1eb1a611a8d6235b6b4b78f32e7abc4fb4c6cdcce94895c47"},
+		{102400, "bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085"},
+	};
+
+	for (auto [count, expected]: vectors)
+	{
+		auto input = digestInput(count);
+		auto digest = core::Digest::blake3(core::Span<const std::byte>{input.data(), input.size()});
+		REQUIRE(core::strf(&allocator, "{}"_sv, digest) == core::StringView{expected});
+
+		core::Blake3Hasher hasher;
+		for (size_t i = 0, step = 1; i < count; i += step, step = step * 2 + 1)
+		{
+			hasher.hash(core::Span<const std::byte>{input.data() + i, std::min(step, count - i)});
+		}
+		REQUIRE(hasher.final() == digest);
+	}
+}
+
+TEST_CASE("core::Digest blake3 on a thread pool")
+{
+	core::Mallocator allocator;
+	core::ThreadPool pool{&allocator, 4};
+
+	// big enough for a few subtrees which don't end at a subtree boundary
+	auto input = digestInput(5 * 1024 * 1024 + 777);
+	auto bytes = core::Span<const std::byte>{input.data(), input.size()};
+	auto expected = core::Digest::blake3(bytes);
+	REQUIRE(core::Digest::blake3(bytes, &pool, &allocator) == expected);
+
+	// pieces which leave the tree in the middle of a subtree
+	core::Blake3Hasher hasher{&pool, &allocator};
+	hasher.hash(core::Span<const std::byte>{input.data(), 3000});
+	hasher.hash(core::Span<const std::byte>{input.data() + 3000, input.size() - 3000});
+	REQUIRE(hasher.final() == expected);
+}
+
+TEST_CASE("core::Digest hashFile")
+{
+	core::Mallocator allocator;
+	core::ThreadPool pool{&allocator, 4};
+
+	auto input = digestInput(17 * 1024 * 1024 + 5);
+	auto bytes = core::Span<const std::byte>{input.data(), input.size()};
+	{
+		auto file = core::File::open(
+			&allocator, "test_digest.bin"_sv, core::File::IO_MODE_WRITE, core::File::OPEN_MODE_CREATE_OVERWRITE);
+		REQUIRE(file != nullptr);
+		REQUIRE(file->write(input.data(), input.size()) == input.size());
+	}
+
+	auto sha256 = core::Digest::hashFile(&allocator, "test_digest.bin"_sv, core::Digest::ALGORITHM_SHA256);
+	REQUIRE(sha256.isError() == false);
+	REQUIRE(sha256.value() == core::Digest::sha256(bytes));
+
+	auto blake3 = core::Digest::hashFile(&allocator, "test_digest.bin"_sv, core::Digest::ALGORITHM_BLAKE3, &pool);
+	REQUIRE(blake3.isError() == false);
+	REQUIRE(blake3.value() == core::Digest::blake3(bytes));
+
+	auto missing = core::Digest::hashFile(&allocator, "missing_digest.bin"_sv, core::Digest::ALGORITHM_BLAKE3);
+	REQUIRE(missing.isError());
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include <doctest/doctest.h>
+
+#include <core/FlatMap.h>
+#include <core/Mallocator.h>
+#include <core/ProfilingAllocator.h>
+#include <core/String.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+TEST_CASE("core::FlatMap insert, lookup and remove")
+{
+	core::Mallocator allocator;
+	core::FlatMap<int, int> map{&allocator};
+	REQUIRE(map.empty());
+	REQUIRE(map.begin() == map.end());
+	REQUIRE(map.lookup(1) == map.end());
+	REQUIRE(map.remove(1) == false);
+
+	// sizes below and above the linear search threshold
+	for (int count: {1, 3, 7, 8, 9, 100})
+	{
+		map.clear();
+		for (int i = count - 1; i >= 0; --i)
+		{
+			REQUIRE(map.insert(i * 2, i));
+		}
+		REQUIRE(map.insert(0, 100) == false);
+		REQUIRE(map.lookup(0)->value == 0);
+		REQUIRE(map.count() == size_t(count));
+
+		int expected = 0;
+		for (const auto& [key, value]: map)
+		{
+			REQUIRE(key == expected * 2);
+			REQUIRE(value == expected);
+			++expected;
+		}
+		REQUIRE(expected == count);
+
+		for (int i = -1; i < count * 2 + 1; ++i)
+		{
+			auto it = map.lookup(i);
+			if (i >= 0 && i % 2 == 0 && i < count * 2)
+			{
+				REQUIRE(it != map.end());
+				REQUIRE(it->value == i / 2);
+			}
+			else
+			{
+				REQUIRE(it == map.end());
+			}
+			REQUIRE(map.lowerBound(i) - map.begin() == std::clamp((i + 1) / 2, 0, count));
+			REQUIRE(map.upperBound(i) - map.begin() == std::clamp(i < 0 ? 0 : i / 2 + 1, 0, count));
+		}
+
+		for (int i = 0; i < count * 2; i += 4)
+		{
+			REQUIRE(map.remove(i));
+			REQUIRE(map.remove(i) == false);
+		}
+		for (int i = 0; i < count * 2; i += 2)
+		{
+			REQUIRE((map.lookup(i) != map.end()) == (i % 4 != 0));
+		}
+	}
+}
+
+TEST_CASE("core::FlatMap build")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator allocator{&mallocator, 0};
+	{
+		std::mt19937 gen{42};
+		std::map<int, int> reference;
+		core::Array<core::KeyValue<int, int>> entries{&allocator};
+		for (int i = 0; i < 1000; ++i)
+		{
+			auto key = int(gen() % 500);
+			entries.push(core::KeyValue<int, int>{key, i});
+			reference.insert({key, i});
+		}
+
+		core::FlatMap<int, int> map{&allocator};
+		map.insert(1000, 1000);
+		map.build(std::move(entries));
+		REQUIRE(map.count() == reference.size());
+		REQUIRE(map.lookup(1000) == map.end());
+
+		// a repeated key keeps its first value like inserting one by one
+		auto it = map.entries().begin();
+		for (const auto& [key, value]: reference)
+		{
+			REQUIRE(it->key == key);
+			REQUIRE(it->value == value);
+			++it;
+		}
+
+		auto copy = map;
+		REQUIRE(copy.remove(reference.begin()->first));
+		REQUIRE(copy.count() + 1 == map.count());
+	}
+	REQUIRE(allocator.stats().liveCount == 0);
+}
+
+TEST_CASE("core::FlatMap string keys")
+{
+	core::Mallocator allocator;
+	core::FlatMap<core::String, int> map{&allocator};
+	REQUIRE(map.insert("content-type"_sv, 1));
+	REQUIRE(map.insert(core::String{"host"_sv, &allocator}, 2));
+	REQUIRE(map.insert("accept"_sv, 3));
+	REQUIRE(map.insert("host"_sv, 4) == false);
+
+	REQUIRE(map.lookup("host"_sv)->value == 2);
+	REQUIRE(map.lookup("accept"_sv)->value == 3);
+	REQUIRE(map.lookup("cookie"_sv) == map.end());
+	REQUIRE(map.begin()->key == "accept"_sv);
+
+	core::FlatSet<core::StringView> set{&allocator};
+	REQUIRE(set.insert("while"_sv));
+	REQUIRE(set.insert("class"_sv));
+	REQUIRE(set.insert("if"_sv));
+	REQUIRE(set.insert("if"_sv) == false);
+	REQUIRE(set.count() == 3);
+	REQUIRE(set.lookup("class"_sv) != set.end());
+	REQUIRE(set.lookup("else"_sv) == set.end());
+	REQUIRE(*set.begin() == "class"_sv);
+	REQUIRE(set.entries()[2] == "while"_sv);
+	REQUIRE(set.remove("class"_sv));
+	REQUIRE(*set.begin() == "if"_sv);
+}
@@ -2,6 +2,8 @@
 
 #include <core/Hash.h>
 #include <core/Mallocator.h>
+#include <core/ProfilingAllocator.h>
+#include <core/SHA1.h>
 #include <core/Shared.h>
 #include <core/Unique.h>
 
@@ -71,3 +73,404 @@ TEST_CASE("basic core::Set test with core::Weak")
 	numbers.insert(val);
 	numbers.remove(val);
 }
+
+TEST_CASE("core::Map insert, lookup and remove many keys")
+{
+	core::Mallocator allocator;
+	core::Map<int, int> numbers{&allocator};
+
+	constexpr int COUNT = 10000;
+	for (int i = 0; i < COUNT; ++i)
+	{
+		numbers.insert(i, i * 2);
+	}
+	REQUIRE(numbers.count() == COUNT);
+
+	// insert keeps the first value of a key
+	numbers.insert(42, 0);
+	REQUIRE(numbers.lookup(42)->value == 84);
+
+	for (int i = 0; i < COUNT; i += 2)
+	{
+		REQUIRE(numbers.remove(i));
+	}
+	REQUIRE(numbers.remove(0) == false);
+	REQUIRE(numbers.count() == COUNT / 2);
+
+	for (int i = 0; i < COUNT; ++i)
+	{
+		auto it = numbers.lookup(i);
+		if (i % 2 == 0)
+		{
+			REQUIRE(it == numbers.end());
+		}
+		else
+		{
+			REQUIRE(it != numbers.end());
+			REQUIRE(it->value == i * 2);
+		}
+	}
+
+	// the values are stored densely
+	size_t visited = 0;
+	for (const auto& [key, value]: numbers)
+	{
+		REQUIRE(key % 2 == 1);
+		REQUIRE(value == key * 2);
+		++visited;
+	}
+	REQUIRE(visited == numbers.count());
+
+	auto copy = numbers;
+	for (int i = 1; i < COUNT; i += 2)
+	{
+		REQUIRE(copy.lookup(i)->value == i * 2);
+	}
+}
+
+TEST_CASE("core::Set insert and remove churn")
+{
+	core::Mallocator allocator;
+	core::Set<core::String> strings{&allocator};
+
+	// a sliding window of keys keeps the table size stable while it's full of removed slots
+	constexpr int WINDOW = 100;
+	for (int i = 0; i < 20000; ++i)
+	{
+		strings.insert(core::strf(&allocator, "key-{}"_sv, i));
+		if (i >= WINDOW)
+		{
+			REQUIRE(strings.remove(core::strf(&allocator, "key-{}"_sv, i - WINDOW)));
+		}
+	}
+	REQUIRE(strings.count() == WINDOW);
+	REQUIRE(strings.capacity() <= 256);
+
+	for (int i = 20000 - WINDOW; i < 20000; ++i)
+	{
+		REQUIRE(strings.lookup(core::strf(&allocator, "key-{}"_sv, i)) != strings.end());
+	}
+	REQUIRE(strings.lookup(core::strf(&allocator, "key-{}"_sv, 0)) == strings.end());
+
+	strings.clear();
+	REQUIRE(strings.count() == 0);
+	REQUIRE(strings.begin() == strings.end());
+	strings.insert(core::String{"key"_sv, &allocator});
+	REQUIRE(strings.count() == 1);
+}
+
+TEST_CASE("core::hashBytes")
+{
+	core::Mallocator allocator;
+
+	core::Buffer bytes{&allocator};
+	for (size_t i = 0; i < 300; ++i)
+	{
+		bytes.push(std::byte(i * 31));
+	}
+
+	// every prefix length takes a different path through the hash function so they all have to be distinct
+	core::Set<size_t> hashes{&allocator};
+	for (size_t i = 0; i <= bytes.count(); ++i)
+	{
+		auto prefix = core::Span<const std::byte>{bytes}.sliceLeft(i);
+		REQUIRE(core::hashBytes(prefix, 1) == core::hashBytes(prefix, 1));
+		REQUIRE(core::hashBytes(prefix, 1) != core::hashBytes(prefix, 2));
+		hashes.insert(core::hashBytes(prefix, 1));
+	}
+	REQUIRE(hashes.count() == bytes.count() + 1);
+
+	// flipping any single bit changes the hash
+	for (size_t i = 0; i < 64 * 8; ++i)
+	{
+		auto before = core::hashBytes(core::Span<const std::byte>{bytes}.sliceLeft(64), 1);
+		bytes[i / 8] ^= std::byte(1 << (i % 8));
+		auto after = core::hashBytes(core::Span<const std::byte>{bytes}.sliceLeft(64), 1);
+		bytes[i / 8] ^= std::byte(1 << (i % 8));
+		REQUIRE(before != after);
+	}
+}
+
+TEST_CASE("core::Hash specializations")
+{
+	REQUIRE(core::Hash<double>{}(0.0, 1) == core::Hash<double>{}(-0.0, 1));
+	REQUIRE(core::Hash<float>{}(0.0f, 1) == core::Hash<float>{}(-0.0f, 1));
+	REQUIRE(core::Hash<int>{}(1, 1) != core::Hash<int>{}(2, 1));
+	REQUIRE(core::Hash<int>{}(1, 1) != core::Hash<int>{}(1, 2));
+
+	auto sha = core::SHA1::hash("hello"_sv);
+	auto other = core::SHA1::hash("world"_sv);
+	REQUIRE(core::Hash<core::SHA1>{}(sha, 1) == core::Hash<core::SHA1>{}(core::SHA1::hash("hello"_sv), 1));
+	REQUIRE(core::Hash<core::SHA1>{}(sha, 1) != core::Hash<core::SHA1>{}(other, 1));
+}
+
+TEST_CASE("core::HashSeed")
+{
+	REQUIRE(core::HashSeed::random().value() != core::HashSeed::random().value());
+
+	// copies keep the seed of the original so their slots are copied as is
+	core::Mallocator allocator;
+	core::Map<int, int> a{&allocator, core::HashSeed{42}};
+	for (int i = 0; i < 1000; ++i)
+	{
+		a.insert(i, i);
+	}
+	auto c = a;
+	for (int i = 0; i < 1000; ++i)
+	{
+		REQUIRE(c.lookup(i)->value == i);
+	}
+	c.insert(1000, 1000);
+	REQUIRE(c.lookup(1000)->value == 1000);
+	REQUIRE(a.lookup(1000) == a.end());
+}
+
+TEST_CASE("core::Map incremental rehash")
+{
+	core::Mallocator allocator;
+	core::Map<int, int> numbers{&allocator};
+	numbers.setIncrementalRehash(true);
+	REQUIRE(numbers.incrementalRehash());
+
+	// check the whole table every few inserts and right after the table grows while the rehash is in progress, the
+	// bigger tables take a few steps to move
+	constexpr int COUNT = 100000;
+	size_t capacity = numbers.capacity();
+	int check_until = -1;
+	for (int i = 0; i < COUNT; ++i)
+	{
+		numbers.insert(i, i * 2);
+		numbers.insert(i, 0);
+		if (numbers.capacity() != capacity)
+		{
+			capacity = numbers.capacity();
+			check_until = i + 4;
+		}
+		if (i % 10000 == 9999 || i <= check_until)
+		{
+			for (int j = 0; j <= i; ++j)
+			{
+				REQUIRE(numbers.lookup(j)->value == j * 2);
+			}
+			REQUIRE(numbers.lookup(i + 1) == numbers.end());
+
+			// copies and moves take the in progress rehash with them
+			auto copy = numbers;
+			copy.insert(-1, -1);
+			REQUIRE(copy.count() == size_t(i) + 2);
+			auto moved = std::move(copy);
+			for (int j = -1; j <= i; ++j)
+			{
+				REQUIRE(moved.lookup(j) != moved.end());
+			}
+		}
+	}
+	REQUIRE(numbers.count() == COUNT);
+
+	// removing most of the keys shrinks the table while keys are still in the old table
+	for (int i = 0; i < COUNT; ++i)
+	{
+		if (i % 10 != 0)
+		{
+			REQUIRE(numbers.remove(i));
+		}
+		if (i % 5000 == 4999)
+		{
+			for (int j = i + 1; j < COUNT; ++j)
+			{
+				REQUIRE(numbers.lookup(j)->value == j * 2);
+			}
+		}
+	}
+	REQUIRE(numbers.count() == COUNT / 10);
+	REQUIRE(numbers.capacity() <= 32768);
+
+	numbers.setIncrementalRehash(false);
+	for (int i = 0; i < COUNT; ++i)
+	{
+		auto it = numbers.lookup(i);
+		REQUIRE((it != numbers.end()) == (i % 10 == 0));
+	}
+	size_t visited = 0;
+	for (const auto& [key, value]: numbers)
+	{
+		REQUIRE(value == key * 2);
+		++visited;
+	}
+	REQUIRE(visited == numbers.count());
+}
+
+TEST_CASE("core::Set incremental rehash preparation")
+{
+	core::Mallocator allocator;
+	core::Set<int> numbers{&allocator};
+	numbers.setIncrementalRehash(true);
+
+	// the table grows from 128K to 256K slots which is too big to prepare in a single step, the inserts around the
+	// threshold go to the current table while the next one is prepared and copies, moves, removes and disabling the
+	// incremental mode in between leave the tables complete
+	constexpr int GROW_AT = 131072 - 131072 / 8;
+	int grown_at = -1;
+	for (int i = 0; i < GROW_AT + 64; ++i)
+	{
+		numbers.insert(i);
+		if (grown_at == -1 && numbers.capacity() > 131072)
+		{
+			grown_at = i;
+		}
+		if (i < GROW_AT - 4)
+		{
+			continue;
+		}
+
+		REQUIRE(numbers.lookup(i) != numbers.end());
+		REQUIRE(numbers.lookup(i - GROW_AT / 2) != numbers.end());
+		REQUIRE(numbers.lookup(i + 1) == numbers.end());
+		if (i % 8 == 0)
+		{
+			auto copy = numbers;
+			copy.insert(-1);
+			REQUIRE(copy.remove(0));
+			auto moved = std::move(copy);
+			moved.setIncrementalRehash(false);
+			for (int j = 1; j <= i; ++j)
+			{
+				REQUIRE(moved.lookup(j) != moved.end());
+			}
+			REQUIRE(moved.lookup(-1) != moved.end());
+			REQUIRE(moved.lookup(0) == moved.end());
+			REQUIRE(moved.count() == size_t(i) + 1);
+		}
+	}
+	REQUIRE(grown_at > GROW_AT);
+	REQUIRE(grown_at < GROW_AT + 16);
+
+	for (int i = 0; i < GROW_AT + 64; ++i)
+	{
+		REQUIRE(numbers.lookup(i) != numbers.end());
+	}
+	REQUIRE(numbers.count() == GROW_AT + 64);
+}
+
+TEST_CASE("core::Set incremental rehash churn")
+{
+	core::Mallocator allocator;
+	core::Set<core::String> strings{&allocator};
+	strings.setIncrementalRehash(true);
+
+	// the sliding window rebuilds the table to clean up the removed slots over and over
+	constexpr int WINDOW = 1000;
+	for (int i = 0; i < 50000; ++i)
+	{
+		strings.insert(core::strf(&allocator, "key-{}"_sv, i));
+		if (i >= WINDOW)
+		{
+			REQUIRE(strings.remove(core::strf(&allocator, "key-{}"_sv, i - WINDOW)));
+		}
+		if (i % 997 == 0)
+		{
+			for (int j = i < WINDOW ? 0 : i - WINDOW + 1; j <= i; ++j)
+			{
+				REQUIRE(strings.lookup(core::strf(&allocator, "key-{}"_sv, j)) != strings.end());
+			}
+		}
+	}
+	REQUIRE(strings.count() == WINDOW);
+	REQUIRE(strings.capacity() <= 4096);
+
+	strings.clear();
+	REQUIRE(strings.count() == 0);
+	strings.insert(core::String{"key"_sv, &allocator});
+	REQUIRE(strings.lookup(core::String{"key"_sv, &allocator}) != strings.end());
+}
+
+TEST_CASE("core::Map incremental values growth")
+{
+	core::Mallocator allocator;
+	core::Map<int, core::String> numbers{&allocator};
+	numbers.setIncrementalRehash(true);
+
+	auto check = [&] {
+		size_t visited = 0;
+		size_t matching = 0;
+		for (const auto& [key, value]: numbers)
+		{
+			if (value == core::strf(&allocator, "{}"_sv, key) && numbers.lookup(key) != numbers.end())
+			{
+				++matching;
+			}
+			++visited;
+		}
+		REQUIRE(matching == visited);
+		REQUIRE(visited == numbers.count());
+	};
+
+	// the last insert grows the values array and there are enough values that moving them takes a few steps, removes
+	// fill their hole with the last value which may be in either array and inserts go to the old array if there's room
+	constexpr int COUNT = 128 * 1024 + 1;
+	for (int i = 0; i < COUNT; ++i)
+	{
+		numbers.insert(i, core::strf(&allocator, "{}"_sv, i));
+	}
+	for (int i = 0; i < 16; ++i)
+	{
+		REQUIRE(numbers.remove(i * 7));
+		check();
+		numbers.insert(COUNT + i, core::strf(&allocator, "{}"_sv, COUNT + i));
+		check();
+		REQUIRE(numbers.remove(COUNT - 1 - i * 7));
+		check();
+		REQUIRE(numbers.lookup(i * 7) == numbers.end());
+		REQUIRE(numbers.lookup(COUNT + i)->value == core::strf(&allocator, "{}"_sv, COUNT + i));
+	}
+
+	auto copy = numbers;
+	REQUIRE(copy.count() == numbers.count());
+	numbers.clear();
+	REQUIRE(numbers.begin() == numbers.end());
+}
+
+TEST_CASE("core::Map heterogeneous lookup")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator allocator{&mallocator, 0};
+	core::Map<core::String, int> numbers{&allocator};
+
+	// keys longer than the small string optimization so any conversion would allocate
+	auto one = "the first key which doesn't fit in a small string"_sv;
+	auto two = "the second key which doesn't fit in a small string"_sv;
+	numbers.insert(one, 1);
+	numbers.insert(core::String{two, &allocator}, 2);
+	REQUIRE(numbers.lookup(one)->key.allocator() == &allocator);
+
+	auto allocatedCount = allocator.stats().allocatedCount;
+	REQUIRE(numbers.lookup(one)->value == 1);
+	REQUIRE(numbers.lookup(two)->value == 2);
+	REQUIRE(numbers.lookup("the third key which doesn't fit in a small string"_sv) == numbers.end());
+	numbers.insert(one, 3);
+	REQUIRE(numbers.lookup(one)->value == 1);
+	REQUIRE(allocator.stats().allocatedCount == allocatedCount);
+
+	REQUIRE(numbers.remove(two));
+	REQUIRE(numbers.remove(two) == false);
+	REQUIRE(numbers.count() == 1);
+
+	// tables with the same seed agree on the hashes so a key can be hashed once for all of them
+	core::Map<core::String, int> other{&allocator, numbers.seed()};
+	auto hash = core::Hash<core::String>{}(two, numbers.seed().value());
+	REQUIRE(hash == core::Hash<core::StringView>{}(two, numbers.seed().value()));
+	numbers.insertWithHash(two, hash, 2);
+	other.insertWithHash(two, hash, 4);
+	REQUIRE(numbers.lookupWithHash(two, hash)->value == 2);
+	REQUIRE(other.lookupWithHash(two, hash)->value == 4);
+	REQUIRE(other.lookup(two)->value == 4);
+	REQUIRE(other.removeWithHash(two, hash));
+	REQUIRE(other.lookup(two) == other.end());
+
+	core::Set<core::String> strings{&allocator};
+	strings.insert(one);
+	REQUIRE(strings.lookup(one) != strings.end());
+	REQUIRE(strings.lookupWithHash(one, core::Hash<core::String>{}(one, strings.seed().value())) != strings.end());
+	REQUIRE(strings.remove(one));
+	REQUIRE(strings.count() == 0);
+}
@@ -0,0 +1,164 @@
+#include <doctest/doctest.h>
+
+#include <core/Interner.h>
+#include <core/Mallocator.h>
+#include <core/MemoryStream.h>
+#include <core/Msgpack.h>
+#include <core/String.h>
+#include <core/Thread.h>
+
+TEST_CASE("core::Interner basics")
+{
+	core::Mallocator allocator;
+	core::Interner interner{&allocator};
+	REQUIRE(interner.count() == 0);
+	REQUIRE(core::Symbol{}.valid() == false);
+	REQUIRE(interner.str(core::Symbol{}) == ""_sv);
+
+	auto one = interner.intern("one"_sv);
+	auto two = interner.intern("two"_sv);
+	REQUIRE(one.valid());
+	REQUIRE(two.valid());
+	REQUIRE(one != two);
+	REQUIRE(interner.intern("one"_sv) == one);
+	REQUIRE(interner.intern(core::String{"two"_sv, &allocator}) == two);
+	REQUIRE(interner.count() == 2);
+
+	REQUIRE(interner.str(one) == "one"_sv);
+	REQUIRE(interner.str(two) == "two"_sv);
+	REQUIRE(interner.lookup("two"_sv) == two);
+	REQUIRE(interner.lookup("three"_sv).valid() == false);
+	REQUIRE(interner.count() == 2);
+
+	auto empty = interner.intern(""_sv);
+	REQUIRE(empty.valid());
+	REQUIRE(interner.str(empty) == ""_sv);
+
+	core::Map<core::Symbol, int> values{&allocator};
+	values.insert(one, 1);
+	values.insert(two, 2);
+	REQUIRE(values.lookup(interner.intern("two"_sv))->value == 2);
+}
+
+TEST_CASE("core::Interner views stay valid")
+{
+	core::Mallocator allocator;
+	core::Interner interner{&allocator};
+
+	// enough strings to fill a few blocks and grow the table many times, with one bigger than a block
+	core::Array<core::Symbol> symbols{&allocator};
+	core::Array<core::StringView> views{&allocator};
+	for (int i = 0; i < 20000; ++i)
+	{
+		auto symbol = interner.intern(core::strf(&allocator, "symbol-{}"_sv, i));
+		symbols.push(symbol);
+		views.push(interner.str(symbol));
+	}
+	core::String big{&allocator};
+	big.resize(100 * 1024);
+	auto bigSymbol = interner.intern(big);
+	REQUIRE(interner.str(bigSymbol).count() == big.count());
+
+	for (int i = 0; i < 20000; ++i)
+	{
+		auto str = core::strf(&allocator, "symbol-{}"_sv, i);
+		REQUIRE(views[i] == str);
+		REQUIRE(views[i].data() == interner.str(symbols[i]).data());
+		REQUIRE(interner.lookup(str) == symbols[i]);
+	}
+
+	auto moved = std::move(interner);
+	REQUIRE(moved.count() == 20001);
+	REQUIRE(moved.str(symbols[42]).data() == views[42].data());
+}
+
+TEST_CASE("core::ConcurrentInterner many threads")
+{
+	core::Mallocator allocator;
+	core::ConcurrentInterner interner{&allocator, 4};
+	REQUIRE(interner.shardsCount() == 4);
+
+	constexpr int THREADS_COUNT = 8;
+	constexpr int STRINGS_COUNT = 5000;
+	core::Array<core::Array<core::Symbol>> results{&allocator};
+	for (int t = 0; t < THREADS_COUNT; ++t)
+	{
+		results.push(core::Array<core::Symbol>{&allocator});
+	}
+
+	// a thread records the invalid symbol if str() doesn't give back the string it interned
+	core::Array<core::Thread> threads{&allocator};
+	for (int t = 0; t < THREADS_COUNT; ++t)
+	{
+		threads.push(core::Thread{&allocator, [&interner, &results, t] {
+									  auto& symbols = results[t];
+									  for (int i = 0; i < STRINGS_COUNT; ++i)
+									  {
+										  auto index = (i + t * 97) % STRINGS_COUNT;
+										  auto str = core::strf(symbols.allocator(), "str-{}"_sv, index);
+										  auto symbol = interner.intern(str);
+										  symbols.push(interner.str(symbol) == str ? symbol : core::Symbol{});
+									  }
+								  }});
+	}
+	for (auto& thread: threads)
+	{
+		thread.join();
+	}
+	REQUIRE(interner.count() == STRINGS_COUNT);
+
+	// every thread must have got the same symbol for the same string
+	for (int t = 0; t < THREADS_COUNT; ++t)
+	{
+		for (int i = 0; i < STRINGS_COUNT; ++i)
+		{
+			REQUIRE(results[t][i].valid());
+			REQUIRE(results[t][i] == results[0][(i + t * 97) % STRINGS_COUNT]);
+		}
+	}
+
+	REQUIRE(interner.lookup("str-7"_sv) == results[0][7]);
+	REQUIRE(interner.lookup("missing"_sv).valid() == false);
+}
+
+TEST_CASE("core::Interner msgpack map keys")
+{
+	core::Mallocator allocator;
+	core::Interner interner{&allocator};
+
+	core::Map<core::String, uint64_t> map{&allocator};
+	map.insert(core::String{"id"_sv, &allocator}, uint64_t(1));
+	map.insert(core::String{"name"_sv, &allocator}, uint64_t(2));
+
+	core::MemoryStream stream{&allocator};
+	core::msgpack::Writer writer{&stream, &allocator};
+	for (int i = 0; i < 3; ++i)
+	{
+		REQUIRE(core::msgpack::msgpack(writer, map) == false);
+	}
+
+	stream.seek(0, core::Stream::SEEK_MODE_BEGIN);
+	core::msgpack::Reader reader{&stream, &allocator, &interner};
+	for (int i = 0; i < 3; ++i)
+	{
+		core::Map<core::Symbol, uint64_t> decoded{&allocator};
+		REQUIRE(core::msgpack::msgpack(reader, decoded) == false);
+		REQUIRE(decoded.count() == 2);
+		REQUIRE(decoded.lookup(interner.lookup("id"_sv))->value == 1);
+		REQUIRE(decoded.lookup(interner.lookup("name"_sv))->value == 2);
+	}
+	// the keys were copied once no matter how many maps used them
+	REQUIRE(interner.count() == 2);
+
+	core::MemoryStream out{&allocator};
+	core::msgpack::Writer symbolWriter{&out, &allocator, &interner};
+	core::Map<core::Symbol, uint64_t> symbols{&allocator};
+	symbols.insert(interner.intern("id"_sv), uint64_t(1));
+	REQUIRE(core::msgpack::msgpack(symbolWriter, symbols) == false);
+
+	out.seek(0, core::Stream::SEEK_MODE_BEGIN);
+	core::msgpack::Reader stringReader{&out, &allocator};
+	core::Map<core::String, uint64_t> strings{&allocator};
+	REQUIRE(core::msgpack::msgpack(stringReader, strings) == false);
+	REQUIRE(strings.lookup("id"_sv)->value == 1);
+}
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include <doctest/doctest.h>
+
+#include <core/Number.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+static uint64_t bitsOf(double value)
+{
+	uint64_t res;
+	::memcpy(&res, &value, sizeof(res));
+	return res;
+}
+
+// checks parseFloat against strtod which is correctly rounded in glibc and msvc
+static void checkFloat(const std::string& str)
+{
+	auto expected = ::strtod(str.c_str(), nullptr);
+	auto res = core::parseFloat(core::StringView{str.data(), str.size()});
+	if (std::isinf(expected))
+	{
+		REQUIRE(res.isError());
+		REQUIRE(res.error() == core::ParseNumberErr::Range);
+	}
+	else
+	{
+		INFO(str);
+		REQUIRE(res.isValue());
+		REQUIRE(bitsOf(res.value()) == bitsOf(expected));
+	}
+}
+
+TEST_CASE("core::parseUint")
+{
+	REQUIRE(core::parseUint("0"_sv).value() == 0);
+	REQUIRE(core::parseUint("8080"_sv).value() == 8080);
+	REQUIRE(core::parseUint("18446744073709551615"_sv).value() == UINT64_MAX);
+	REQUIRE(core::parseUint("000000000000000000000000000042"_sv).value() == 42);
+	REQUIRE(core::parseUint("18446744073709551616"_sv).error() == core::ParseNumberErr::Range);
+	REQUIRE(core::parseUint("99999999999999999999"_sv).error() == core::ParseNumberErr::Range);
+	REQUIRE(core::parseUint("123456789012345678901234567890"_sv).error() == core::ParseNumberErr::Range);
+	REQUIRE(core::parseUint("123456789012345678901234567890x"_sv).error() == core::ParseNumberErr::Syntax);
+
+	for (auto str: {""_sv, "+1"_sv, "-1"_sv, " 1"_sv, "1 "_sv, "12345678a"_sv, "1.0"_sv, "0x10"_sv})
+	{
+		REQUIRE(core::parseUint(str).error() == core::ParseNumberErr::Syntax);
+	}
+
+	std::mt19937_64 gen{1};
+	for (size_t i = 0; i < 10000; ++i)
+	{
+		auto value = gen() >> (gen() % 64);
+		auto str = std::to_string(value);
+		REQUIRE(core::parseUint(core::StringView{str.data(), str.size()}).value() == value);
+	}
+}
+
+TEST_CASE("core::parseInt")
+{
+	REQUIRE(core::parseInt("-0"_sv).value() == 0);
+	REQUIRE(core::parseInt("+42"_sv).value() == 42);
+	REQUIRE(core::parseInt("-42"_sv).value() == -42);
+	REQUIRE(core::parseInt("9223372036854775807"_sv).value() == INT64_MAX);
+	REQUIRE(core::parseInt("-9223372036854775808"_sv).value() == INT64_MIN);
+	REQUIRE(core::parseInt("9223372036854775808"_sv).error() == core::ParseNumberErr::Range);
+	REQUIRE(core::parseInt("-9223372036854775809"_sv).error() == core::ParseNumberErr::Range);
+	REQUIRE(core::parseInt("-"_sv).error() == core::ParseNumberErr::Syntax);
+	REQUIRE(core::parseInt("--1"_sv).error() == core::ParseNumberErr::Syntax);
+
+	std::mt19937_64 gen{2};
+	for (size_t i = 0; i < 10000; ++i)
+	{
+		auto value = int64_t(gen()) >> (gen() % 64);
+		auto str = std::to_string(value);
+		REQUIRE(core::parseInt(core::StringView{str.data(), str.size()}).value() == value);
+	}
+}
+
+TEST_CASE("core::parseFloat")
+{
+	REQUIRE(core::parseFloat("1.5"_sv).value() == 1.5);
+	REQUIRE(core::parseFloat("-.5e1"_sv).value() == -5.0);
+	REQUIRE(core::parseFloat("5."_sv).value() == 5.0);
+	REQUIRE(bitsOf(core::parseFloat("-0"_sv).value()) == bitsOf(-0.0));
+	REQUIRE(core::parseFloat("inf"_sv).value() == HUGE_VAL);
+	REQUIRE(core::parseFloat("-Infinity"_sv).value() == -HUGE_VAL);
+	REQUIRE(std::isnan(core::parseFloat("NaN"_sv).value()));
+	REQUIRE(core::parseFloat("1e400"_sv).error() == core::ParseNumberErr::Range);
+	REQUIRE(core::parseFloat("-1e400"_sv).error() == core::ParseNumberErr::Range);
+	REQUIRE(core::parseFloat("1e-400"_sv).value() == 0.0);
+	REQUIRE(core::parseFloat("1e99999999999999999999"_sv).error() == core::ParseNumberErr::Range);
+	REQUIRE(core::parseFloat("0e99999999999999999999"_sv).value() == 0.0);
+
+	auto syntaxErrors = {
+		""_sv, "."_sv, "+"_sv, "e5"_sv, "1e"_sv, "1e+"_sv, "1.2.3"_sv, " 1"_sv, "1 "_sv, "0x10"_sv, "in"_sv};
+	for (auto str: syntaxErrors)
+	{
+		REQUIRE(core::parseFloat(str).error() == core::ParseNumberErr::Syntax);
+	}
+
+	// halfway cases, subnormals and the edges of the double range
+	for (auto str: {
+			 "9007199254740993",
+			 "9007199254740993.0000000000000000000000000000001",
+			 "9007199254740992.9999999999999999999999999999999",
+			 "2.2250738585072011e-308",
+			 "2.2250738585072014e-308",
+			 "4.9406564584124654e-324",
+			 "2.4703282292062327e-324",
+			 "2.4703282292062328e-324",
+			 "1.7976931348623157e308",
+			 "1.7976931348623158e308",
+			 "1.7976931348623159e308",
+			 "179769313486231580793728971405301e276",
+			 "0.1",
+			 "0.30000000000000004",
+			 "123456789012345678901234567890",
+			 "7.3177701707893310e+15",
+		 })
+	{
+		checkFloat(str);
+	}
+
+	// the halfway point between 1 and the next double with enough digits to go through the slow path and a non zero
+	// digit far beyond the digits strtod needs
+	std::string halfway = "1.00000000000000011102230246251565404236316680908203125";
+	checkFloat(halfway);
+	checkFloat(halfway + std::string(1000, '0'));
+	checkFloat(halfway + std::string(1000, '0') + "1");
+	checkFloat("0." + std::string(1000, '0') + "1e1010");
+
+	std::mt19937_64 gen{3};
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		std::string str;
+		if (gen() % 2)
+		{
+			str += '-';
+		}
+		auto digits = 1 + gen() % 25;
+		auto point = gen() % (digits + 1);
+		for (size_t j = 0; j < digits; ++j)
+		{
+			if (j == point)
+			{
+				str += '.';
+			}
+			str += char('0' + gen() % 10);
+		}
+		if (gen() % 2)
+		{
+			str += 'e';
+			str += std::to_string(int(gen() % 700) - 350);
+		}
+		checkFloat(str);
+	}
+
+	// the shortest representations of random doubles
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		auto bits = gen();
+		double value;
+		::memcpy(&value, &bits, sizeof(value));
+		if (std::isfinite(value))
+		{
+			char buffer[64];
+			::snprintf(buffer, sizeof(buffer), "%.17g", value);
+			checkFloat(buffer);
+		}
+	}
+}
+
+TEST_CASE("core::formatInt")
+{
+	char buffer[core::FORMAT_INT_MAX];
+	auto format = [&](int64_t value) {
+		return std::string(buffer, core::formatInt(value, buffer));
+	};
+	REQUIRE(format(0) == "0");
+	REQUIRE(format(-7) == "-7");
+	REQUIRE(format(INT64_MIN) == "-9223372036854775808");
+	REQUIRE(format(INT64_MAX) == "9223372036854775807");
+	REQUIRE(std::string(buffer, core::formatUint(UINT64_MAX, buffer)) == "18446744073709551615");
+
+	std::mt19937_64 gen{4};
+	for (size_t i = 0; i < 10000; ++i)
+	{
+		auto value = int64_t(gen()) >> (gen() % 64);
+		REQUIRE(format(value) == std::to_string(value));
+		auto unsignedValue = gen() >> (gen() % 64);
+		REQUIRE(std::string(buffer, core::formatUint(unsignedValue, buffer)) == std::to_string(unsignedValue));
+	}
+
+	// every power of ten and its neighbors since they're where the count of digits changes
+	uint64_t pow10 = 1;
+	for (size_t i = 0; i < 20; ++i, pow10 *= 10)
+	{
+		for (auto value: {pow10 - 1, pow10, pow10 + 1})
+		{
+			REQUIRE(std::string(buffer, core::formatUint(value, buffer)) == std::to_string(value));
+		}
+	}
+}
+
+TEST_CASE("core::formatFloat")
+{
+	char buffer[core::FORMAT_FLOAT_MAX];
+	auto format = [&](double value) {
+		return std::string(buffer, core::formatFloat(value, buffer));
+	};
+	REQUIRE(format(0.1) == "0.1");
+	REQUIRE(format(-1.5) == "-1.5");
+	REQUIRE(format(1e300) == "1e+300");
+	REQUIRE(format(HUGE_VAL) == "inf");
+
+	// the output is the shortest which parses back to the same double
+	std::mt19937_64 gen{5};
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		auto bits = gen();
+		double value;
+		::memcpy(&value, &bits, sizeof(value));
+		if (std::isfinite(value))
+		{
+			auto str = format(value);
+			auto res = core::parseFloat(core::StringView{str.data(), str.size()});
+			REQUIRE(bitsOf(res.value()) == bits);
+		}
+	}
+}
\ No newline at end of file
@@ -10,4 +10,10 @@ TEST_CASE("core::OS")
 	core::Log log{&allocator};
 
 	log.info("page size = {}"_sv, core::OS::pageSize());
+	log.info("huge page size = {}"_sv, core::OS::hugePageSize());
+	log.info("numa nodes count = {}"_sv, core::OS::numaNodesCount());
+
+	REQUIRE(core::OS::numaNodesCount() >= 1);
+	REQUIRE(core::OS::currentNumaNode() >= 0);
+	REQUIRE(core::OS::currentNumaNode() < core::OS::numaNodesCount());
 }
@@ -0,0 +1,166 @@
+#include <doctest/doctest.h>
+
+#include <core/Rand.h>
+
+#include <cstring>
+
+#if TAHA_OS_LINUX || TAHA_OS_DARWIN
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+TEST_CASE("core::Rand::cryptoRand")
+{
+	// covers the requests which are served from the pool, the ones which cross a refill and the ones which skip it
+	for (size_t count: {1, 16, 255, 256, 257, 4095, 4096, 10000})
+	{
+		std::byte a[10000] = {};
+		std::byte b[10000] = {};
+		REQUIRE(core::Rand::cryptoRand(core::Span<std::byte>{a, count}));
+		REQUIRE(core::Rand::cryptoRand(core::Span<std::byte>{b, count}));
+		if (count >= 16)
+		{
+			REQUIRE(::memcmp(a, b, count) != 0);
+		}
+	}
+}
+
+#if TAHA_OS_LINUX || TAHA_OS_DARWIN
+TEST_CASE("core::Rand::cryptoRand after fork")
+{
+	// fills the pool so the child inherits it
+	std::byte parent[16] = {};
+	REQUIRE(core::Rand::cryptoRand(core::Span<std::byte>{parent, sizeof(parent)}));
+
+	int fds[2] = {};
+	REQUIRE(::pipe(fds) == 0);
+	auto pid = ::fork();
+	REQUIRE(pid >= 0);
+	if (pid == 0)
+	{
+		std::byte child[16] = {};
+		core::Rand::cryptoRand(core::Span<std::byte>{child, sizeof(child)});
+		[[maybe_unused]] auto res = ::write(fds[1], child, sizeof(child));
+		::_exit(0);
+	}
+
+	std::byte child[16] = {};
+	REQUIRE(::read(fds[0], child, sizeof(child)) == sizeof(child));
+	::waitpid(pid, nullptr, 0);
+	::close(fds[0]);
+	::close(fds[1]);
+
+	REQUIRE(core::Rand::cryptoRand(core::Span<std::byte>{parent, sizeof(parent)}));
+	REQUIRE(::memcmp(parent, child, sizeof(parent)) != 0);
+}
+#endif
+
+TEST_CASE("core::FastRand")
+{
+	// splitmix64 expansion of 42 followed by the reference xoshiro256++ step
+	core::FastRand rand{42};
+	REQUIRE(rand.next() == 0xD0764D4F4476689FULL);
+	REQUIRE(rand.next() == 0x519E4174576F3791ULL);
+	REQUIRE(rand.next() == 0xFBE07CFB0C24ED8CULL);
+
+	core::FastRand a{7}, b{7};
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		REQUIRE(a.next() == b.next());
+	}
+
+	core::FastRand c, d;
+	REQUIRE(c.next() != d.next());
+}
+
+TEST_CASE("core::FastRand::uniform")
+{
+	core::FastRand rand{1};
+	REQUIRE(rand.uniform(0) == 0);
+	REQUIRE(rand.uniform(1) == 0);
+
+	size_t buckets[10] = {};
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		auto value = rand.uniform(10);
+		REQUIRE(value < 10);
+		++buckets[value];
+	}
+	for (auto count: buckets)
+	{
+		REQUIRE(count > 9000);
+		REQUIRE(count < 11000);
+	}
+
+	// a range just above half of 2^64 rejects almost half of the values
+	auto big = (UINT64_MAX / 2) + 2;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		REQUIRE(rand.uniform(big) < big);
+	}
+
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		auto value = rand.uniformDouble();
+		REQUIRE(value >= 0.0);
+		REQUIRE(value < 1.0);
+	}
+
+	auto& local = core::FastRand::threadLocal();
+	REQUIRE(&local == &core::FastRand::threadLocal());
+	REQUIRE(local.uniform(5) < 5);
+}
+
+TEST_CASE("core::FastRand::fill")
+{
+	// small buffers come from next in order
+	{
+		core::FastRand a{3}, b{3};
+		std::byte bytes[21] = {};
+		a.fill(core::Span<std::byte>{bytes, sizeof(bytes)});
+		uint64_t expected[3] = {b.next(), b.next(), b.next()};
+		REQUIRE(::memcmp(bytes, expected, sizeof(bytes)) == 0);
+	}
+
+	// big buffers are 4 interleaved streams each one jump apart, the generator continues after the last one
+	{
+		constexpr size_t COUNT = 64 * 1024 + 13;
+		static std::byte bytes[COUNT];
+		core::FastRand rand{5};
+		rand.fill(core::Span<std::byte>{bytes, COUNT});
+
+		core::FastRand streams[4] = {core::FastRand{5}, core::FastRand{5}, core::FastRand{5}, core::FastRand{5}};
+		for (size_t i = 1; i < 4; ++i)
+		{
+			for (size_t j = i; j < 4; ++j)
+			{
+				streams[j].jump();
+			}
+		}
+
+		bool interleaved = true;
+		for (size_t i = 0; i + 32 <= COUNT; i += 32)
+		{
+			for (size_t j = 0; j < 4; ++j)
+			{
+				auto value = streams[j].next();
+				interleaved = interleaved && ::memcmp(bytes + i + j * 8, &value, sizeof(value)) == 0;
+			}
+		}
+
+		// the scalar path fills it all from next when avx2 isn't there
+		if (interleaved == false)
+		{
+			core::FastRand scalar{5};
+			for (size_t i = 0; i + 8 <= COUNT; i += 8)
+			{
+				auto value = scalar.next();
+				REQUIRE(::memcmp(bytes + i, &value, sizeof(value)) == 0);
+			}
+		}
+
+		std::byte again[32] = {};
+		rand.fill(core::Span<std::byte>{again, sizeof(again)});
+		REQUIRE(::memcmp(again, bytes, sizeof(again)) != 0);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include <doctest/doctest.h>
+
+#include <core/Mallocator.h>
+#include <core/ProfilingAllocator.h>
+#include <core/SmallArray.h>
+#include <core/String.h>
+#include <core/Unique.h>
+
+TEST_CASE("basic core::SmallArray test")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator allocator{&mallocator, 0};
+	core::SmallArray<int, 4> numbers{&allocator};
+	REQUIRE(numbers.count() == 0);
+	REQUIRE(numbers.capacity() == 4);
+	REQUIRE(numbers.isInline());
+
+	for (int i = 0; i < 4; ++i)
+	{
+		numbers.push(i);
+	}
+	REQUIRE(numbers.isInline());
+	REQUIRE(allocator.stats().allocatedCount == 0);
+
+	for (int i = 4; i < 10; ++i)
+	{
+		numbers.push(i);
+	}
+	REQUIRE(numbers.isInline() == false);
+	REQUIRE(numbers.count() == 10);
+	REQUIRE(numbers.capacity() >= numbers.count());
+
+	int expected = 0;
+	for (auto n: numbers)
+	{
+		REQUIRE(n == expected++);
+	}
+
+	core::Span<const int> span = numbers;
+	REQUIRE(span.count() == 10);
+	REQUIRE(span[9] == 9);
+
+	numbers.pop();
+	REQUIRE(numbers.count() == 9);
+
+	numbers.resize(2);
+	REQUIRE(numbers.count() == 2);
+	REQUIRE(numbers[1] == 1);
+
+	numbers.clear();
+	REQUIRE(numbers.count() == 0);
+}
+
+TEST_CASE("core::SmallArray copy and move")
+{
+	core::Mallocator allocator;
+
+	core::SmallArray<core::String, 2> strings{&allocator};
+	strings.push(core::String{"a"_sv, &allocator});
+	strings.emplace("b"_sv, &allocator);
+
+	auto inlineCopy = strings;
+	REQUIRE(inlineCopy.isInline());
+	REQUIRE(inlineCopy.count() == 2);
+	REQUIRE(inlineCopy[1] == "b"_sv);
+
+	auto inlineMoved = std::move(inlineCopy);
+	REQUIRE(inlineMoved.isInline());
+	REQUIRE(inlineMoved.count() == 2);
+	REQUIRE(inlineMoved[0] == "a"_sv);
+	REQUIRE(inlineCopy.count() == 0);
+
+	strings.emplace("a string which doesn't fit in the inline storage"_sv, &allocator);
+	REQUIRE(strings.isInline() == false);
+
+	auto heapCopy = strings;
+	REQUIRE(heapCopy.count() == 3);
+	REQUIRE(heapCopy[2] == "a string which doesn't fit in the inline storage"_sv);
+
+	auto heapMoved = std::move(strings);
+	REQUIRE(heapMoved.isInline() == false);
+	REQUIRE(heapMoved.count() == 3);
+	REQUIRE(strings.count() == 0);
+
+	heapMoved = inlineMoved;
+	REQUIRE(heapMoved.isInline());
+	REQUIRE(heapMoved.count() == 2);
+
+	core::SmallArray<core::Unique<int>, 1> uniques{&allocator};
+	uniques.push(core::unique_from<int>(&allocator, 1));
+	uniques.push(core::unique_from<int>(&allocator, 2));
+	REQUIRE(*uniques[0] == 1);
+	REQUIRE(*uniques[1] == 2);
+}
+
+TEST_CASE("core::StringView::split into core::SmallArray")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator allocator{&mallocator, 0};
+
+	core::SmallArray<core::StringView, 8> parts{&allocator};
+	"/usr/local/bin"_sv.split("/"_sv, true, parts);
+	REQUIRE(parts.count() == 3);
+	REQUIRE(parts[0] == "usr"_sv);
+	REQUIRE(parts[1] == "local"_sv);
+	REQUIRE(parts[2] == "bin"_sv);
+	REQUIRE(allocator.stats().allocatedCount == 0);
+
+	",A,B,C,"_sv.split(","_sv, false, parts);
+	REQUIRE(parts.count() == 5);
+	REQUIRE(parts[0] == ""_sv);
+	REQUIRE(parts[4] == ""_sv);
+}
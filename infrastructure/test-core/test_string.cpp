@@ -1,9 +1,15 @@
 #include <doctest/doctest.h>
 
+#include <core/Buffer.h>
 #include <core/Mallocator.h>
+#include <core/ProfilingAllocator.h>
 #include <core/String.h>
 #include <core/StringView.h>
 
+#include <cctype>
+#include <random>
+#include <string>
+
 TEST_CASE("core::StringView basics")
 {
 	auto str = "Hello"_sv;
@@ -47,11 +53,246 @@ TEST_CASE("core::StringView findLast")
 	REQUIRE(""_sv.findLast("hello"_sv) == SIZE_MAX);
 }
 
+TEST_CASE("core::StringView find and findLast against std::string")
+{
+	std::mt19937 gen{42};
+	// small alphabets make many partial and periodic matches, the needle lengths cover single bytes, the vector
+	// filter and Two-Way for long needles
+	for (int alphabet: {1, 2, 4, 26})
+	{
+		for (size_t haystackCount: {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000})
+		{
+			std::string haystack;
+			for (size_t i = 0; i < haystackCount; ++i)
+			{
+				haystack.push_back(char('a' + gen() % alphabet));
+			}
+			core::StringView view{haystack.data(), haystack.size()};
+
+			for (size_t needleCount: {1, 2, 3, 5, 8, 17, 64, 65, 100, 300})
+			{
+				for (int trial = 0; trial < 4; ++trial)
+				{
+					std::string needle;
+					if (trial < 2 && needleCount <= haystackCount)
+					{
+						// a needle which exists in the haystack
+						needle = haystack.substr(gen() % (haystackCount - needleCount + 1), needleCount);
+					}
+					else
+					{
+						for (size_t i = 0; i < needleCount; ++i)
+						{
+							needle.push_back(char('a' + gen() % alphabet));
+						}
+					}
+					core::StringView target{needle.data(), needle.size()};
+
+					auto start = haystackCount == 0 ? 0 : gen() % haystackCount;
+					auto expected = haystack.find(needle, start);
+					REQUIRE(view.find(target, start) == (expected == std::string::npos ? SIZE_MAX : expected));
+					expected = haystack.find(needle);
+					REQUIRE(view.find(target) == (expected == std::string::npos ? SIZE_MAX : expected));
+
+					// findLast searches the bytes up to and including start
+					expected = std::string::npos;
+					if (start + 1 >= needleCount)
+					{
+						expected = haystack.rfind(needle, start + 1 - needleCount);
+					}
+					REQUIRE(view.findLast(target, start) == (expected == std::string::npos ? SIZE_MAX : expected));
+					expected = haystack.rfind(needle);
+					REQUIRE(view.findLast(target) == (expected == std::string::npos ? SIZE_MAX : expected));
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("core::StringView find repetitive input")
+{
+	// almost every position is a candidate of the vector filter so the search switches to Two-Way
+	for (size_t repeat: {10, 100, 1000})
+	{
+		std::string haystack(20000, 'a');
+		std::string needle(repeat, 'a');
+		needle.push_back('b');
+		std::string reversed = "b" + std::string(repeat, 'a');
+		core::StringView view{haystack.data(), haystack.size()};
+		REQUIRE(view.find(core::StringView{needle.data(), needle.size()}) == SIZE_MAX);
+		REQUIRE(view.findLast(core::StringView{reversed.data(), reversed.size()}) == SIZE_MAX);
+
+		haystack.replace(15000, needle.size(), needle);
+		view = core::StringView{haystack.data(), haystack.size()};
+		REQUIRE(view.find(core::StringView{needle.data(), needle.size()}) == 15000);
+
+		haystack.assign(20000, 'a');
+		haystack.replace(3000, reversed.size(), reversed);
+		view = core::StringView{haystack.data(), haystack.size()};
+		REQUIRE(view.findLast(core::StringView{reversed.data(), reversed.size()}) == 3000);
+
+		// a periodic needle
+		std::string periodic;
+		for (size_t i = 0; i < repeat; ++i)
+		{
+			periodic += "ab";
+		}
+		std::string text;
+		for (size_t i = 0; i < 10000; ++i)
+		{
+			text += i == 7000 ? "abb" : "ab";
+		}
+		text += periodic;
+		view = core::StringView{text.data(), text.size()};
+		core::StringView target{periodic.data(), periodic.size()};
+		REQUIRE(view.find(target) == text.find(periodic));
+		REQUIRE(view.find(target, 14001) == text.find(periodic, 14001));
+		REQUIRE(view.findLast(target) == text.rfind(periodic));
+		REQUIRE(view.findLast(target, 14000) == text.rfind(periodic, 14001 - periodic.size()));
+	}
+}
+
 TEST_CASE("core::StringView::find Rune")
 {
 	REQUIRE("hello world"_sv.find(core::Rune{'h'}) == 0);
 	REQUIRE("hello world"_sv.find(core::Rune{' '}) == 5);
 	REQUIRE("hello world"_sv.find(core::Rune{'o'}, 6) == 7);
+	REQUIRE("hello world"_sv.find(core::Rune{'x'}) == SIZE_MAX);
+	REQUIRE("مصطفى:"_sv.find(core::Rune{':'}) == 10);
+	REQUIRE("مصطفى:"_sv.find(core::Rune{0x637}) == 4);
+}
+
+TEST_CASE("core::StringView equalsIgnoreCase")
+{
+	REQUIRE("Sec-WebSocket-Key"_sv.equalsIgnoreCase("sec-websocket-key"_sv));
+	REQUIRE("UPGRADE"_sv.equalsIgnoreCase("upgrade"_sv));
+	REQUIRE(""_sv.equalsIgnoreCase(""_sv));
+	REQUIRE("upgrade"_sv.equalsIgnoreCase("upgrades"_sv) == false);
+	REQUIRE("scan"_sv.equalsIgnoreCase("scam"_sv) == false);
+	// only letters are folded, '@' and '`' are next to 'A' and 'a'
+	REQUIRE("@"_sv.equalsIgnoreCase("`"_sv) == false);
+	REQUIRE("["_sv.equalsIgnoreCase("{"_sv) == false);
+	REQUIRE("مصطفى"_sv.equalsIgnoreCase("مصطفى"_sv));
+	REQUIRE("ÉCOLE"_sv.equalsIgnoreCase("école"_sv));
+	REQUIRE("Straße"_sv.equalsIgnoreCase("STRASSE"_sv) == false);
+
+	// strings longer than a vector block with the difference at every position
+	std::string lower = "content-type: text/html; charset=utf-8 ÀÉ and more text after the runes";
+	std::string upper = "CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8 àé AND MORE TEXT AFTER THE RUNES";
+	REQUIRE(core::StringView{lower.data(), lower.size()}.equalsIgnoreCase(
+		core::StringView{upper.data(), upper.size()}));
+	for (size_t i = 0; i < lower.size(); ++i)
+	{
+		if ((lower[i] & 0x80) != 0)
+		{
+			continue;
+		}
+		auto changed = lower;
+		changed[i] = changed[i] == '#' ? '$' : '#';
+		REQUIRE(core::StringView{changed.data(), changed.size()}.equalsIgnoreCase(
+					core::StringView{upper.data(), upper.size()}) == false);
+	}
+}
+
+TEST_CASE("core::StringView findIgnoreCase")
+{
+	REQUIRE("Connection: keep-alive, Upgrade"_sv.findIgnoreCase("upgrade"_sv) == 24);
+	REQUIRE("Connection: keep-alive, Upgrade"_sv.findIgnoreCase("UPGRADE"_sv, 24) == 24);
+	REQUIRE("Connection: keep-alive, Upgrade"_sv.findIgnoreCase("upgrade"_sv, 25) == SIZE_MAX);
+	REQUIRE("Connection: keep-alive"_sv.findIgnoreCase("upgrade"_sv) == SIZE_MAX);
+	REQUIRE("abc"_sv.findIgnoreCase(""_sv) == 0);
+	REQUIRE("abc"_sv.findIgnoreCase("C"_sv) == 2);
+	REQUIRE("ab"_sv.findIgnoreCase("abc"_sv) == SIZE_MAX);
+	REQUIRE("اسم مصطفى"_sv.findIgnoreCase("مصطفى"_sv) == 7);
+
+	// against a search over the lower case copies of random mixed case strings
+	std::mt19937 gen{42};
+	for (size_t alphabet: {2, 4, 26})
+	{
+		for (size_t i = 0; i < 200; ++i)
+		{
+			std::string haystack, needle;
+			auto randomString = [&](std::string& str, size_t count) {
+				for (size_t j = 0; j < count; ++j)
+				{
+					auto c = char('a' + gen() % alphabet);
+					str.push_back(gen() % 2 == 0 ? c : char(c - 'a' + 'A'));
+				}
+			};
+			randomString(haystack, gen() % 200);
+			randomString(needle, 1 + gen() % 6);
+
+			auto lowerHaystack = haystack, lowerNeedle = needle;
+			for (auto& c: lowerHaystack)
+			{
+				c = char(std::tolower(c));
+			}
+			for (auto& c: lowerNeedle)
+			{
+				c = char(std::tolower(c));
+			}
+
+			core::StringView view{haystack.data(), haystack.size()};
+			core::StringView target{needle.data(), needle.size()};
+			for (size_t start: {size_t(0), haystack.size() / 2})
+			{
+				auto expected = lowerHaystack.find(lowerNeedle, start);
+				REQUIRE(view.findIgnoreCase(target, start) == (expected == std::string::npos ? SIZE_MAX : expected));
+			}
+		}
+	}
+}
+
+TEST_CASE("core::StringView findIgnoreCase repetitive input")
+{
+	// the last byte of the needle matches too so every position is a candidate and ascii needles switch to Two-Way
+	for (size_t repeat: {10, 100, 1000})
+	{
+		std::string haystack(20000, 'a');
+		std::string needle(repeat, 'A');
+		needle += "bA";
+		core::StringView view{haystack.data(), haystack.size()};
+		core::StringView target{needle.data(), needle.size()};
+		REQUIRE(view.findIgnoreCase(target) == SIZE_MAX);
+
+		haystack.replace(15000, needle.size(), std::string(repeat, 'a') + "Ba");
+		view = core::StringView{haystack.data(), haystack.size()};
+		REQUIRE(view.findIgnoreCase(target) == 15000);
+		REQUIRE(view.findIgnoreCase(target, 15001) == SIZE_MAX);
+
+		// a periodic needle
+		std::string periodic;
+		for (size_t i = 0; i < repeat; ++i)
+		{
+			periodic += "aB";
+		}
+		std::string text;
+		for (size_t i = 0; i < 10000; ++i)
+		{
+			text += i == 7000 ? "Abb" : "Ab";
+		}
+		text += "AB";
+		std::string lowerText = text, lowerPeriodic = periodic;
+		for (auto& c: lowerText)
+		{
+			c = char(std::tolower(c));
+		}
+		for (auto& c: lowerPeriodic)
+		{
+			c = char(std::tolower(c));
+		}
+		view = core::StringView{text.data(), text.size()};
+		target = core::StringView{periodic.data(), periodic.size()};
+		REQUIRE(view.findIgnoreCase(target) == lowerText.find(lowerPeriodic));
+		REQUIRE(view.findIgnoreCase(target, 14001) == lowerText.find(lowerPeriodic, 14001));
+
+		// needles with non ascii runes keep verifying the candidates
+		std::string runes = std::string(repeat, 'A') + "Éa";
+		std::string runesText = std::string(20000, 'a') + "éa";
+		view = core::StringView{runesText.data(), runesText.size()};
+		target = core::StringView{runes.data(), runes.size()};
+		REQUIRE(view.findIgnoreCase(target) == 20000 - repeat);
+	}
 }
 
 TEST_CASE("core::String creation")
@@ -149,7 +390,174 @@ TEST_CASE("core::String::split")
 	REQUIRE(res[0] == "test"_sv);
 }
 
+TEST_CASE("core::StringView lazy split")
+{
+	core::Mallocator allocator;
+
+	auto parts = ",A,,B,C,"_sv.split(","_sv, true);
+	auto it = parts.begin();
+	REQUIRE(*it == "A"_sv);
+	REQUIRE(it->count() == 1);
+	REQUIRE(*++it == "B"_sv);
+	REQUIRE(*++it == "C"_sv);
+	REQUIRE(++it == parts.end());
+
+	// the lazy split yields the same parts as the allocating one
+	std::mt19937 gen{3};
+	const char* delims[] = {",", ",,", "\r\n", "ab"};
+	for (size_t i = 0; i < 2000; ++i)
+	{
+		std::string text;
+		auto count = gen() % 40;
+		for (size_t j = 0; j < count; ++j)
+		{
+			text += ",\r\nab"[gen() % 6];
+		}
+		auto str = core::StringView{text.data(), text.size()};
+		auto delim = core::StringView{delims[i % std::size(delims)]};
+		auto skipEmpty = gen() % 2 == 0;
+
+		auto expected = str.split(delim, skipEmpty, &allocator);
+		size_t index = 0;
+		for (auto part: str.split(delim, skipEmpty))
+		{
+			REQUIRE(index < expected.count());
+			REQUIRE(part == expected[index++]);
+		}
+		REQUIRE(index == expected.count());
+
+		core::SmallArray<core::StringView, 4> small{&allocator};
+		str.split(delim, skipEmpty, small);
+		REQUIRE(small.count() == expected.count());
+		for (size_t j = 0; j < small.count(); ++j)
+		{
+			REQUIRE(small[j] == expected[j]);
+		}
+	}
+}
+
+TEST_CASE("core::StringView lines")
+{
+	core::Mallocator allocator;
+	auto collect = [&](core::StringView str) {
+		core::Array<core::StringView> res{&allocator};
+		for (auto line: str.lines())
+		{
+			res.push(line);
+		}
+		return res;
+	};
+
+	REQUIRE(collect(""_sv).count() == 0);
+
+	auto res = collect("a\nb\r\n\nc"_sv);
+	REQUIRE(res.count() == 4);
+	REQUIRE(res[0] == "a"_sv);
+	REQUIRE(res[1] == "b"_sv);
+	REQUIRE(res[2] == ""_sv);
+	REQUIRE(res[3] == "c"_sv);
+
+	// a trailing line break doesn't start another line
+	res = collect("a\r\nb\n"_sv);
+	REQUIRE(res.count() == 2);
+	REQUIRE(res[0] == "a"_sv);
+	REQUIRE(res[1] == "b"_sv);
+
+	res = collect("\n\n"_sv);
+	REQUIRE(res.count() == 2);
+	REQUIRE(res[0] == ""_sv);
+	REQUIRE(res[1] == ""_sv);
+}
+
+TEST_CASE("core::StringView fields")
+{
+	core::Mallocator allocator;
+	auto collect = [&](core::StringView str) {
+		core::Array<core::StringView> res{&allocator};
+		for (auto field: str.fields())
+		{
+			res.push(field);
+		}
+		return res;
+	};
+
+	REQUIRE(collect(""_sv).count() == 0);
+	REQUIRE(collect(" \t\r\n "_sv).count() == 0);
+
+	auto res = collect("  GET /index.html\tHTTP/1.1\r\n"_sv);
+	REQUIRE(res.count() == 3);
+	REQUIRE(res[0] == "GET"_sv);
+	REQUIRE(res[1] == "/index.html"_sv);
+	REQUIRE(res[2] == "HTTP/1.1"_sv);
+
+	res = collect("مصطفى سعد"_sv);
+	REQUIRE(res.count() == 2);
+	REQUIRE(res[0] == "مصطفى"_sv);
+	REQUIRE(res[1] == "سعد"_sv);
+}
+
 TEST_CASE("core::String::endsWithIgnoreCase")
 {
 	REQUIRE("GET / HTTP/1.1"_sv.endsWithIgnoreCase("HTTP/1.1"_sv));
 }
+
+TEST_CASE("core::String small string optimization")
+{
+	core::Mallocator mallocator;
+	core::ProfilingAllocator allocator{&mallocator, 0};
+
+	core::String empty{&allocator};
+	REQUIRE(empty.isInline());
+	REQUIRE(empty.count() == 0);
+	REQUIRE(empty.data()[0] == '\0');
+
+	core::String small{"0123456789012345678901"_sv, &allocator};
+	REQUIRE(small.isInline());
+	REQUIRE(small.count() == 22);
+	REQUIRE(small.data()[22] == '\0');
+	REQUIRE(allocator.stats().allocatedCount == 0);
+
+	auto copy = small;
+	REQUIRE(copy.isInline());
+	REQUIRE(copy == small);
+
+	small.pushByte('2');
+	REQUIRE(small.isInline() == false);
+	REQUIRE(small == "01234567890123456789012"_sv);
+	REQUIRE(small.data()[23] == '\0');
+	REQUIRE(allocator.stats().allocatedCount == 1);
+
+	for (int i = 0; i < 100; ++i)
+	{
+		copy.push(core::Rune{U'🌎'});
+	}
+	REQUIRE(copy.count() == 22 + 400);
+	REQUIRE(copy.runeCount() == 22 + 100);
+	REQUIRE(copy.endsWith("🌎🌎"_sv));
+
+	auto moved = std::move(copy);
+	REQUIRE(moved.count() == 22 + 400);
+	REQUIRE(copy.count() == 0);
+
+	moved.resize(3);
+	REQUIRE(moved == "012"_sv);
+
+	core::String built{&allocator};
+	for (char c = 'a'; c <= 'z'; ++c)
+	{
+		built.pushByte(c);
+	}
+	REQUIRE(built == "abcdefghijklmnopqrstuvwxyz"_sv);
+	REQUIRE(core::strf(&allocator, "{}"_sv, built) == built);
+
+	core::Buffer buffer{std::move(built)};
+	REQUIRE(buffer.count() == 26);
+	auto back = core::String{std::move(buffer)};
+	REQUIRE(back == "abcdefghijklmnopqrstuvwxyz"_sv);
+
+	core::Buffer smallBuffer{core::String{"small"_sv, &allocator}};
+	REQUIRE(smallBuffer.isInline());
+	auto smallBack = core::String{std::move(smallBuffer)};
+	REQUIRE(smallBack.isInline());
+	REQUIRE(smallBack == "small"_sv);
+}
@@ -3,6 +3,7 @@
 #include <core/ExecutionQueue.h>
 #include <core/Log.h>
 #include <core/Mallocator.h>
+#include <core/ThreadCachedAllocator.h>
 #include <core/ThreadPool.h>
 
 TEST_CASE("core::ThreadPool basics")
@@ -23,6 +24,30 @@ TEST_CASE("core::ThreadPool basics")
 	REQUIRE(count == 1000);
 }
 
+TEST_CASE("core::ThreadPool current allocator")
+{
+	core::Mallocator mallocator;
+	core::ThreadCachedAllocator allocator{&mallocator};
+
+	std::atomic<int> matches = 0;
+	{
+		core::ThreadPool pool{&allocator, 4};
+		for (size_t i = 0; i < 100; ++i)
+		{
+			pool.run([&]() {
+				if (core::currentAllocator() == &allocator)
+				{
+					matches += 1;
+				}
+			});
+		}
+		pool.flush();
+	}
+
+	REQUIRE(matches == 100);
+	REQUIRE(core::currentAllocator() != &allocator);
+}
+
 TEST_CASE("core::ThreadPool ExecutionQueue")
 {
 	core::Mallocator allocator;
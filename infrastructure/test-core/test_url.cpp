@@ -170,3 +170,138 @@ TEST_CASE("basic core::Url::parse test")
 		REQUIRE(encoded_string == "%3A+%2F+%3F+%23+%5B+%5D+%40+%21+%24+%26+%27+%28+%29+%2A+%2B+%2C+%3B+%3D+%25"_sv);
 	}
 }
+
+TEST_CASE("core::UrlQuery many keys")
+{
+	core::Mallocator allocator;
+
+	core::UrlQuery query{&allocator};
+	for (int i = 0; i < 100; ++i)
+	{
+		auto key = core::strf(&allocator, "key{}"_sv, i);
+		auto value = core::strf(&allocator, "value{}"_sv, i);
+		query.add(key, value);
+	}
+
+	auto copy = query;
+	for (int i = 0; i < 100; ++i)
+	{
+		auto key = core::strf(&allocator, "key{}"_sv, i);
+		auto value = core::strf(&allocator, "value{}"_sv, i);
+		REQUIRE(query.get(query.find(key)) == value);
+		REQUIRE(copy.get(copy.find(key)) == value);
+	}
+	REQUIRE(query.find("key100"_sv) == nullptr);
+
+	// a repeated key finds its first value
+	query.add("key7"_sv, "other"_sv);
+	REQUIRE(query.count() == 101);
+	REQUIRE(query.get(query.find("key7"_sv)) == "value7"_sv);
+	REQUIRE(query[100].value == "other"_sv);
+}
+
+TEST_CASE("core::UrlView::parse")
+{
+	SUBCASE("parts are views into the url")
+	{
+		auto str = "HTTPS://john%20doe@WWW.Example.com:8443/a/./b%2F?q=go%20language&x#top%20id"_sv;
+		auto parsedUrl = core::UrlView::parse(str);
+		REQUIRE(parsedUrl.isError() == false);
+		auto url = parsedUrl.value();
+		REQUIRE(url.scheme() == "HTTPS"_sv);
+		REQUIRE(url.user() == "john%20doe"_sv);
+		REQUIRE(url.host() == "WWW.Example.com"_sv);
+		REQUIRE(url.port() == "8443"_sv);
+		REQUIRE(url.path() == "/a/./b%2F"_sv);
+		REQUIRE(url.query().str() == "q=go%20language&x"_sv);
+		REQUIRE(url.fragment() == "top%20id"_sv);
+		REQUIRE(url.pathWithQueryAndFragment() == "/a/./b%2F?q=go%20language&x#top%20id"_sv);
+		REQUIRE(url.host().data() == str.data() + 19);
+
+		char buffer[64];
+		auto count = core::UrlView::decode(url.user(), core::Span<char>{buffer, sizeof(buffer)});
+		REQUIRE(core::StringView{buffer, count} == "john doe"_sv);
+	}
+
+	SUBCASE("ipv6")
+	{
+		auto parsedUrl = core::UrlView::parse("ws://[::1]:9001"_sv);
+		REQUIRE(parsedUrl.isError() == false);
+		auto url = parsedUrl.value();
+		REQUIRE(url.host() == "::1"_sv);
+		REQUIRE(url.port() == "9001"_sv);
+		REQUIRE(url.ipVersion() == 6);
+		REQUIRE(url.pathWithQueryAndFragment() == ""_sv);
+	}
+
+	SUBCASE("errors")
+	{
+		REQUIRE(core::UrlView::parse("1http://a.com"_sv).error() == core::UrlParseErr::Scheme);
+		REQUIRE(core::UrlView::parse("http://a b.com/"_sv).error() == core::UrlParseErr::Host);
+		REQUIRE(core::UrlView::parse("http://[::1/"_sv).error() == core::UrlParseErr::Host);
+		REQUIRE(core::UrlView::parse("http://a.com:99999/"_sv).error() == core::UrlParseErr::Port);
+		REQUIRE(core::UrlView::parse("http://a.com/a b"_sv).error() == core::UrlParseErr::Path);
+		REQUIRE(core::UrlView::parse("http://a.com/?a=<"_sv).error() == core::UrlParseErr::Query);
+		REQUIRE(core::UrlView::parse("http://a.com/#<"_sv).error() == core::UrlParseErr::Fragment);
+		REQUIRE(core::UrlView::parse("http://a.com:"_sv).error() == core::UrlParseErr::Port);
+		REQUIRE(core::UrlView::parse("http://"_sv).isError() == false);
+
+		core::Mallocator allocator;
+		auto parsedUrl = core::Url::parse("http://a.com:99999/"_sv, &allocator);
+		REQUIRE(parsedUrl.isError());
+		REQUIRE(parsedUrl.error().message() == "Port is invalid"_sv);
+	}
+
+	SUBCASE("decode")
+	{
+		char buffer[32];
+		core::Span<char> out{buffer, sizeof(buffer)};
+		REQUIRE(core::UrlView::decode("a%2"_sv, out) == SIZE_MAX);
+		REQUIRE(core::UrlView::decode("a%zz"_sv, out) == SIZE_MAX);
+		REQUIRE(core::UrlView::decode("%"_sv, out) == SIZE_MAX);
+
+		auto count = core::UrlView::decode("a+b%2b%41"_sv, out);
+		REQUIRE(core::StringView{buffer, count} == "a+b+A"_sv);
+		count = core::UrlView::decodeQueryElement("a+b%2b%41"_sv, out);
+		REQUIRE(core::StringView{buffer, count} == "a b+A"_sv);
+	}
+}
+
+TEST_CASE("core::UrlQueryView")
+{
+	core::UrlQueryView query{"a=1&b&=3;c=x=y&&d%20e=f+g&"_sv};
+
+	core::UrlQueryKeyValue expected[] = {
+		{"a"_sv, "1"_sv},
+		{"b"_sv, ""_sv},
+		{""_sv, "3"_sv},
+		{"c"_sv, "x=y"_sv},
+		{""_sv, ""_sv},
+		{"d%20e"_sv, "f+g"_sv},
+	};
+
+	size_t i = 0;
+	for (auto [key, value]: query)
+	{
+		REQUIRE(i < sizeof(expected) / sizeof(*expected));
+		REQUIRE(key == expected[i].key);
+		REQUIRE(value == expected[i].value);
+		++i;
+	}
+	REQUIRE(i == sizeof(expected) / sizeof(*expected));
+
+	REQUIRE(query.find("c"_sv)->value == "x=y"_sv);
+	REQUIRE(query.find("d e"_sv)->value == "f+g"_sv);
+	REQUIRE(query.find("d%20e"_sv) == query.end());
+	REQUIRE(query.find("z"_sv) == query.end());
+	REQUIRE(core::UrlQueryView{}.begin() == core::UrlQueryView{}.end());
+	REQUIRE(core::UrlQueryView{"%zz=1"_sv}.find("%zz"_sv)->value == "1"_sv);
+
+	core::Mallocator allocator;
+	auto parsedUrl = core::Url::parse("http://a.com/?a=1&b&d%20e=f+g"_sv, &allocator);
+	REQUIRE(parsedUrl.isError() == false);
+	auto url = parsedUrl.releaseValue();
+	REQUIRE(url.query().count() == 3);
+	REQUIRE(url.query().get(url.query().find("d e"_sv)) == "f g"_sv);
+	REQUIRE(url.query().get(url.query().find("b"_sv)) == ""_sv);
+}
@@ -0,0 +1,179 @@
+#include <doctest/doctest.h>
+
+#include <core/Rune.h>
+#include <core/StringView.h>
+#include <core/Utf8.h>
+
+#include <utf8proc.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+
+// the validation of utf8proc which rejects the same sequences
+static bool referenceValidate(const std::string& str)
+{
+	auto ptr = reinterpret_cast<const utf8proc_uint8_t*>(str.data());
+	for (size_t i = 0; i < str.size();)
+	{
+		utf8proc_int32_t rune = 0;
+		auto size = utf8proc_iterate(ptr + i, utf8proc_ssize_t(str.size() - i), &rune);
+		if (size <= 0)
+		{
+			return false;
+		}
+		i += size_t(size);
+	}
+	return true;
+}
+
+// random text which is mostly valid utf8 from every script length with a random byte thrown in sometimes
+static std::string randomText(std::mt19937& gen, size_t count, bool corrupt)
+{
+	static const char* RUNES[] = {"a", " ", "\n", "é", "م", "ص", "€", "中", "🌎", "\xf4\x8f\xbf\xbf"};
+	std::string res;
+	while (res.size() < count)
+	{
+		res += RUNES[gen() % std::size(RUNES)];
+	}
+	if (corrupt && res.empty() == false)
+	{
+		res[gen() % res.size()] = char(gen());
+	}
+	return res;
+}
+
+TEST_CASE("core::Utf8::decode against utf8proc")
+{
+	const uint8_t tails[] = {0x00, 0x41, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0, 0xbf, 0xc0, 0xf4, 0xff};
+	auto check = [](const uint8_t (&bytes)[5]) {
+		auto ptr = reinterpret_cast<const char*>(bytes);
+		size_t count = 0;
+		while (count < 4 && bytes[count] != 0)
+		{
+			++count;
+		}
+
+		utf8proc_int32_t expected = 0;
+		if (count > 0)
+		{
+			utf8proc_iterate(bytes, utf8proc_ssize_t(count), &expected);
+		}
+		REQUIRE(core::Rune::decode(ptr) == core::Rune{expected});
+
+		core::Rune rune{};
+		auto size = core::Utf8::decode(ptr, count, rune);
+		REQUIRE(rune == core::Rune{expected});
+		REQUIRE(size == (expected < 0 ? 1 : core::Rune{expected}.size()));
+	};
+
+	for (int a = 1; a < 256; ++a)
+	{
+		for (int b = 0; b < 256; ++b)
+		{
+			check({uint8_t(a), uint8_t(b), 0x80, 0x80, 0});
+		}
+	}
+	for (int a = 0xe0; a < 256; ++a)
+	{
+		for (int b = 0x80; b < 0xc0; ++b)
+		{
+			for (auto c: tails)
+			{
+				for (auto d: tails)
+				{
+					check({uint8_t(a), uint8_t(b), c, d, 0});
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("core::Utf8::validate")
+{
+	REQUIRE(core::Utf8::validate("", 0));
+	REQUIRE("Hello يا عالم 🌎!"_sv.isValidUtf8());
+	REQUIRE("\xc0\x80"_sv.isValidUtf8() == false);
+	REQUIRE("\xed\xa0\x80"_sv.isValidUtf8() == false);
+	REQUIRE("\xf4\x90\x80\x80"_sv.isValidUtf8() == false);
+	REQUIRE("\xe2\x82"_sv.isValidUtf8() == false);
+
+	// lengths around the vector blocks with errors at every position
+	std::mt19937 gen{42};
+	for (size_t i = 0; i < 5000; ++i)
+	{
+		auto text = randomText(gen, gen() % 130, i % 2 == 0);
+		REQUIRE(core::Utf8::validate(text.data(), text.size()) == referenceValidate(text));
+	}
+
+	// a sequence truncated at the end of the input or cut by ascii at each block boundary
+	std::string text(100, 'a');
+	for (const char* rune: {"é", "€", "🌎"})
+	{
+		auto runeCount = ::strlen(rune);
+		for (size_t i = 0; i + runeCount <= text.size(); ++i)
+		{
+			auto copy = text;
+			copy.replace(i, runeCount, rune);
+			REQUIRE(core::Utf8::validate(copy.data(), copy.size()));
+			REQUIRE(core::Utf8::validate(copy.data(), i + runeCount - 1) == false);
+			copy[i + runeCount - 1] = 'a';
+			REQUIRE(core::Utf8::validate(copy.data(), copy.size()) == false);
+		}
+	}
+}
+
+TEST_CASE("core::Utf8::countRunes")
+{
+	std::mt19937 gen{7};
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		auto text = randomText(gen, gen() % 300, true);
+		size_t expected = 0;
+		for (auto c: text)
+		{
+			expected += (c & 0xc0) != 0x80;
+		}
+		REQUIRE(core::Utf8::countRunes(text.data(), text.size()) == expected);
+	}
+
+	REQUIRE("Hello يا عالم 🌎!"_sv.runeCount() == 16);
+	REQUIRE(core::Rune::count("Hello يا عالم 🌎!") == 16);
+	// the rune count stops at the first null byte
+	REQUIRE(core::StringView{"ab\0cd", 5}.runeCount() == 2);
+}
+
+TEST_CASE("core::Utf8 conversions")
+{
+	std::mt19937 gen{11};
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		auto text = randomText(gen, gen() % 300, false);
+		std::u16string utf16(text.size(), u'\0');
+		utf16.resize(core::Utf8::toUtf16(text.data(), text.size(), utf16.data()));
+		std::u32string utf32(text.size(), U'\0');
+		utf32.resize(core::Utf8::toUtf32(text.data(), text.size(), utf32.data()));
+
+		size_t index = 0;
+		for (auto rune: core::StringView{text.data(), text.size()}.runes())
+		{
+			REQUIRE(utf32[index++] == char32_t(int(rune)));
+		}
+		REQUIRE(index == utf32.size());
+
+		std::string back(utf16.size() * 3, '\0');
+		back.resize(core::Utf8::fromUtf16(utf16.data(), utf16.size(), back.data()));
+		REQUIRE(back == text);
+	}
+
+	// invalid sequences and unpaired surrogates become U+FFFD
+	std::string invalid = "ab\xff" "c\xe2\x82" "d";
+	std::u32string utf32(invalid.size(), U'\0');
+	utf32.resize(core::Utf8::toUtf32(invalid.data(), invalid.size(), utf32.data()));
+	REQUIRE(utf32 == U"ab�c��d");
+
+	std::u16string surrogates = u"a\xd800" "b\xdc00";
+	std::string utf8(surrogates.size() * 3, '\0');
+	utf8.resize(core::Utf8::fromUtf16(surrogates.data(), surrogates.size(), utf8.data()));
+	REQUIRE(utf8 == "a\xef\xbf\xbd" "b\xef\xbf\xbd");
+}
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include <core/String.h>
 #include <core/UUID.h>
 
+#include <chrono>
+
 TEST_CASE("basic core::UUID test")
 {
 	core::Mallocator allocator;
@@ -53,3 +55,77 @@ TEST_CASE("core::UUID parsing")
 	REQUIRE(res.isError() == false);
 	REQUIRE(res.value() == core::UUID{});
 }
+
+static uint64_t unixMilliseconds()
+{
+	auto now = std::chrono::system_clock::now().time_since_epoch();
+	return uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+}
+
+TEST_CASE("core::UUID::generateV7")
+{
+	auto before = unixMilliseconds();
+
+	auto prev = core::UUID::generateV7();
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		auto id = core::UUID::generateV7();
+		REQUIRE(prev < id);
+		REQUIRE(id.version() == core::UUID::UUID_VERSION_UNIX_TIME_BASED);
+		REQUIRE(id.variant() == core::UUID::UUID_VARIANT_RFC);
+		prev = id;
+	}
+
+	auto after = unixMilliseconds();
+
+	uint64_t timestamp = 0;
+	for (size_t i = 0; i < 6; ++i)
+	{
+		timestamp = (timestamp << 8) | prev[i];
+	}
+	REQUIRE(timestamp >= before);
+	// the counter can carry into the timestamp when more than 2048 uuids are generated in a millisecond
+	REQUIRE(timestamp <= after + 100000 / 2048 + 1);
+}
+
+TEST_CASE("core::UUID format and parse")
+{
+	core::Mallocator allocator;
+
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		auto id = i % 2 == 0 ? core::UUID::generate() : core::UUID::generateV7();
+		char buffer[core::UUID::STRING_SIZE];
+		id.format(core::Span<char>{buffer, sizeof(buffer)});
+		core::StringView str{buffer, sizeof(buffer)};
+		core::String expected{&allocator};
+		for (size_t j = 0; j < 16; ++j)
+		{
+			if (j == 4 || j == 6 || j == 8 || j == 10)
+			{
+				expected.push("-"_sv);
+			}
+			expected.push(core::strf(&allocator, "{:02x}"_sv, id[j]));
+		}
+		REQUIRE(str == expected);
+
+		auto parsed = core::UUID::parse(str, &allocator);
+		REQUIRE(parsed.isError() == false);
+		REQUIRE(parsed.value() == id);
+
+		auto braced = core::strf(&allocator, "{{{}}}"_sv, str);
+		parsed = core::UUID::parse(braced, &allocator);
+		REQUIRE(parsed.isError() == false);
+		REQUIRE(parsed.value() == id);
+	}
+
+	auto res = core::UUID::parse("{62013B88-FA54-4008-8D42-F9CA4889E0B5}"_sv, &allocator);
+	REQUIRE(res.isError() == false);
+	REQUIRE(res.value() == core::UUID::parse("62013b88fa5440088d42f9ca4889e0b5"_sv, &allocator).value());
+
+	res = core::UUID::parse("62013B88-FA54-4008-8D42-F9CA4889E0BG"_sv, &allocator);
+	REQUIRE(res.isError());
+
+	res = core::UUID::parse("{62013B88-FA54-4008-8D42-F9CA4889E0B5"_sv, &allocator);
+	REQUIRE(res.isError());
+}